@@ -925,6 +925,13 @@ macro(process_options)
     endif()
   endif()
 
+  set(ENABLE_MTP FALSE)
+  if(${NS3_MTP})
+    message(STATUS "Multithreaded parallel simulation enabled.")
+    add_definitions(-DNS3_MTP)
+    set(ENABLE_MTP TRUE)
+  endif()
+
   mark_as_advanced(Boost_INCLUDE_DIR)
   find_package(Boost)
   if(${Boost_FOUND})
@@ -1204,6 +1211,30 @@ macro(process_options)
   if(${NS3_LOG} OR (${build_profile} STREQUAL "debug"))
     add_definitions(-DNS3_LOG_ENABLE)
   endif()
+  # Compile the log statements down to a level only, e.g. -DNS3_LOG_FLOOR=warn
+  if(NOT ("${NS3_LOG_FLOOR}" STREQUAL ""))
+    string(TOUPPER ${NS3_LOG_FLOOR} log_floor)
+    set(log_levels ERROR WARN DEBUG INFO FUNCTION LOGIC)
+    if(NOT (${log_floor} IN_LIST log_levels))
+      message(
+        FATAL_ERROR
+          "NS3_LOG_FLOOR must be one of: error, warn, debug, info, function, logic"
+      )
+    endif()
+    add_definitions(-DNS3_LOG_FLOOR=ns3::LOG_${log_floor})
+  endif()
+  # The same for the cybertwin data path only, e.g. -DCYBERTWIN_LOG_FLOOR=warn
+  if(NOT ("${CYBERTWIN_LOG_FLOOR}" STREQUAL ""))
+    string(TOUPPER ${CYBERTWIN_LOG_FLOOR} cybertwin_log_floor)
+    set(log_levels ERROR WARN DEBUG INFO FUNCTION LOGIC)
+    if(NOT (${cybertwin_log_floor} IN_LIST log_levels))
+      message(
+        FATAL_ERROR
+          "CYBERTWIN_LOG_FLOOR must be one of: error, warn, debug, info, function, logic"
+      )
+    endif()
+    add_definitions(-DCYBERTWIN_LOG_FLOOR=ns3::LOG_${cybertwin_log_floor})
+  endif()
   # Force enable ns-3 asserts in debug builds and if requested for other build
   # types
   if(${NS3_ASSERT} OR (${build_profile} STREQUAL "debug"))
@@ -1238,6 +1269,10 @@ macro(process_options)
     list(REMOVE_ITEM libs_to_build mpi)
   endif()
 
+  if(NOT ${ENABLE_MTP})
+    list(REMOVE_ITEM libs_to_build mtp)
+  endif()
+
   if(NOT ${ENABLE_VISUALIZER})
     list(REMOVE_ITEM libs_to_build visualizer)
   endif()
@@ -1439,6 +1474,12 @@ function(build_exec)
     ${BEXEC_EXECNAME_PREFIX}${BEXEC_EXECNAME} PUBLIC ${BEXEC_DEFINITIONS}
   )
 
+  # Export the symbols of the executable (-rdynamic), so that the event
+  # profiler can name the functions defined in it
+  set_target_properties(
+    ${BEXEC_EXECNAME_PREFIX}${BEXEC_EXECNAME} PROPERTIES ENABLE_EXPORTS ON
+  )
+
   if(${PRECOMPILE_HEADERS_ENABLED} AND (NOT ${BEXEC_IGNORE_PCH}))
     target_precompile_headers(
       ${BEXEC_EXECNAME_PREFIX}${BEXEC_EXECNAME} REUSE_FROM stdlib_pch_exec
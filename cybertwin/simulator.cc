@@ -18,12 +18,34 @@ CybertwinNetworkSimulator::GetTypeId()
 }
 
 CybertwinNetworkSimulator::CybertwinNetworkSimulator()
+    : m_systemCount(1),
+      m_appRxBytes(0),
+      m_lastAppRxBytes(0),
+      m_warmStart(false),
+      m_maxParallelVariants(1)
 {
     NS_LOG_FUNCTION(this);
     std::string topologyFile = "cybertwin/topology.yaml";
     std::string appFiles = "cybertwin/applications.yaml";
     m_topologyReader.SetFileName(topologyFile);
     m_topologyReader.SetAppFiles(appFiles);
+
+    m_stopConditions.maxSimTime = Seconds(NORMAL_SIM_SECONDS);
+    m_stopConditions.maxWallSeconds = 0;
+    m_stopConditions.allDownloadsFinished = false;
+    m_stopConditions.noProgressTime = Seconds(0);
+    m_stopConditions.checkInterval = MilliSeconds(STOP_CONDITION_CHECK_INTERVAL);
+
+    m_animation.format = "xml";
+    m_animation.file = "cybertwin.xml";
+    m_animation.sampleEvery = 1;
+    m_animation.sampleFlows = false;
+    m_animation.start = Seconds(0);
+    m_animation.stop = Seconds(0);
+
+    m_flowmon.enabled = false;
+    m_flowmon.file = "cybertwin-flowmon.xml";
+    m_flowmon.sampleEvery = 1;
 }
 
 CybertwinNetworkSimulator::~CybertwinNetworkSimulator()
@@ -46,6 +68,11 @@ CybertwinNetworkSimulator::DriverCompileTopology()
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("[1] Reading the topology file...");
     m_nodes = m_topologyReader.Read();
+    ReadStopConditions();
+    ReadWarmStartConfig();
+    ReadAnimationConfig();
+    ReadFlowMonitorConfig();
+    ReadManagerConfig();
 
     // populate routing tables
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
@@ -53,6 +80,36 @@ CybertwinNetworkSimulator::DriverCompileTopology()
     NS_LOG_INFO("[1] Topology file read successfully!");
 }
 
+// Assign the nodes to the simulation threads, either by layer (the core
+// cloud, then each edge server with its end clusters) or by partitioning
+// the graph of the links
+void
+CybertwinNetworkSimulator::DriverPartitionTopology(uint32_t threads, const std::string& partition)
+{
+    NS_LOG_FUNCTION(this << threads << partition);
+#ifdef NS3_MTP
+    std::vector<NodeContainer> partitions;
+    if (partition == "layer")
+    {
+        partitions = m_topologyReader.GetLayerPartitions();
+    }
+    else if (partition == "graph")
+    {
+        partitions = MtpHelper::Partition(m_nodes, threads);
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unknown partitioning " << partition << ", use layer or graph");
+    }
+    MtpHelper::Install(partitions);
+    NS_LOG_INFO("[1] " << partitions.size() << " partitions by " << partition << " on " << threads
+                       << " threads, lookahead "
+                       << MtpHelper::GetLookahead(partitions).GetMicroSeconds() << "(us)");
+#else
+    NS_FATAL_ERROR("Multithreaded simulation needs a build with NS3_MTP enabled");
+#endif
+}
+
 void
 CybertwinNetworkSimulator::DriverInstallApps()
 {
@@ -65,21 +122,30 @@ CybertwinNetworkSimulator::DriverInstallApps()
     for (uint32_t i = 0; i < coreNodes.GetN(); i++)
     {
         Ptr<CybertwinCoreServer> node = DynamicCast<CybertwinCoreServer>(coreNodes.Get(i));
-        node->StartAllAggregatedApps();
+        if (CybertwinTopologyReader::IsLocalNode(node))
+        {
+            node->StartAllAggregatedApps();
+        }
     }
 
     NodeContainer edgeNodes = m_topologyReader.GetEdgeCloudNodes();
     for (uint32_t i = 0; i < edgeNodes.GetN(); i++)
     {
         Ptr<CybertwinEdgeServer> node = DynamicCast<CybertwinEdgeServer>(edgeNodes.Get(i));
-        node->StartAllAggregatedApps();
+        if (CybertwinTopologyReader::IsLocalNode(node))
+        {
+            node->StartAllAggregatedApps();
+        }
     }
 
     NodeContainer endNodes = m_topologyReader.GetEndClusterNodes();
     for (uint32_t i = 0; i < endNodes.GetN(); i++)
     {
         Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(endNodes.Get(i));
-        node->StartAllAggregatedApps();
+        if (CybertwinTopologyReader::IsLocalNode(node))
+        {
+            node->StartAllAggregatedApps();
+        }
     }
 
     NS_LOG_INFO("[2] Nodes and applications configured successfully!");
@@ -95,64 +161,553 @@ CybertwinNetworkSimulator::DriverBootSimulator()
     // 2. Power on Edge Nodes
     // 3. Power on End Hosts
 
-    // power on the nodes
+    // power on the nodes simulated by this system
     NodeContainer coreNodes = m_topologyReader.GetCoreCloudNodes();
     for (uint32_t i = 0; i < coreNodes.GetN(); i++)
     {
         Ptr<CybertwinCoreServer> node = DynamicCast<CybertwinCoreServer>(coreNodes.Get(i));
+        if (!CybertwinTopologyReader::IsLocalNode(node))
+        {
+            continue;
+        }
         node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), CORE_CLOUD_NODE_SIZE, CORE_CLOUD_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 0);
+        UpdateNodeAnimation(node->GetId(), CORE_CLOUD_NODE_SIZE, 0);
     }
 
     NodeContainer edgeNodes = m_topologyReader.GetEdgeCloudNodes();
     for (uint32_t i = 0; i < edgeNodes.GetN(); i++)
     {
         Ptr<CybertwinEdgeServer> node = DynamicCast<CybertwinEdgeServer>(edgeNodes.Get(i));
+        if (!CybertwinTopologyReader::IsLocalNode(node))
+        {
+            continue;
+        }
         node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), EDGE_CLOUD_NODE_SIZE, EDGE_CLOUD_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 1);
+        UpdateNodeAnimation(node->GetId(), EDGE_CLOUD_NODE_SIZE, 1);
     }
 
     NodeContainer endhostNodes = m_topologyReader.GetEndHostNodes();
     for (uint32_t i = 0; i < endhostNodes.GetN(); i++)
     {
         Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(endhostNodes.Get(i));
+        if (!CybertwinTopologyReader::IsLocalNode(node))
+        {
+            continue;
+        }
+        m_bootingHosts.Add(node);
         node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), END_HOST_NODE_SIZE, END_HOST_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 2);
+        UpdateNodeAnimation(node->GetId(), END_HOST_NODE_SIZE, 2);
     }
 
     NodeContainer apNodes = m_topologyReader.GetApNodes();
     for (uint32_t i = 0; i < apNodes.GetN(); i++)
     {
         Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(apNodes.Get(i));
+        if (!CybertwinTopologyReader::IsLocalNode(node))
+        {
+            continue;
+        }
+        m_bootingHosts.Add(node);
         node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), AP_NODE_SIZE, AP_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 3);
+        UpdateNodeAnimation(node->GetId(), AP_NODE_SIZE, 3);
     }
 
     NodeContainer staNodes = m_topologyReader.GetStaNodes();
     for (uint32_t i = 0; i < staNodes.GetN(); i++)
     {
         Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(staNodes.Get(i));
+        if (!CybertwinTopologyReader::IsLocalNode(node))
+        {
+            continue;
+        }
+        m_bootingHosts.Add(node);
         node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), STA_NODE_SIZE, STA_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 4);
+        UpdateNodeAnimation(node->GetId(), STA_NODE_SIZE, 4);
     }
 
+    // report when the boot phase completes
+    m_bootWallStart = std::chrono::steady_clock::now();
+    Simulator::ScheduleNow(&CybertwinNetworkSimulator::CheckBootPhase, this);
 
     NS_LOG_INFO("[3] Simulation completed!");
 }
 
+void
+CybertwinNetworkSimulator::CheckBootPhase()
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t registered = 0;
+    for (uint32_t i = 0; i < m_bootingHosts.GetN(); i++)
+    {
+        Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(m_bootingHosts.Get(i));
+        if (node->isCybertwinCreated())
+        {
+            registered++;
+        }
+    }
+
+    if (registered < m_bootingHosts.GetN())
+    {
+        Simulator::Schedule(MilliSeconds(BOOT_PHASE_CHECK_INTERVAL),
+                            &CybertwinNetworkSimulator::CheckBootPhase,
+                            this);
+        return;
+    }
+
+    double wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - m_bootWallStart).count();
+    NS_LOG_INFO("[3] Boot phase completed: " << registered << " cybertwins registered at "
+                                             << Simulator::Now().GetSeconds() << "(s), wall time "
+                                             << wallSeconds << "(s)");
+}
+
+void
+CybertwinNetworkSimulator::ReadStopConditions()
+{
+    NS_LOG_FUNCTION(this);
+    // Stop conditions are optional, e.g.
+    //  simulation:
+    //    max_sim_time: 10s
+    //    max_wall_time: 600          # seconds
+    //    all_downloads_finished: true
+    //    no_progress_for: 2s
+    //    check_interval: 100ms
+    YAML::Node topology_yaml = YAML::LoadFile(m_topologyReader.GetFileName());
+    const YAML::Node& simulation = topology_yaml["simulation"];
+    if (!simulation)
+    {
+        return;
+    }
+
+    if (simulation["max_sim_time"])
+    {
+        m_stopConditions.maxSimTime = Time(simulation["max_sim_time"].as<std::string>());
+    }
+    if (simulation["max_wall_time"])
+    {
+        m_stopConditions.maxWallSeconds = simulation["max_wall_time"].as<double>();
+    }
+    if (simulation["all_downloads_finished"])
+    {
+        m_stopConditions.allDownloadsFinished = simulation["all_downloads_finished"].as<bool>();
+    }
+    if (simulation["no_progress_for"])
+    {
+        m_stopConditions.noProgressTime = Time(simulation["no_progress_for"].as<std::string>());
+    }
+    if (simulation["check_interval"])
+    {
+        m_stopConditions.checkInterval = Time(simulation["check_interval"].as<std::string>());
+    }
+    NS_ABORT_MSG_IF(!m_stopConditions.checkInterval.IsStrictlyPositive(),
+                    "check_interval must be positive");
+
+    NS_LOG_INFO("[1] Stop conditions: max sim time " << m_stopConditions.maxSimTime.GetSeconds()
+                << "(s), max wall time " << m_stopConditions.maxWallSeconds
+                << "(s), all downloads finished " << m_stopConditions.allDownloadsFinished
+                << ", no progress for " << m_stopConditions.noProgressTime.GetSeconds() << "(s)");
+}
+
+void
+CybertwinNetworkSimulator::ReadAnimationConfig()
+{
+    NS_LOG_FUNCTION(this);
+    // The animation is optional, AnimationInterface XML by default, e.g.
+    //  animation:
+    //    format: binary              # xml, binary or none
+    //    file: cybertwin.ctsa
+    //    sample_every: 10            # binary only
+    //    sample_by: flow             # packet or flow
+    //    start: 1s
+    //    stop: 2s
+    //    nodes: [core_node1, edge_node1]  # binary only
+    YAML::Node topology_yaml = YAML::LoadFile(m_topologyReader.GetFileName());
+    const YAML::Node& animation = topology_yaml["animation"];
+    if (!animation)
+    {
+        return;
+    }
+
+    if (animation["format"])
+    {
+        m_animation.format = animation["format"].as<std::string>();
+        m_animation.file = m_animation.format == "binary" ? "cybertwin.ctsa" : "cybertwin.xml";
+    }
+    NS_ABORT_MSG_IF(m_animation.format != "xml" && m_animation.format != "binary" &&
+                        m_animation.format != "none",
+                    "Unknown animation format " << m_animation.format);
+    if (animation["file"])
+    {
+        m_animation.file = animation["file"].as<std::string>();
+    }
+    if (animation["sample_every"])
+    {
+        m_animation.sampleEvery = animation["sample_every"].as<uint32_t>();
+        NS_ABORT_MSG_IF(m_animation.sampleEvery == 0, "sample_every must be positive");
+    }
+    if (animation["sample_by"])
+    {
+        std::string sampleBy = animation["sample_by"].as<std::string>();
+        NS_ABORT_MSG_IF(sampleBy != "packet" && sampleBy != "flow",
+                        "sample_by must be packet or flow");
+        m_animation.sampleFlows = sampleBy == "flow";
+    }
+    if (animation["start"])
+    {
+        m_animation.start = Time(animation["start"].as<std::string>());
+    }
+    if (animation["stop"])
+    {
+        m_animation.stop = Time(animation["stop"].as<std::string>());
+    }
+    if (animation["nodes"])
+    {
+        m_animation.nodes = animation["nodes"].as<std::vector<std::string>>();
+    }
+    if (m_animation.format == "xml" && (m_animation.sampleEvery > 1 || !m_animation.nodes.empty()))
+    {
+        NS_LOG_WARN("The xml animation ignores the sampling and the node filter");
+    }
+
+    NS_LOG_INFO("[1] Animation: " << m_animation.format << " " << m_animation.file
+                << ", one in " << m_animation.sampleEvery
+                << (m_animation.sampleFlows ? " flows" : " packets") << ", "
+                << m_animation.nodes.size() << " nodes selected");
+}
+
+void
+CybertwinNetworkSimulator::ReadFlowMonitorConfig()
+{
+    NS_LOG_FUNCTION(this);
+    // The flow monitor is optional and off by default, e.g.
+    //  flow_monitor:
+    //    file: cybertwin-flowmon.xml
+    //    sample_every: 16            # track one packet in 16 of every flow
+    YAML::Node topology_yaml = YAML::LoadFile(m_topologyReader.GetFileName());
+    const YAML::Node& flowmon = topology_yaml["flow_monitor"];
+    if (!flowmon)
+    {
+        return;
+    }
+
+    m_flowmon.enabled = true;
+    if (flowmon["file"])
+    {
+        m_flowmon.file = flowmon["file"].as<std::string>();
+    }
+    if (flowmon["sample_every"])
+    {
+        m_flowmon.sampleEvery = flowmon["sample_every"].as<uint32_t>();
+        NS_ABORT_MSG_IF(m_flowmon.sampleEvery == 0, "sample_every must be positive");
+    }
+
+    NS_LOG_INFO("[1] Flow monitor: " << m_flowmon.file << ", one packet in "
+                                     << m_flowmon.sampleEvery << " tracked");
+}
+
+void
+CybertwinNetworkSimulator::ReadManagerConfig()
+{
+    NS_LOG_FUNCTION(this);
+    // The cybertwin manager options are optional, e.g.
+    //  cybertwin_manager:
+    //    shared_listener: true       # one listener per interface for all cybertwins
+    YAML::Node topology_yaml = YAML::LoadFile(m_topologyReader.GetFileName());
+    const YAML::Node& manager = topology_yaml["cybertwin_manager"];
+    if (!manager)
+    {
+        return;
+    }
+
+    // the managers are created when the nodes power on, after this
+    if (manager["shared_listener"])
+    {
+        bool sharedListener = manager["shared_listener"].as<bool>();
+        Config::SetDefault("ns3::CybertwinManager::SharedListener", BooleanValue(sharedListener));
+        NS_LOG_INFO("[1] Cybertwin managers: shared listener " << sharedListener);
+    }
+}
+
+void
+CybertwinNetworkSimulator::ApplicationRx(Ptr<const Packet> packet, const Address& from)
+{
+    m_appRxBytes += packet->GetSize();
+}
+
+void
+CybertwinNetworkSimulator::CheckStopConditions()
+{
+    NS_LOG_FUNCTION(this);
+    // Only bytes delivered to applications count as progress, so the
+    // self-rescheduling timers (statistics, polling, token buckets) do not
+    // keep a finished experiment alive.
+    if (m_appRxBytes != m_lastAppRxBytes)
+    {
+        m_lastAppRxBytes = m_appRxBytes;
+        m_lastProgressTime = Simulator::Now();
+    }
+
+    double wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - m_runWallStart).count();
+    if (m_stopConditions.maxWallSeconds > 0 && wallSeconds >= m_stopConditions.maxWallSeconds)
+    {
+        m_stopReason = "max wall time reached";
+    }
+    else if (m_stopConditions.allDownloadsFinished && !m_downloadClients.empty() &&
+             std::all_of(m_downloadClients.begin(),
+                         m_downloadClients.end(),
+                         [](Ptr<CybertwinAppDownloadClient> app) { return app->IsFinished(); }))
+    {
+        m_stopReason = "all download clients finished";
+    }
+    else if (m_stopConditions.noProgressTime.IsStrictlyPositive() && m_appRxBytes > 0 &&
+             Simulator::Now() - m_lastProgressTime >= m_stopConditions.noProgressTime)
+    {
+        // armed by the first delivered byte, so start-up delays are not idle time
+        m_stopReason = "no application progress";
+    }
+
+    if (!m_stopReason.empty())
+    {
+        Simulator::Stop();
+        return;
+    }
+
+    Simulator::Schedule(m_stopConditions.checkInterval,
+                        &CybertwinNetworkSimulator::CheckStopConditions,
+                        this);
+}
+
 void
 CybertwinNetworkSimulator::RunSimulator()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("[4] Running the simulation...");
-    Simulator::Stop(Seconds(10));
+
+    // watch the download clients, the other ranks run theirs
+    for (auto it = NodeList::Begin(); it != NodeList::End(); it++)
+    {
+        if (!CybertwinTopologyReader::IsLocalNode(*it))
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < (*it)->GetNApplications(); i++)
+        {
+            Ptr<CybertwinAppDownloadClient> app =
+                DynamicCast<CybertwinAppDownloadClient>((*it)->GetApplication(i));
+            if (app)
+            {
+                m_downloadClients.push_back(app);
+            }
+        }
+    }
+    Config::ConnectWithoutContextFailSafe(
+        "/NodeList/*/ApplicationList/*/$ns3::CybertwinAppDownloadClient/Rx",
+        MakeCallback(&CybertwinNetworkSimulator::ApplicationRx, this));
+    Config::ConnectWithoutContextFailSafe(
+        "/NodeList/*/ApplicationList/*/$ns3::PacketSink/Rx",
+        MakeCallback(&CybertwinNetworkSimulator::ApplicationRx, this));
+
+    m_runWallStart = std::chrono::steady_clock::now();
+    m_lastProgressTime = Simulator::Now();
+    // every rank would decide on its own progress and stop alone, while the
+    // others wait for it, so a distributed run stops at max_sim_time only
+    if (m_systemCount > 1)
+    {
+        if (m_stopConditions.maxWallSeconds > 0 || m_stopConditions.allDownloadsFinished ||
+            m_stopConditions.noProgressTime.IsStrictlyPositive())
+        {
+            NS_LOG_WARN("[4] Only max_sim_time stops a distributed run");
+        }
+    }
+    else
+    {
+        Simulator::Schedule(m_stopConditions.checkInterval,
+                            &CybertwinNetworkSimulator::CheckStopConditions,
+                            this);
+    }
+    // after a warm start the clock is already past zero
+    if (m_stopConditions.maxSimTime > Simulator::Now())
+    {
+        Simulator::Stop(m_stopConditions.maxSimTime - Simulator::Now());
+    }
+    else
+    {
+        Simulator::Stop();
+    }
+    Simulator::Run();
+
+    if (m_stopReason.empty())
+    {
+        m_stopReason = "max simulation time reached";
+    }
+    NS_LOG_INFO("[4] Simulation completed at " << Simulator::Now().GetSeconds() << "(s): "
+                                               << m_stopReason);
+}
+
+void
+CybertwinNetworkSimulator::ReadWarmStartConfig()
+{
+    NS_LOG_FUNCTION(this);
+    // Warm start is optional, e.g.
+    //  warm_start:
+    //    checkpoint: 3s
+    //    max_parallel: 4
+    //    output_dir: sweep
+    //    variants:
+    //      - name: small-batches
+    //        applications: cybertwin/applications.yaml
+    //        defaults:
+    //          ns3::TcpSocket::SegmentSize: 1448
+    //        attributes:
+    //          /NodeList/*/ApplicationList/*/$ns3::CybertwinManager/RegistrationBatchSize: 8
+    YAML::Node topology_yaml = YAML::LoadFile(m_topologyReader.GetFileName());
+    const YAML::Node& warmStart = topology_yaml["warm_start"];
+    if (!warmStart || !warmStart["variants"] || warmStart["variants"].size() == 0)
+    {
+        return;
+    }
+
+    m_warmStart = true;
+    NS_ABORT_MSG_IF(!warmStart["checkpoint"], "warm_start needs a checkpoint time");
+    m_checkpointTime = Time(warmStart["checkpoint"].as<std::string>());
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    m_maxParallelVariants = warmStart["max_parallel"] ? warmStart["max_parallel"].as<uint32_t>()
+                                                      : static_cast<uint32_t>(std::max(cpus, 1L));
+    m_maxParallelVariants = std::max(m_maxParallelVariants, 1U);
+    m_variantOutputDir = warmStart["output_dir"] ? warmStart["output_dir"].as<std::string>() : ".";
+
+    for (const auto& node : warmStart["variants"])
+    {
+        WarmStartVariant_t variant;
+        variant.name = node["name"].as<std::string>();
+        NS_ABORT_MSG_IF(variant.name.empty(), "every warm_start variant needs a name");
+        if (node["applications"])
+        {
+            variant.appFiles = node["applications"].as<std::string>();
+        }
+        for (const auto& item : node["defaults"])
+        {
+            variant.defaults.emplace_back(item.first.as<std::string>(),
+                                          item.second.as<std::string>());
+        }
+        for (const auto& item : node["attributes"])
+        {
+            variant.attributes.emplace_back(item.first.as<std::string>(),
+                                            item.second.as<std::string>());
+        }
+        m_variants.push_back(variant);
+    }
+
+    NS_LOG_INFO("[1] Warm start: checkpoint at " << m_checkpointTime.GetSeconds() << "(s), "
+                << m_variants.size() << " variants, " << m_maxParallelVariants
+                << " in parallel");
+}
+
+bool
+CybertwinNetworkSimulator::IsWarmStartEnabled() const
+{
+    return m_warmStart;
+}
+
+uint32_t
+CybertwinNetworkSimulator::RunWarmStartSweep()
+{
+    NS_LOG_FUNCTION(this);
+    NS_LOG_INFO("[4] Warming up until the checkpoint at " << m_checkpointTime.GetSeconds()
+                                                          << "(s)...");
+    auto warmWallStart = std::chrono::steady_clock::now();
+    Simulator::Stop(m_checkpointTime);
     Simulator::Run();
-    NS_LOG_INFO("[4] Simulation completed!");
+    double warmSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - warmWallStart).count();
+    NS_LOG_INFO("[4] Checkpoint reached after " << warmSeconds << "(s) of wall time");
+
+    // buffered output would otherwise be written once per child
+    std::cout.flush();
+    std::clog.flush();
+    fflush(nullptr);
+
+    uint32_t running = 0;
+    uint32_t failed = 0;
+    for (const auto& variant : m_variants)
+    {
+        if (running >= m_maxParallelVariants)
+        {
+            int status;
+            if (wait(&status) > 0)
+            {
+                running--;
+                failed += (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+            }
+        }
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            NS_FATAL_ERROR("Failed to fork variant " << variant.name);
+        }
+        if (pid == 0)
+        {
+            // child: continue from the shared checkpoint with this variant
+            RunVariant(variant);
+            return 0;
+        }
+        NS_LOG_INFO("[4] Variant " << variant.name << " started as process " << pid);
+        running++;
+    }
+
+    int status;
+    while (running > 0 && wait(&status) > 0)
+    {
+        running--;
+        failed += (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+    }
+    NS_LOG_INFO("[4] Warm-start sweep completed: " << m_variants.size() - failed << "/"
+                                                   << m_variants.size() << " variants succeeded");
+    if (failed > 0)
+    {
+        NS_LOG_WARN("[4] " << failed << " variants failed, see their logs in "
+                           << m_variantOutputDir);
+    }
+    return failed;
+}
+
+std::string
+CybertwinNetworkSimulator::GetVariantName() const
+{
+    return m_variantName;
+}
+
+void
+CybertwinNetworkSimulator::RunVariant(const WarmStartVariant_t& variant)
+{
+    NS_LOG_FUNCTION(this << variant.name);
+    m_variantName = variant.name;
+    // keep the output of every variant apart
+    std::string logFile = m_variantOutputDir + "/" + variant.name + ".log";
+    if (!freopen(logFile.c_str(), "w", stdout) || !freopen(logFile.c_str(), "a", stderr))
+    {
+        NS_FATAL_ERROR("Failed to open " << logFile);
+    }
+    NS_LOG_INFO("[4] Variant " << variant.name << " continues from "
+                               << Simulator::Now().GetSeconds() << "(s)");
+
+    for (const auto& item : variant.defaults)
+    {
+        Config::SetDefault(item.first, StringValue(item.second));
+    }
+    for (const auto& item : variant.attributes)
+    {
+        Config::Set(item.first, StringValue(item.second));
+    }
+    if (!variant.appFiles.empty())
+    {
+        m_topologyReader.SetAppFiles(variant.appFiles);
+    }
+
+    DriverInstallApps();
+    RunSimulator();
 }
 
 void
@@ -160,16 +715,137 @@ CybertwinNetworkSimulator::Output()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("[5] Output the simulation results...");
+    WriteFlowMonitorResults();
+    // write the rest of the binary animation trace
+    m_animTrace.reset();
     Simulator::Destroy();
     NS_LOG_INFO("[5] Simulation results outputted successfully!");
 }
 
 void
-CybertwinNetworkSimulator::SetAnimationInterface(AnimationInterface* animInterface)
+CybertwinNetworkSimulator::WriteFlowMonitorResults()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_flowMonitor)
+    {
+        return;
+    }
+    m_flowMonitor->SerializeToXmlFile(m_flowmon.file, false, false);
+
+    // QoE of the MDTP streams, summed over their subflows
+    auto streams = m_flowClassifier->GetStreamStats(m_flowMonitor->GetFlowStats());
+    for (const auto& item : streams)
+    {
+        const CybertwinFlowClassifier::StreamStats& stream = item.second;
+        Time duration = stream.timeLastRxPacket - stream.timeFirstTxPacket;
+        NS_LOG_INFO("[5] Stream " << item.first.cuid << " -> " << item.first.peer << " conn "
+                    << item.first.connId << ": " << stream.flows << " subflows, "
+                    << stream.rxBytes * m_flowmon.sampleEvery << " bytes received, "
+                    << (duration.IsStrictlyPositive()
+                            ? stream.rxBytes * 8.0 * m_flowmon.sampleEvery /
+                                  duration.GetSeconds() / 1e6
+                            : 0)
+                    << " Mbps, mean delay "
+                    << (stream.rxPackets ? stream.delaySum.GetSeconds() * 1e3 / stream.rxPackets
+                                         : 0)
+                    << " ms, loss "
+                    << (stream.txPackets ? 100.0 * stream.lostPackets / stream.txPackets : 0)
+                    << " %");
+    }
+    NS_LOG_INFO("[5] Flow monitor: " << m_flowMonitor->GetFlowStats().size() << " flows, "
+                                     << streams.size() << " MDTP streams, written to "
+                                     << m_flowmon.file);
+
+    m_flowmonHelper.reset();
+    m_flowMonitor = nullptr;
+    m_flowClassifier = nullptr;
+}
+
+void
+CybertwinNetworkSimulator::UpdateNodeAnimation(uint32_t nodeId, double size, uint32_t image)
+{
+    // no animation in warm-start mode
+    if (m_animInterface)
+    {
+        m_animInterface->UpdateNodeSize(nodeId, size, size);
+        m_animInterface->UpdateNodeImage(nodeId, image);
+    }
+    if (m_animTrace)
+    {
+        m_animTrace->UpdateNodeSize(nodeId, size, size);
+        m_animTrace->UpdateNodeImage(nodeId, image);
+    }
+}
+
+void
+CybertwinNetworkSimulator::SetSystemCount(uint32_t systems)
+{
+    NS_LOG_FUNCTION(this << systems);
+    m_systemCount = systems;
+    m_topologyReader.SetSystemCount(systems);
+}
+
+// must be called after the topology is read, before the boot phase
+void
+CybertwinNetworkSimulator::EnableAnimation()
 {
     NS_LOG_FUNCTION(this);
-    m_animInterface = animInterface;
+    const std::vector<std::string> resources = {"doc/netanim_icon/core_server.png",
+                                                "doc/netanim_icon/edge_server.png",
+                                                "doc/netanim_icon/endhost_station.png",
+                                                "doc/netanim_icon/wireless_ap.png",
+                                                "doc/netanim_icon/wireless_sta.png"};
+    if (m_animation.format == "xml")
+    {
+        m_animInterface = std::make_unique<AnimationInterface>(m_animation.file);
+        m_animInterface->SetStartTime(m_animation.start);
+        if (m_animation.stop.IsStrictlyPositive())
+        {
+            m_animInterface->SetStopTime(m_animation.stop);
+        }
+        for (const auto& resource : resources)
+        {
+            m_animInterface->AddResource(resource);
+        }
+    }
+    else if (m_animation.format == "binary")
+    {
+        std::set<uint32_t> nodes;
+        for (const auto& name : m_animation.nodes)
+        {
+            nodes.insert(m_topologyReader.GetNodeByName(name)->GetId());
+        }
+        m_animTrace = std::make_unique<StreamingAnimationTrace>(m_animation.file, nodes);
+        m_animTrace->SetSampling(m_animation.sampleEvery,
+                                 m_animation.sampleFlows
+                                     ? StreamingAnimationTrace::SAMPLE_FLOWS
+                                     : StreamingAnimationTrace::SAMPLE_PACKETS);
+        m_animTrace->SetStartTime(m_animation.start);
+        if (m_animation.stop.IsStrictlyPositive())
+        {
+            m_animTrace->SetStopTime(m_animation.stop);
+        }
+        for (const auto& resource : resources)
+        {
+            m_animTrace->AddResource(resource);
+        }
+    }
+}
 
+// must be called after the topology is read, before the boot phase
+void
+CybertwinNetworkSimulator::EnableFlowMonitor()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_flowmon.enabled)
+    {
+        return;
+    }
+    m_flowmonHelper = std::make_unique<FlowMonitorHelper>();
+    m_flowClassifier = Create<CybertwinFlowClassifier>();
+    m_flowmonHelper->SetClassifier(m_flowClassifier);
+    m_flowmonHelper->SetMonitorAttribute("SamplingRatio", UintegerValue(m_flowmon.sampleEvery));
+    m_flowMonitor = m_flowmonHelper->InstallAll();
 }
 
 }; // namespace ns3
@@ -179,6 +855,46 @@ using namespace ns3;
 int
 main(int argc, char* argv[])
 {
+    // allows attribute overrides, e.g. --ns3::CybertwinEndHostDaemon::StartJitter=50ms
+    CommandLine cmd(__FILE__);
+    uint32_t threads = 1;
+    std::string partition = "layer";
+    cmd.AddValue("threads", "Number of simulation threads, needs NS3_MTP", threads);
+    cmd.AddValue("partition", "Partitioning of the nodes between threads: layer or graph", partition);
+    bool distributed = false;
+    cmd.AddValue("distributed", "Run on the MPI ranks with DistributedSimulatorImpl", distributed);
+    // e.g. --binaryLog=cybertwin.nslog, then ./ns3 run 'log-render --input=cybertwin.nslog'
+    std::string binaryLog;
+    uint32_t binaryLogSize = 64;
+    cmd.AddValue("binaryLog",
+                 "Record the log in a ring buffer written to this file, suffixed with "
+                 "the variant name in a warm-start sweep",
+                 binaryLog);
+    cmd.AddValue("binaryLogSize", "Size of the binary log ring buffer in MiB", binaryLogSize);
+    cmd.Parse(argc, argv);
+#ifdef NS3_MTP
+    // must be bound before anything is scheduled
+    if (threads > 1)
+    {
+        MtpHelper::Enable(threads);
+    }
+#endif
+#ifdef NS3_MPI
+    // e.g. mpirun -np 4 ./ctsim-cybertwin --distributed
+    if (distributed)
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+    }
+#else
+    NS_ABORT_MSG_IF(distributed, "Distributed simulation needs a build with MPI enabled");
+#endif
+
+    if (!binaryLog.empty())
+    {
+        BinaryLogSink::Enable(binaryLogSize << 20);
+    }
     LogComponentEnable("CybertwinNetworkSimulator", LOG_LEVEL_INFO);
     LogComponentEnable("CybertwinTopologyReader", LOG_LEVEL_INFO);
     LogComponentEnable("CybertwinNode", LOG_LEVEL_DEBUG);
@@ -197,30 +913,73 @@ main(int argc, char* argv[])
     // init the simulator
     simulator->InputInit();
 
+#ifdef NS3_MPI
+    if (distributed)
+    {
+        simulator->SetSystemCount(MpiInterface::GetSize());
+    }
+#endif
+
     // read the topology file
     simulator->DriverCompileTopology();
+    NS_ABORT_MSG_IF(distributed && simulator->IsWarmStartEnabled(),
+                    "Warm starts fork the process and cannot be distributed");
+    NS_ABORT_MSG_IF(distributed && threads > 1,
+                    "A distributed run cannot also be multithreaded");
+    if (threads > 1)
+    {
+        simulator->DriverPartitionTopology(threads, partition);
+    }
 
-    // the animation interface must define after the topology is read
-    AnimationInterface anim("cybertwin.xml");
-    anim.AddResource("doc/netanim_icon/core_server.png");
-    anim.AddResource("doc/netanim_icon/edge_server.png");
-    anim.AddResource("doc/netanim_icon/endhost_station.png");
-    anim.AddResource("doc/netanim_icon/wireless_ap.png");
-    anim.AddResource("doc/netanim_icon/wireless_sta.png");
-    simulator->SetAnimationInterface(&anim);
+    // the animation and the flow monitor must be enabled after the topology
+    // is read, forked variants would share their files so warm starts go
+    // without, and none of them is thread safe nor distributed
+    if (!simulator->IsWarmStartEnabled() && threads <= 1 && !distributed)
+    {
+        simulator->EnableAnimation();
+        simulator->EnableFlowMonitor();
+    }
 
     // boot the simulator
     simulator->DriverBootSimulator();
 
-    // configure the nodes and applications
-    simulator->DriverInstallApps();
+    uint32_t failedVariants = 0;
+    if (simulator->IsWarmStartEnabled())
+    {
+        // boot once, then fork a process per variant from the checkpoint
+        failedVariants = simulator->RunWarmStartSweep();
+    }
+    else
+    {
+        // configure the nodes and applications
+        simulator->DriverInstallApps();
 
-    // run the simulator
-    simulator->RunSimulator();
+        // run the simulator
+        simulator->RunSimulator();
+    }
 
     // output the simulation results
     simulator->Output();
+    bool isVariant = !simulator->GetVariantName().empty();
+    // every variant writes its own log, which holds the warm-up too, so the
+    // parent of a sweep has nothing to add
+    if (!binaryLog.empty() && (isVariant || !simulator->IsWarmStartEnabled()))
+    {
+        BinaryLogSink::Disable();
+        if (isVariant)
+        {
+            binaryLog += "." + simulator->GetVariantName();
+        }
+        NS_ABORT_MSG_UNLESS(BinaryLogSink::Write(binaryLog), "Cannot write " << binaryLog);
+    }
+#ifdef NS3_MPI
+    if (distributed)
+    {
+        MpiInterface::Disable();
+    }
+#endif
 
-    return 0;
+    // a sweep fails when any of its variants does
+    return failedVariants > 0 ? 1 : 0;
 
 }; // namespace ns3
\ No newline at end of file
@@ -2,12 +2,34 @@
 #define CYBERTWIN_SIMULATOR_H
 
 #include "ns3/core-module.h"
+#include "ns3/cybertwin-app-download-client.h"
+#include "ns3/cybertwin-flow-classifier.h"
 #include "ns3/cybertwin-topology-reader.h"
+#include "ns3/flow-monitor-helper.h"
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/log.h"
+#ifdef NS3_MTP
+#include "ns3/mtp-helper.h"
+#endif
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
 #include "ns3/netanim-module.h"
 #include "ns3/node-container.h"
 #include "ns3/simulator.h"
+#include "ns3/streaming-animation-trace.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #define CORE_CLOUD_NODE_SIZE (7)
 #define EDGE_CLOUD_NODE_SIZE (5)
@@ -15,8 +37,50 @@
 #define AP_NODE_SIZE (5)
 #define STA_NODE_SIZE (5)
 
+#define BOOT_PHASE_CHECK_INTERVAL (10) // ms
+#define STOP_CONDITION_CHECK_INTERVAL (100) // ms
+
 namespace ns3
 {
+// when to end the run, read from the "simulation" section of the topology file
+typedef struct StopConditions
+{
+    Time maxSimTime;           // hard limit of simulated time
+    double maxWallSeconds;     // hard limit of wall-clock time, 0: unlimited
+    bool allDownloadsFinished; // stop once every download client is done
+    Time noProgressTime;       // stop after no application progress for this long, 0: never
+    Time checkInterval;        // how often the conditions are evaluated
+} StopConditions_t;
+
+// an experiment continued from the warm-start checkpoint
+typedef struct WarmStartVariant
+{
+    std::string name;
+    std::string appFiles; // applications file, empty: the default one
+    std::vector<std::pair<std::string, std::string>> defaults;   // Config::SetDefault
+    std::vector<std::pair<std::string, std::string>> attributes; // Config::Set
+} WarmStartVariant_t;
+
+// animation trace, read from the "animation" section of the topology file
+typedef struct AnimationConfig
+{
+    std::string format;             // xml (AnimationInterface), binary or none
+    std::string file;               // trace file
+    uint32_t sampleEvery;           // trace one packet or flow in N, binary only
+    bool sampleFlows;               // sample whole flows rather than packets
+    Time start;                     // no packet traced before
+    Time stop;                      // no packet traced from then, 0: never
+    std::vector<std::string> nodes; // names of the nodes traced, empty: all, binary only
+} AnimationConfig_t;
+
+// flow statistics, read from the "flow_monitor" section of the topology file
+typedef struct FlowMonitorConfig
+{
+    bool enabled;
+    std::string file;     // FlowMonitor XML results
+    uint32_t sampleEvery; // track one packet in N of every flow
+} FlowMonitorConfig_t;
+
 class CybertwinNetworkSimulator : public Object
 {
   public:
@@ -28,19 +92,71 @@ class CybertwinNetworkSimulator : public Object
     CybertwinNetworkSimulator(const CybertwinNetworkSimulator&) = delete;
     CybertwinNetworkSimulator& operator=(const CybertwinNetworkSimulator&) = delete;
 
-    void SetAnimationInterface(AnimationInterface* animInterface);
+    void EnableAnimation();
+    void EnableFlowMonitor();
+    void SetSystemCount(uint32_t systems);
 
     void InputInit();
     void DriverCompileTopology();
+    void DriverPartitionTopology(uint32_t threads, const std::string& partition);
     void DriverInstallApps();
     void DriverBootSimulator();
     void RunSimulator();
     void Output();
 
+    // warm start: boot once, fork every variant at the checkpoint; returns
+    // the number of variants that failed in the parent and 0 in a variant
+    bool IsWarmStartEnabled() const;
+    uint32_t RunWarmStartSweep();
+    // name of the variant run by this process, empty in the parent
+    std::string GetVariantName() const;
+
   private:
+    void UpdateNodeAnimation(uint32_t nodeId, double size, uint32_t image);
+    void ReadWarmStartConfig();
+    void ReadAnimationConfig();
+    void ReadFlowMonitorConfig();
+    void WriteFlowMonitorResults();
+    void ReadManagerConfig();
+    void RunVariant(const WarmStartVariant_t& variant);
+
+    void CheckBootPhase();
+
+    // stop conditions and quiescence detection
+    void ReadStopConditions();
+    void CheckStopConditions();
+    void ApplicationRx(Ptr<const Packet> packet, const Address& from);
+
+
     NodeContainer m_nodes;
     CybertwinTopologyReader m_topologyReader;
-    AnimationInterface* m_animInterface;
+    AnimationConfig_t m_animation;
+    std::unique_ptr<AnimationInterface> m_animInterface;
+    std::unique_ptr<StreamingAnimationTrace> m_animTrace;
+    FlowMonitorConfig_t m_flowmon;
+    std::unique_ptr<FlowMonitorHelper> m_flowmonHelper;
+    Ptr<FlowMonitor> m_flowMonitor;
+    Ptr<CybertwinFlowClassifier> m_flowClassifier;
+
+    // boot phase: from power on until every end host has its cybertwin
+    NodeContainer m_bootingHosts;
+    std::chrono::steady_clock::time_point m_bootWallStart;
+
+    uint32_t m_systemCount; // MPI ranks of a distributed run
+    StopConditions_t m_stopConditions;
+    std::vector<Ptr<CybertwinAppDownloadClient>> m_downloadClients;
+    std::chrono::steady_clock::time_point m_runWallStart;
+    std::atomic<uint64_t> m_appRxBytes; // updated by every simulation thread
+    uint64_t m_lastAppRxBytes;
+    Time m_lastProgressTime;
+    std::string m_stopReason;
+
+    bool m_warmStart;
+    Time m_checkpointTime;
+    uint32_t m_maxParallelVariants;
+    std::string m_variantOutputDir;
+    std::string m_variantName;
+    std::vector<WarmStartVariant_t> m_variants;
 };
 
 }; // namespace ns3
@@ -0,0 +1,767 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-log-sink.h"
+
+#include "log.h"
+#include "nstime.h"
+#include "simulator.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::BinaryLogSink implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BinaryLogSink");
+
+namespace
+{
+
+/** The magic number of the files written by BinaryLogSink::Write(). */
+const char BINARY_LOG_MAGIC[8] = {'n', 's', '3', 'b', 'l', 'o', 'g', '1'};
+
+/** A log statement. */
+struct Site
+{
+    BinaryLogSink::Kind kind; //!< The kind of statement.
+    uint32_t level;           //!< The log level.
+    int32_t line;             //!< The line.
+    std::string component;    //!< The name of the log component.
+    std::string function;     //!< The function.
+    std::string file;         //!< The file.
+};
+
+/**
+ * The sites and the ring buffer.
+ *
+ * The records are stored from the oldest, at head, to the newest, ending
+ * at tail.  A record that does not fit before the end of the buffer goes
+ * to its start, and a zero size marks where the records wrapped, if there
+ * is room for it.
+ */
+struct SinkState
+{
+    std::mutex mutex;          //!< Serializes the threads.
+    std::vector<Site> sites;   //!< The sites, by identifier.
+    std::vector<uint8_t> ring; //!< The ring buffer.
+    std::size_t head{0};       //!< Offset of the oldest record.
+    std::size_t tail{0};       //!< Offset after the newest record.
+    uint64_t count{0};         //!< Number of records.
+    uint64_t lost{0};          //!< Number of records overwritten or dropped.
+};
+
+/**
+ * \returns The state of the sink, never destroyed so that messages can
+ * be logged until the end of the process.
+ */
+SinkState&
+GetState()
+{
+    static SinkState* state = new SinkState;
+    return *state;
+}
+
+/** The streams of the records of the thread, by nesting level. */
+thread_local std::vector<std::unique_ptr<BinaryLogStream>> t_streams;
+/** The nesting level of the record of the thread being recorded. */
+thread_local std::size_t t_depth = 0;
+
+/**
+ * \param [in] p The bytes.
+ * \returns The value.
+ */
+template <typename T>
+T
+Read(const uint8_t* p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * \param [in] s The state.
+ * \param [in] pos An offset in the ring buffer, after a record.
+ * \returns The offset of the next record.
+ */
+std::size_t
+SkipWrap(const SinkState& s, std::size_t pos)
+{
+    if (pos + 4 > s.ring.size() || Read<uint32_t>(&s.ring[pos]) == 0)
+    {
+        return 0;
+    }
+    return pos;
+}
+
+/**
+ * Drop the oldest records while they start in a range.
+ *
+ * \param [in] s The state.
+ * \param [in] start The start of the range.
+ * \param [in] end The end of the range.
+ */
+void
+Evict(SinkState& s, std::size_t start, std::size_t end)
+{
+    while (s.count > 0 && s.head >= start && s.head < end)
+    {
+        s.head += Read<uint32_t>(&s.ring[s.head]);
+        s.count--;
+        s.lost++;
+        if (s.count > 0)
+        {
+            s.head = SkipWrap(s, s.head);
+        }
+    }
+}
+
+/**
+ * Call a function with each part of a record.
+ *
+ * \param [in] p The first part.
+ * \param [in] end The end of the record.
+ * \param [in] f Called with the tag, the value and the size of each part.
+ * \returns \c false if the record is malformed.
+ */
+template <typename F>
+bool
+ForEachPart(const uint8_t* p, const uint8_t* end, F f)
+{
+    while (p < end)
+    {
+        auto tag = static_cast<BinaryLogStream::Tag>(*p++);
+        uint32_t size;
+        switch (tag)
+        {
+        case BinaryLogStream::TEXT:
+        case BinaryLogStream::STRING:
+            if (end - p < 4)
+            {
+                return false;
+            }
+            size = Read<uint32_t>(p);
+            p += 4;
+            break;
+        case BinaryLogStream::LITERAL:
+        case BinaryLogStream::INT:
+        case BinaryLogStream::UINT:
+        case BinaryLogStream::DOUBLE:
+        case BinaryLogStream::POINTER:
+        case BinaryLogStream::TIME:
+            size = 8;
+            break;
+        case BinaryLogStream::BOOL:
+        case BinaryLogStream::CHAR:
+            size = 1;
+            break;
+        case BinaryLogStream::SEPARATOR:
+            size = 0;
+            break;
+        default:
+            return false;
+        }
+        if (static_cast<std::size_t>(end - p) < size)
+        {
+            return false;
+        }
+        f(tag, p, size);
+        p += size;
+    }
+    return true;
+}
+
+/**
+ * \param [in] os The output stream.
+ * \param [in] s The string.
+ */
+void
+PutString(std::ostream& os, const std::string& s)
+{
+    uint32_t size = s.size();
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    os.write(s.data(), size);
+}
+
+/** Reads the file written by BinaryLogSink::Write(). */
+class Reader
+{
+  public:
+    /**
+     * \param [in] data The file.
+     */
+    Reader(const std::vector<uint8_t>& data)
+        : m_p(data.data()),
+          m_end(data.data() + data.size()),
+          m_ok(true)
+    {
+    }
+
+    /** \returns The next value. */
+    template <typename T>
+    T Get()
+    {
+        const uint8_t* p = Take(sizeof(T));
+        return p != nullptr ? Read<T>(p) : T();
+    }
+
+    /** \returns The next string. */
+    std::string GetString()
+    {
+        uint32_t size = Get<uint32_t>();
+        const uint8_t* p = Take(size);
+        return p != nullptr ? std::string(reinterpret_cast<const char*>(p), size) : "";
+    }
+
+    /**
+     * \param [in] size A number of bytes.
+     * \returns The next bytes, or nullptr if there are not as many.
+     */
+    const uint8_t* Take(std::size_t size)
+    {
+        if (!m_ok || static_cast<std::size_t>(m_end - m_p) < size)
+        {
+            m_ok = false;
+            return nullptr;
+        }
+        const uint8_t* p = m_p;
+        m_p += size;
+        return p;
+    }
+
+    /** \returns \c true if nothing was missing. */
+    bool IsOk() const
+    {
+        return m_ok;
+    }
+
+  private:
+    const uint8_t* m_p;   //!< The next byte.
+    const uint8_t* m_end; //!< The end of the file.
+    bool m_ok;            //!< Nothing was missing.
+};
+
+} // namespace
+
+std::atomic<bool> BinaryLogSink::s_enabled(false);
+
+void
+BinaryLogSink::Enable(uint32_t capacity)
+{
+    NS_LOG_FUNCTION(capacity);
+    SinkState& s = GetState();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.ring.assign(capacity, 0);
+    s.head = 0;
+    s.tail = 0;
+    s.count = 0;
+    s.lost = 0;
+    s_enabled = true;
+}
+
+void
+BinaryLogSink::Disable()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    s_enabled = false;
+}
+
+uint64_t
+BinaryLogSink::GetRecordCount()
+{
+    SinkState& s = GetState();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.count;
+}
+
+uint64_t
+BinaryLogSink::GetLostCount()
+{
+    SinkState& s = GetState();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.lost;
+}
+
+uint32_t
+BinaryLogSink::RegisterSite(Kind kind,
+                            uint32_t level,
+                            const char* component,
+                            const char* function,
+                            const char* file,
+                            int line)
+{
+    SinkState& s = GetState();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.sites.push_back({kind, level, line, component, function, file});
+    return s.sites.size() - 1;
+}
+
+void
+BinaryLogSink::Commit(const uint8_t* record, uint32_t size)
+{
+    SinkState& s = GetState();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::size_t capacity = s.ring.size();
+    if (size > capacity / 2)
+    {
+        s.lost++;
+        return;
+    }
+    if (s.tail + size > capacity)
+    {
+        // the records after tail are the oldest ones
+        Evict(s, s.tail, capacity);
+        if (s.tail + 4 <= capacity)
+        {
+            std::memset(&s.ring[s.tail], 0, 4);
+        }
+        s.tail = 0;
+    }
+    Evict(s, s.tail, s.tail + size);
+    if (s.count == 0)
+    {
+        s.head = s.tail;
+    }
+    std::memcpy(&s.ring[s.tail], record, size);
+    s.tail += size;
+    s.count++;
+}
+
+bool
+BinaryLogSink::Write(const std::string& filename)
+{
+    NS_LOG_FUNCTION(filename);
+    std::ofstream os(filename, std::ios::binary);
+    if (!os.is_open())
+    {
+        NS_LOG_WARN("Cannot open " << filename);
+        return false;
+    }
+
+    SinkState& s = GetState();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    // the offsets of the records, from the oldest, and the literals
+    std::vector<std::size_t> records;
+    std::unordered_map<uint64_t, std::string> literals;
+    std::size_t pos = s.head;
+    for (uint64_t i = 0; i < s.count; i++)
+    {
+        pos = SkipWrap(s, pos);
+        records.push_back(pos);
+        uint32_t size = Read<uint32_t>(&s.ring[pos]);
+        const uint8_t* record = &s.ring[pos];
+        ForEachPart(record + BinaryLogStream::HEADER_SIZE,
+                    record + size,
+                    [&literals](BinaryLogStream::Tag tag, const uint8_t* value, uint32_t) {
+                        if (tag == BinaryLogStream::LITERAL)
+                        {
+                            auto address = Read<uint64_t>(value);
+                            if (literals.find(address) == literals.end())
+                            {
+                                literals[address] =
+                                    reinterpret_cast<const char*>(static_cast<uintptr_t>(address));
+                            }
+                        }
+                    });
+        pos += size;
+    }
+
+    os.write(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+    auto resolution = static_cast<int32_t>(Time::GetResolution());
+    os.write(reinterpret_cast<const char*>(&resolution), sizeof(resolution));
+    os.write(reinterpret_cast<const char*>(&s.lost), sizeof(s.lost));
+
+    auto siteCount = static_cast<uint32_t>(s.sites.size());
+    os.write(reinterpret_cast<const char*>(&siteCount), sizeof(siteCount));
+    for (const Site& site : s.sites)
+    {
+        auto kind = static_cast<uint8_t>(site.kind);
+        os.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+        os.write(reinterpret_cast<const char*>(&site.level), sizeof(site.level));
+        os.write(reinterpret_cast<const char*>(&site.line), sizeof(site.line));
+        PutString(os, site.component);
+        PutString(os, site.function);
+        PutString(os, site.file);
+    }
+
+    auto literalCount = static_cast<uint32_t>(literals.size());
+    os.write(reinterpret_cast<const char*>(&literalCount), sizeof(literalCount));
+    for (const auto& literal : literals)
+    {
+        os.write(reinterpret_cast<const char*>(&literal.first), sizeof(literal.first));
+        PutString(os, literal.second);
+    }
+
+    os.write(reinterpret_cast<const char*>(&s.count), sizeof(s.count));
+    for (std::size_t offset : records)
+    {
+        os.write(reinterpret_cast<const char*>(&s.ring[offset]),
+                 Read<uint32_t>(&s.ring[offset]));
+    }
+    return !os.fail();
+}
+
+bool
+BinaryLogSink::Render(const std::string& filename, std::ostream& os)
+{
+    NS_LOG_FUNCTION(filename << &os);
+    std::ifstream is(filename, std::ios::binary);
+    if (!is.is_open())
+    {
+        NS_LOG_WARN("Cannot open " << filename);
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(is)),
+                              std::istreambuf_iterator<char>());
+    Reader reader(data);
+
+    const uint8_t* magic = reader.Take(sizeof(BINARY_LOG_MAGIC));
+    if (magic == nullptr || std::memcmp(magic, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)) != 0)
+    {
+        NS_LOG_WARN(filename << " is not a binary log");
+        return false;
+    }
+    auto resolution = static_cast<Time::Unit>(reader.Get<int32_t>());
+    reader.Get<uint64_t>(); // records lost
+
+    std::vector<Site> sites(reader.Get<uint32_t>());
+    for (Site& site : sites)
+    {
+        site.kind = static_cast<Kind>(reader.Get<uint8_t>());
+        site.level = reader.Get<uint32_t>();
+        site.line = reader.Get<int32_t>();
+        site.component = reader.GetString();
+        site.function = reader.GetString();
+        site.file = reader.GetString();
+    }
+
+    std::unordered_map<uint64_t, std::string> literals;
+    uint32_t literalCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < literalCount && reader.IsOk(); i++)
+    {
+        auto address = reader.Get<uint64_t>();
+        literals[address] = reader.GetString();
+    }
+
+    // as DefaultTimePrinter
+    int timePrecision;
+    switch (resolution)
+    {
+    case Time::US:
+        timePrecision = 6;
+        break;
+    case Time::NS:
+        timePrecision = 9;
+        break;
+    case Time::PS:
+        timePrecision = 12;
+        break;
+    case Time::FS:
+        timePrecision = 15;
+        break;
+    default:
+        timePrecision = 5;
+    }
+
+    auto recordCount = reader.Get<uint64_t>();
+    for (uint64_t i = 0; i < recordCount && reader.IsOk(); i++)
+    {
+        const uint8_t* header = reader.Take(BinaryLogStream::HEADER_SIZE);
+        if (header == nullptr)
+        {
+            break;
+        }
+        auto size = Read<uint32_t>(header);
+        auto siteId = Read<uint32_t>(header + 4);
+        uint8_t prefixes = header[8];
+        auto time = Read<int64_t>(header + 9);
+        auto context = Read<uint32_t>(header + 17);
+        const uint8_t* parts = size >= BinaryLogStream::HEADER_SIZE
+                                   ? reader.Take(size - BinaryLogStream::HEADER_SIZE)
+                                   : nullptr;
+        if (parts == nullptr || siteId >= sites.size())
+        {
+            NS_LOG_WARN("Malformed record " << i << " in " << filename);
+            return false;
+        }
+        const Site& site = sites[siteId];
+
+        if (prefixes & BinaryLogStream::PREFIX_TIME)
+        {
+            std::ios_base::fmtflags ff = os.flags();
+            std::streamsize oldPrecision = os.precision();
+            os << std::fixed << std::setprecision(timePrecision)
+               << Time::From(time, resolution).As(Time::S) << " ";
+            os << std::setprecision(oldPrecision);
+            os.flags(ff);
+        }
+        if (prefixes & BinaryLogStream::PREFIX_NODE)
+        {
+            if (context == Simulator::NO_CONTEXT)
+            {
+                os << "-1 ";
+            }
+            else
+            {
+                os << context << " ";
+            }
+        }
+        bool quote = site.kind == FUNCTION;
+        if (quote)
+        {
+            os << site.component << ":" << site.function << "(";
+        }
+        else
+        {
+            if (prefixes & BinaryLogStream::PREFIX_FUNC)
+            {
+                os << site.component << ":" << site.function << "(): ";
+            }
+            if (prefixes & BinaryLogStream::PREFIX_LEVEL)
+            {
+                os << "[" << LogComponent::GetLevelLabel(static_cast<LogLevel>(site.level))
+                   << "] ";
+            }
+        }
+
+        bool ok = ForEachPart(
+            parts,
+            parts + size - BinaryLogStream::HEADER_SIZE,
+            [&](BinaryLogStream::Tag tag, const uint8_t* value, uint32_t valueSize) {
+                switch (tag)
+                {
+                case BinaryLogStream::TEXT:
+                    os.write(reinterpret_cast<const char*>(value), valueSize);
+                    break;
+                case BinaryLogStream::STRING:
+                    if (quote)
+                    {
+                        os << "\"";
+                    }
+                    os.write(reinterpret_cast<const char*>(value), valueSize);
+                    if (quote)
+                    {
+                        os << "\"";
+                    }
+                    break;
+                case BinaryLogStream::LITERAL: {
+                    auto literal = literals.find(Read<uint64_t>(value));
+                    const std::string& s =
+                        literal != literals.end() ? literal->second : std::string();
+                    if (quote)
+                    {
+                        os << "\"" << s << "\"";
+                    }
+                    else
+                    {
+                        os << s;
+                    }
+                    break;
+                }
+                case BinaryLogStream::INT:
+                    os << Read<int64_t>(value);
+                    break;
+                case BinaryLogStream::UINT:
+                    os << Read<uint64_t>(value);
+                    break;
+                case BinaryLogStream::DOUBLE:
+                    os << Read<double>(value);
+                    break;
+                case BinaryLogStream::BOOL:
+                    os << static_cast<bool>(*value);
+                    break;
+                case BinaryLogStream::CHAR:
+                    os << static_cast<char>(*value);
+                    break;
+                case BinaryLogStream::POINTER:
+                    os << reinterpret_cast<const void*>(
+                        static_cast<uintptr_t>(Read<uint64_t>(value)));
+                    break;
+                case BinaryLogStream::TIME:
+                    os << Time::From(Read<int64_t>(value), resolution);
+                    break;
+                case BinaryLogStream::SEPARATOR:
+                    os << ", ";
+                    break;
+                }
+            });
+        if (!ok)
+        {
+            NS_LOG_WARN("Malformed record " << i << " in " << filename);
+            return false;
+        }
+        if (quote)
+        {
+            os << ")";
+        }
+        os << "\n";
+    }
+    if (!reader.IsOk())
+    {
+        NS_LOG_WARN(filename << " is truncated");
+    }
+    return reader.IsOk();
+}
+
+BinaryLogStream::TextBuffer::TextBuffer(BinaryLogStream* stream)
+    : m_stream(stream)
+{
+}
+
+BinaryLogStream::TextBuffer::int_type
+BinaryLogStream::TextBuffer::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        char ch = traits_type::to_char_type(c);
+        m_stream->AppendText(&ch, 1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize
+BinaryLogStream::TextBuffer::xsputn(const char* s, std::streamsize n)
+{
+    m_stream->AppendText(s, n);
+    return n;
+}
+
+BinaryLogStream::BinaryLogStream()
+    : std::ostream(nullptr),
+      m_buffer(this),
+      m_textStart(0)
+{
+    rdbuf(&m_buffer);
+    m_record.reserve(256);
+}
+
+void
+BinaryLogStream::Begin(uint32_t site, uint8_t prefixes, int64_t time, uint32_t context)
+{
+    m_record.resize(HEADER_SIZE);
+    char* header = &m_record[0];
+    std::memcpy(header + 4, &site, 4);
+    header[8] = static_cast<char>(prefixes);
+    std::memcpy(header + 9, &time, 8);
+    std::memcpy(header + 17, &context, 4);
+    m_textStart = 0;
+    clear();
+    flags(std::ios_base::skipws | std::ios_base::dec);
+    precision(6);
+    width(0);
+    fill(' ');
+}
+
+void
+BinaryLogStream::Commit()
+{
+    EndText();
+    auto size = static_cast<uint32_t>(m_record.size());
+    std::memcpy(&m_record[0], &size, 4);
+    BinaryLogSink::Commit(reinterpret_cast<const uint8_t*>(m_record.data()), size);
+}
+
+void
+BinaryLogStream::PutString(const char* s, std::size_t size)
+{
+    EndText();
+    m_record.push_back(static_cast<char>(STRING));
+    auto length = static_cast<uint32_t>(size);
+    m_record.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    m_record.append(s, size);
+}
+
+void
+BinaryLogStream::PutSeparator()
+{
+    EndText();
+    m_record.push_back(static_cast<char>(SEPARATOR));
+}
+
+void
+BinaryLogStream::AppendText(const char* s, std::size_t n)
+{
+    if (m_textStart == 0)
+    {
+        m_record.push_back(static_cast<char>(TEXT));
+        m_textStart = m_record.size();
+        m_record.append(4, '\0');
+    }
+    m_record.append(s, n);
+}
+
+void
+BinaryLogStream::EndText()
+{
+    if (m_textStart != 0)
+    {
+        auto length = static_cast<uint32_t>(m_record.size() - m_textStart - 4);
+        std::memcpy(&m_record[m_textStart], &length, 4);
+        m_textStart = 0;
+    }
+}
+
+BinaryLogRecord::BinaryLogRecord(uint32_t site, const LogComponent& log)
+{
+    uint8_t prefixes = 0;
+    int64_t time = 0;
+    uint32_t context = Simulator::NO_CONTEXT;
+    // the printers are set once the simulator exists
+    if (log.IsEnabled(LOG_PREFIX_TIME) && LogGetTimePrinter() != nullptr)
+    {
+        prefixes |= BinaryLogStream::PREFIX_TIME;
+        time = Simulator::Now().GetTimeStep();
+    }
+    if (log.IsEnabled(LOG_PREFIX_NODE) && LogGetNodePrinter() != nullptr)
+    {
+        prefixes |= BinaryLogStream::PREFIX_NODE;
+        context = Simulator::GetContext();
+    }
+    if (log.IsEnabled(LOG_PREFIX_FUNC))
+    {
+        prefixes |= BinaryLogStream::PREFIX_FUNC;
+    }
+    if (log.IsEnabled(LOG_PREFIX_LEVEL))
+    {
+        prefixes |= BinaryLogStream::PREFIX_LEVEL;
+    }
+
+    if (t_depth == t_streams.size())
+    {
+        t_streams.push_back(std::make_unique<BinaryLogStream>());
+    }
+    m_stream = t_streams[t_depth++].get();
+    m_stream->Begin(site, prefixes, time, context);
+}
+
+BinaryLogRecord::~BinaryLogRecord()
+{
+    m_stream->Commit();
+    t_depth--;
+}
+
+} // namespace ns3
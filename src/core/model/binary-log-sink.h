@@ -0,0 +1,502 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_LOG_SINK_H
+#define BINARY_LOG_SINK_H
+
+#include <atomic>
+#include <cstring>
+#include <ostream>
+#include <stdint.h>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::BinaryLogSink declaration, and the classes recording the log
+ * messages for it.
+ */
+
+namespace ns3
+{
+
+class LogComponent;
+class Time;
+
+/**
+ * \ingroup logging
+ * \brief Records the log messages in memory, in binary, to render them
+ * offline.
+ *
+ * While the sink is enabled, the NS_LOG macros of the enabled components
+ * do not format their messages to \c std::clog.  Each statement is
+ * registered once as a site, its component, function, file, line and
+ * level, and each message is recorded as the site, the simulation time,
+ * the context and the raw values streamed: integers, floating point
+ * numbers, strings, pointers and Time values are copied as they are, and
+ * string literals as their address.  Values of other types are formatted
+ * by their \c operator<<, as are all the values streamed while the
+ * format of the stream is changed, by \c std::hex or \c std::setw for
+ * instance.
+ *
+ * The records go to a ring buffer, which keeps the latest messages when
+ * it is full.  Write() saves them with the sites and the string literals,
+ * and Render() prints them as NS_LOG would have, e.g. with the
+ * \c log-render program:
+ * \code
+ *   BinaryLogSink::Enable(64 << 20);
+ *   LogComponentEnable("CybertwinNode", LOG_LEVEL_DEBUG);
+ *   Simulator::Run();
+ *   BinaryLogSink::Write("cybertwin.nslog");
+ * \endcode
+ * \code
+ *   $ ./ns3 run 'log-render --input=cybertwin.nslog'
+ * \endcode
+ *
+ * The time and node prefixes are rendered as by DefaultTimePrinter() and
+ * DefaultNodePrinter(), and NS_LOG_APPEND_CONTEXT is not recorded.  A
+ * \c const \c char array streamed is taken for a string literal, so it
+ * must outlive the sink.  The sink can be written to from several
+ * threads.
+ */
+class BinaryLogSink
+{
+  public:
+    /** The kinds of log statements. */
+    enum Kind
+    {
+        MESSAGE, //!< NS_LOG and the macros of the levels.
+        FUNCTION //!< NS_LOG_FUNCTION and NS_LOG_FUNCTION_NOARGS.
+    };
+
+    /**
+     * Start recording the log messages, discarding the previous records.
+     *
+     * \param [in] capacity The size of the ring buffer, in bytes.
+     */
+    static void Enable(uint32_t capacity = 64 << 20);
+    /** Stop recording, keeping the records. */
+    static void Disable();
+    /** \returns \c true if recording. */
+    static bool IsEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /** \returns The number of records in the ring buffer. */
+    static uint64_t GetRecordCount();
+    /**
+     * \returns The number of records overwritten when the ring buffer was
+     * full, or dropped because they were larger than half of it.
+     */
+    static uint64_t GetLostCount();
+
+    /**
+     * Write the records.
+     *
+     * \param [in] filename The name of the file.
+     * \returns \c false if the file cannot be written.
+     */
+    static bool Write(const std::string& filename);
+    /**
+     * Print the messages of a file written by Write(), one per line.
+     *
+     * \param [in] filename The name of the file.
+     * \param [in] os The output stream.
+     * \returns \c false if the file cannot be read.
+     */
+    static bool Render(const std::string& filename, std::ostream& os);
+
+    /**
+     * Register a log statement.
+     *
+     * \param [in] kind The kind of statement.
+     * \param [in] level The log level.
+     * \param [in] component The name of the log component.
+     * \param [in] function The function.
+     * \param [in] file The file.
+     * \param [in] line The line.
+     * \returns The identifier of the site.
+     */
+    static uint32_t RegisterSite(Kind kind,
+                                 uint32_t level,
+                                 const char* component,
+                                 const char* function,
+                                 const char* file,
+                                 int line);
+
+  private:
+    friend class BinaryLogStream;
+
+    /**
+     * Copy a record into the ring buffer.
+     *
+     * \param [in] record The record, starting with its size.
+     * \param [in] size The size of the record.
+     */
+    static void Commit(const uint8_t* record, uint32_t size);
+
+    static std::atomic<bool> s_enabled; //!< Recording.
+};
+
+/**
+ * \ingroup logging
+ * \brief The stream a log message is recorded with.
+ *
+ * The values of the types recorded raw are appended to the record by the
+ * \c operator<< below; the other values are formatted by the
+ * \c std::ostream, into text parts of the record.
+ */
+class BinaryLogStream : public std::ostream
+{
+  public:
+    /** The types of the parts of a record. */
+    enum Tag : uint8_t
+    {
+        TEXT,      //!< Formatted text: uint32_t size and characters.
+        STRING,    //!< A string: uint32_t size and characters.
+        LITERAL,   //!< A string literal: its address, uint64_t.
+        INT,       //!< int64_t.
+        UINT,      //!< uint64_t.
+        DOUBLE,    //!< double.
+        BOOL,      //!< uint8_t.
+        CHAR,      //!< A character, uint8_t.
+        POINTER,   //!< uint64_t.
+        TIME,      //!< A Time, int64_t time step.
+        SEPARATOR, //!< Between two function parameters.
+    };
+
+    /** The prefixes of a record. */
+    enum Prefix : uint8_t
+    {
+        PREFIX_TIME = 1,  //!< Simulation time.
+        PREFIX_NODE = 2,  //!< Context.
+        PREFIX_FUNC = 4,  //!< Component and function.
+        PREFIX_LEVEL = 8, //!< Log level.
+    };
+
+    /** Size of the header of a record: size, site, prefixes, time and context. */
+    static constexpr uint32_t HEADER_SIZE = 4 + 4 + 1 + 8 + 4;
+
+    BinaryLogStream();
+
+    /**
+     * Start a record, resetting the format of the stream.
+     *
+     * \param [in] site The log statement.
+     * \param [in] prefixes The Prefix values of the record.
+     * \param [in] time The simulation time step.
+     * \param [in] context The context.
+     */
+    void Begin(uint32_t site, uint8_t prefixes, int64_t time, uint32_t context);
+    /** Copy the record into the ring buffer of the sink. */
+    void Commit();
+
+    /**
+     * \returns \c true if the stream is in its initial format, in which
+     * the raw values recorded render as they would have been formatted.
+     */
+    bool IsDefaultFormat() const
+    {
+        return flags() == (std::ios_base::skipws | std::ios_base::dec) && precision() == 6 &&
+               width() == 0;
+    }
+
+    /**
+     * Append a part.
+     *
+     * \param [in] tag The type of the part.
+     * \param [in] value The value.
+     */
+    template <typename T>
+    void Put(Tag tag, T value)
+    {
+        EndText();
+        m_record.push_back(static_cast<char>(tag));
+        m_record.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    /**
+     * Append a string.
+     *
+     * \param [in] s The characters.
+     * \param [in] size The number of characters.
+     */
+    void PutString(const char* s, std::size_t size);
+    /** Append a separator of function parameters. */
+    void PutSeparator();
+
+  private:
+    /** Appends the characters formatted by the stream to the record. */
+    class TextBuffer : public std::streambuf
+    {
+      public:
+        /** \param [in] stream The stream of the record. */
+        TextBuffer(BinaryLogStream* stream);
+
+      protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+      private:
+        BinaryLogStream* m_stream; //!< The stream of the record.
+    };
+
+    /**
+     * Append formatted characters, in a TEXT part.
+     *
+     * \param [in] s The characters.
+     * \param [in] n The number of characters.
+     */
+    void AppendText(const char* s, std::size_t n);
+    /** Write the size of the current TEXT part, if any. */
+    void EndText();
+
+    TextBuffer m_buffer;     //!< The buffer of the stream.
+    std::string m_record;    //!< The record.
+    std::size_t m_textStart; //!< Offset of the size of the current TEXT part, or 0.
+};
+
+/**
+ * \ingroup logging
+ * Whether a type is recorded raw by a BinaryLogStream.
+ *
+ * \tparam T The type, without reference.
+ */
+template <typename T>
+struct IsBinaryLogRaw
+{
+    /** The type without cv-qualifiers nor array extent. */
+    using Element = std::remove_cv_t<std::remove_extent_t<T>>;
+    /** The type pointed to, if a pointer. */
+    using Pointee = std::remove_cv_t<std::remove_pointer_t<std::remove_cv_t<T>>>;
+    /** \c true if recorded raw. */
+    static constexpr bool value =
+        (std::is_arithmetic_v<std::remove_cv_t<T>> &&
+         !std::is_same_v<std::remove_cv_t<T>, long double> &&
+         !std::is_same_v<std::remove_cv_t<T>, wchar_t> &&
+         !std::is_same_v<std::remove_cv_t<T>, char16_t> &&
+         !std::is_same_v<std::remove_cv_t<T>, char32_t>) ||
+        (std::is_array_v<T> && std::rank_v<T> == 1 && std::is_same_v<Element, char>) ||
+        (std::is_pointer_v<std::remove_cv_t<T>> &&
+         (std::is_object_v<Pointee> || std::is_void_v<Pointee>) &&
+         !std::is_volatile_v<std::remove_pointer_t<std::remove_cv_t<T>>> &&
+         !std::is_same_v<Pointee, signed char> && !std::is_same_v<Pointee, unsigned char>) ||
+        std::is_same_v<std::remove_cv_t<T>, std::string> ||
+        std::is_same_v<std::remove_cv_t<T>, Time>;
+};
+
+/**
+ * \ingroup logging
+ * Record a value raw, unless the format of the stream is changed.
+ *
+ * \param [in] os The stream.
+ * \param [in] value The value.
+ * \returns The stream.
+ */
+template <typename T,
+          typename = std::enable_if_t<IsBinaryLogRaw<std::remove_reference_t<T>>::value>>
+BinaryLogStream&
+operator<<(BinaryLogStream& os, T&& value)
+{
+    using U = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (std::is_array_v<U>)
+    {
+        // a const char array is taken for a string literal
+        if (os.width() != 0)
+        {
+            static_cast<std::ostream&>(os) << value;
+        }
+        else if constexpr (std::is_const_v<std::remove_extent_t<std::remove_reference_t<T>>>)
+        {
+            os.Put(BinaryLogStream::LITERAL,
+                   static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&value[0])));
+        }
+        else
+        {
+            os.PutString(value, std::strlen(value));
+        }
+    }
+    else if constexpr (std::is_same_v<U, std::string>)
+    {
+        if (os.width() != 0)
+        {
+            static_cast<std::ostream&>(os) << value;
+        }
+        else
+        {
+            os.PutString(value.data(), value.size());
+        }
+    }
+    else if (!os.IsDefaultFormat())
+    {
+        static_cast<std::ostream&>(os) << value;
+    }
+    else if constexpr (std::is_same_v<U, bool>)
+    {
+        os.Put(BinaryLogStream::BOOL, static_cast<uint8_t>(value));
+    }
+    else if constexpr (std::is_same_v<U, char> || std::is_same_v<U, signed char> ||
+                       std::is_same_v<U, unsigned char>)
+    {
+        os.Put(BinaryLogStream::CHAR, static_cast<uint8_t>(value));
+    }
+    else if constexpr (std::is_floating_point_v<U>)
+    {
+        os.Put(BinaryLogStream::DOUBLE, static_cast<double>(value));
+    }
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+    {
+        os.Put(BinaryLogStream::INT, static_cast<int64_t>(value));
+    }
+    else if constexpr (std::is_integral_v<U>)
+    {
+        os.Put(BinaryLogStream::UINT, static_cast<uint64_t>(value));
+    }
+    else if constexpr (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>, char>)
+    {
+        if (value == nullptr)
+        {
+            // as undefined for std::ostream
+            static_cast<std::ostream&>(os) << value;
+        }
+        else
+        {
+            os.PutString(value, std::strlen(value));
+        }
+    }
+    else if constexpr (std::is_pointer_v<U>)
+    {
+        os.Put(BinaryLogStream::POINTER,
+               static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+    }
+    else
+    {
+        os.Put(BinaryLogStream::TIME, value.GetTimeStep());
+    }
+    return os;
+}
+
+/**
+ * \ingroup logging
+ * \brief A log message being recorded.
+ *
+ * Takes a BinaryLogStream of the thread, and commits the record when
+ * destroyed.  The streams are kept per thread and per nesting level, for
+ * the messages logged while formatting a message.
+ */
+class BinaryLogRecord
+{
+  public:
+    /**
+     * \param [in] site The log statement.
+     * \param [in] log The log component.
+     */
+    BinaryLogRecord(uint32_t site, const LogComponent& log);
+    /** Commit the record. */
+    ~BinaryLogRecord();
+
+    BinaryLogRecord(const BinaryLogRecord&) = delete;
+    BinaryLogRecord& operator=(const BinaryLogRecord&) = delete;
+
+    /** \returns The stream to record the message with. */
+    BinaryLogStream& GetStream()
+    {
+        return *m_stream;
+    }
+
+  private:
+    BinaryLogStream* m_stream; //!< The stream.
+};
+
+/**
+ * \ingroup logging
+ * \brief Records function parameters as ParameterLogger prints them.
+ */
+class BinaryParameterLogger
+{
+  public:
+    /** \param [in] os The stream of the record. */
+    BinaryParameterLogger(BinaryLogStream& os)
+        : m_os(os)
+    {
+    }
+
+    /**
+     * Record a function parameter.
+     *
+     * \param [in] param The parameter.
+     * \returns This BinaryParameterLogger, so it's chainable.
+     */
+    template <typename T>
+    BinaryParameterLogger& operator<<(const T& param)
+    {
+        CommaRest();
+        if constexpr (std::is_same_v<T, int8_t>)
+        {
+            m_os << static_cast<int16_t>(param);
+        }
+        else if constexpr (std::is_same_v<T, uint8_t>)
+        {
+            m_os << static_cast<uint16_t>(param);
+        }
+        else
+        {
+            m_os << param;
+        }
+        return *this;
+    }
+
+    /**
+     * Record each element of a vector as a parameter.
+     *
+     * \param [in] vector The vector.
+     * \returns This BinaryParameterLogger, so it's chainable.
+     */
+    template <typename T>
+    BinaryParameterLogger& operator<<(const std::vector<T>& vector)
+    {
+        for (const auto& i : vector)
+        {
+            *this << i;
+        }
+        return *this;
+    }
+
+  private:
+    /** Separate every parameter from the previous one. */
+    void CommaRest()
+    {
+        if (m_first)
+        {
+            m_first = false;
+        }
+        else
+        {
+            m_os.PutSeparator();
+        }
+    }
+
+    bool m_first{true};    //!< First parameter.
+    BinaryLogStream& m_os; //!< The stream of the record.
+};
+
+} // namespace ns3
+
+#endif /* BINARY_LOG_SINK_H */
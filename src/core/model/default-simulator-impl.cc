@@ -20,11 +20,14 @@
 #include "default-simulator-impl.h"
 
 #include "assert.h"
+#include "boolean.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
 
 #include <cmath>
+#include <fstream>
 
 /**
  * \file
@@ -48,7 +51,27 @@ DefaultSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+                            .AddConstructor<DefaultSimulatorImpl>()
+                            .AddAttribute("EventPool",
+                                          "Recycle the memory of executed events through the "
+                                          "per-thread event pool of the simulation thread.",
+                                          BooleanValue(true),
+                                          MakeBooleanAccessor(&DefaultSimulatorImpl::m_eventPool),
+                                          MakeBooleanChecker())
+                            .AddAttribute("EventTrace",
+                                          "Name of a file to record every event inserted in and "
+                                          "removed from the scheduler to, as an event trace for "
+                                          "bench-scheduler; empty for no recording.",
+                                          StringValue(""),
+                                          MakeStringAccessor(&DefaultSimulatorImpl::m_eventTrace),
+                                          MakeStringChecker())
+                            .AddAttribute("EventProfile",
+                                          "Name of a file to write a profile of the wall time "
+                                          "spent in each event function and context to, at "
+                                          "Simulator::Destroy; empty for no profiling.",
+                                          StringValue(""),
+                                          MakeStringAccessor(&DefaultSimulatorImpl::m_eventProfile),
+                                          MakeStringChecker());
     return tid;
 }
 
@@ -64,6 +87,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_eventCount = 0;
     m_eventsWithContextEmpty = true;
     m_mainThreadId = std::this_thread::get_id();
+    m_eventPool = true;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl()
@@ -71,6 +95,22 @@ DefaultSimulatorImpl::~DefaultSimulatorImpl()
     NS_LOG_FUNCTION(this);
 }
 
+void
+DefaultSimulatorImpl::NotifyConstructionCompleted()
+{
+    NS_LOG_FUNCTION(this);
+    SimulatorImpl::NotifyConstructionCompleted();
+    EventImpl::SetPoolEnabled(m_eventPool);
+    if (!m_eventTrace.empty() && !m_traceWriter.Open(m_eventTrace))
+    {
+        NS_FATAL_ERROR("Cannot create the event trace " << m_eventTrace);
+    }
+    if (!m_eventProfile.empty())
+    {
+        m_profiler.Enable();
+    }
+}
+
 void
 DefaultSimulatorImpl::DoDispose()
 {
@@ -83,6 +123,18 @@ DefaultSimulatorImpl::DoDispose()
         next.impl->Unref();
     }
     m_events = nullptr;
+    m_traceWriter.Close();
+    if (m_traceWriter.Fail())
+    {
+        NS_FATAL_ERROR("Cannot write the event trace " << m_eventTrace);
+    }
+    // Events still referenced elsewhere are freed to the general purpose
+    // allocator from now on.
+    if (m_eventPool)
+    {
+        EventImpl::SetPoolEnabled(false);
+        EventImpl::PurgePool();
+    }
     SimulatorImpl::DoDispose();
 }
 
@@ -100,6 +152,16 @@ DefaultSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+    if (m_profiler.IsEnabled())
+    {
+        m_profiler.Disable();
+        std::ofstream os(m_eventProfile);
+        if (!os)
+        {
+            NS_FATAL_ERROR("Cannot create the event profile " << m_eventProfile);
+        }
+        m_profiler.Write(os);
+    }
 }
 
 void
@@ -141,7 +203,14 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (m_profiler.IsEnabled())
+    {
+        m_profiler.Invoke(next.impl, next.key.m_context);
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
     ProcessEventsWithContext();
@@ -180,6 +249,10 @@ DefaultSimulatorImpl::ProcessEventsWithContext()
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        if (m_traceWriter.IsOpen())
+        {
+            m_traceWriter.RecordInsert(m_currentTs, ev, m_currentUid);
+        }
     }
 }
 
@@ -237,6 +310,10 @@ DefaultSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
     m_uid++;
     m_unscheduledEvents++;
     m_events->Insert(ev);
+    if (m_traceWriter.IsOpen())
+    {
+        m_traceWriter.RecordInsert(m_currentTs, ev, m_currentUid);
+    }
     return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -256,6 +333,10 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        if (m_traceWriter.IsOpen())
+        {
+            m_traceWriter.RecordInsert(m_currentTs, ev, m_currentUid);
+        }
     }
     else
     {
@@ -339,6 +420,14 @@ DefaultSimulatorImpl::Remove(const EventId& id)
     event.key.m_context = id.GetContext();
     event.key.m_uid = id.GetUid();
     m_events->Remove(event);
+    if (m_traceWriter.IsOpen())
+    {
+        m_traceWriter.RecordRemove(m_currentTs, event);
+    }
+    if (m_profiler.IsEnabled())
+    {
+        m_profiler.RecordCancel(event.impl, event.key.m_context);
+    }
     event.impl->Cancel();
     // whenever we remove an event from the event list, we have to unref it.
     event.impl->Unref();
@@ -351,6 +440,10 @@ DefaultSimulatorImpl::Cancel(const EventId& id)
 {
     if (!IsExpired(id))
     {
+        if (m_profiler.IsEnabled())
+        {
+            m_profiler.RecordCancel(id.PeekEventImpl(), id.GetContext());
+        }
         id.PeekEventImpl()->Cancel();
     }
 }
@@ -20,10 +20,13 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "event-profiler.h"
+#include "event-trace.h"
 #include "simulator-impl.h"
 
 #include <list>
 #include <mutex>
+#include <string>
 #include <thread>
 
 /**
@@ -78,6 +81,9 @@ class DefaultSimulatorImpl : public SimulatorImpl
     uint32_t GetContext() const override;
     uint64_t GetEventCount() const override;
 
+  protected:
+    void NotifyConstructionCompleted() override;
+
   private:
     void DoDispose() override;
 
@@ -135,6 +141,17 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
+
+    /** Whether to recycle the memory of events through the event pool. */
+    bool m_eventPool;
+    /** Name of the event trace file, empty for no recording. */
+    std::string m_eventTrace;
+    /** The event trace recorder. */
+    EventTraceWriter m_traceWriter;
+    /** Name of the event profile file, empty for no profiling. */
+    std::string m_eventProfile;
+    /** The event profiler. */
+    EventProfiler m_profiler;
 };
 
 } // namespace ns3
@@ -21,6 +21,9 @@
 
 #include "log.h"
 
+#include <cstring>
+#include <new>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +35,119 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Granularity of the event size classes, in bytes. */
+constexpr std::size_t EVENT_POOL_GRANULARITY = 16;
+/** Number of size classes; larger events are not pooled. */
+constexpr std::size_t EVENT_POOL_CLASSES = 16;
+/** Maximum number of free blocks kept per size class. */
+constexpr uint32_t EVENT_POOL_MAX_FREE = 16384;
+
+/** A free block, linked to the next free block of its size class. */
+struct EventFreeBlock
+{
+    EventFreeBlock* next; //!< The next free block.
+};
+
+/**
+ * The event pool of a thread.
+ *
+ * This is trivially destructible, so that events freed while the thread
+ * exits, or during static destruction, never touch a destroyed pool.
+ */
+struct EventPool
+{
+    bool enabled;                             //!< Whether blocks are recycled.
+    EventFreeBlock* free[EVENT_POOL_CLASSES]; //!< The free lists.
+    uint32_t nFree[EVENT_POOL_CLASSES];       //!< The free list lengths.
+};
+
+/** The event pool of the calling thread, zero initialized, so disabled. */
+thread_local EventPool g_eventPool;
+
+/**
+ * Get the size class of an event.
+ * \param [in] size The size of the event.
+ * \returns The size class, EVENT_POOL_CLASSES or more if not pooled.
+ */
+inline std::size_t
+EventSizeClass(std::size_t size)
+{
+    return (size - 1) / EVENT_POOL_GRANULARITY;
+}
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    std::size_t sizeClass = EventSizeClass(size);
+    if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+        return ::operator new(size);
+    }
+    EventPool& pool = g_eventPool;
+    EventFreeBlock* block = pool.free[sizeClass];
+    if (pool.enabled && block)
+    {
+        pool.free[sizeClass] = block->next;
+        pool.nFree[sizeClass]--;
+        return block;
+    }
+    // Always allocate the whole size class, so that the block can be
+    // recycled by any pool, enabled now or later.
+    return ::operator new((sizeClass + 1) * EVENT_POOL_GRANULARITY);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    std::size_t sizeClass = EventSizeClass(size);
+    EventPool& pool = g_eventPool;
+    if (sizeClass >= EVENT_POOL_CLASSES || !pool.enabled ||
+        pool.nFree[sizeClass] >= EVENT_POOL_MAX_FREE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    EventFreeBlock* block = static_cast<EventFreeBlock*>(p);
+    block->next = pool.free[sizeClass];
+    pool.free[sizeClass] = block;
+    pool.nFree[sizeClass]++;
+}
+
+void
+EventImpl::SetPoolEnabled(bool enabled)
+{
+    NS_LOG_FUNCTION(enabled);
+    g_eventPool.enabled = enabled;
+}
+
+bool
+EventImpl::IsPoolEnabled()
+{
+    return g_eventPool.enabled;
+}
+
+void
+EventImpl::PurgePool()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    EventPool& pool = g_eventPool;
+    for (std::size_t i = 0; i < EVENT_POOL_CLASSES; i++)
+    {
+        while (pool.free[i])
+        {
+            EventFreeBlock* block = pool.free[i];
+            pool.free[i] = block->next;
+            ::operator delete(block);
+        }
+        pool.nFree[i] = 0;
+    }
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -67,4 +183,49 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+const void*
+EventImpl::GetFunction() const
+{
+    return nullptr;
+}
+
+const void*
+EventImpl::GetMemberFunction(const void* pmf, std::size_t size, const void* obj)
+{
+#if defined(__GXX_ABI_VERSION)
+    // Itanium C++ ABI: a function pointer, or one plus the offset of a
+    // virtual function in the virtual table, and an adjustment of this
+    struct
+    {
+        uintptr_t ptr;
+        ptrdiff_t adj;
+    } rep;
+
+    if (size != sizeof(rep))
+    {
+        return nullptr;
+    }
+    std::memcpy(&rep, pmf, sizeof(rep));
+#if defined(__arm__) || defined(__aarch64__)
+    // The ARM variant flags the virtual functions in the adjustment
+    bool isVirtual = rep.adj & 1;
+    ptrdiff_t adj = rep.adj >> 1;
+    uintptr_t offset = rep.ptr;
+#else
+    bool isVirtual = rep.ptr & 1;
+    ptrdiff_t adj = rep.adj;
+    uintptr_t offset = rep.ptr - 1;
+#endif
+    if (!isVirtual)
+    {
+        return reinterpret_cast<const void*>(rep.ptr);
+    }
+    const char* self = static_cast<const char*>(obj) + adj;
+    const char* vtable = *reinterpret_cast<const char* const*>(self);
+    return *reinterpret_cast<const void* const*>(vtable + offset);
+#else
+    return nullptr;
+#endif
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -41,10 +42,51 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated and freed at a very high rate, so the memory of
+ * small events can be recycled through per-thread free lists, one per size
+ * class, instead of going through the general purpose allocator every time.
+ * This event pool is disabled by default; simulator implementations enable
+ * it for the thread running the simulation.  A block can be freed on a
+ * different thread than the one which allocated it, and the pool can be
+ * enabled or disabled at any time.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
   public:
+    /**
+     * Allocate the memory of an event, from the event pool of the calling
+     * thread if it is enabled and has a free block of the right size class.
+     *
+     * \param [in] size The size of the event.
+     * \returns The memory.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Free the memory of an event, keeping it in the event pool of the
+     * calling thread if it is enabled and not full.
+     *
+     * \param [in] p The memory.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
+
+    /**
+     * Enable or disable the event pool of the calling thread.
+     *
+     * \param [in] enabled Whether to recycle the memory of events.
+     */
+    static void SetPoolEnabled(bool enabled);
+    /**
+     * \returns Whether the event pool of the calling thread is enabled.
+     */
+    static bool IsPoolEnabled();
+    /**
+     * Release the free blocks of the event pool of the calling thread to
+     * the general purpose allocator.
+     */
+    static void PurgePool();
+
     /** Default constructor. */
     EventImpl();
     /** Destructor. */
@@ -66,6 +108,29 @@ class EventImpl : public SimpleRefCount<EventImpl>
      * Checked by the simulation engine before calling Invoke().
      */
     bool IsCancelled();
+    /**
+     * Get the function called by Notify(), so that profiles can attribute
+     * the event to it.
+     *
+     * The address is that of the code, whether or not the function is
+     * exported; EventProfiler can only name the exported ones.
+     *
+     * \returns The address of the function, or nullptr if unknown.
+     */
+    virtual const void* GetFunction() const;
+
+    /**
+     * Get the address of the function a member function pointer calls on
+     * an object, looking virtual functions up in the object.
+     *
+     * \param [in] pmf The member function pointer.
+     * \param [in] size The size of the member function pointer.
+     * \param [in] obj The object, as an instance of the class declaring the
+     * member function.
+     * \returns The address of the function, or nullptr if the representation
+     * of member function pointers is unknown.
+     */
+    static const void* GetMemberFunction(const void* pmf, std::size_t size, const void* obj);
 
   protected:
     /**
@@ -0,0 +1,350 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+
+#include "event-id.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#if (__GNUC__ >= 3)
+#include <cxxabi.h>
+#endif
+
+#if __has_include(<dlfcn.h>)
+#include <dlfcn.h>
+#define NS3_EVENT_PROFILER_DLADDR
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventProfiler");
+
+namespace
+{
+
+/**
+ * \ingroup simulator
+ * Demangle a C++ name.
+ *
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or the mangled one on failure.
+ */
+std::string
+Demangle(const char* mangled)
+{
+    std::string name = mangled;
+#if (__GNUC__ >= 3)
+    int status;
+    char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    if (status == 0)
+    {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+    return name;
+}
+
+/** Totals of a row of the profile. */
+struct ProfileRow
+{
+    std::string name;     //!< The function name.
+    uint32_t context;     //!< The context.
+    uint64_t count;       //!< Number of events invoked.
+    uint64_t cancelled;   //!< Number of events cancelled or removed.
+    uint64_t nanoseconds; //!< Wall time of the invoked events.
+};
+
+/**
+ * Write rows of the profile, by decreasing wall time.
+ *
+ * \param [in] os The output stream.
+ * \param [in,out] rows The rows, sorted on return.
+ * \param [in] maxRows The number of rows to write.
+ * \param [in] total The total wall time, in ns.
+ * \param [in] withContext Whether to write the context column.
+ */
+void
+WriteRows(std::ostream& os,
+          std::vector<ProfileRow>& rows,
+          std::size_t maxRows,
+          uint64_t total,
+          bool withContext)
+{
+    std::sort(rows.begin(), rows.end(), [](const ProfileRow& a, const ProfileRow& b) {
+        return a.nanoseconds > b.nanoseconds ||
+               (a.nanoseconds == b.nanoseconds && a.cancelled > b.cancelled);
+    });
+    os << std::setw(12) << "Time (s)" << std::setw(8) << "%" << std::setw(12) << "Events"
+       << std::setw(12) << "Cancelled" << std::setw(10) << "ns/event";
+    if (withContext)
+    {
+        os << std::setw(11) << "Context";
+    }
+    os << "  Function" << std::endl;
+    for (std::size_t i = 0; i < rows.size() && i < maxRows; i++)
+    {
+        const ProfileRow& row = rows[i];
+        os << std::fixed << std::setw(12) << std::setprecision(6) << row.nanoseconds * 1e-9
+           << std::setw(8) << std::setprecision(2)
+           << (total ? 100.0 * row.nanoseconds / total : 0.0) << std::setw(12) << row.count
+           << std::setw(12) << row.cancelled << std::setw(10) << std::setprecision(0)
+           << (row.count ? static_cast<double>(row.nanoseconds) / row.count : 0.0);
+        if (withContext)
+        {
+            if (row.context == Simulator::NO_CONTEXT)
+            {
+                os << std::setw(11) << "-";
+            }
+            else
+            {
+                os << std::setw(11) << row.context;
+            }
+        }
+        os << "  " << row.name << std::endl;
+    }
+    os << std::defaultfloat;
+}
+
+} // unnamed namespace
+
+EventProfiler* EventProfiler::m_current = nullptr;
+
+bool
+EventProfiler::Key::operator==(const Key& other) const
+{
+    return function == other.function && type == other.type && context == other.context;
+}
+
+std::size_t
+EventProfiler::KeyHash::operator()(const Key& key) const
+{
+    std::size_t h = std::hash<const void*>()(key.function);
+    h ^= std::hash<const void*>()(key.type) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= std::hash<uint32_t>()(key.context) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+EventProfiler::EventProfiler()
+    : m_enabled(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EventProfiler::~EventProfiler()
+{
+    NS_LOG_FUNCTION(this);
+    Disable();
+}
+
+void
+EventProfiler::Enable()
+{
+    NS_LOG_FUNCTION(this);
+    m_stats.clear();
+    m_labels.clear();
+    m_labelNames.clear();
+    m_enabled = true;
+    m_current = this;
+}
+
+void
+EventProfiler::Disable()
+{
+    NS_LOG_FUNCTION(this);
+    m_enabled = false;
+    m_labels.clear();
+    if (m_current == this)
+    {
+        m_current = nullptr;
+    }
+}
+
+void
+EventProfiler::SetLabel(const EventId& id, const std::string& label)
+{
+    NS_LOG_FUNCTION(id.GetUid() << label);
+    if (!m_current || id.IsExpired())
+    {
+        return;
+    }
+    const std::string* name = &*m_current->m_labelNames.insert(label).first;
+    m_current->m_labels[id.PeekEventImpl()] = name;
+}
+
+EventProfiler::Stats&
+EventProfiler::Lookup(EventImpl* event, uint32_t context)
+{
+    Key key;
+    key.function = nullptr;
+    key.type = nullptr;
+    key.context = context;
+    if (!m_labels.empty())
+    {
+        auto it = m_labels.find(event);
+        if (it != m_labels.end())
+        {
+            key.function = it->second;
+            m_labels.erase(it);
+        }
+    }
+    if (!key.function)
+    {
+        key.function = event->GetFunction();
+        key.type = &typeid(*event);
+    }
+    return m_stats[key];
+}
+
+void
+EventProfiler::Invoke(EventImpl* event, uint32_t context)
+{
+    if (event->IsCancelled())
+    {
+        // Counted by RecordCancel(), while the object of the event was alive
+        if (!m_labels.empty())
+        {
+            m_labels.erase(event);
+        }
+        return;
+    }
+    Stats& stats = Lookup(event, context);
+    auto start = std::chrono::steady_clock::now();
+    event->Invoke();
+    auto stop = std::chrono::steady_clock::now();
+    stats.count++;
+    stats.nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+}
+
+void
+EventProfiler::RecordCancel(EventImpl* event, uint32_t context)
+{
+    Lookup(event, context).cancelled++;
+}
+
+std::string
+EventProfiler::GetName(const Key& key) const
+{
+    if (!key.type)
+    {
+        return *static_cast<const std::string*>(key.function);
+    }
+#ifdef NS3_EVENT_PROFILER_DLADDR
+    Dl_info info;
+    if (key.function && dladdr(key.function, &info) && info.dli_sname &&
+        info.dli_saddr == key.function)
+    {
+        // Attribute the calls through a base class to the function itself
+        std::string name = Demangle(info.dli_sname);
+        for (const std::string prefix : {"non-virtual thunk to ", "virtual thunk to "})
+        {
+            if (name.compare(0, prefix.size(), prefix) == 0)
+            {
+                return name.substr(prefix.size());
+            }
+        }
+        return name;
+    }
+#endif
+    std::ostringstream oss;
+    oss << Demangle(key.type->name());
+    if (key.function)
+    {
+        oss << " calling " << key.function;
+    }
+    return oss.str();
+}
+
+void
+EventProfiler::Write(std::ostream& os, uint32_t maxContextRows) const
+{
+    NS_LOG_FUNCTION(this << maxContextRows);
+    // By function, so that the events of different types calling a function
+    // not found in the symbol tables share its name
+    std::unordered_map<const void*, std::string> names;
+    std::map<std::string, ProfileRow> functions;
+    std::map<std::pair<std::string, uint32_t>, ProfileRow> pairs;
+    uint64_t count = 0;
+    uint64_t cancelled = 0;
+    uint64_t total = 0;
+    for (const auto& [key, stats] : m_stats)
+    {
+        std::string name;
+        if (key.function)
+        {
+            auto it = names.emplace(key.function, "");
+            if (it.second)
+            {
+                it.first->second = GetName(key);
+            }
+            name = it.first->second;
+        }
+        else
+        {
+            name = GetName(key);
+        }
+        for (ProfileRow* row :
+             {&functions[name], &pairs[std::make_pair(name, key.context)]})
+        {
+            row->name = name;
+            row->context = key.context;
+            row->count += stats.count;
+            row->cancelled += stats.cancelled;
+            row->nanoseconds += stats.nanoseconds;
+        }
+        count += stats.count;
+        cancelled += stats.cancelled;
+        total += stats.nanoseconds;
+    }
+
+    std::vector<ProfileRow> rows;
+    os << "Event profile: " << count << " events in " << total * 1e-9 << " s, " << cancelled
+       << " cancelled, " << functions.size() << " functions" << std::endl;
+    for (const auto& function : functions)
+    {
+        rows.push_back(function.second);
+    }
+    WriteRows(os, rows, rows.size(), total, false);
+
+    rows.clear();
+    for (const auto& pair : pairs)
+    {
+        rows.push_back(pair.second);
+    }
+    os << std::endl
+       << "Top " << std::min<std::size_t>(maxContextRows, rows.size())
+       << " function and context pairs:" << std::endl;
+    WriteRows(os, rows, maxContextRows, total, true);
+}
+
+} // namespace ns3
@@ -0,0 +1,189 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include "event-impl.h"
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+class EventId;
+
+/**
+ * \ingroup simulator
+ * \brief Wall time profile of the simulation events, by function and context.
+ *
+ * The profiler times each event it invokes and attributes the time to the
+ * function the event calls, as given by EventImpl::GetFunction(), and to
+ * the context of the event.  Member functions are attributed to the
+ * override actually called.  Events whose function is unknown, such as
+ * lambdas, are attributed to their EventImpl type, which names the lambda.
+ * An event can also be given a label with SetLabel(), which then replaces
+ * its function.  The profiler also counts the events cancelled, or
+ * removed, before their expiry.
+ *
+ * Write() prints the totals by function, sorted by decreasing wall time,
+ * followed by the function and context pairs with the most wall time.
+ * Function names are looked up with dladdr() in the dynamic symbol
+ * tables, so only exported functions are named.  The ns-3 libraries export
+ * their functions, and executables built with build_exec() are linked with
+ * -rdynamic so that theirs are exported too.  Functions with internal
+ * linkage, such as static functions or those in anonymous namespaces, and
+ * functions of executables linked without -rdynamic are printed as their
+ * EventImpl type and address.
+ *
+ * The cost per event is two reads of the steady clock, a virtual call and
+ * a hash table lookup, so profiling can be left on for long runs.
+ */
+class EventProfiler
+{
+  public:
+    EventProfiler();
+    /** Destructor. */
+    ~EventProfiler();
+
+    /**
+     * Start profiling, discarding any previous profile.  The labels set
+     * with SetLabel() go to the last profiler enabled.
+     */
+    void Enable();
+    /** Stop profiling, keeping the profile. */
+    void Disable();
+    /** \returns \c true if profiling. */
+    bool IsEnabled() const;
+
+    /**
+     * Invoke an event, recording its wall time, unless it was cancelled.
+     *
+     * \param [in] event The event.
+     * \param [in] context The context of the event.
+     */
+    void Invoke(EventImpl* event, uint32_t context);
+    /**
+     * Count an event cancelled or removed before its expiry.
+     *
+     * This must be called when the event is cancelled rather than when it
+     * expires, since the function of an event calling a virtual method is
+     * looked up in the object, which may be deleted by then.
+     *
+     * \param [in] event The event.
+     * \param [in] context The context of the event.
+     */
+    void RecordCancel(EventImpl* event, uint32_t context);
+
+    /**
+     * Write the profile.
+     *
+     * \param [in] os The output stream.
+     * \param [in] maxContextRows The number of function and context pairs
+     * to print.
+     */
+    void Write(std::ostream& os, uint32_t maxContextRows = 50) const;
+
+    /**
+     * Attribute a scheduled event to a label rather than to its function,
+     * in the profile of the running simulation, if it is being profiled.
+     *
+     * \param [in] id The event.
+     * \param [in] label The label.
+     */
+    static void SetLabel(const EventId& id, const std::string& label);
+
+  private:
+    /** A function and context pair. */
+    struct Key
+    {
+        const void* function;       //!< The function, or label, address.
+        const std::type_info* type; //!< The type of the event.
+        uint32_t context;           //!< The context.
+
+        /**
+         * \param [in] other The other key.
+         * \returns \c true if both keys are equal.
+         */
+        bool operator==(const Key& other) const;
+    };
+
+    /** Hash of a Key. */
+    struct KeyHash
+    {
+        /**
+         * \param [in] key The key.
+         * \returns The hash.
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /** The profile of a function and context pair. */
+    struct Stats
+    {
+        uint64_t count;       //!< Number of events invoked.
+        uint64_t cancelled;   //!< Number of events cancelled or removed.
+        uint64_t nanoseconds; //!< Wall time of the invoked events.
+    };
+
+    /**
+     * Get the profile entry of an event.
+     *
+     * \param [in] event The event.
+     * \param [in] context The context of the event.
+     * \returns The entry.
+     */
+    Stats& Lookup(EventImpl* event, uint32_t context);
+    /**
+     * Get the printable name of a function.
+     *
+     * \param [in] key The key of the function.
+     * \returns The name.
+     */
+    std::string GetName(const Key& key) const;
+
+    /** The profile. */
+    std::unordered_map<Key, Stats, KeyHash> m_stats;
+    /** The labels of the pending labelled events. */
+    std::unordered_map<const EventImpl*, const std::string*> m_labels;
+    /** The label names, with stable addresses. */
+    std::unordered_set<std::string> m_labelNames;
+    /** Whether profiling. */
+    bool m_enabled;
+
+    /** The profiler the labels go to. */
+    static EventProfiler* m_current;
+};
+
+inline bool
+EventProfiler::IsEnabled() const
+{
+    return m_enabled;
+}
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
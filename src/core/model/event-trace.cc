@@ -0,0 +1,332 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-trace.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <cstring>
+#include <typeinfo>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventTraceWriter and ns3::EventTraceReader implementations.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventTrace");
+
+/** The magic at the start of an event trace. */
+static const char EVENT_TRACE_MAGIC[] = "ns3evtr1";
+/** Size of the magic, without the terminating null. */
+static const std::size_t EVENT_TRACE_MAGIC_SIZE = sizeof(EVENT_TRACE_MAGIC) - 1;
+/** Size of the write buffer. */
+static const std::size_t EVENT_TRACE_BUFFER_SIZE = 1 << 16;
+/** Room kept in the write buffer for one record, besides type names. */
+static const std::size_t EVENT_TRACE_MAX_RECORD = 64;
+
+EventTraceWriter::EventTraceWriter()
+    : m_file(nullptr),
+      m_lastNow(0),
+      m_lastUid(0),
+      m_fail(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EventTraceWriter::~EventTraceWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+EventTraceWriter::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    Close();
+    m_file = std::fopen(filename.c_str(), "wb");
+    if (!m_file)
+    {
+        return false;
+    }
+    m_buffer.reserve(EVENT_TRACE_BUFFER_SIZE);
+    m_buffer.assign(EVENT_TRACE_MAGIC, EVENT_TRACE_MAGIC + EVENT_TRACE_MAGIC_SIZE);
+    m_types.clear();
+    m_lastNow = 0;
+    m_lastUid = 0;
+    m_fail = false;
+    return true;
+}
+
+void
+EventTraceWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_file)
+    {
+        Flush();
+        if (std::fclose(m_file) != 0 && !m_fail)
+        {
+            NS_LOG_ERROR("Cannot close the event trace");
+            m_fail = true;
+        }
+        m_file = nullptr;
+    }
+}
+
+bool
+EventTraceWriter::IsOpen() const
+{
+    return m_file != nullptr;
+}
+
+bool
+EventTraceWriter::Fail() const
+{
+    return m_fail;
+}
+
+void
+EventTraceWriter::PutVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void
+EventTraceWriter::MaybeFlush()
+{
+    if (m_buffer.size() + EVENT_TRACE_MAX_RECORD > EVENT_TRACE_BUFFER_SIZE)
+    {
+        Flush();
+    }
+}
+
+void
+EventTraceWriter::Flush()
+{
+    if (!m_buffer.empty())
+    {
+        // after a failure the records are dropped, the trace being unusable
+        if (!m_fail &&
+            std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size())
+        {
+            NS_LOG_ERROR("Cannot write the event trace");
+            m_fail = true;
+        }
+        m_buffer.clear();
+    }
+}
+
+uint32_t
+EventTraceWriter::GetTypeIndex(const EventImpl* impl)
+{
+    std::type_index type(typeid(*impl));
+    auto it = m_types.find(type);
+    if (it != m_types.end())
+    {
+        return it->second;
+    }
+    uint32_t index = m_types.size();
+    m_types.emplace(type, index);
+    const char* name = type.name();
+    std::size_t length = std::strlen(name);
+    m_buffer.push_back('T');
+    PutVarint(index);
+    PutVarint(length);
+    m_buffer.insert(m_buffer.end(), name, name + length);
+    MaybeFlush();
+    return index;
+}
+
+void
+EventTraceWriter::RecordInsert(uint64_t now, const Scheduler::Event& ev, uint32_t parent)
+{
+    uint32_t type = GetTypeIndex(ev.impl);
+    m_buffer.push_back('I');
+    PutVarint(now - m_lastNow);
+    PutVarint(ev.key.m_ts - now);
+    PutVarint(static_cast<uint32_t>(ev.key.m_uid - m_lastUid));
+    PutVarint(static_cast<uint32_t>(ev.key.m_uid - parent));
+    PutVarint(static_cast<uint32_t>(ev.key.m_context + 1));
+    PutVarint(type);
+    m_lastNow = now;
+    m_lastUid = ev.key.m_uid;
+    MaybeFlush();
+}
+
+void
+EventTraceWriter::RecordRemove(uint64_t now, const Scheduler::Event& ev)
+{
+    m_buffer.push_back('R');
+    PutVarint(now - m_lastNow);
+    PutVarint(ev.key.m_ts - now);
+    PutVarint(ev.key.m_uid);
+    m_lastNow = now;
+    MaybeFlush();
+}
+
+EventTraceReader::EventTraceReader()
+    : m_file(nullptr),
+      m_lastNow(0),
+      m_lastUid(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EventTraceReader::~EventTraceReader()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_file)
+    {
+        std::fclose(m_file);
+    }
+}
+
+bool
+EventTraceReader::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    if (m_file)
+    {
+        std::fclose(m_file);
+    }
+    m_types.clear();
+    m_lastNow = 0;
+    m_lastUid = 0;
+    m_file = std::fopen(filename.c_str(), "rb");
+    if (!m_file)
+    {
+        return false;
+    }
+    char magic[EVENT_TRACE_MAGIC_SIZE];
+    return std::fread(magic, 1, EVENT_TRACE_MAGIC_SIZE, m_file) == EVENT_TRACE_MAGIC_SIZE &&
+           std::memcmp(magic, EVENT_TRACE_MAGIC, EVENT_TRACE_MAGIC_SIZE) == 0;
+}
+
+bool
+EventTraceReader::GetVarint(uint64_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        int c = std::getc(m_file);
+        if (c == EOF)
+        {
+            return false;
+        }
+        value |= static_cast<uint64_t>(c & 0x7f) << shift;
+        if (!(c & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+EventTraceReader::Read(Record& record)
+{
+    if (!m_file)
+    {
+        return false;
+    }
+    while (true)
+    {
+        int kind = std::getc(m_file);
+        uint64_t a;
+        uint64_t b;
+        uint64_t c;
+        switch (kind)
+        {
+        case 'T': {
+            uint64_t index;
+            uint64_t length;
+            if (!GetVarint(index) || !GetVarint(length))
+            {
+                return false;
+            }
+            std::string name(length, '\0');
+            if (std::fread(&name[0], 1, length, m_file) != length)
+            {
+                return false;
+            }
+            if (m_types.size() <= index)
+            {
+                m_types.resize(index + 1);
+            }
+            m_types[index] = name;
+            break;
+        }
+        case 'I': {
+            uint64_t parent;
+            uint64_t context;
+            uint64_t type;
+            if (!GetVarint(a) || !GetVarint(b) || !GetVarint(c) || !GetVarint(parent) ||
+                !GetVarint(context) || !GetVarint(type))
+            {
+                return false;
+            }
+            record.insert = true;
+            record.now = m_lastNow + a;
+            record.event.impl = nullptr;
+            record.event.key.m_ts = record.now + b;
+            record.event.key.m_uid = static_cast<uint32_t>(m_lastUid + c);
+            record.parent = static_cast<uint32_t>(record.event.key.m_uid - parent);
+            record.event.key.m_context = static_cast<uint32_t>(context - 1);
+            record.type = type;
+            m_lastNow = record.now;
+            m_lastUid = record.event.key.m_uid;
+            return true;
+        }
+        case 'R': {
+            if (!GetVarint(a) || !GetVarint(b) || !GetVarint(c))
+            {
+                return false;
+            }
+            record.insert = false;
+            record.now = m_lastNow + a;
+            record.parent = 0;
+            record.type = 0;
+            record.event.impl = nullptr;
+            record.event.key.m_ts = record.now + b;
+            record.event.key.m_uid = static_cast<uint32_t>(c);
+            record.event.key.m_context = 0;
+            m_lastNow = record.now;
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+}
+
+const std::vector<std::string>&
+EventTraceReader::GetTypeNames() const
+{
+    return m_types;
+}
+
+} // namespace ns3
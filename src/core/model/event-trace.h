@@ -0,0 +1,188 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include "scheduler.h"
+
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventTraceWriter and ns3::EventTraceReader declarations.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ * \brief Binary trace of the operations of a simulation on its event list.
+ *
+ * An event trace lists, in order, every event inserted in the Scheduler,
+ * with the simulation time of the insertion, the expiry time, the event
+ * uid, the uid of the event being executed when it was inserted, the
+ * context and the callback type, as well as the events removed before
+ * their expiry.  Replaying a trace against a Scheduler reproduces the
+ * exact sequence of Insert(), RemoveNext() and Remove() calls of the
+ * simulation, without running its models.
+ *
+ * The file starts with the 8 bytes magic "ns3evtr1".  Each record then
+ * starts with a kind byte followed by unsigned LEB128 varints:
+ *
+ * Kind | Record | Fields
+ * :--- | :----- | :-----
+ * `T`  | callback type | index, name length, name bytes
+ * `I`  | insert | now - previous now, ts - now, uid - previous uid, uid - parent uid, context + 1, type index
+ * `R`  | remove | now - previous now, ts - now, uid
+ *
+ * A callback type record precedes the first insert of that type.  The
+ * callback types are the dynamic types of the EventImpl objects, so the
+ * events created by MakeEvent for different functions are told apart.
+ * Typical insert records take 6 to 10 bytes.
+ */
+class EventTraceWriter
+{
+  public:
+    EventTraceWriter();
+    /** Destructor, closing the file. */
+    ~EventTraceWriter();
+
+    /**
+     * Create the trace file, replacing any existing one.
+     *
+     * \param [in] filename The file name.
+     * \returns \c true on success.
+     */
+    bool Open(const std::string& filename);
+    /** Flush and close the trace file. */
+    void Close();
+    /** \returns \c true if the trace file is open. */
+    bool IsOpen() const;
+    /**
+     * \returns \c true if writing or closing the trace file failed since
+     * it was opened, so the trace is truncated.
+     */
+    bool Fail() const;
+
+    /**
+     * Record the insertion of an event.
+     *
+     * \param [in] now The current simulation time stamp.
+     * \param [in] ev The event.
+     * \param [in] parent The uid of the event being executed.
+     */
+    void RecordInsert(uint64_t now, const Scheduler::Event& ev, uint32_t parent);
+    /**
+     * Record the removal of an event before its expiry.
+     *
+     * \param [in] now The current simulation time stamp.
+     * \param [in] ev The event.
+     */
+    void RecordRemove(uint64_t now, const Scheduler::Event& ev);
+
+  private:
+    /**
+     * Get the index of the callback type of an event, recording the type
+     * if it is new.
+     *
+     * \param [in] impl The event implementation.
+     * \returns The index.
+     */
+    uint32_t GetTypeIndex(const EventImpl* impl);
+    /**
+     * Append a varint to the buffer.
+     *
+     * \param [in] value The value.
+     */
+    void PutVarint(uint64_t value);
+    /** Write the buffer to the file, if it is nearly full. */
+    void MaybeFlush();
+    /** Write the buffer to the file. */
+    void Flush();
+
+    std::FILE* m_file;                                     //!< The trace file.
+    std::vector<uint8_t> m_buffer;                         //!< Records not yet written.
+    std::unordered_map<std::type_index, uint32_t> m_types; //!< The callback type indices.
+    uint64_t m_lastNow;                                    //!< Time of the previous record.
+    uint32_t m_lastUid;                                    //!< Uid of the previous insert.
+    bool m_fail;                                           //!< A write failed.
+};
+
+/**
+ * \ingroup simulator
+ * \brief Reader of the event traces written by EventTraceWriter.
+ */
+class EventTraceReader
+{
+  public:
+    /** A record of an event trace. */
+    struct Record
+    {
+        bool insert;            //!< \c true for an insert, \c false for a remove.
+        uint64_t now;           //!< The simulation time stamp of the operation.
+        uint32_t parent;        //!< For an insert, the uid of the event being executed.
+        uint32_t type;          //!< For an insert, the callback type index.
+        Scheduler::Event event; //!< The event, with a null implementation.
+    };
+
+    EventTraceReader();
+    /** Destructor, closing the file. */
+    ~EventTraceReader();
+
+    /**
+     * Open a trace file.
+     *
+     * \param [in] filename The file name.
+     * \returns \c true if the file is open and starts with the magic.
+     */
+    bool Open(const std::string& filename);
+    /**
+     * Read the next insert or remove record.
+     *
+     * \param [out] record The record.
+     * \returns \c false at the end of the trace.
+     */
+    bool Read(Record& record);
+    /**
+     * \returns The names of the callback types read so far, by index.
+     */
+    const std::vector<std::string>& GetTypeNames() const;
+
+  private:
+    /**
+     * Read a varint.
+     *
+     * \param [out] value The value.
+     * \returns \c false at the end of the file.
+     */
+    bool GetVarint(uint64_t& value);
+
+    std::FILE* m_file;                //!< The trace file.
+    std::vector<std::string> m_types; //!< The callback type names.
+    uint64_t m_lastNow;               //!< Time of the previous record.
+    uint32_t m_lastUid;               //!< Uid of the previous insert.
+};
+
+} // namespace ns3
+
+#endif /* EVENT_TRACE_H */
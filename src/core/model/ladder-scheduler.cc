@@ -0,0 +1,313 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+/**
+ * Buckets and bottoms with more events than this are spread over a new
+ * rung rather than sorted, as suggested by Tang et al.
+ */
+static const uint64_t LADDER_THRESHOLD = 50;
+
+/** Maximum number of rungs. */
+static const uint32_t LADDER_MAX_RUNGS = 8;
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topMin(std::numeric_limits<uint64_t>::max()),
+      m_topMax(0),
+      m_topStart(0),
+      m_rungs(LADDER_MAX_RUNGS),
+      m_nRungs(0),
+      m_nEvents(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart(const Rung& rung)
+{
+    return rung.start + rung.current * rung.width;
+}
+
+LadderScheduler::Rung&
+LadderScheduler::AddRung(uint64_t start, uint64_t end, uint64_t nEvents)
+{
+    NS_LOG_FUNCTION(this << start << end << nEvents);
+    NS_ASSERT(m_nRungs < LADDER_MAX_RUNGS);
+    NS_ASSERT(end > start);
+    uint64_t span = end - start;
+    uint64_t nBuckets = std::max<uint64_t>(1, std::min(nEvents, span));
+    uint64_t width = (span + nBuckets - 1) / nBuckets;
+    nBuckets = (span + width - 1) / width;
+
+    Rung& rung = m_rungs[m_nRungs++];
+    if (rung.buckets.size() < nBuckets)
+    {
+        rung.buckets.resize(nBuckets);
+    }
+    rung.nBuckets = nBuckets;
+    rung.start = start;
+    rung.width = width;
+    rung.current = 0;
+    rung.count = 0;
+    return rung;
+}
+
+void
+LadderScheduler::AddToRung(Rung& rung, const Scheduler::Event& ev)
+{
+    uint64_t index = (ev.key.m_ts - rung.start) / rung.width;
+    NS_ASSERT(index >= rung.current && index < rung.nBuckets);
+    rung.buckets[index].push_back(ev);
+    rung.count++;
+}
+
+void
+LadderScheduler::InsertBottom(const Scheduler::Event& ev)
+{
+    m_bottom.insert(
+        std::upper_bound(m_bottom.begin(), m_bottom.end(), ev, std::greater<Scheduler::Event>()),
+        ev);
+
+    // Keep the bottom small, unless all its events are simultaneous
+    if (m_bottom.size() > LADDER_THRESHOLD && m_nRungs < LADDER_MAX_RUNGS &&
+        m_bottom.front().key.m_ts != m_bottom.back().key.m_ts)
+    {
+        uint64_t end = m_nRungs > 0 ? CurrentStart(m_rungs[m_nRungs - 1]) : m_topStart;
+        Rung& rung = AddRung(m_bottom.back().key.m_ts, end, m_bottom.size());
+        for (const auto& event : m_bottom)
+        {
+            AddToRung(rung, event);
+        }
+        m_bottom.clear();
+    }
+}
+
+void
+LadderScheduler::SortToBottom(Bucket& bucket)
+{
+    NS_ASSERT(m_bottom.empty());
+    m_bottom.swap(bucket);
+    std::sort(m_bottom.begin(), m_bottom.end(), std::greater<Scheduler::Event>());
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+    while (m_bottom.empty())
+    {
+        if (m_nRungs == 0)
+        {
+            if (m_top.empty())
+            {
+                return;
+            }
+            NS_LOG_LOGIC("moving " << m_top.size() << " events from the top");
+            uint64_t topMin = m_topMin;
+            uint64_t topMax = m_topMax;
+            m_topMin = std::numeric_limits<uint64_t>::max();
+            m_topMax = 0;
+            if (m_top.size() <= LADDER_THRESHOLD)
+            {
+                SortToBottom(m_top);
+                m_topStart = topMax + 1;
+                return;
+            }
+            Rung& rung = AddRung(topMin, topMax + 1, m_top.size());
+            m_topStart = rung.start + rung.nBuckets * rung.width;
+            for (const auto& event : m_top)
+            {
+                AddToRung(rung, event);
+            }
+            m_top.clear();
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.count == 0)
+        {
+            m_nRungs--;
+            continue;
+        }
+        while (rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        Bucket& bucket = rung.buckets[rung.current];
+        uint64_t bucketStart = CurrentStart(rung);
+        rung.current++;
+        rung.count -= bucket.size();
+
+        if (bucket.size() > LADDER_THRESHOLD && rung.width > 1 && m_nRungs < LADDER_MAX_RUNGS)
+        {
+            NS_LOG_LOGIC("spreading " << bucket.size() << " events over rung " << m_nRungs);
+            Rung& child = AddRung(bucketStart, bucketStart + rung.width, bucket.size());
+            for (const auto& event : bucket)
+            {
+                AddToRung(child, event);
+            }
+            bucket.clear();
+        }
+        else
+        {
+            SortToBottom(bucket);
+        }
+    }
+}
+
+void
+LadderScheduler::Insert(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+    }
+    else
+    {
+        uint32_t i = 0;
+        while (i < m_nRungs && ts < CurrentStart(m_rungs[i]))
+        {
+            i++;
+        }
+        if (i < m_nRungs)
+        {
+            AddToRung(m_rungs[i], ev);
+        }
+        else
+        {
+            InsertBottom(ev);
+        }
+    }
+    m_nEvents++;
+    Refill();
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    return m_nEvents == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom.back();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Scheduler::Event ev = m_bottom.back();
+    m_bottom.pop_back();
+    m_nEvents--;
+    Refill();
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    uint64_t ts = ev.key.m_ts;
+    auto sameUid = [&ev](const Scheduler::Event& event) -> bool {
+        return event.key.m_uid == ev.key.m_uid;
+    };
+
+    Bucket* bucket = nullptr;
+    if (ts >= m_topStart)
+    {
+        bucket = &m_top;
+    }
+    else
+    {
+        uint32_t i = 0;
+        while (i < m_nRungs && ts < CurrentStart(m_rungs[i]))
+        {
+            i++;
+        }
+        if (i < m_nRungs)
+        {
+            Rung& rung = m_rungs[i];
+            bucket = &rung.buckets[(ts - rung.start) / rung.width];
+            rung.count--;
+        }
+    }
+
+    if (bucket)
+    {
+        auto it = std::find_if(bucket->begin(), bucket->end(), sameUid);
+        NS_ASSERT(it != bucket->end());
+        *it = bucket->back();
+        bucket->pop_back();
+    }
+    else
+    {
+        auto it = std::lower_bound(m_bottom.begin(),
+                                   m_bottom.end(),
+                                   ev,
+                                   std::greater<Scheduler::Event>());
+        NS_ASSERT(it != m_bottom.end() && sameUid(*it));
+        m_bottom.erase(it);
+    }
+    m_nEvents--;
+    Refill();
+}
+
+} // namespace ns3
@@ -0,0 +1,189 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue of
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Tang, Goh and Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The events are kept in three tiers:
+ *
+ *   - Top: an unsorted vector of the far future events, whose time stamps
+ *     are at least the top start.
+ *   - Ladder: up to eight rungs of buckets.  Each rung covers the time span
+ *     of one bucket of the rung above it (the first rung covers the whole
+ *     time span of the top when it was emptied into the ladder), and the
+ *     buckets are unsorted vectors.
+ *   - Bottom: a small vector of the near future events, sorted in
+ *     decreasing time stamp order, so that the next event is at the back.
+ *
+ * The next event is always taken from the bottom.  When the bottom is
+ * empty, the first non empty bucket of the last rung is either sorted into
+ * the bottom, if it holds few events, or spread over a new rung of
+ * narrower buckets.  When the ladder is empty, the top becomes the first
+ * rung.  Events are sorted only when they get close to the head of the
+ * queue, and only a few at a time, so the distributions with many near
+ * future timers and sparse long timers, which hurt the binary heap and
+ * the calendar queue, keep an amortized constant cost per event.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to a bucket or the top; small sorted bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Back of the bottom
+ * Remove()     | Linear          | Search within the tier holding the event
+ * RemoveNext() | ~Constant       | Back of the bottom; possible bucket transfer
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | Buckets of the rungs             | `std::vector`, kept for reuse
+ * Per Event | `sizeof (Event)`                 | `std::vector`
+ *
+ * \note Remove() searches the unsorted top, or a bucket, linearly.  It is
+ * only used by Simulator::Remove, which is much less common than
+ * cancelling events.
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Bucket type: an unsorted vector of Events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        std::vector<Bucket> buckets; /**< The buckets, possibly more than used. */
+        uint64_t nBuckets;           /**< The number of buckets in use. */
+        uint64_t start;              /**< Time stamp at the start of the first bucket. */
+        uint64_t width;              /**< Duration of a bucket. */
+        uint64_t current;            /**< First bucket not yet transferred. */
+        uint64_t count;              /**< Number of events in the rung. */
+    };
+
+    /**
+     * Get the time stamp at the start of the first bucket of a rung not
+     * yet transferred to the rung below or to the bottom.
+     *
+     * \param [in] rung The rung.
+     * \returns The time stamp.
+     */
+    static uint64_t CurrentStart(const Rung& rung);
+
+    /**
+     * Add a rung below the last one.
+     *
+     * \param [in] start The time stamp at the start of the rung.
+     * \param [in] end The time stamp at the end of the rung, exclusive.
+     * \param [in] nEvents The number of events about to be added, used to
+     * choose the number of buckets.
+     * \returns The new rung.
+     */
+    Rung& AddRung(uint64_t start, uint64_t end, uint64_t nEvents);
+
+    /**
+     * Add an event to its bucket of a rung.
+     *
+     * \param [in] rung The rung.
+     * \param [in] ev The event.
+     */
+    static void AddToRung(Rung& rung, const Scheduler::Event& ev);
+
+    /**
+     * Insert an event in the sorted bottom, spreading the bottom over a
+     * new rung if it gets too large.
+     *
+     * \param [in] ev The event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+
+    /**
+     * Move the events from a bucket to the bottom, sorted.
+     *
+     * \param [in] bucket The bucket, empty on return.
+     */
+    void SortToBottom(Bucket& bucket);
+
+    /**
+     * Move the next events to the bottom, if it is empty and the queue is
+     * not, going down the ladder and creating rungs as needed.
+     */
+    void Refill();
+
+    /** The far future events, unsorted. */
+    Bucket m_top;
+    /** Lower bound of the time stamps of the top events. */
+    uint64_t m_topMin;
+    /** Upper bound of the time stamps of the top events. */
+    uint64_t m_topMax;
+    /** The events at or after this time stamp are in the top. */
+    uint64_t m_topStart;
+    /** The rungs, allocated once, the first m_nRungs being in use. */
+    std::vector<Rung> m_rungs;
+    /** Number of rungs in use. */
+    uint32_t m_nRungs;
+    /** The near future events, in decreasing order. */
+    Bucket m_bottom;
+    /** Number of events in queue. */
+    uint64_t m_nEvents;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
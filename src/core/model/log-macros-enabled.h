@@ -159,6 +159,39 @@
 #define NS_LOG_CONDITION
 #endif
 
+/**
+ * \ingroup logging
+ * Check at compile time that a log level is at least as severe as the
+ * floor of the log component, so that the statements of the levels below
+ * the floor are optimized away.
+ *
+ * \param [in] level The log level.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ */
+#define NS_LOG_ABOVE_FLOOR(level)                                                                  \
+    ((level) <= std::remove_reference_t<decltype(g_log)>::FLOOR)
+
+/**
+ * \ingroup logging
+ * Register the log statement with the BinaryLogSink, once, and start
+ * a record of it, \c ns3LogRecord.
+ *
+ * \param [in] kind The BinaryLogSink::Kind of statement.
+ * \param [in] level The log level.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ */
+#define NS_LOG_BINARY_RECORD(kind, level)                                                          \
+    static const uint32_t ns3LogSite =                                                             \
+        ns3::BinaryLogSink::RegisterSite(kind,                                                     \
+                                         level,                                                    \
+                                         g_log.Name(),                                             \
+                                         __FUNCTION__,                                             \
+                                         __FILE__,                                                 \
+                                         __LINE__);                                                \
+    ns3::BinaryLogRecord ns3LogRecord(ns3LogSite, g_log)
+
 /**
  * \ingroup logging
  *
@@ -182,14 +215,22 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(level))                                                                \
+        if (NS_LOG_ABOVE_FLOOR(level) && g_log.IsEnabled(level))                                   \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            NS_LOG_APPEND_FUNC_PREFIX;                                                             \
-            NS_LOG_APPEND_LEVEL_PREFIX(level);                                                     \
-            std::clog << msg << std::endl;                                                         \
+            if (ns3::BinaryLogSink::IsEnabled())                                                   \
+            {                                                                                      \
+                NS_LOG_BINARY_RECORD(ns3::BinaryLogSink::MESSAGE, level);                          \
+                ns3LogRecord.GetStream() << msg;                                                   \
+            }                                                                                      \
+            else                                                                                   \
+            {                                                                                      \
+                NS_LOG_APPEND_TIME_PREFIX;                                                         \
+                NS_LOG_APPEND_NODE_PREFIX;                                                         \
+                NS_LOG_APPEND_CONTEXT;                                                             \
+                NS_LOG_APPEND_FUNC_PREFIX;                                                         \
+                NS_LOG_APPEND_LEVEL_PREFIX(level);                                                 \
+                std::clog << msg << std::endl;                                                     \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -205,12 +246,19 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if (NS_LOG_ABOVE_FLOOR(ns3::LOG_FUNCTION) && g_log.IsEnabled(ns3::LOG_FUNCTION))           \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            std::clog << g_log.Name() << ":" << __FUNCTION__ << "()" << std::endl;                 \
+            if (ns3::BinaryLogSink::IsEnabled())                                                   \
+            {                                                                                      \
+                NS_LOG_BINARY_RECORD(ns3::BinaryLogSink::FUNCTION, ns3::LOG_FUNCTION);             \
+            }                                                                                      \
+            else                                                                                   \
+            {                                                                                      \
+                NS_LOG_APPEND_TIME_PREFIX;                                                         \
+                NS_LOG_APPEND_NODE_PREFIX;                                                         \
+                NS_LOG_APPEND_CONTEXT;                                                             \
+                std::clog << g_log.Name() << ":" << __FUNCTION__ << "()" << std::endl;             \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -239,14 +287,22 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if (NS_LOG_ABOVE_FLOOR(ns3::LOG_FUNCTION) && g_log.IsEnabled(ns3::LOG_FUNCTION))           \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            std::clog << g_log.Name() << ":" << __FUNCTION__ << "(";                               \
-            ns3::ParameterLogger(std::clog) << parameters;                                         \
-            std::clog << ")" << std::endl;                                                         \
+            if (ns3::BinaryLogSink::IsEnabled())                                                   \
+            {                                                                                      \
+                NS_LOG_BINARY_RECORD(ns3::BinaryLogSink::FUNCTION, ns3::LOG_FUNCTION);             \
+                ns3::BinaryParameterLogger(ns3LogRecord.GetStream()) << parameters;                \
+            }                                                                                      \
+            else                                                                                   \
+            {                                                                                      \
+                NS_LOG_APPEND_TIME_PREFIX;                                                         \
+                NS_LOG_APPEND_NODE_PREFIX;                                                         \
+                NS_LOG_APPEND_CONTEXT;                                                             \
+                std::clog << g_log.Name() << ":" << __FUNCTION__ << "(";                           \
+                ns3::ParameterLogger(std::clog) << parameters;                                     \
+                std::clog << ")" << std::endl;                                                     \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -20,6 +20,7 @@
 #ifndef NS3_LOG_H
 #define NS3_LOG_H
 
+#include "binary-log-sink.h"
 #include "log-macros-disabled.h"
 #include "log-macros-enabled.h"
 #include "node-printer.h"
@@ -202,6 +203,24 @@ void LogComponentDisableAll(enum LogLevel level);
 #define NS_LOG_COMPONENT_DEFINE(name)                                                              \
     static ns3::LogComponent g_log = ns3::LogComponent(name, __FILE__)
 
+/**
+ * Define a log component with a compile time floor.
+ *
+ * The statements of the levels less severe than the floor are compiled
+ * out of the file, whatever the levels enabled at run time.  For example
+ * \code
+ *   NS_LOG_COMPONENT_DEFINE_FLOOR ("CybertwinNode", ns3::LOG_DEBUG);
+ * \endcode
+ * keeps the LOG_ERROR, LOG_WARN and LOG_DEBUG statements, and removes the
+ * LOG_INFO, LOG_FUNCTION and LOG_LOGIC ones.  The components defined by
+ * NS_LOG_COMPONENT_DEFINE have the floor NS3_LOG_FLOOR.
+ *
+ * \param [in] name The log component name.
+ * \param [in] floor The least severe level compiled, a single LogLevel.
+ */
+#define NS_LOG_COMPONENT_DEFINE_FLOOR(name, floor)                                                 \
+    static ns3::LogComponentWithFloor<floor> g_log(name, __FILE__)
+
 /**
  * Define a logging component with a mask.
  *
@@ -321,12 +340,28 @@ void LogSetNodePrinter(NodePrinter np);
  */
 NodePrinter LogGetNodePrinter();
 
+/**
+ * \def NS3_LOG_FLOOR
+ * The least severe log level compiled by default, set with the
+ * NS3_LOG_FLOOR option of the build, e.g. \c -DNS3_LOG_FLOOR=info.
+ * All the levels are compiled unless it is set.
+ */
+#ifndef NS3_LOG_FLOOR
+#define NS3_LOG_FLOOR ns3::LOG_LOGIC
+#endif
+
 /**
  * A single log component configuration.
  */
 class LogComponent
 {
   public:
+    /**
+     * The least severe level compiled in the file of the component, see
+     * NS_LOG_COMPONENT_DEFINE_FLOOR.
+     */
+    static constexpr LogLevel FLOOR = NS3_LOG_FLOOR;
+
     /**
      * Constructor.
      *
@@ -425,6 +460,21 @@ class LogComponent
 
 }; // class LogComponent
 
+/**
+ * A log component with its own compile time floor.
+ *
+ * \tparam Floor The least severe level compiled.
+ */
+template <LogLevel Floor>
+class LogComponentWithFloor : public LogComponent
+{
+  public:
+    /** The least severe level compiled in the file of the component. */
+    static constexpr LogLevel FLOOR = Floor;
+
+    using LogComponent::LogComponent;
+};
+
 /**
  * Get the LogComponent registered with the given name.
  *
@@ -142,6 +142,64 @@ RandomVariableStream::Peek() const
     return m_rng;
 }
 
+void
+RandomVariableStream::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        values[i] = GetValue();
+    }
+}
+
+/**
+ * \ingroup randomvariable
+ * Draw random values by inversion of uniform variates, the same as the
+ * loops of GetValue() of the bounded distributions: the uniforms are drawn
+ * in batches, and a value above the bound is replaced by the value of the
+ * next uniform.
+ *
+ * \tparam Inverse \deduced The type of the inverse distribution function.
+ * \param [in] rng The underlying RngStream.
+ * \param [in] isAntithetic If \c true, invert the antithetic uniforms.
+ * \param [in] bound The upper bound on the values, 0 for none.
+ * \param [out] values The random values.
+ * \param [in] n The number of values.
+ * \param [in] inverse The inverse distribution function.
+ */
+template <typename Inverse>
+static void
+GetBoundedValues(RngStream* rng,
+                 bool isAntithetic,
+                 double bound,
+                 double* values,
+                 std::size_t n,
+                 Inverse inverse)
+{
+    std::size_t kept = 0;
+    while (kept < n)
+    {
+        // the uniforms are drawn in place, each is read before a value
+        // overwrites it
+        double* uniforms = values + kept;
+        std::size_t drawn = n - kept;
+        rng->RandU01(uniforms, drawn);
+        for (std::size_t i = 0; i < drawn; i++)
+        {
+            double v = uniforms[i];
+            if (isAntithetic)
+            {
+                v = (1 - v);
+            }
+            double r = inverse(v);
+            if (bound == 0 || r <= bound)
+            {
+                values[kept++] = r;
+            }
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(UniformRandomVariable);
 
 TypeId
@@ -212,6 +270,25 @@ UniformRandomVariable::GetValue()
     return GetValue(m_min, m_max);
 }
 
+void
+UniformRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    double min = m_min;
+    double max = m_max;
+    bool isAntithetic = IsAntithetic();
+    Peek()->RandU01(values, n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double v = min + values[i] * (max - min);
+        if (isAntithetic)
+        {
+            v = min + (max - v);
+        }
+        values[i] = v;
+    }
+}
+
 uint32_t
 UniformRandomVariable::GetInteger()
 {
@@ -270,6 +347,13 @@ ConstantRandomVariable::GetValue()
     return GetValue(m_constant);
 }
 
+void
+ConstantRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    std::fill(values, values + n, m_constant);
+}
+
 uint32_t
 ConstantRandomVariable::GetInteger()
 {
@@ -462,6 +546,16 @@ ExponentialRandomVariable::GetValue()
     return GetValue(m_mean, m_bound);
 }
 
+void
+ExponentialRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    double mean = m_mean;
+    GetBoundedValues(Peek(), IsAntithetic(), m_bound, values, n, [mean](double v) {
+        return -mean * std::log(v);
+    });
+}
+
 uint32_t
 ExponentialRandomVariable::GetInteger()
 {
@@ -568,6 +662,17 @@ ParetoRandomVariable::GetValue()
     return GetValue(m_scale, m_shape, m_bound);
 }
 
+void
+ParetoRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    double scale = m_scale;
+    double shape = m_shape;
+    GetBoundedValues(Peek(), IsAntithetic(), m_bound, values, n, [scale, shape](double v) {
+        return (scale * (1.0 / std::pow(v, 1.0 / shape)));
+    });
+}
+
 uint32_t
 ParetoRandomVariable::GetInteger()
 {
@@ -672,6 +777,17 @@ WeibullRandomVariable::GetValue()
     return GetValue(m_scale, m_shape, m_bound);
 }
 
+void
+WeibullRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    double scale = m_scale;
+    double exponent = 1.0 / m_shape;
+    GetBoundedValues(Peek(), IsAntithetic(), m_bound, values, n, [scale, exponent](double v) {
+        return scale * std::pow(-std::log(v), exponent);
+    });
+}
+
 uint32_t
 WeibullRandomVariable::GetInteger()
 {
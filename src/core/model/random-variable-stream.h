@@ -29,6 +29,7 @@
 #include "object.h"
 #include "type-id.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -154,6 +155,18 @@ class RandomVariableStream : public Object
      */
     virtual uint32_t GetInteger() = 0;
 
+    /**
+     * \brief Get the next random values as doubles drawn from the distribution.
+     *
+     * The values are the same as from \pname{n} calls to GetValue(); the
+     * distributions drawn by inversion override it to draw their uniform
+     * variates in one batch.
+     *
+     * \param [out] values The floating point random values.
+     * \param [in] n The number of values.
+     */
+    virtual void GetValues(double* values, std::size_t n);
+
   protected:
     /**
      * \brief Get the pointer to the underlying RngStream.
@@ -271,6 +284,13 @@ class UniformRandomVariable : public RandomVariableStream
      * \note The upper limit is excluded from the output range.
      */
     double GetValue() override;
+    /**
+     * \brief Get the next random values as doubles drawn from the distribution.
+     * \param [out] values The floating point random values.
+     * \param [in] n The number of values.
+     * \note The upper limit is excluded from the output range.
+     */
+    void GetValues(double* values, std::size_t n) override;
     /**
      * \brief Get the next random value as an integer drawn from the distribution.
      * \return  An integer random value.
@@ -334,6 +354,8 @@ class ConstantRandomVariable : public RandomVariableStream
     /* \note This RNG always returns the same value. */
     double GetValue() override;
     /* \note This RNG always returns the same value. */
+    void GetValues(double* values, std::size_t n) override;
+    /* \note This RNG always returns the same value. */
     uint32_t GetInteger() override;
 
   private:
@@ -565,6 +587,7 @@ class ExponentialRandomVariable : public RandomVariableStream
 
     // Inherited from RandomVariableStream
     double GetValue() override;
+    void GetValues(double* values, std::size_t n) override;
     uint32_t GetInteger() override;
 
   private:
@@ -742,6 +765,14 @@ class ParetoRandomVariable : public RandomVariableStream
      */
     double GetValue() override;
 
+    /**
+     * \brief Returns the next random doubles from a Pareto distribution with
+     * the current scale, shape, and upper bound, drawn as by GetValue().
+     * \param [out] values The floating point random values.
+     * \param [in] n The number of values.
+     */
+    void GetValues(double* values, std::size_t n) override;
+
     /**
      * \brief Returns a random unsigned integer from a Pareto distribution with the current mean,
      * shape, and upper bound.
@@ -955,6 +986,14 @@ class WeibullRandomVariable : public RandomVariableStream
      */
     double GetValue() override;
 
+    /**
+     * \brief Returns the next random doubles from a Weibull distribution with
+     * the current scale, shape, and upper bound, drawn as by GetValue().
+     * \param [out] values The floating point random values.
+     * \param [in] n The number of values.
+     */
+    void GetValues(double* values, std::size_t n) override;
+
     /**
      * \brief Returns a random unsigned integer from a Weibull distribution with the current scale,
      * shape, and upper bound.
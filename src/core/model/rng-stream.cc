@@ -24,6 +24,7 @@
 #include "fatal-error.h"
 #include "log.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -328,51 +329,73 @@ void PowerOfTwoMatrix (int n, Matrix a1p, Matrix a2p)
     }
 }
 
-} // namespace MRG32k3a
-
-// clang-format on
-
-namespace ns3
-{
-
-using namespace MRG32k3a;
-
-double
-RngStream::RandU01()
+/**
+ * Advance a state vector by one step and combine its components.
+ *
+ * \param [in,out] state The state vector.
+ * \returns The next random, uniform on [0,1).
+ */
+inline double
+Next(double state[6])
 {
     int32_t k;
     double p1;
     double p2;
-    double u;
 
     /* Component 1 */
-    p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
+    p1 = a12 * state[1] - a13n * state[0];
     k = static_cast<int32_t>(p1 / m1);
     p1 -= k * m1;
     if (p1 < 0.0)
     {
         p1 += m1;
     }
-    m_currentState[0] = m_currentState[1];
-    m_currentState[1] = m_currentState[2];
-    m_currentState[2] = p1;
+    state[0] = state[1];
+    state[1] = state[2];
+    state[2] = p1;
 
     /* Component 2 */
-    p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
+    p2 = a21 * state[5] - a23n * state[3];
     k = static_cast<int32_t>(p2 / m2);
     p2 -= k * m2;
     if (p2 < 0.0)
     {
         p2 += m2;
     }
-    m_currentState[3] = m_currentState[4];
-    m_currentState[4] = m_currentState[5];
-    m_currentState[5] = p2;
+    state[3] = state[4];
+    state[4] = state[5];
+    state[5] = p2;
 
     /* Combination */
-    u = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
+    return ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
+}
+
+} // namespace MRG32k3a
 
-    return u;
+// clang-format on
+
+namespace ns3
+{
+
+using namespace MRG32k3a;
+
+double
+RngStream::RandU01()
+{
+    return Next(m_currentState);
+}
+
+void
+RngStream::RandU01(double* values, std::size_t n)
+{
+    // a local copy of the state stays in registers across the loop
+    double state[6];
+    std::copy(m_currentState, m_currentState + 6, state);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        values[i] = Next(state);
+    }
+    std::copy(state, state + 6, m_currentState);
 }
 
 RngStream::RngStream(uint32_t seedNumber, uint64_t stream, uint64_t substream)
@@ -18,6 +18,7 @@
 
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
+#include <cstddef>
 #include <stdint.h>
 #include <string>
 
@@ -70,6 +71,14 @@ class RngStream
      * \returns The next random.
      */
     double RandU01();
+    /**
+     * Generate the next \pname{n} random numbers for this stream, the
+     * same as \pname{n} calls to RandU01().
+     *
+     * \param [out] values The randoms, uniformly distributed between 0 and 1.
+     * \param [in] n The number of randoms.
+     */
+    void RandU01(double* values, std::size_t n);
 
   private:
     /**
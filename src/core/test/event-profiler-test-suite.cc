@@ -0,0 +1,286 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/event-profiler.h"
+#include "ns3/make-event.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulator-tests
+ * EventProfiler test suite
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup simulator-tests
+ * Base class of the targets of the profiled events.
+ */
+class EventProfilerTestBase
+{
+  public:
+    virtual ~EventProfilerTestBase() = default;
+
+    /** A method overridden in the derived class. */
+    virtual void Fire()
+    {
+    }
+
+    /** A non virtual method. */
+    void Tick()
+    {
+    }
+};
+
+/**
+ * \ingroup simulator-tests
+ * Another base class, so that EventProfilerTestTarget has a non primary
+ * base.
+ */
+class EventProfilerTestOther
+{
+  public:
+    virtual ~EventProfilerTestOther() = default;
+
+    /** A method not overridden. */
+    virtual void Other()
+    {
+    }
+};
+
+/**
+ * \ingroup simulator-tests
+ * A class with a single base.
+ */
+class EventProfilerTestDerived : public EventProfilerTestBase
+{
+  public:
+    void Fire() override
+    {
+    }
+};
+
+/**
+ * \ingroup simulator-tests
+ * The target of the profiled events, whose EventProfilerTestBase methods
+ * are called through thunks.
+ */
+class EventProfilerTestTarget : public EventProfilerTestOther, public EventProfilerTestBase
+{
+  public:
+    void Fire() override
+    {
+    }
+};
+
+/** A function for function pointer events. */
+static void
+EventProfilerTestFunction()
+{
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the functions events are attributed to.
+ */
+class EventFunctionTestCase : public TestCase
+{
+  public:
+    EventFunctionTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Get the function of an event.
+     *
+     * \param [in] event The event, released on return.
+     * \returns The function.
+     */
+    static const void* GetFunction(EventImpl* event);
+};
+
+EventFunctionTestCase::EventFunctionTestCase()
+    : TestCase("Check the functions called by events")
+{
+}
+
+const void*
+EventFunctionTestCase::GetFunction(EventImpl* event)
+{
+    const void* function = event->GetFunction();
+    event->Unref();
+    return function;
+}
+
+void
+EventFunctionTestCase::DoRun()
+{
+    EventProfilerTestBase base;
+    EventProfilerTestDerived derived;
+    EventProfilerTestTarget target;
+
+    NS_TEST_ASSERT_MSG_EQ(GetFunction(MakeEvent(&EventProfilerTestFunction)),
+                          reinterpret_cast<const void*>(&EventProfilerTestFunction),
+                          "Wrong function pointer");
+    NS_TEST_ASSERT_MSG_NE(GetFunction(MakeEvent(&EventProfilerTestBase::Tick, &base)),
+                          nullptr,
+                          "Non virtual method not found");
+    NS_TEST_ASSERT_MSG_EQ(GetFunction(MakeEvent(&EventProfilerTestBase::Tick, &base)),
+                          GetFunction(MakeEvent(&EventProfilerTestBase::Tick, &derived)),
+                          "Non virtual method depends on the object");
+
+    const void* baseFire = GetFunction(MakeEvent(&EventProfilerTestBase::Fire, &base));
+    const void* derivedFire = GetFunction(MakeEvent(&EventProfilerTestBase::Fire, &derived));
+    NS_TEST_ASSERT_MSG_NE(baseFire, nullptr, "Virtual method not found");
+    NS_TEST_ASSERT_MSG_NE(baseFire, derivedFire, "Override not found");
+    NS_TEST_ASSERT_MSG_EQ(GetFunction(MakeEvent(&EventProfilerTestDerived::Fire, &derived)),
+                          derivedFire,
+                          "Override depends on the method pointer class");
+
+    // The override called through the non primary base is a thunk
+    const void* targetFire = GetFunction(MakeEvent(&EventProfilerTestBase::Fire, &target));
+    NS_TEST_ASSERT_MSG_NE(targetFire, nullptr, "Virtual method not found");
+    NS_TEST_ASSERT_MSG_NE(targetFire, baseFire, "Override not found");
+    NS_TEST_ASSERT_MSG_NE(GetFunction(MakeEvent(&EventProfilerTestTarget::Other, &target)),
+                          GetFunction(MakeEvent(&EventProfilerTestTarget::Fire, &target)),
+                          "Wrong virtual method of the primary base");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event profile written at Simulator::Destroy.
+ */
+class EventProfileTestCase : public TestCase
+{
+  public:
+    EventProfileTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Find the totals of a function in a profile.
+     *
+     * \param [in] profile The profile.
+     * \param [in] name A part of the function name.
+     * \param [out] count The number of events invoked.
+     * \param [out] cancelled The number of events cancelled.
+     * \returns \c true if the function was found.
+     */
+    static bool Find(const std::string& profile,
+                     const std::string& name,
+                     uint64_t& count,
+                     uint64_t& cancelled);
+};
+
+EventProfileTestCase::EventProfileTestCase()
+    : TestCase("Check the event profile")
+{
+}
+
+bool
+EventProfileTestCase::Find(const std::string& profile,
+                           const std::string& name,
+                           uint64_t& count,
+                           uint64_t& cancelled)
+{
+    std::istringstream is(profile);
+    std::string line;
+    // The totals by function end at the first blank line
+    while (std::getline(is, line) && !line.empty())
+    {
+        if (line.find(name) != std::string::npos)
+        {
+            double time;
+            double percent;
+            std::istringstream(line) >> time >> percent >> count >> cancelled;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+EventProfileTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("event-profile.txt");
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfile", StringValue(filename));
+
+    EventProfilerTestTarget target;
+    Simulator::Schedule(Seconds(1), &EventProfilerTestBase::Fire, &target);
+    Simulator::ScheduleWithContext(7, Seconds(2), &EventProfilerTestTarget::Fire, &target);
+    EventId cancelled = Simulator::Schedule(Seconds(3), &EventProfilerTestBase::Fire, &target);
+    EventId removed = Simulator::Schedule(Seconds(3), &EventProfilerTestBase::Fire, &target);
+    EventId labelled = Simulator::Schedule(Seconds(4), &EventProfilerTestBase::Fire, &target);
+    EventProfiler::SetLabel(labelled, "event-profiler-test-label");
+    Simulator::Schedule(Seconds(5), []() {});
+    cancelled.Cancel();
+    Simulator::Remove(removed);
+    Simulator::Run();
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfile", StringValue(""));
+
+    std::ifstream ifs(filename);
+    NS_TEST_ASSERT_MSG_EQ(ifs.good(), true, "No profile written");
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    std::string profile = oss.str();
+
+    uint64_t count = 0;
+    uint64_t nCancelled = 0;
+    NS_TEST_ASSERT_MSG_EQ(Find(profile, "EventProfilerTestTarget", count, nCancelled),
+                          true,
+                          "Method not in the profile");
+    NS_TEST_ASSERT_MSG_EQ(count, 2, "Wrong number of events invoked");
+    NS_TEST_ASSERT_MSG_EQ(nCancelled, 2, "Wrong number of events cancelled");
+    NS_TEST_ASSERT_MSG_EQ(Find(profile, "event-profiler-test-label", count, nCancelled),
+                          true,
+                          "Label not in the profile");
+    NS_TEST_ASSERT_MSG_EQ(count, 1, "Wrong number of labelled events");
+    NS_TEST_ASSERT_MSG_EQ(Find(profile, "lambda", count, nCancelled),
+                          true,
+                          "Lambda not in the profile");
+    NS_TEST_ASSERT_MSG_EQ(count, 1, "Wrong number of lambda events");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief The EventProfiler TestSuite.
+ */
+class EventProfilerTestSuite : public TestSuite
+{
+  public:
+    EventProfilerTestSuite()
+        : TestSuite("event-profiler", UNIT)
+    {
+        AddTestCase(new EventFunctionTestCase, TestCase::QUICK);
+        AddTestCase(new EventProfileTestCase, TestCase::QUICK);
+    }
+};
+
+static EventProfilerTestSuite g_eventProfilerTestSuite; //!< Static variable for test initialization
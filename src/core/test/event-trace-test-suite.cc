@@ -0,0 +1,280 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/event-trace.h"
+#include "ns3/make-event.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator-tests
+ * Event trace test suite
+ */
+
+using namespace ns3;
+
+/** A function for the traced events. */
+static void
+EventTraceTestFunction()
+{
+}
+
+/** Another function for the traced events, with another callback type. */
+static void
+EventTraceTestOther(int)
+{
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that EventTraceReader reads back the records written by
+ * EventTraceWriter.
+ */
+class EventTraceRoundTripTestCase : public TestCase
+{
+  public:
+    EventTraceRoundTripTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+EventTraceRoundTripTestCase::EventTraceRoundTripTestCase()
+    : TestCase("Check the records read back from an event trace")
+{
+}
+
+void
+EventTraceRoundTripTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("event-trace.bin");
+    EventImpl* function = MakeEvent(&EventTraceTestFunction);
+    EventImpl* other = MakeEvent(&EventTraceTestOther, 1);
+
+    // enough records to flush the write buffer several times, with times,
+    // uids and contexts spanning their whole ranges
+    std::vector<EventTraceReader::Record> expected;
+    uint64_t now = 0;
+    for (uint32_t i = 0; i < 50000; i++)
+    {
+        EventTraceReader::Record record;
+        record.insert = i % 5 != 4;
+        record.now = now;
+        record.event.impl = nullptr;
+        if (record.insert)
+        {
+            record.event.key.m_ts = now + (i % 7 == 0 ? 0 : (uint64_t(1) << (i % 64)) - 1);
+            record.event.key.m_uid = 4 + i;
+            record.event.key.m_context = i % 3 == 0 ? Simulator::NO_CONTEXT : i;
+            record.parent = i % 2 ? 4 + i / 2 : 0;
+            record.type = i % 3 == 1 ? 1 : 0;
+        }
+        else
+        {
+            record.event.key.m_ts = now + 1000;
+            record.event.key.m_uid = i / 2;
+            record.event.key.m_context = 0;
+            record.parent = 0;
+            record.type = 0;
+        }
+        expected.push_back(record);
+        now += i % 11;
+    }
+
+    EventTraceWriter writer;
+    NS_TEST_ASSERT_MSG_EQ(writer.Open(filename), true, "Cannot create " << filename);
+    NS_TEST_ASSERT_MSG_EQ(writer.IsOpen(), true, "Trace not open");
+    for (const auto& record : expected)
+    {
+        Scheduler::Event ev = record.event;
+        if (record.insert)
+        {
+            ev.impl = record.type == 0 ? function : other;
+            writer.RecordInsert(record.now, ev, record.parent);
+        }
+        else
+        {
+            writer.RecordRemove(record.now, ev);
+        }
+    }
+    writer.Close();
+    NS_TEST_ASSERT_MSG_EQ(writer.IsOpen(), false, "Trace still open");
+    NS_TEST_ASSERT_MSG_EQ(writer.Fail(), false, "Write failed");
+
+    EventTraceReader reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Open(filename), true, "Cannot read " << filename);
+    EventTraceReader::Record record;
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Trace ends at record " << i);
+        NS_TEST_ASSERT_MSG_EQ(record.insert, expected[i].insert, "Wrong kind of record " << i);
+        NS_TEST_ASSERT_MSG_EQ(record.now, expected[i].now, "Wrong time of record " << i);
+        NS_TEST_ASSERT_MSG_EQ(record.event.key.m_ts,
+                              expected[i].event.key.m_ts,
+                              "Wrong time stamp of record " << i);
+        NS_TEST_ASSERT_MSG_EQ(record.event.key.m_uid,
+                              expected[i].event.key.m_uid,
+                              "Wrong uid of record " << i);
+        NS_TEST_ASSERT_MSG_EQ(record.event.key.m_context,
+                              expected[i].event.key.m_context,
+                              "Wrong context of record " << i);
+        NS_TEST_ASSERT_MSG_EQ(record.parent, expected[i].parent, "Wrong parent of record " << i);
+        NS_TEST_ASSERT_MSG_EQ(record.type, expected[i].type, "Wrong type of record " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), false, "Records past the end of the trace");
+
+    const std::vector<std::string>& names = reader.GetTypeNames();
+    NS_TEST_ASSERT_MSG_EQ(names.size(), 2, "Wrong number of callback types");
+    NS_TEST_ASSERT_MSG_EQ(names[0], typeid(*function).name(), "Wrong name of the first type");
+    NS_TEST_ASSERT_MSG_EQ(names[1], typeid(*other).name(), "Wrong name of the second type");
+
+    function->Unref();
+    other->Unref();
+    std::remove(filename.c_str());
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event trace written by the simulator.
+ */
+class EventTraceSimulatorTestCase : public TestCase
+{
+  public:
+    EventTraceSimulatorTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+EventTraceSimulatorTestCase::EventTraceSimulatorTestCase()
+    : TestCase("Check the event trace of a simulation")
+{
+}
+
+void
+EventTraceSimulatorTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("event-trace-simulator.bin");
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventTrace", StringValue(filename));
+
+    Simulator::Schedule(Seconds(1), &EventTraceTestFunction);
+    Simulator::ScheduleWithContext(7, Seconds(2), &EventTraceTestOther, 2);
+    EventId removed = Simulator::Schedule(Seconds(3), &EventTraceTestFunction);
+    Simulator::Remove(removed);
+    Simulator::Run();
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventTrace", StringValue(""));
+
+    EventTraceReader reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Open(filename), true, "Cannot read " << filename);
+    uint32_t inserts = 0;
+    uint32_t removes = 0;
+    bool contextFound = false;
+    EventTraceReader::Record record;
+    while (reader.Read(record))
+    {
+        if (record.insert)
+        {
+            inserts++;
+            contextFound = contextFound || record.event.key.m_context == 7;
+        }
+        else
+        {
+            removes++;
+            NS_TEST_ASSERT_MSG_EQ(record.event.key.m_uid,
+                                  removed.GetUid(),
+                                  "Wrong uid of the removed event");
+            NS_TEST_ASSERT_MSG_EQ(record.event.key.m_ts,
+                                  static_cast<uint64_t>(Seconds(3).GetTimeStep()),
+                                  "Wrong time stamp of the removed event");
+        }
+    }
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(inserts, 3, "Inserts missing from the trace");
+    NS_TEST_ASSERT_MSG_EQ(removes, 1, "Wrong number of removes");
+    NS_TEST_ASSERT_MSG_EQ(contextFound, true, "Context not in the trace");
+    std::remove(filename.c_str());
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that a write error is reported by EventTraceWriter::Fail.
+ */
+class EventTraceFailTestCase : public TestCase
+{
+  public:
+    EventTraceFailTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+EventTraceFailTestCase::EventTraceFailTestCase()
+    : TestCase("Check the report of event trace write errors")
+{
+}
+
+void
+EventTraceFailTestCase::DoRun()
+{
+    EventTraceWriter writer;
+    // /dev/full accepts the file creation and fails every write
+    if (!writer.Open("/dev/full"))
+    {
+        return;
+    }
+    EventImpl* function = MakeEvent(&EventTraceTestFunction);
+    Scheduler::Event ev;
+    ev.impl = function;
+    ev.key.m_context = 0;
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        ev.key.m_ts = i;
+        ev.key.m_uid = i + 4;
+        writer.RecordInsert(i, ev, 0);
+    }
+    writer.Close();
+    NS_TEST_ASSERT_MSG_EQ(writer.Fail(), true, "Write error not reported");
+    function->Unref();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief The event trace TestSuite.
+ */
+class EventTraceTestSuite : public TestSuite
+{
+  public:
+    EventTraceTestSuite()
+        : TestSuite("event-trace", UNIT)
+    {
+        AddTestCase(new EventTraceRoundTripTestCase, TestCase::QUICK);
+        AddTestCase(new EventTraceSimulatorTestCase, TestCase::QUICK);
+        AddTestCase(new EventTraceFailTestCase, TestCase::QUICK);
+    }
+};
+
+static EventTraceTestSuite g_eventTraceTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,153 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator-tests
+ * LadderScheduler test suite
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the LadderScheduler against the MapScheduler with random
+ * inserts and removals, so that events move through the top, new rungs
+ * and the bottom.
+ */
+class LadderSchedulerTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] name The name of the delay distribution.
+     * \param [in] delay The distribution of the delays of new events, in ns.
+     */
+    LadderSchedulerTestCase(std::string name, Ptr<RandomVariableStream> delay);
+
+  private:
+    void DoRun() override;
+
+    Ptr<RandomVariableStream> m_delay; //!< The delays of new events.
+};
+
+LadderSchedulerTestCase::LadderSchedulerTestCase(std::string name,
+                                                 Ptr<RandomVariableStream> delay)
+    : TestCase("Check the ladder queue order with " + name + " delays"),
+      m_delay(delay)
+{
+}
+
+void
+LadderSchedulerTestCase::DoRun()
+{
+    Ptr<LadderScheduler> ladder = CreateObject<LadderScheduler>();
+    Ptr<MapScheduler> map = CreateObject<MapScheduler>();
+    Ptr<UniformRandomVariable> op = CreateObject<UniformRandomVariable>();
+    std::vector<Scheduler::Event> events; // indexed by uid
+    std::vector<bool> done;               // whether removed, indexed by uid
+    uint64_t now = 0;
+    uint32_t uid = 0;
+
+    for (uint32_t i = 0; i < 50000; i++)
+    {
+        uint32_t choice = op->GetInteger(0, 99);
+        if (choice < 55 || map->IsEmpty())
+        {
+            Scheduler::Event ev;
+            ev.impl = nullptr;
+            ev.key.m_ts = now + static_cast<uint64_t>(m_delay->GetValue());
+            ev.key.m_uid = uid++;
+            ev.key.m_context = 0;
+            ladder->Insert(ev);
+            map->Insert(ev);
+            events.push_back(ev);
+            done.push_back(false);
+        }
+        else if (choice < 95)
+        {
+            Scheduler::Event expected = map->RemoveNext();
+            Scheduler::Event next = ladder->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(next.key.m_uid, expected.key.m_uid, "Wrong next event");
+            now = next.key.m_ts;
+            done[next.key.m_uid] = true;
+        }
+        else
+        {
+            // remove a random event, if it is still scheduled
+            Scheduler::Event ev = events[op->GetInteger(0, events.size() - 1)];
+            if (!done[ev.key.m_uid])
+            {
+                map->Remove(ev);
+                ladder->Remove(ev);
+                done[ev.key.m_uid] = true;
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), map->IsEmpty(), "Wrong queue size");
+        if (!map->IsEmpty())
+        {
+            NS_TEST_ASSERT_MSG_EQ(ladder->PeekNext().key.m_uid,
+                                  map->PeekNext().key.m_uid,
+                                  "Wrong head of the queue");
+        }
+    }
+    while (!map->IsEmpty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(ladder->RemoveNext().key.m_uid,
+                              map->RemoveNext().key.m_uid,
+                              "Wrong next event while draining");
+    }
+    NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), true, "Queue not empty after draining");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief The LadderScheduler TestSuite.
+ */
+class LadderSchedulerTestSuite : public TestSuite
+{
+  public:
+    LadderSchedulerTestSuite()
+        : TestSuite("ladder-scheduler", UNIT)
+    {
+        Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable>();
+        uniform->SetAttribute("Min", DoubleValue(0));
+        uniform->SetAttribute("Max", DoubleValue(200));
+        AddTestCase(new LadderSchedulerTestCase("uniform", uniform), TestCase::QUICK);
+
+        // simultaneous events, timers and a few long timeouts
+        Ptr<EmpiricalRandomVariable> timers = CreateObject<EmpiricalRandomVariable>();
+        timers->SetInterpolate(false);
+        timers->CDF(0, 0.3);
+        timers->CDF(10000, 0.7);
+        timers->CDF(1000000, 0.9);
+        timers->CDF(1000000000, 1.0);
+        AddTestCase(new LadderSchedulerTestCase("timer", timers), TestCase::QUICK);
+    }
+};
+
+static LadderSchedulerTestSuite g_ladderSchedulerTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,346 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/binary-log-sink.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging-tests
+ * Log floor and BinaryLogSink test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup logging-tests Logging tests
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+NS_LOG_COMPONENT_DEFINE("LogTestSuite");
+
+/**
+ * \ingroup logging-tests
+ * A type streamed by its own operator<<.
+ */
+struct LogTestPoint
+{
+    int x; //!< The abscissa.
+    int y; //!< The ordinate.
+};
+
+/**
+ * \param [in] os The output stream.
+ * \param [in] p The point.
+ * \returns The output stream.
+ */
+std::ostream&
+operator<<(std::ostream& os, const LogTestPoint& p)
+{
+    return os << "(" << p.x << ", " << p.y << ")";
+}
+
+/**
+ * \ingroup logging-tests
+ * A type whose operator<< logs a message.
+ */
+struct LogTestNested
+{
+};
+
+/**
+ * \param [in] os The output stream.
+ * \returns The output stream.
+ */
+std::ostream&
+operator<<(std::ostream& os, const LogTestNested&)
+{
+    NS_LOG_INFO("nested");
+    return os << "outer";
+}
+
+/**
+ * \ingroup logging-tests
+ * An enumeration, streamed as an integer.
+ */
+enum LogTestColor
+{
+    RED,  //!< Red.
+    GREEN //!< Green.
+};
+
+/**
+ * \ingroup logging-tests
+ * An object logging its member functions.
+ */
+class LogTestObject
+{
+  public:
+    /**
+     * Log messages of every level, with values of every type.
+     *
+     * \param [in] name A string.
+     */
+    void Log(const std::string& name)
+    {
+        static int target;
+        const char* cstring = "cstring";
+        char buffer[8] = "buffer";
+        int8_t i8 = 66;
+        uint8_t u8 = 65;
+        std::vector<int> vector{1, 2};
+        LogTestPoint point{3, 4};
+
+        NS_LOG_FUNCTION(this << name << 42 << i8 << u8 << "literal" << vector);
+        NS_LOG_DEBUG("int " << -42 << " unsigned " << 42U << " long " << 1234567890123LL
+                            << " double " << 3.14159265 << " float " << 0.1F);
+        NS_LOG_INFO("bool " << true << " char " << 'x' << " uint8 " << u8 << " int8 " << i8);
+        NS_LOG_LOGIC("string " << name << " cstring " << cstring << " buffer " << buffer);
+        NS_LOG_WARN("time " << Seconds(1.5) << " now " << Simulator::Now().GetSeconds()
+                            << " pointer " << &target << " null "
+                            << static_cast<void*>(nullptr));
+        NS_LOG_ERROR("hex " << std::hex << 255 << " width " << std::setw(6) << 7 << " precision "
+                            << std::setprecision(3) << 3.14159 << " point "
+                            << point << " enum " << GREEN << std::dec << std::setprecision(6));
+        NS_LOG_DEBUG("point " << point << " then " << 5 << " "
+                              << (name.empty() ? "empty" : "named"));
+    }
+
+    /** Log the function only. */
+    static void LogStatic()
+    {
+        NS_LOG_FUNCTION_NOARGS();
+    }
+};
+
+/// A log component with a floor
+namespace floored
+{
+
+NS_LOG_COMPONENT_DEFINE_FLOOR("LogFloorTest", ns3::LOG_DEBUG);
+
+/** Log a message of every level. */
+void
+LogLevels()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    NS_LOG_ERROR("error");
+    NS_LOG_WARN("warn");
+    NS_LOG_DEBUG("debug");
+    NS_LOG_INFO("info");
+    NS_LOG_LOGIC("logic");
+}
+
+} // namespace floored
+
+/**
+ * \ingroup logging-tests
+ * Check that the statements below the floor of a component are not
+ * compiled.
+ */
+class LogFloorTestCase : public TestCase
+{
+  public:
+    LogFloorTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+LogFloorTestCase::LogFloorTestCase()
+    : TestCase("Check the log levels compiled below the floor of a component")
+{
+}
+
+void
+LogFloorTestCase::DoRun()
+{
+    static_assert(LogComponent::FLOOR == NS3_LOG_FLOOR, "Wrong default floor");
+    static_assert(LogComponentWithFloor<LOG_DEBUG>::FLOOR == LOG_DEBUG, "Wrong floor");
+
+    LogComponentEnable("LogFloorTest", LOG_LEVEL_ALL);
+    std::ostringstream output;
+    std::streambuf* clog = std::clog.rdbuf(output.rdbuf());
+    floored::LogLevels();
+    std::clog.rdbuf(clog);
+    LogComponentDisable("LogFloorTest", LOG_LEVEL_ALL);
+
+    NS_TEST_ASSERT_MSG_EQ(output.str(), "error\nwarn\ndebug\n", "Wrong levels compiled");
+}
+
+/**
+ * \ingroup logging-tests
+ * Check that the messages recorded by the BinaryLogSink render as NS_LOG
+ * prints them.
+ */
+class BinaryLogRenderTestCase : public TestCase
+{
+  public:
+    BinaryLogRenderTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Log messages in a simulation, with and without context.
+     */
+    void Simulate();
+};
+
+BinaryLogRenderTestCase::BinaryLogRenderTestCase()
+    : TestCase("Check that the binary log renders as NS_LOG prints")
+{
+}
+
+void
+BinaryLogRenderTestCase::Simulate()
+{
+    static LogTestObject object;
+    Simulator::ScheduleWithContext(3, Seconds(1.25), &LogTestObject::Log, &object, "node");
+    Simulator::Schedule(Seconds(2), &LogTestObject::Log, &object, "");
+    Simulator::Schedule(Seconds(3), &LogTestObject::LogStatic);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+BinaryLogRenderTestCase::DoRun()
+{
+    LogComponentEnable("LogTestSuite", LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+
+    std::ostringstream expected;
+    std::streambuf* clog = std::clog.rdbuf(expected.rdbuf());
+    Simulate();
+
+    std::ostringstream printed;
+    std::clog.rdbuf(printed.rdbuf());
+    BinaryLogSink::Enable(1 << 20);
+    Simulate();
+    BinaryLogSink::Disable();
+    std::clog.rdbuf(clog);
+    LogComponentDisable("LogTestSuite", LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+
+    NS_TEST_ASSERT_MSG_EQ(printed.str(), "", "Messages printed while recording");
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::GetRecordCount(), 15, "Wrong number of records");
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::GetLostCount(), 0, "Records lost");
+
+    std::string filename = CreateTempDirFilename("binary-log.nslog");
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::Write(filename), true, "Cannot write the records");
+    std::ostringstream rendered;
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::Render(filename, rendered),
+                          true,
+                          "Cannot render the records");
+    NS_TEST_ASSERT_MSG_EQ(rendered.str(), expected.str(), "Wrong rendering");
+}
+
+/**
+ * \ingroup logging-tests
+ * Check that the ring buffer keeps the latest records, and the messages
+ * logged while formatting a message.
+ */
+class BinaryLogRingTestCase : public TestCase
+{
+  public:
+    BinaryLogRingTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BinaryLogRingTestCase::BinaryLogRingTestCase()
+    : TestCase("Check the ring buffer of the binary log")
+{
+}
+
+void
+BinaryLogRingTestCase::DoRun()
+{
+    LogComponentEnable("LogTestSuite", LOG_LEVEL_ALL);
+    BinaryLogSink::Enable(4096);
+    for (int i = 0; i < 1000; i++)
+    {
+        NS_LOG_DEBUG("message " << i);
+    }
+    NS_LOG_DEBUG(std::string(3000, 'x'));
+    BinaryLogSink::Disable();
+
+    uint64_t count = BinaryLogSink::GetRecordCount();
+    NS_TEST_ASSERT_MSG_GT(count, 0, "No record kept");
+    NS_TEST_ASSERT_MSG_LT(count, 1000, "No record overwritten");
+    NS_TEST_ASSERT_MSG_EQ(count + BinaryLogSink::GetLostCount(),
+                          1001,
+                          "Records neither kept nor lost");
+
+    std::string filename = CreateTempDirFilename("binary-log-ring.nslog");
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::Write(filename), true, "Cannot write the records");
+    std::ostringstream rendered;
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::Render(filename, rendered),
+                          true,
+                          "Cannot render the records");
+    std::ostringstream expected;
+    for (uint64_t i = 1000 - count; i < 1000; i++)
+    {
+        expected << "message " << i << "\n";
+    }
+    NS_TEST_ASSERT_MSG_EQ(rendered.str(), expected.str(), "Wrong records kept");
+
+    // the message logged while formatting comes first
+    BinaryLogSink::Enable(4096);
+    NS_LOG_DEBUG("with " << LogTestNested() << " " << 1);
+    BinaryLogSink::Disable();
+    LogComponentDisable("LogTestSuite", LOG_LEVEL_ALL);
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::Write(filename), true, "Cannot write the records");
+    rendered.str("");
+    NS_TEST_ASSERT_MSG_EQ(BinaryLogSink::Render(filename, rendered),
+                          true,
+                          "Cannot render the records");
+    NS_TEST_ASSERT_MSG_EQ(rendered.str(), "nested\nwith outer 1\n", "Wrong nested records");
+}
+
+/**
+ * \ingroup logging-tests
+ * The log TestSuite.
+ */
+class LogTestSuite : public TestSuite
+{
+  public:
+    LogTestSuite()
+        : TestSuite("log", UNIT)
+    {
+#ifdef NS3_LOG_ENABLE
+        AddTestCase(new LogFloorTestCase, TestCase::QUICK);
+        AddTestCase(new BinaryLogRenderTestCase, TestCase::QUICK);
+        AddTestCase(new BinaryLogRingTestCase, TestCase::QUICK);
+#endif
+    }
+};
+
+static LogTestSuite g_logTestSuite; //!< Static variable for test initialization
+
+} // namespace tests
+
+} // namespace ns3
@@ -24,6 +24,7 @@
 #include "ns3/double.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
+#include "ns3/object-factory.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/string.h"
@@ -35,6 +36,7 @@
 #include <gsl/gsl_cdf.h>
 #include <gsl/gsl_histogram.h>
 #include <gsl/gsl_sf_zeta.h>
+#include <vector>
 
 using namespace ns3;
 
@@ -2565,6 +2567,93 @@ NormalCachingTestCase::DoRun()
     NS_TEST_ASSERT_MSG_GT(v2, 0, "Incorrect value returned, expected > 0");
 }
 
+/**
+ * \ingroup rng-tests
+ * Test case for drawing random values in batches
+ */
+class GetValuesTestCase : public TestCaseBase
+{
+  public:
+    // Constructor
+    GetValuesTestCase();
+
+  private:
+    // Inherited
+    void DoRun() override;
+
+    /**
+     * Check that the values drawn in batches are the values drawn one by
+     * one, bit for bit.
+     *
+     * \param [in] factory The factory of the random variable stream.
+     */
+    void CheckValues(const ObjectFactory& factory);
+};
+
+GetValuesTestCase::GetValuesTestCase()
+    : TestCaseBase("RandomVariableStream values drawn in batches")
+{
+}
+
+void
+GetValuesTestCase::CheckValues(const ObjectFactory& factory)
+{
+    Ptr<RandomVariableStream> single = factory.Create<RandomVariableStream>();
+    Ptr<RandomVariableStream> batched = factory.Create<RandomVariableStream>();
+    single->SetStream(42);
+    batched->SetStream(42);
+
+    std::string name = factory.GetTypeId().GetName();
+    std::vector<double> values(10000);
+    for (std::size_t n : {std::size_t(1), std::size_t(7), std::size_t(0), values.size()})
+    {
+        batched->GetValues(values.data(), n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(values[i], single->GetValue(), "Wrong " << name << " value");
+        }
+        // the next value follows the batch
+        NS_TEST_ASSERT_MSG_EQ(batched->GetValue(), single->GetValue(), "Wrong " << name << " value");
+    }
+}
+
+void
+GetValuesTestCase::DoRun()
+{
+    NS_LOG_FUNCTION(this);
+    SetTestSuiteSeed();
+
+    ObjectFactory factory("ns3::UniformRandomVariable");
+    factory.Set("Min", DoubleValue(2), "Max", DoubleValue(5));
+    CheckValues(factory);
+    factory.Set("Antithetic", BooleanValue(true));
+    CheckValues(factory);
+
+    factory = ObjectFactory("ns3::ConstantRandomVariable");
+    factory.Set("Constant", DoubleValue(7));
+    CheckValues(factory);
+
+    // the bounds reject some of the values
+    factory = ObjectFactory("ns3::ExponentialRandomVariable");
+    factory.Set("Mean", DoubleValue(1), "Bound", DoubleValue(1.5));
+    CheckValues(factory);
+    factory.Set("Antithetic", BooleanValue(true));
+    CheckValues(factory);
+
+    factory = ObjectFactory("ns3::ParetoRandomVariable");
+    factory.Set("Scale", DoubleValue(1), "Shape", DoubleValue(2), "Bound", DoubleValue(3));
+    CheckValues(factory);
+
+    factory = ObjectFactory("ns3::WeibullRandomVariable");
+    factory.Set("Scale", DoubleValue(1), "Shape", DoubleValue(2), "Bound", DoubleValue(1.5));
+    CheckValues(factory);
+
+    // drawn by GetValue()
+    factory = ObjectFactory("ns3::NormalRandomVariable");
+    factory.Set("Mean", DoubleValue(0), "Variance", DoubleValue(1));
+    CheckValues(factory);
+}
+
 /**
  * \ingroup rng-tests
  * RandomVariableStream test suite, covering all random number variable
@@ -2617,6 +2706,7 @@ RandomVariableSuite::RandomVariableSuite()
     AddTestCase(new EmpiricalAntitheticTestCase);
     /// Issue #302:  NormalRandomVariable produces stale values
     AddTestCase(new NormalCachingTestCase);
+    AddTestCase(new GetValuesTestCase);
 }
 
 static RandomVariableSuite randomVariableSuite; //!< Static variable for test initialization
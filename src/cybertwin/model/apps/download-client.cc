@@ -2,7 +2,7 @@
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("DownloadClient");
+NS_LOG_COMPONENT_DEFINE_FLOOR("DownloadClient", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(DownloadClient);
 
 #define SECURITY_ENABLED 0
@@ -325,6 +325,10 @@ DownloadStream::Activate()
         m_socket = Socket::CreateSocket(m_node, TcpSocketFactory::GetTypeId());
         m_socket->Bind();
         m_socket->Connect(InetSocketAddress(m_cybertwinAddress, m_cybertwinPort));
+        SendCybertwinDemuxHeader(m_socket,
+                                 m_cybertwinPort,
+                                 CybertwinDemuxHeader::CYBERTWIN_DEMUX_LOCAL,
+                                 DynamicCast<CybertwinEndHost>(m_node)->GetCybertwinId());
         m_socket->SetConnectCallback(MakeCallback(&DownloadStream::ConnectionSucceeded, this),
                                      MakeCallback(&DownloadStream::ConnectionFailed, this));
         NS_LOG_DEBUG("[DownloadStream] Connecting to " << m_targetID);
@@ -2,7 +2,7 @@
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("DownloadServer");
+NS_LOG_COMPONENT_DEFINE_FLOOR("DownloadServer", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(DownloadServer);
 
 TypeId
@@ -100,6 +100,7 @@ DownloadServer::StartApplication()
     {
         NS_FATAL_ERROR("Unknown traffic pattern.");
     }
+    m_interval.SetStream(m_rand);
 
     // CNRS Insertion
     Ptr<CybertwinNode> node = DynamicCast<CybertwinNode>(GetNode());
@@ -210,7 +211,7 @@ DownloadServer::BulkSend(Ptr<Socket> socket)
                      << m_sendBytes[socket] / (1024 * 1024) << " MBytes");
     }
 
-    m_sendEvent = Simulator::Schedule(Seconds(m_rand->GetValue()), &DownloadServer::BulkSend, this, socket);
+    m_sendEvent = Simulator::Schedule(Seconds(m_interval.GetValue()), &DownloadServer::BulkSend, this, socket);
 }
 
 void
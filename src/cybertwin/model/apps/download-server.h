@@ -49,6 +49,7 @@ class DownloadServer: public Application
     Time m_duration;
 
     Ptr<RandomVariableStream> m_rand;
+    PrefetchedRandomVariable m_interval; // draws m_rand
     EventId m_sendEvent;
 };
 } // namespace ns3
@@ -1,9 +1,10 @@
 #include "ns3/end-host-bulk-send.h"
+#include "ns3/cybertwin-header.h"
 #include "ns3/random-variable-stream.h"
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("EndHostBulkSend");
+NS_LOG_COMPONENT_DEFINE_FLOOR("EndHostBulkSend", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(EndHostBulkSend);
 
 EndHostBulkSend::EndHostBulkSend()
@@ -97,7 +98,7 @@ EndHostBulkSend::InitRandomVariableStream()
     default:
         break;
     }
-
+    m_interArrivalTime.SetStream(m_randomVariableStream);
 }
 
 void
@@ -141,6 +142,10 @@ EndHostBulkSend::ConnectCybertwin()
                 MakeCallback(&EndHostBulkSend::ConnectionNormalClosed, this),
                 MakeCallback(&EndHostBulkSend::ConnectionErrorClosed, this));
             m_socket->Connect(InetSocketAddress(m_cybertwinAddr, m_cybertwinPort));
+            SendCybertwinDemuxHeader(m_socket,
+                                     m_cybertwinPort,
+                                     CybertwinDemuxHeader::CYBERTWIN_DEMUX_LOCAL,
+                                     host->GetCybertwinId());
         }
     }
 }
@@ -272,7 +277,7 @@ EndHostBulkSend::SendData()
     }
 
     // schedule next send
-    double interArrivalTime = m_randomVariableStream->GetValue();
+    double interArrivalTime = m_interArrivalTime.GetValue();
     Simulator::Schedule(MicroSeconds(interArrivalTime), &EndHostBulkSend::SendData, this);
 }
 
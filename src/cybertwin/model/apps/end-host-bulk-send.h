@@ -68,6 +68,7 @@ class EndHostBulkSend : public CybertwinApp
 
     TrafficPattern m_trafficPattern;
     Ptr<RandomVariableStream> m_randomVariableStream;
+    PrefetchedRandomVariable m_interArrivalTime; // draws m_randomVariableStream
 
 };
     
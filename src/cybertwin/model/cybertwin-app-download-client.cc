@@ -3,7 +3,7 @@
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("CybertwinAppDownloadClient");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinAppDownloadClient", CYBERTWIN_LOG_FLOOR);
 
 NS_OBJECT_ENSURE_REGISTERED(CybertwinAppDownloadClient);
 
@@ -18,11 +18,17 @@ CybertwinAppDownloadClient::GetTypeId()
                                           "The target cybertwin id.",
                                           UintegerValue(0),
                                           MakeUintegerAccessor(&CybertwinAppDownloadClient::m_targetCybertwinId),
-                                          MakeUintegerChecker<uint64_t>());
+                                          MakeUintegerChecker<uint64_t>())
+                            .AddTraceSource("Rx",
+                                            "A packet has been received",
+                                            MakeTraceSourceAccessor(&CybertwinAppDownloadClient::m_rxTrace),
+                                            "ns3::Packet::AddressTracedCallback");
     return tid;
 }
 
 CybertwinAppDownloadClient::CybertwinAppDownloadClient()
+    : m_finished(false),
+      m_totalRx(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -32,6 +38,18 @@ CybertwinAppDownloadClient::~CybertwinAppDownloadClient()
     NS_LOG_FUNCTION(this);
 }
 
+bool
+CybertwinAppDownloadClient::IsFinished() const
+{
+    return m_finished;
+}
+
+uint64_t
+CybertwinAppDownloadClient::GetTotalRx() const
+{
+    return m_totalRx;
+}
+
 void
 CybertwinAppDownloadClient::StartApplication()
 {
@@ -100,6 +118,13 @@ CybertwinAppDownloadClient::ConnectSucceededCallback(Ptr<Socket> socket)
     NS_LOG_DEBUG("[" << m_nodeName << "][download-client] Connect to Cybertwin Manager succeeded.");
     socket->SetRecvCallback(MakeCallback(&CybertwinAppDownloadClient::RecvCallback, this));
 
+    // name our cybertwin once per connection, if it sits behind the shared listener
+    Ptr<CybertwinEndHost> endHost = DynamicCast<CybertwinEndHost>(GetNode());
+    SendCybertwinDemuxHeader(socket,
+                             m_cybertwinPort,
+                             CybertwinDemuxHeader::CYBERTWIN_DEMUX_LOCAL,
+                             endHost->GetCybertwinId());
+
     // Send Download Request
     SendDownloadRequest(socket);
 }
@@ -116,6 +141,7 @@ CybertwinAppDownloadClient::NormalCloseCallback(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("[" << m_nodeName << "][download-client] Normal close.");
+    m_finished = true;
 }
 
 void
@@ -123,6 +149,7 @@ CybertwinAppDownloadClient::ErrorCloseCallback(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("[" << m_nodeName << "][download-client] Error close.");
+    m_finished = true;
 }
 
 void
@@ -137,6 +164,8 @@ CybertwinAppDownloadClient::RecvCallback(Ptr<Socket> socket)
     while ((packet = socket->RecvFrom(from)))
     {
         NS_LOG_DEBUG("[" << m_nodeName << "][download-client] Received packet from " << InetSocketAddress::ConvertFrom(from).GetIpv4() << " : " << InetSocketAddress::ConvertFrom(from).GetPort());
+        m_totalRx += packet->GetSize();
+        m_rxTrace(packet, from);
     }
 }
 
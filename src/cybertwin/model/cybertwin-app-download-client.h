@@ -20,6 +20,10 @@ class CybertwinAppDownloadClient : public Application
     CybertwinAppDownloadClient();
     ~CybertwinAppDownloadClient();
 
+    // the download is over once the connection to the cybertwin is closed
+    bool IsFinished() const;
+    uint64_t GetTotalRx() const;
+
   private:
     void StartApplication();
     void StopApplication();
@@ -42,6 +46,10 @@ class CybertwinAppDownloadClient : public Application
 
     CYBERTWINID_t m_targetCybertwinId;
     CYBERTWINID_t m_selfCybertwinId;
+
+    bool m_finished;
+    uint64_t m_totalRx;
+    TracedCallback<Ptr<const Packet>, const Address&> m_rxTrace;
 };
 
 } // namespace ns3
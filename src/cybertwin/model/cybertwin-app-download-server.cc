@@ -2,7 +2,7 @@
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("CybertwinAppDownloadServer");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinAppDownloadServer", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinAppDownloadServer);
 
 TypeId
@@ -9,7 +9,7 @@
 namespace ns3
 {
 
-NS_LOG_COMPONENT_DEFINE("CybertwinClient");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinClient", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinClient);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinConnClient);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinBulkClient);
@@ -21,7 +21,13 @@ namespace ns3
 //*****************************************************************
 //1: enable MDTP, 0: disable MDTP
 #define MDTP_ENABLED 0
+//1: MDTP subflows over UDP datagrams by default, 0: over TCP
+#define MDTP_DATAGRAM_SUBFLOW_ENABLED 0
 #define STATISTIC_TIME_INTERVAL (10) // ms
+//least severe log level compiled in the data path, e.g. ns3::LOG_WARN
+#ifndef CYBERTWIN_LOG_FLOOR
+#define CYBERTWIN_LOG_FLOOR NS3_LOG_FLOOR
+#endif
 
 #define MAX_SIM_SECONDS (100)
 #define NORMAL_SIM_SECONDS (10)
@@ -34,9 +40,13 @@ namespace ns3
 #define GLOBAL_PORT_COUNTER_START (50000)
 
 #define NAME_RESOLUTION_SERVICE_PORT (5353)
+//max bytes of CNRS insert headers packed into one report datagram
+#define CNRS_BATCH_MAX_BYTES (1400)
 #define CYBERTWIN_EDGESERVER_CONTROLLER_PORT (2323)         //Tranportation Layer cybertwin controller server port.
 
 #define CYBERTWIN_MANAGER_PROXY_PORT (17)
+//port of the per-interface listener shared by all cybertwins of an edge server
+#define CYBERTWIN_SHARED_LISTEN_PORT (18)
 
 #define APP_CONF_FILE_NAME ("apps.conf")
 
@@ -137,6 +147,37 @@ struct AddressHash
     }
 };
 
+// Returns the values of a random variable stream in the order of its
+// GetValue(), drawn in small batches with GetValues() since the packet
+// generators draw a value per packet. The stream must not be drawn from
+// elsewhere nor have its attributes changed once set.
+class PrefetchedRandomVariable
+{
+  public:
+    static const size_t SIZE = 32;
+
+    void SetStream(Ptr<RandomVariableStream> stream)
+    {
+        m_stream = stream;
+        m_next = SIZE;
+    }
+
+    double GetValue()
+    {
+        if (m_next == SIZE)
+        {
+            m_stream->GetValues(m_values, SIZE);
+            m_next = 0;
+        }
+        return m_values[m_next++];
+    }
+
+  private:
+    Ptr<RandomVariableStream> m_stream;
+    double m_values[SIZE];
+    size_t m_next{SIZE};
+};
+
 void DoSocketMethod(int (Socket::*)(const Address&), Ptr<Socket>, const Address&, uint16_t);
 uint16_t DoSocketBind(Ptr<Socket>, const Address&);
 uint16_t GetBindPort(Ptr<Socket>);
@@ -2,7 +2,7 @@
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("CybertwinEndHostDaemon");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinEndHostDaemon", CYBERTWIN_LOG_FLOOR);
 
 CybertwinEndHostDaemon::CybertwinEndHostDaemon()
 {
@@ -12,6 +12,8 @@ CybertwinEndHostDaemon::CybertwinEndHostDaemon()
 
     m_proxySocket = nullptr;
     m_cybertwinSocket = nullptr;
+    m_rxBuffer = Create<Packet>();
+    m_startJitterRand = CreateObject<UniformRandomVariable>();
     NS_LOG_DEBUG("[CybertwinEndHostDaemon] create CybertwinEndHostDaemon.");
 }
 
@@ -37,7 +39,12 @@ CybertwinEndHostDaemon::GetTypeId()
                           "Manager port.",
                           UintegerValue(CYBERTWIN_MANAGER_PROXY_PORT),
                           MakeUintegerAccessor(&CybertwinEndHostDaemon::m_managerPort),
-                          MakeUintegerChecker<uint16_t>());
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("StartJitter",
+                          "Registration is delayed by a uniform random time in [0, StartJitter].",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&CybertwinEndHostDaemon::m_startJitter),
+                          MakeTimeChecker());
     return tid;
 }
 
@@ -54,7 +61,17 @@ CybertwinEndHostDaemon::StartApplication()
     NS_LOG_INFO("[" << m_nodeName << "][EndHostDaemon] Starting CybertwinEndHostDaemon.");
 
     // Register to Cybertwin
-    RegisterCybertwin();
+    if (m_startJitter.IsStrictlyPositive())
+    {
+        Time delay = Seconds(m_startJitterRand->GetValue(0, m_startJitter.GetSeconds()));
+        NS_LOG_DEBUG("[" << m_nodeName << "][EndHostDaemon] Register after " << delay.GetSeconds()
+                         << "s of start jitter.");
+        m_registerEvent = Simulator::Schedule(delay, &CybertwinEndHostDaemon::RegisterCybertwin, this);
+    }
+    else
+    {
+        RegisterCybertwin();
+    }
 }
 
 void
@@ -62,11 +79,13 @@ CybertwinEndHostDaemon::StopApplication()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("[" << m_nodeName << "][EndHostDaemon] Stopping CybertwinEndHostDaemon.");
+    m_registerEvent.Cancel();
 
     if (m_proxySocket)
     {
         m_proxySocket->Close();
     }
+    m_rxBuffer->RemoveAtEnd(m_rxBuffer->GetSize());
     if (m_cybertwinSocket)
     {
         m_cybertwinSocket->Close();
@@ -170,19 +189,27 @@ CybertwinEndHostDaemon::RecvFromCybertwinManangerCallback(Ptr<Socket> socket)
     Address from;
 
     while ((packet = socket->RecvFrom(from)))
+    {
+        m_rxBuffer->AddAtEnd(packet);
+    }
+
+    // the manager may answer several registrations in one segment, or split one
+    // answer across segments
+    uint32_t headerSize;
+    while ((headerSize = CybertwinManagerHeader::PeekSerializedSize(m_rxBuffer)) > 0)
     {
         CybertwinManagerHeader header;
-        packet->PeekHeader(header);
+        m_rxBuffer->RemoveHeader(header, headerSize);
 
         switch (header.GetCommand())
         {
         case CYBERTWIN_REGISTRATION_ACK: {
             m_isRegisteredToCybertwin = true;
-            RegisterSuccessHandler(socket, packet);
+            RegisterSuccessHandler(socket, header);
             break;
         }
         case CYBERTWIN_REGISTRATION_ERROR: {
-            RegisterFailureHandler(socket, packet);
+            RegisterFailureHandler(socket, header);
             break;
         }
         default: {
@@ -196,11 +223,10 @@ CybertwinEndHostDaemon::RecvFromCybertwinManangerCallback(Ptr<Socket> socket)
 }
 
 void
-CybertwinEndHostDaemon::RegisterSuccessHandler(Ptr<Socket> socket, Ptr<Packet> packet)
+CybertwinEndHostDaemon::RegisterSuccessHandler(Ptr<Socket> socket,
+                                               const CybertwinManagerHeader& header)
 {
     NS_LOG_FUNCTION(this);
-    CybertwinManagerHeader header;
-    packet->RemoveHeader(header);
 
     // get node info
     Ptr<Node> node = GetNode();
@@ -224,7 +250,8 @@ CybertwinEndHostDaemon::RegisterSuccessHandler(Ptr<Socket> socket, Ptr<Packet> p
 }
 
 void
-CybertwinEndHostDaemon::RegisterFailureHandler(Ptr<Socket> socket, Ptr<Packet> packet)
+CybertwinEndHostDaemon::RegisterFailureHandler(Ptr<Socket> socket,
+                                               const CybertwinManagerHeader& header)
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("Handling registration failure.");
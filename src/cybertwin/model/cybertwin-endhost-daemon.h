@@ -6,6 +6,9 @@
 #include "ns3/cybertwin-node.h"
 #include "ns3/cybertwin-tag.h"
 #include "ns3/end-host-bulk-send.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
 
 namespace ns3
 {
@@ -40,8 +43,8 @@ class CybertwinEndHostDaemon : public Application
     void RecvFromCybertwinManangerCallback(Ptr<Socket>);
 
     // cybertwin registration
-    void RegisterSuccessHandler(Ptr<Socket>, Ptr<Packet>);
-    void RegisterFailureHandler(Ptr<Socket>, Ptr<Packet>);
+    void RegisterSuccessHandler(Ptr<Socket>, const CybertwinManagerHeader&);
+    void RegisterFailureHandler(Ptr<Socket>, const CybertwinManagerHeader&);
     void Authenticate();
 
     //private member variables
@@ -49,6 +52,7 @@ class CybertwinEndHostDaemon : public Application
     uint16_t m_managerPort;
     Ptr<Socket> m_proxySocket;
     Ptr<Socket> m_cybertwinSocket;
+    Ptr<Packet> m_rxBuffer; // bytes of a partial header from the manager
 
     bool m_isConnectedToCybertwinManager;
     bool m_isRegisteredToCybertwin;
@@ -58,6 +62,11 @@ class CybertwinEndHostDaemon : public Application
 
     CYBERTWINID_t m_cybertwinId;
     uint16_t m_cybertwinPort;
+
+    // spread the registrations of hosts powered on together
+    Time m_startJitter;
+    Ptr<UniformRandomVariable> m_startJitterRand;
+    EventId m_registerEvent;
 };
     
 } // namespace ns
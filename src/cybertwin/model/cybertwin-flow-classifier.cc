@@ -0,0 +1,154 @@
+#include "cybertwin-flow-classifier.h"
+
+#include "cybertwin-tag.h"
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+#include <tuple>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinFlowClassifier");
+
+bool
+operator<(const CybertwinFlowClassifier::FlowLabel& a, const CybertwinFlowClassifier::FlowLabel& b)
+{
+    return std::tie(a.cuid, a.peer, a.connId) < std::tie(b.cuid, b.peer, b.connId);
+}
+
+CybertwinFlowClassifier::CybertwinFlowClassifier()
+{
+    NS_LOG_FUNCTION(this);
+    // the connections tag their data only when someone reads the tags
+    MdtpFlowTag::Enable();
+}
+
+bool
+CybertwinFlowClassifier::Classify(const Ipv4Header& ipHeader,
+                                  Ptr<const Packet> ipPayload,
+                                  uint32_t* out_flowId,
+                                  uint32_t* out_packetId)
+{
+    if (!Ipv4FlowClassifier::Classify(ipHeader, ipPayload, out_flowId, out_packetId))
+    {
+        return false;
+    }
+
+    FlowId flowId = *out_flowId;
+    if (flowId > m_labeled.size())
+    {
+        m_labels.resize(flowId);
+        m_labeled.resize(flowId, false);
+    }
+    if (m_labeled[flowId - 1])
+    {
+        return true;
+    }
+
+    // a cybertwin relaying MDTP data may leave the tag of the previous
+    // connection on it, so keep the last tag added
+    bool found = false;
+    MdtpFlowTag tag;
+    ByteTagIterator i = ipPayload->GetByteTagIterator();
+    while (i.HasNext())
+    {
+        ByteTagIterator::Item item = i.Next();
+        if (item.GetTypeId() == MdtpFlowTag::GetTypeId())
+        {
+            item.GetTag(tag);
+            found = true;
+        }
+    }
+    if (found)
+    {
+        m_labels[flowId - 1] = {tag.GetCybertwin(), tag.GetPeer(), tag.GetConnId()};
+        m_labeled[flowId - 1] = true;
+        NS_LOG_DEBUG("Flow " << flowId << " carries the MDTP stream of " << tag.GetCybertwin()
+                             << " to " << tag.GetPeer() << ", connection " << tag.GetConnId());
+    }
+    return true;
+}
+
+bool
+CybertwinFlowClassifier::FindLabel(FlowId flowId, FlowLabel& label) const
+{
+    if (flowId < 1 || flowId > m_labeled.size() || !m_labeled[flowId - 1])
+    {
+        return false;
+    }
+    label = m_labels[flowId - 1];
+    return true;
+}
+
+std::map<CybertwinFlowClassifier::FlowLabel, CybertwinFlowClassifier::StreamStats>
+CybertwinFlowClassifier::GetStreamStats(const FlowMonitor::FlowStatsContainer& flowStats) const
+{
+    std::map<FlowLabel, StreamStats> streams;
+    for (const auto& flow : flowStats)
+    {
+        FlowLabel label;
+        if (!FindLabel(flow.first, label))
+        {
+            continue;
+        }
+        const FlowMonitor::FlowStats& stats = flow.second;
+        auto insert = streams.insert({label, StreamStats()});
+        StreamStats& stream = insert.first->second;
+        if (insert.second)
+        {
+            stream.flows = 0;
+            stream.txBytes = 0;
+            stream.rxBytes = 0;
+            stream.txPackets = 0;
+            stream.rxPackets = 0;
+            stream.lostPackets = 0;
+            stream.timeFirstTxPacket = stats.timeFirstTxPacket;
+            stream.timeLastRxPacket = stats.timeLastRxPacket;
+        }
+        stream.flows++;
+        stream.txBytes += stats.txBytes;
+        stream.rxBytes += stats.rxBytes;
+        stream.txPackets += stats.txPackets;
+        stream.rxPackets += stats.rxPackets;
+        stream.lostPackets += stats.lostPackets;
+        stream.delaySum += stats.delaySum;
+        stream.jitterSum += stats.jitterSum;
+        if (stats.txPackets > 0 && stats.timeFirstTxPacket < stream.timeFirstTxPacket)
+        {
+            stream.timeFirstTxPacket = stats.timeFirstTxPacket;
+        }
+        if (stats.timeLastRxPacket > stream.timeLastRxPacket)
+        {
+            stream.timeLastRxPacket = stats.timeLastRxPacket;
+        }
+    }
+    return streams;
+}
+
+void
+CybertwinFlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) const
+{
+    Ipv4FlowClassifier::SerializeToXmlStream(os, indent);
+
+    Indent(os, indent);
+    os << "<CybertwinFlowLabels>\n";
+    for (FlowId flowId = 1; flowId <= m_labeled.size(); flowId++)
+    {
+        if (!m_labeled[flowId - 1])
+        {
+            continue;
+        }
+        const FlowLabel& label = m_labels[flowId - 1];
+        Indent(os, indent + 2);
+        os << "<Flow flowId=\"" << flowId << "\""
+           << " cuid=\"" << label.cuid << "\""
+           << " peerCuid=\"" << label.peer << "\""
+           << " connId=\"" << label.connId << "\" />\n";
+    }
+    Indent(os, indent);
+    os << "</CybertwinFlowLabels>\n";
+}
+
+} // namespace ns3
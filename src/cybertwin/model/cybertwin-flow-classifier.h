@@ -0,0 +1,87 @@
+#ifndef CYBERTWIN_FLOW_CLASSIFIER_H
+#define CYBERTWIN_FLOW_CLASSIFIER_H
+
+#include "cybertwin-common.h"
+
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-flow-classifier.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+//*****************************************************************************
+//*                      Cybertwin Flow Classifier                            *
+//*****************************************************************************
+// Classifies the IPv4 packets like Ipv4FlowClassifier, and labels the flows
+// that carry MDTP data with the cybertwin sending it, its peer and the MDTP
+// connection, read from the MdtpFlowTag of their packets. The subflows of a
+// connection are separate flows with the same label, so the statistics of
+// the flow monitor add up per stream, e.g.
+//
+//   FlowMonitorHelper flowmon;
+//   Ptr<CybertwinFlowClassifier> classifier = Create<CybertwinFlowClassifier>();
+//   flowmon.SetClassifier(classifier);
+//   flowmon.SetMonitorAttribute("SamplingRatio", UintegerValue(16));
+//   Ptr<FlowMonitor> monitor = flowmon.InstallAll();
+//   ...
+//   auto streams = classifier->GetStreamStats(monitor->GetFlowStats());
+//
+// A flow is labeled by the first tagged packet seen, and its packets are no
+// longer searched for tags afterwards. The connections tag their data only
+// once a classifier exists, so create it before they send.
+class CybertwinFlowClassifier : public Ipv4FlowClassifier
+{
+  public:
+    // the MDTP stream of a flow
+    struct FlowLabel
+    {
+        CYBERTWINID_t cuid; // cybertwin sending the data
+        CYBERTWINID_t peer; // cybertwin receiving it
+        MP_CONN_ID_t connId;
+    };
+
+    // statistics of the flows of a stream, summed
+    struct StreamStats
+    {
+        uint32_t flows;
+        uint64_t txBytes;
+        uint64_t rxBytes;
+        uint32_t txPackets;
+        uint32_t rxPackets;
+        uint32_t lostPackets;
+        Time delaySum; // divide by rxPackets for the mean delay
+        Time jitterSum;
+        Time timeFirstTxPacket;
+        Time timeLastRxPacket;
+    };
+
+    CybertwinFlowClassifier();
+
+    bool Classify(const Ipv4Header& ipHeader,
+                  Ptr<const Packet> ipPayload,
+                  uint32_t* out_flowId,
+                  uint32_t* out_packetId) override;
+
+    // \return true and the label of the flow if it carries MDTP data
+    bool FindLabel(FlowId flowId, FlowLabel& label) const;
+
+    // sum the statistics of the monitor per stream; unlabeled flows are left out
+    std::map<FlowLabel, StreamStats> GetStreamStats(
+        const FlowMonitor::FlowStatsContainer& flowStats) const;
+
+    void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
+
+  private:
+    std::vector<FlowLabel> m_labels; // by FlowId - 1, connId valid if m_labeled
+    std::vector<bool> m_labeled;
+};
+
+bool operator<(const CybertwinFlowClassifier::FlowLabel& a,
+               const CybertwinFlowClassifier::FlowLabel& b);
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_FLOW_CLASSIFIER_H */
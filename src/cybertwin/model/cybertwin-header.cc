@@ -8,7 +8,7 @@ namespace ns3
 //********************************************************************
 //*             Cybertwin Header                                      *
 //********************************************************************
-NS_LOG_COMPONENT_DEFINE("CybertwinHeader");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinHeader", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinHeader);
 
 TypeId
@@ -48,21 +48,13 @@ CybertwinHeader::ToString() const
 uint32_t
 CybertwinHeader::GetSerializedSize() const
 {
-    // TODO: the size of the header should be fixed
-    return sizeof(m_command) + sizeof(m_cybertwin) + sizeof(m_peer) + sizeof(m_size) +
-           sizeof(m_cybertwinPort) + sizeof(m_recvRate);
+    return Layout::SIZE;
 }
 
 void
 CybertwinHeader::Serialize(Buffer::Iterator start) const
 {
-    Buffer::Iterator i = start;
-    i.WriteU8(m_command);
-    i.WriteHtonU64(m_cybertwin);
-    i.WriteHtonU64(m_peer);
-    i.WriteHtonU32(m_size);
-    i.WriteHtonU16(m_cybertwinPort);
-    i.WriteU8(m_recvRate);
+    Layout::Write(start, m_command, m_cybertwin, m_peer, m_size, m_cybertwinPort, m_recvRate);
 
     NS_LOG_DEBUG("Serialized command: " << static_cast<uint32_t>(m_command) << " cybertwin: "
                                         << m_cybertwin << " peer: " << m_peer << " size: " << m_size
@@ -74,13 +66,7 @@ uint32_t
 CybertwinHeader::Deserialize(Buffer::Iterator start)
 {
     NS_LOG_DEBUG("Deserializing CybertwinHeader");
-    Buffer::Iterator i = start;
-    m_command = i.ReadU8();
-    m_cybertwin = i.ReadNtohU64();
-    m_peer = i.ReadNtohU64();
-    m_size = i.ReadNtohU32();
-    m_cybertwinPort = i.ReadNtohU16();
-    m_recvRate = i.ReadU8();
+    Layout::Read(start, m_command, m_cybertwin, m_peer, m_size, m_cybertwinPort, m_recvRate);
 
     NS_LOG_DEBUG("Deserialized command: " << static_cast<uint32_t>(m_command)
                                           << " cybertwin: " << m_cybertwin << " peer: " << m_peer
@@ -211,21 +197,19 @@ EndHostHeader::GetInstanceTypeId() const
 uint32_t
 EndHostHeader::GetSerializedSize() const
 {
-    return sizeof(m_command) + sizeof(m_targetID);
+    return Layout::SIZE;
 }
 
 void
 EndHostHeader::Serialize(Buffer::Iterator start) const
 {
-    start.WriteU8(m_command);
-    start.WriteHtonU64(m_targetID);
+    Layout::Write(start, m_command, m_targetID);
 }
 
 uint32_t
 EndHostHeader::Deserialize(Buffer::Iterator start)
 {
-    m_command = start.ReadU8();
-    m_targetID = start.ReadNtohU64();
+    Layout::Read(start, m_command, m_targetID);
     return GetSerializedSize();
 }
 
@@ -351,35 +335,45 @@ CybertwinManagerHeader::GetSerializedSize() const
     return size;
 }
 
+/// Fields before the name: command and length of the name
+using CybertwinManagerHeaderPrefix = FixedHeaderLayout<uint8_t, uint16_t>;
+/// Fields after the name: cuid and port
+using CybertwinManagerHeaderSuffix = FixedHeaderLayout<uint64_t, uint16_t>;
+
 void
 CybertwinManagerHeader::Serialize(Buffer::Iterator it) const
 {
-    // Serialize each member variable to the buffer
-    it.WriteU8(m_command);
-    it.WriteHtonU16(static_cast<uint16_t>(m_cname.size()));
-    it.Write(reinterpret_cast<const uint8_t*>(m_cname.c_str()), m_cname.size());
-    it.WriteHtonU64(m_cuid);
-    it.WriteHtonU16(m_port);
+    CybertwinManagerHeaderPrefix::Write(it, m_command, static_cast<uint16_t>(m_cname.size()));
+    it.Write(reinterpret_cast<const uint8_t*>(m_cname.data()), m_cname.size());
+    CybertwinManagerHeaderSuffix::Write(it, m_cuid, m_port);
 }
 
 uint32_t
 CybertwinManagerHeader::Deserialize(Buffer::Iterator it)
 {
-    // Deserialize each member variable from the buffer
-    m_command = it.ReadU8();
-    uint16_t cnameLength = it.ReadNtohU16();
-
-    char* cnameBuffer = new char[cnameLength];
-    it.Read(reinterpret_cast<uint8_t*>(cnameBuffer), cnameLength);
-    m_cname.assign(cnameBuffer, cnameLength);
-    delete[] cnameBuffer;
-
-    m_cuid = it.ReadNtohU64();
-    m_port = it.ReadNtohU16();
+    uint16_t cnameLength;
+    CybertwinManagerHeaderPrefix::Read(it, m_command, cnameLength);
+    m_cname.resize(cnameLength);
+    it.Read(reinterpret_cast<uint8_t*>(&m_cname[0]), cnameLength);
+    CybertwinManagerHeaderSuffix::Read(it, m_cuid, m_port);
 
     return GetSerializedSize();
 }
 
+uint32_t
+CybertwinManagerHeader::PeekSerializedSize(Ptr<const Packet> packet)
+{
+    uint8_t prefix[CybertwinManagerHeaderPrefix::SIZE];
+    if (packet->GetSize() < sizeof(prefix))
+    {
+        return 0;
+    }
+    packet->CopyData(prefix, sizeof(prefix));
+    uint16_t cnameLength = (prefix[1] << 8) | prefix[2];
+    uint32_t size = sizeof(prefix) + cnameLength + CybertwinManagerHeaderSuffix::SIZE;
+    return packet->GetSize() < size ? 0 : size;
+}
+
 void
 CybertwinManagerHeader::Print(std::ostream& os) const
 {
@@ -426,35 +420,25 @@ MultipathHeader::GetInstanceTypeId() const
 uint32_t
 MultipathHeader::GetSize()
 {
-    return sizeof(m_pathId) + sizeof(m_cuid) + sizeof(m_senderKey) + sizeof(m_recverKey) +
-           sizeof(m_connId);
+    return Layout::SIZE;
 }
 
 uint32_t
 MultipathHeader::GetSerializedSize() const
 {
-    return sizeof(m_pathId) + sizeof(m_cuid) + sizeof(m_senderKey) + sizeof(m_recverKey) +
-           sizeof(m_connId);
+    return Layout::SIZE;
 }
 
 void
 MultipathHeader::Serialize(Buffer::Iterator start) const
 {
-    start.WriteHtonU32(m_pathId);
-    start.WriteHtonU64(m_cuid);
-    start.WriteHtonU32(m_senderKey);
-    start.WriteHtonU32(m_recverKey);
-    start.WriteHtonU64(m_connId);
+    Layout::Write(start, m_pathId, m_cuid, m_senderKey, m_recverKey, m_connId);
 }
 
 uint32_t
 MultipathHeader::Deserialize(Buffer::Iterator start)
 {
-    m_pathId = start.ReadNtohU32();
-    m_cuid = start.ReadNtohU64();
-    m_senderKey = start.ReadNtohU32();
-    m_recverKey = start.ReadNtohU32();
-    m_connId = start.ReadNtohU64();
+    Layout::Read(start, m_pathId, m_cuid, m_senderKey, m_recverKey, m_connId);
 
     return GetSerializedSize();
 }
@@ -531,6 +515,103 @@ MultipathHeader::SetConnId(MP_CONN_ID_t connId)
     m_connId = connId;
 }
 
+//********************************************************************
+//*             Cybertwin Demultiplexing Header                      *
+//********************************************************************
+NS_OBJECT_ENSURE_REGISTERED(CybertwinDemuxHeader);
+
+CybertwinDemuxHeader::CybertwinDemuxHeader()
+    : m_channel(CYBERTWIN_DEMUX_LOCAL),
+      m_cuid(0)
+{
+}
+
+TypeId
+CybertwinDemuxHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::CybertwinDemuxHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("cybertwin")
+                            .AddConstructor<CybertwinDemuxHeader>();
+    return tid;
+}
+
+TypeId
+CybertwinDemuxHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+CybertwinDemuxHeader::Print(std::ostream& os) const
+{
+    os << "Channel: " << (uint32_t)m_channel << " CUID: " << m_cuid;
+}
+
+uint32_t
+CybertwinDemuxHeader::GetSerializedSize() const
+{
+    return Layout::SIZE;
+}
+
+void
+CybertwinDemuxHeader::Serialize(Buffer::Iterator start) const
+{
+    Layout::Write(start, m_channel, m_cuid);
+}
+
+uint32_t
+CybertwinDemuxHeader::Deserialize(Buffer::Iterator start)
+{
+    Layout::Read(start, m_channel, m_cuid);
+
+    return GetSerializedSize();
+}
+
+void
+CybertwinDemuxHeader::SetChannel(DemuxChannel channel)
+{
+    m_channel = channel;
+}
+
+CybertwinDemuxHeader::DemuxChannel
+CybertwinDemuxHeader::GetChannel() const
+{
+    return (DemuxChannel)m_channel;
+}
+
+void
+CybertwinDemuxHeader::SetCuid(CYBERTWINID_t cuid)
+{
+    m_cuid = cuid;
+}
+
+CYBERTWINID_t
+CybertwinDemuxHeader::GetCuid() const
+{
+    return m_cuid;
+}
+
+int32_t
+SendCybertwinDemuxHeader(Ptr<Socket> socket,
+                         uint16_t peerPort,
+                         CybertwinDemuxHeader::DemuxChannel channel,
+                         CYBERTWINID_t cuid)
+{
+    if (peerPort != CYBERTWIN_SHARED_LISTEN_PORT)
+    {
+        return 0;
+    }
+
+    CybertwinDemuxHeader header;
+    header.SetChannel(channel);
+    header.SetCuid(cuid);
+
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(header);
+    return socket->Send(packet);
+}
+
 //********************************************************************
 //*             CyberTwin Multipath Header DSN                       *
 //********************************************************************
@@ -563,23 +644,21 @@ MultipathHeaderDSN::GetInstanceTypeId() const
 uint32_t
 MultipathHeaderDSN::GetSerializedSize() const
 {
-    return sizeof(m_cuid) + sizeof(m_dataSeqNum) + sizeof(m_dataLen);
+    return Layout::SIZE;
 }
 
 void
 MultipathHeaderDSN::Serialize(Buffer::Iterator start) const
 {
-    start.WriteHtonU64(m_cuid);
-    start.WriteHtonU64(m_dataSeqNum.GetValue());
-    start.WriteHtonU32(m_dataLen);
+    Layout::Write(start, m_cuid, m_dataSeqNum.GetValue(), m_dataLen);
 }
 
 uint32_t
 MultipathHeaderDSN::Deserialize(Buffer::Iterator start)
 {
-    m_cuid = start.ReadNtohU64();
-    m_dataSeqNum = start.ReadNtohU64();
-    m_dataLen = start.ReadNtohU32();
+    uint64_t dataSeqNum;
+    Layout::Read(start, m_cuid, dataSeqNum, m_dataLen);
+    m_dataSeqNum = dataSeqNum;
 
     return GetSerializedSize();
 }
@@ -628,6 +707,125 @@ MultipathHeaderDSN::GetDataLen() const
     return m_dataLen;
 }
 
+//********************************************************************
+//*             MDTP Datagram Subflow Header                         *
+//********************************************************************
+NS_OBJECT_ENSURE_REGISTERED(MdtpDatagramHeader);
+
+MdtpDatagramHeader::MdtpDatagramHeader()
+    : m_flags(0),
+      m_seq(0),
+      m_ack(0),
+      m_sack(0)
+{
+}
+
+MdtpDatagramHeader::~MdtpDatagramHeader()
+{
+}
+
+TypeId
+MdtpDatagramHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MdtpDatagramHeader")
+                            .SetParent<Header>()
+                            .AddConstructor<MdtpDatagramHeader>();
+    return tid;
+}
+
+TypeId
+MdtpDatagramHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+MdtpDatagramHeader::GetSerializedSize() const
+{
+    return Layout::SIZE;
+}
+
+void
+MdtpDatagramHeader::Serialize(Buffer::Iterator start) const
+{
+    Layout::Write(start, m_flags, m_seq, m_ack, m_sack);
+}
+
+uint32_t
+MdtpDatagramHeader::Deserialize(Buffer::Iterator start)
+{
+    Layout::Read(start, m_flags, m_seq, m_ack, m_sack);
+
+    return GetSerializedSize();
+}
+
+void
+MdtpDatagramHeader::Print(std::ostream& os) const
+{
+    os << "Flags: " << (uint32_t)m_flags << " Seq: " << m_seq << " Ack: " << m_ack
+       << " Sack: " << m_sack;
+}
+
+uint8_t
+MdtpDatagramHeader::GetFlags() const
+{
+    return m_flags;
+}
+
+void
+MdtpDatagramHeader::SetFlags(uint8_t flags)
+{
+    m_flags = flags;
+}
+
+bool
+MdtpDatagramHeader::IsData() const
+{
+    return m_flags & MDTP_DGRAM_DATA;
+}
+
+bool
+MdtpDatagramHeader::IsAck() const
+{
+    return m_flags & MDTP_DGRAM_ACK;
+}
+
+uint32_t
+MdtpDatagramHeader::GetSeq() const
+{
+    return m_seq;
+}
+
+void
+MdtpDatagramHeader::SetSeq(uint32_t seq)
+{
+    m_seq = seq;
+}
+
+uint32_t
+MdtpDatagramHeader::GetAck() const
+{
+    return m_ack;
+}
+
+void
+MdtpDatagramHeader::SetAck(uint32_t ack)
+{
+    m_ack = ack;
+}
+
+uint32_t
+MdtpDatagramHeader::GetSack() const
+{
+    return m_sack;
+}
+
+void
+MdtpDatagramHeader::SetSack(uint32_t sack)
+{
+    m_sack = sack;
+}
+
 //************************************************************************
 //*                             CNRS Header                              *
 //************************************************************************
@@ -654,28 +852,26 @@ CNRSHeader::GetInstanceTypeId(void) const
     return GetTypeId();
 }
 
+/// Fields before the interfaces: method, query id, cuid and number of interfaces
+using CNRSHeaderPrefix = FixedHeaderLayout<uint8_t, uint32_t, uint64_t, uint8_t>;
+/// Fields of an interface: address and port
+using CNRSHeaderInterface = FixedHeaderLayout<uint32_t, uint16_t>;
+
 uint32_t
 CNRSHeader::GetSerializedSize(void) const
 {
-    uint32_t size = sizeof(uint8_t) + sizeof(QUERY_ID_t) + sizeof(CYBERTWINID_t) + sizeof(uint8_t) +
-                    m_interfaceNum * (sizeof(uint32_t) + sizeof(uint16_t));
-
-    return size;
+    return CNRSHeaderPrefix::SIZE + m_interfaceNum * CNRSHeaderInterface::SIZE;
 }
 
 void
 CNRSHeader::Serialize(Buffer::Iterator start) const
 {
-    start.WriteU8(m_method);
-    start.WriteHtonU32(m_queryId);
-    start.WriteHtonU64(m_cuid);
-    start.WriteU8(m_interfaceNum);
+    CNRSHeaderPrefix::Write(start, m_method, m_queryId, m_cuid, m_interfaceNum);
     if (m_method == CNRS_INSERT || m_method == CNRS_QUERY_OK)
     {
         for (auto& interface : m_interfaceList)
         {
-            start.WriteHtonU32(interface.first.Get());
-            start.WriteHtonU16(interface.second);
+            CNRSHeaderInterface::Write(start, interface.first.Get(), interface.second);
         }
     }
 }
@@ -683,17 +879,15 @@ CNRSHeader::Serialize(Buffer::Iterator start) const
 uint32_t
 CNRSHeader::Deserialize(Buffer::Iterator start)
 {
-    m_method = start.ReadU8();
-    m_queryId = start.ReadNtohU32();
-    m_cuid = start.ReadNtohU64();
-    m_interfaceNum = start.ReadU8();
+    CNRSHeaderPrefix::Read(start, m_method, m_queryId, m_cuid, m_interfaceNum);
     if (m_method == CNRS_INSERT || m_method == CNRS_QUERY_OK)
     {
         for (uint8_t i = 0; i < m_interfaceNum; i++)
         {
-            ns3::Ipv4Address address(start.ReadNtohU32());
-            uint16_t port = start.ReadNtohU16();
-            m_interfaceList.push_back({address, port});
+            uint32_t address;
+            uint16_t port;
+            CNRSHeaderInterface::Read(start, address, port);
+            m_interfaceList.push_back({Ipv4Address(address), port});
         }
     }
     return GetSerializedSize();
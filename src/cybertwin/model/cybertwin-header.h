@@ -4,10 +4,119 @@
 #include "cybertwin-common.h"
 
 #include "ns3/header.h"
+#include "ns3/packet.h"
+
+#include <optional>
+#include <type_traits>
 
 namespace ns3
 {
 
+//************************************************************************
+//*                       Fixed Header Layout                            *
+//************************************************************************
+
+/**
+ * Fixed layout of a header: the types of its fields, in wire order.
+ *
+ * The size of the layout is known at compile time, so the fields are
+ * encoded in network order into a buffer on the stack and written to the
+ * packet with a single copy, and read back the same way, instead of byte
+ * by byte through the Buffer::Iterator.
+ */
+template <typename... Fields>
+class FixedHeaderLayout
+{
+  public:
+    /// Serialized size of the layout, in bytes
+    static constexpr uint32_t SIZE = (sizeof(Fields) + ...);
+
+    /**
+     * Write the fields and advance the iterator past them.
+     *
+     * \param i the iterator
+     * \param fields the values of the fields
+     */
+    static void Write(Buffer::Iterator& i, Fields... fields)
+    {
+        uint8_t buffer[SIZE];
+        uint8_t* p = buffer;
+        (Encode(p, fields), ...);
+        i.Write(buffer, SIZE);
+    }
+
+    /**
+     * Read the fields and advance the iterator past them.
+     *
+     * \param i the iterator
+     * \param [out] fields the values of the fields
+     */
+    static void Read(Buffer::Iterator& i, Fields&... fields)
+    {
+        uint8_t buffer[SIZE];
+        i.Read(buffer, SIZE);
+        const uint8_t* p = buffer;
+        (Decode(p, fields), ...);
+    }
+
+  private:
+    /**
+     * Encode an unsigned integer in network order.
+     *
+     * \param [in,out] p the position in the buffer
+     * \param value the value
+     */
+    template <typename T>
+    static void Encode(uint8_t*& p, T value)
+    {
+        static_assert(std::is_unsigned<T>::value, "fields must be unsigned integers");
+        for (int shift = 8 * (sizeof(T) - 1); shift >= 0; shift -= 8)
+        {
+            *p++ = static_cast<uint8_t>(value >> shift);
+        }
+    }
+
+    /**
+     * Decode an unsigned integer in network order.
+     *
+     * \param [in,out] p the position in the buffer
+     * \param [out] value the value
+     */
+    template <typename T>
+    static void Decode(const uint8_t*& p, T& value)
+    {
+        static_assert(std::is_unsigned<T>::value, "fields must be unsigned integers");
+        value = 0;
+        for (uint32_t j = 0; j < sizeof(T); j++)
+        {
+            value = (value << 8) | *p++;
+        }
+    }
+};
+
+/**
+ * Remove the header at the front of a packet and return it, deserializing
+ * it once, instead of a PeekHeader followed by a RemoveHeader of the same
+ * header.
+ *
+ * \tparam T a header with a fixed layout
+ * \param packet the packet
+ * \return the header, or nothing, leaving the packet untouched, if the
+ *         packet is shorter than the header
+ */
+template <typename T>
+std::optional<T>
+StripHeader(Ptr<Packet> packet)
+{
+    if (packet->GetSize() < T::Layout::SIZE)
+    {
+        return std::nullopt;
+    }
+    T header;
+    packet->RemoveHeader(header, T::Layout::SIZE);
+    return header;
+}
+
 enum CybertwinCommand_t
 {
     HOST_CONNECT,
@@ -27,6 +136,9 @@ enum CybertwinCommand_t
 class CybertwinHeader : public Header
 {
   public:
+    /// Wire layout of the header
+    using Layout = FixedHeaderLayout<uint8_t, uint64_t, uint64_t, uint32_t, uint16_t, uint8_t>;
+
     CybertwinHeader();
     static TypeId GetTypeId();
     TypeId GetInstanceTypeId() const override;
@@ -85,6 +197,9 @@ typedef enum
 class EndHostHeader : public Header
 {
   public:
+    /// Wire layout of the header
+    using Layout = FixedHeaderLayout<uint8_t, uint64_t>;
+
     EndHostHeader();
     static TypeId GetTypeId();
     TypeId GetInstanceTypeId() const override;
@@ -150,6 +265,16 @@ class CybertwinManagerHeader : public Header
 
     virtual void Print(std::ostream& os) const;
 
+    /**
+     * Size of the header at the start of a stream of headers, read from the
+     * length of its name.
+     *
+     * \param packet the received bytes
+     * \return the size of the first header, or 0 if the packet does not hold
+     *         all of it yet
+     */
+    static uint32_t PeekSerializedSize(Ptr<const Packet> packet);
+
   private:
     uint8_t m_command;
     std::string m_cname;
@@ -157,6 +282,64 @@ class CybertwinManagerHeader : public Header
     uint16_t m_port;
 };
 
+//************************************************************************
+//*                  Cybertwin Demultiplexing Header                     *
+//************************************************************************
+
+/**
+ * Cybertwin Demultiplexing Header
+ *
+ * First bytes of a connection towards CYBERTWIN_SHARED_LISTEN_PORT. The
+ * edge server's shared listener strips it and hands the connection to the
+ * cybertwin it names.
+ * - m_channel: CYBERTWIN_DEMUX_LOCAL (from an end host) or
+ *              CYBERTWIN_DEMUX_GLOBAL (from the cloud)
+ * - m_cuid: the target cybertwin
+ */
+class CybertwinDemuxHeader : public Header
+{
+  public:
+    /// Wire layout of the header
+    using Layout = FixedHeaderLayout<uint8_t, uint64_t>;
+
+    enum DemuxChannel
+    {
+        CYBERTWIN_DEMUX_LOCAL = 0,
+        CYBERTWIN_DEMUX_GLOBAL,
+    };
+
+    CybertwinDemuxHeader();
+
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    void Print(std::ostream&) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator) const override;
+    uint32_t Deserialize(Buffer::Iterator) override;
+
+    void SetChannel(DemuxChannel channel);
+    DemuxChannel GetChannel() const;
+
+    void SetCuid(CYBERTWINID_t cuid);
+    CYBERTWINID_t GetCuid() const;
+
+  private:
+    uint8_t m_channel;
+    CYBERTWINID_t m_cuid;
+};
+
+/**
+ * Prefix a new connection with a CybertwinDemuxHeader if it is made towards
+ * a shared listener, i.e. the peer port is CYBERTWIN_SHARED_LISTEN_PORT.
+ *
+ * \return the number of bytes queued, 0 if the peer needs no demultiplexing
+ */
+int32_t SendCybertwinDemuxHeader(Ptr<Socket> socket,
+                                 uint16_t peerPort,
+                                 CybertwinDemuxHeader::DemuxChannel channel,
+                                 CYBERTWINID_t cuid);
+
 //************************************************************************
 //*                        Multipath Header                              *
 //************************************************************************
@@ -176,6 +359,9 @@ class CybertwinManagerHeader : public Header
 class MultipathHeader : public Header
 {
   public:
+    /// Wire layout of the header
+    using Layout = FixedHeaderLayout<uint32_t, uint64_t, uint32_t, uint32_t, uint64_t>;
+
     MultipathHeader();
     virtual ~MultipathHeader();
 
@@ -211,6 +397,9 @@ class MultipathHeader : public Header
 class MultipathHeaderDSN : public Header
 {
   public:
+    /// Wire layout of the header
+    using Layout = FixedHeaderLayout<uint64_t, uint64_t, uint32_t>;
+
     MultipathHeaderDSN();
     virtual ~MultipathHeaderDSN();
 
@@ -245,6 +434,58 @@ class MultipathHeaderDSN : public Header
     uint32_t m_dataLen;
 };
 
+/**
+ * MDTP datagram subflow header
+ *
+ * Carried in front of every datagram sent on a UDP subflow. It provides
+ * the per-subflow sequencing used by the lightweight ACK / loss recovery
+ * of MdtpDatagramSubflow:
+ * - m_flags: MDTP_DGRAM_DATA and/or MDTP_DGRAM_ACK
+ * - m_seq: subflow sequence number of a DATA datagram
+ * - m_ack: cumulative ACK, the next expected subflow sequence number
+ * - m_sack: the sequence number of the datagram that triggered the ACK
+ */
+class MdtpDatagramHeader : public Header
+{
+  public:
+    /// Wire layout of the header
+    using Layout = FixedHeaderLayout<uint8_t, uint32_t, uint32_t, uint32_t>;
+
+    enum DatagramFlags
+    {
+        MDTP_DGRAM_DATA = 0x01,
+        MDTP_DGRAM_ACK = 0x02,
+    };
+
+    MdtpDatagramHeader();
+    virtual ~MdtpDatagramHeader();
+
+    static TypeId GetTypeId();
+    virtual TypeId GetInstanceTypeId() const;
+
+    virtual uint32_t GetSerializedSize() const;
+    virtual void Serialize(Buffer::Iterator start) const;
+    virtual uint32_t Deserialize(Buffer::Iterator start);
+    virtual void Print(std::ostream& os) const;
+
+    uint8_t GetFlags() const;
+    void SetFlags(uint8_t flags);
+    bool IsData() const;
+    bool IsAck() const;
+    uint32_t GetSeq() const;
+    void SetSeq(uint32_t seq);
+    uint32_t GetAck() const;
+    void SetAck(uint32_t ack);
+    uint32_t GetSack() const;
+    void SetSack(uint32_t sack);
+
+  private:
+    uint8_t m_flags;
+    uint32_t m_seq;
+    uint32_t m_ack;
+    uint32_t m_sack;
+};
+
 //************************************************************************
 //*                             CNRS Header                              *
 //************************************************************************
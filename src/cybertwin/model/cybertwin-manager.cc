@@ -1,16 +1,18 @@
 #include "ns3/cybertwin-manager.h"
 
+#include "ns3/boolean.h"
 #include "ns3/callback.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/simulator.h"
 #include "ns3/tcp-header.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("CybertwinManager");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinManager", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinManager);
 
 TypeId
@@ -24,13 +26,37 @@ CybertwinManager::GetTypeId()
                                           "The port on which the proxy listens",
                                           UintegerValue(CYBERTWIN_MANAGER_PROXY_PORT),
                                           MakeUintegerAccessor(&CybertwinManager::m_proxyPort),
-                                          MakeUintegerChecker<uint16_t>());
+                                          MakeUintegerChecker<uint16_t>())
+                            .AddAttribute("SharedListener",
+                                          "Serve all cybertwins through one listener per interface "
+                                          "on CYBERTWIN_SHARED_LISTEN_PORT instead of dedicated "
+                                          "ports and sockets per cybertwin",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&CybertwinManager::m_sharedListener),
+                                          MakeBooleanChecker())
+                            .AddAttribute("RegistrationBatchSize",
+                                          "Number of pending registrations that triggers an "
+                                          "immediate batch creation",
+                                          UintegerValue(64),
+                                          MakeUintegerAccessor(&CybertwinManager::m_registrationBatchSize),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("RegistrationBatchDelay",
+                                          "How long a registration may wait for its batch to fill, "
+                                          "zero batches the registrations of the same instant",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&CybertwinManager::m_registrationBatchDelay),
+                                          MakeTimeChecker());
     return tid;
 }
 
 CybertwinManager::CybertwinManager()
     : m_proxySocket(nullptr),
-      m_lastAssignedPort(1000)
+      m_lastAssignedPort(1000),
+      m_sharedListener(false),
+      m_registrationBatchSize(64),
+      m_registrationBatchDelay(Seconds(0)),
+      m_registeredCount(0),
+      m_registrationBatches(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -38,7 +64,12 @@ CybertwinManager::CybertwinManager()
 CybertwinManager::CybertwinManager(std::vector<Ipv4Address> localIpv4AddrList,
                                     std::vector<Ipv4Address> globalIpv4AddrList)
     : m_proxySocket(nullptr),
-      m_lastAssignedPort(1000)
+      m_lastAssignedPort(1000),
+      m_sharedListener(false),
+      m_registrationBatchSize(64),
+      m_registrationBatchDelay(Seconds(0)),
+      m_registeredCount(0),
+      m_registrationBatches(0)
 {
     NS_LOG_FUNCTION(this);
     m_localIpv4AddrList = localIpv4AddrList;
@@ -53,6 +84,18 @@ CybertwinManager::~CybertwinManager()
 {
 }
 
+uint64_t
+CybertwinManager::GetRegisteredCount() const
+{
+    return m_registeredCount;
+}
+
+Time
+CybertwinManager::GetLastRegistrationTime() const
+{
+    return m_lastRegistrationTime;
+}
+
 void
 CybertwinManager::DoDispose()
 {
@@ -63,6 +106,10 @@ CybertwinManager::DoDispose()
         StopApplication();
     }
     m_proxySocket = nullptr;
+    m_sharedListenSockets.clear();
+    m_registrationFlushEvent.Cancel();
+    m_pendingRegistrations.clear();
+    m_rxBuffers.clear();
     m_cybertwinTable.clear();
     Application::DoDispose();
 }
@@ -84,6 +131,11 @@ CybertwinManager::StartApplication()
     NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: CybertwinManager starts");
 
     StartProxy();
+
+    if (m_sharedListener)
+    {
+        StartSharedListeners();
+    }
 }
 
 void
@@ -122,6 +174,99 @@ CybertwinManager::StopApplication()
         m_proxySocket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
         m_proxySocket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
     }
+
+    for (auto sock : m_sharedListenSockets)
+    {
+        sock->Close();
+        sock->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                MakeNullCallback<void, Ptr<Socket>, const Address&>());
+    }
+}
+
+void
+CybertwinManager::StartSharedListeners()
+{
+    NS_LOG_FUNCTION(GetNode()->GetId());
+    if (!m_sharedListenSockets.empty())
+    {
+        return;
+    }
+
+    // one listener per interface address, local and global alike
+    std::vector<Ipv4Address> addrList = m_localIpv4AddrList;
+    for (auto addr : m_globalIpv4AddrList)
+    {
+        if (std::find(addrList.begin(), addrList.end(), addr) == addrList.end())
+        {
+            addrList.push_back(addr);
+        }
+    }
+
+    for (auto addr : addrList)
+    {
+        Ptr<Socket> sock = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+        if (sock->Bind(InetSocketAddress(addr, CYBERTWIN_SHARED_LISTEN_PORT)) < 0)
+        {
+            NS_FATAL_ERROR("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                               << "]: Failed to bind shared listener on " << addr);
+        }
+        sock->SetAcceptCallback(MakeCallback(&CybertwinManager::HostConnecting, this),
+                                MakeCallback(&CybertwinManager::SharedConnCreated, this));
+        sock->Listen();
+        m_sharedListenSockets.push_back(sock);
+
+        NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                        << "]: Shared listener on " << addr << ":"
+                        << CYBERTWIN_SHARED_LISTEN_PORT);
+    }
+}
+
+void
+CybertwinManager::SharedConnCreated(Ptr<Socket> socket, const Address& address)
+{
+    NS_LOG_FUNCTION(GetNode()->GetId() << socket << address);
+    // keep the connection until its first segment names the target cybertwin
+    socket->SetRecvCallback(MakeCallback(&CybertwinManager::DemuxSharedConnection, this));
+    socket->SetCloseCallbacks(MakeCallback(&CybertwinManager::NormalHostClose, this),
+                              MakeCallback(&CybertwinManager::ErrorHostClose, this));
+}
+
+void
+CybertwinManager::DemuxSharedConnection(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(GetNode()->GetId() << socket);
+    CybertwinDemuxHeader header;
+    if (socket->GetRxAvailable() < header.GetSerializedSize())
+    {
+        // wait for the whole demultiplexing header
+        return;
+    }
+
+    // only consume the header, the rest belongs to the cybertwin
+    Ptr<Packet> packet = socket->Recv(header.GetSerializedSize(), 0);
+    packet->RemoveHeader(header);
+
+    auto it = m_cybertwinTable.find(header.GetCuid());
+    if (it == m_cybertwinTable.end())
+    {
+        NS_LOG_ERROR("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                         << "]: Shared listener got a connection for unknown cybertwin "
+                         << header.GetCuid());
+        socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        socket->Close();
+        return;
+    }
+
+    NS_LOG_DEBUG("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                     << "]: Hand over connection to cybertwin " << header.GetCuid());
+    if (header.GetChannel() == CybertwinDemuxHeader::CYBERTWIN_DEMUX_LOCAL)
+    {
+        it->second->AcceptLocalConnection(socket);
+    }
+    else
+    {
+        it->second->AcceptGlobalConnection(socket);
+    }
 }
 
 bool
@@ -149,26 +294,39 @@ CybertwinManager::ReceiveFromHost(Ptr<Socket> socket)
     Ptr<Packet> packet;
     Address from;
 
+    // a segment may carry several headers (multi-registration messages,
+    // coalesced retries) or only a part of one
+    Ptr<Packet>& buffer = m_rxBuffers[socket];
+    if (!buffer)
+    {
+        buffer = Create<Packet>();
+    }
     while ((packet = socket->RecvFrom(from)))
     {
         if (packet->GetSize() == 0)
         {
             break;
         }
+        buffer->AddAtEnd(packet);
+    }
 
+    uint32_t headerSize;
+    while ((headerSize = CybertwinManagerHeader::PeekSerializedSize(buffer)) > 0)
+    {
+        // deserialize the header once, straight from the buffer
         CybertwinManagerHeader header;
-        packet->PeekHeader(header);
+        buffer->RemoveHeader(header, headerSize);
 
         switch (header.GetCommand())
         {
         case CYBERTWIN_REGISTRATION:
-            HandleCybertwinRegistration(socket, packet);
+            HandleCybertwinRegistration(socket, header);
             break;
         case CYBERTWIN_DESTRUCTION:
-            HandleCybertwinDestruction(socket, packet);
+            HandleCybertwinDestruction(socket, header);
             break;
         case CYBERTWIN_RECONNECT:
-            HandleCybertwinReconnect(socket, packet);
+            HandleCybertwinReconnect(socket, header);
             break;
         }
     }
@@ -176,77 +334,128 @@ CybertwinManager::ReceiveFromHost(Ptr<Socket> socket)
 
 void
 CybertwinManager::HandleCybertwinRegistration(Ptr<Socket> socket,
-                                              Ptr<Packet> packet)
+                                              const CybertwinManagerHeader& header)
 {
     NS_LOG_FUNCTION(this);
-    NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: HandleCybertwinRegistration");
-    CybertwinManagerHeader header;
-    CybertwinManagerHeader replyHeader;
-    std::string name;
-    CYBERTWINID_t cuid;
-
-    packet->RemoveHeader(header);
-    name = header.GetCName();
-    cuid = StringToUint64(name);
+    NS_LOG_DEBUG("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                     << "]: Queue registration of " << header.GetCName());
+    m_pendingRegistrations.push_back({socket, header.GetCName()});
 
-    // create a new cybertwin
-    if (m_cybertwinTable.find(cuid) != m_cybertwinTable.end())
+    if (m_pendingRegistrations.size() >= m_registrationBatchSize)
     {
-        NS_LOG_ERROR("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: cybertwin already exists");
-        // set reply header
-        replyHeader.SetCommand(CYBERTWIN_REGISTRATION_ERROR);
-        replyHeader.SetCName(name);
+        FlushRegistrations();
     }
-    else
+    else if (!m_registrationFlushEvent.IsRunning())
     {
-        // assign local port for new cybertwin
-        uint16_t local_port = m_lastAssignedPort++;
-        Address local_addr;
-        socket->GetSockName(local_addr);
-        Ipv4Address local_Addr = InetSocketAddress::ConvertFrom(local_addr).GetIpv4();
-        CYBERTWIN_INTERFACE_t l_interface = std::make_pair(local_Addr, local_port);
+        m_registrationFlushEvent =
+            Simulator::Schedule(m_registrationBatchDelay, &CybertwinManager::FlushRegistrations, this);
+    }
+}
+
+void
+CybertwinManager::FlushRegistrations()
+{
+    NS_LOG_FUNCTION(this);
+    m_registrationFlushEvent.Cancel();
+    if (m_pendingRegistrations.empty())
+    {
+        return;
+    }
+
+    std::vector<PendingRegistration> batch;
+    batch.swap(m_pendingRegistrations);
+    NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                    << "]: HandleCybertwinRegistration, batch of " << batch.size());
 
-        NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "s]: Assign local address: " << local_Addr << ", local port: " << local_port << " to cybertwin " << name);
+    CNRSItemList_t published;
+    std::map<Ptr<Socket>, Ptr<Packet>> replies;
+    for (auto& reg : batch)
+    {
+        CybertwinManagerHeader replyHeader;
+        CYBERTWINID_t cuid = StringToUint64(reg.name);
 
-        // assign global interfaces (multiple addr:port) for new cybertwin
-        CYBERTWIN_INTERFACE_LIST_t g_interfaces;
-        AssignInterfaces(g_interfaces);
+        if (m_cybertwinTable.find(cuid) != m_cybertwinTable.end())
+        {
+            NS_LOG_ERROR("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: cybertwin already exists");
+            // set reply header
+            replyHeader.SetCommand(CYBERTWIN_REGISTRATION_ERROR);
+            replyHeader.SetCName(reg.name);
+        }
+        else
+        {
+            // assign local port for new cybertwin
+            uint16_t local_port =
+                m_sharedListener ? CYBERTWIN_SHARED_LISTEN_PORT : m_lastAssignedPort++;
+            Address local_addr;
+            reg.socket->GetSockName(local_addr);
+            Ipv4Address local_Addr = InetSocketAddress::ConvertFrom(local_addr).GetIpv4();
+            CYBERTWIN_INTERFACE_t l_interface = std::make_pair(local_Addr, local_port);
+
+            NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "s]: Assign local address: " << local_Addr << ", local port: " << local_port << " to cybertwin " << reg.name);
+
+            // assign global interfaces (multiple addr:port) for new cybertwin
+            CYBERTWIN_INTERFACE_LIST_t g_interfaces;
+            AssignInterfaces(g_interfaces);
+
+            // create a new cybertwin, published to CNRS with the whole batch
+            NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: Create a new cybertwin " << reg.name);
+            Ptr<Cybertwin> cybertwin = CreateObject<Cybertwin>(cuid, l_interface, g_interfaces);
+            cybertwin->SetPublishedByManager(true);
+            GetNode()->AddApplication(cybertwin);
+            m_cybertwinTable[cuid] = cybertwin;
+            published.push_back(std::make_pair(cuid, g_interfaces));
+
+            // Not started right away
+            cybertwin->SetStartTime(Simulator::Now());
+
+            // set reply header
+            replyHeader.SetCommand(CYBERTWIN_REGISTRATION_ACK);
+            replyHeader.SetCName(reg.name);
+            replyHeader.SetCUID(cuid);
+            replyHeader.SetPort(local_port);
+        }
 
-        // create a new cybertwin
-        NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: Create a new cybertwin " << name);
-        Ptr<Cybertwin> cybertwin = CreateObject<Cybertwin>(cuid, l_interface, g_interfaces);
-        GetNode()->AddApplication(cybertwin);
-        m_cybertwinTable[cuid] = cybertwin;
+        // replies to the same host leave in one segment
+        Ptr<Packet>& reply = replies[reg.socket];
+        if (!reply)
+        {
+            reply = Create<Packet>(0);
+        }
+        Ptr<Packet> replyPacket = Create<Packet>(0);
+        replyPacket->AddHeader(replyHeader);
+        reply->AddAtEnd(replyPacket);
+    }
 
-        // Not started right away
-        cybertwin->SetStartTime(Simulator::Now());
+    if (!published.empty())
+    {
+        Ptr<NameResolutionService> cnrs = DynamicCast<CybertwinNode>(GetNode())->GetCNRSApp();
+        NS_ASSERT(cnrs != nullptr);
+        cnrs->InsertCybertwinInterfaceNameBatch(published);
 
-        // set reply header
-        replyHeader.SetCommand(CYBERTWIN_REGISTRATION_ACK);
-        replyHeader.SetCName(name);
-        replyHeader.SetCUID(cuid);
-        replyHeader.SetPort(local_port);
+        m_registeredCount += published.size();
+        m_lastRegistrationTime = Simulator::Now();
     }
+    m_registrationBatches++;
+    NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: Registration batch #"
+                    << m_registrationBatches << " created " << published.size() << " cybertwins, "
+                    << m_registeredCount << " in total");
 
-    // send reply
-    NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: Send reply to cybertwin " << name);
-    Ptr<Packet> replyPacket = Create<Packet>(0);
-    replyPacket->AddHeader(replyHeader);
-    socket->Send(replyPacket);
+    // send replies
+    for (auto& reply : replies)
+    {
+        reply.first->Send(reply.second);
+    }
 }
 
 void
 CybertwinManager::HandleCybertwinDestruction(Ptr<Socket> socket,
-                                                Ptr<Packet> packet)
+                                                const CybertwinManagerHeader& header)
 {
     NS_LOG_FUNCTION(GetNode()->GetId() << socket);
-    CybertwinManagerHeader header;
     CybertwinManagerHeader replyHeader;
     std::string name;
     CYBERTWINID_t cuid;
 
-    packet->RemoveHeader(header);
-
     name = header.GetCName();
     cuid = StringToUint64(name);
 
@@ -278,16 +487,13 @@ CybertwinManager::HandleCybertwinDestruction(Ptr<Socket> socket,
 //TODO: Cybertwin Migration related
 void
 CybertwinManager::HandleCybertwinReconnect(Ptr<Socket> socket,
-                                            Ptr<Packet> packet)
+                                            const CybertwinManagerHeader& header)
 {
     NS_LOG_FUNCTION(GetNode()->GetId() << socket);
-    CybertwinManagerHeader header;
     CybertwinManagerHeader replyHeader;
     std::string name;
     CYBERTWINID_t cuid;
 
-    packet->RemoveHeader(header);
-
     name = header.GetCName();
     cuid = StringToUint64(name);
 
@@ -318,6 +524,7 @@ CybertwinManager::NormalHostClose(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(GetNode()->GetId() << socket);
     NS_LOG_DEBUG("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: Normal Connection closed.");
+    m_rxBuffers.erase(socket);
     if (socket != m_proxySocket)
     {
         socket->ShutdownSend();
@@ -329,6 +536,7 @@ CybertwinManager::ErrorHostClose(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(GetNode()->GetId() << socket);
     NS_LOG_ERROR("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: Error Connection closed.");
+    m_rxBuffers.erase(socket);
     if (socket != m_proxySocket)
     {
         socket->ShutdownSend();
@@ -339,6 +547,18 @@ void
 CybertwinManager::AssignInterfaces(CYBERTWIN_INTERFACE_LIST_t& ifs)
 {
     NS_LOG_FUNCTION(GetNode()->GetId() << ifs);
+#if !MDTP_ENABLED
+    if (m_sharedListener)
+    {
+        // every cybertwin is reached through the shared listeners
+        for (auto addr : m_globalIpv4AddrList)
+        {
+            ifs.push_back(std::make_pair(addr, CYBERTWIN_SHARED_LISTEN_PORT));
+        }
+        return;
+    }
+#endif
+
     for (auto addr : m_globalIpv4AddrList)
     {
         CYBERTWIN_INTERFACE_t interface;
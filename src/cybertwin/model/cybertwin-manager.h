@@ -10,8 +10,11 @@
 #include "ns3/address.h"
 #include "ns3/application.h"
 #include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
 #include "ns3/node.h"
 
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -28,6 +31,10 @@ class CybertwinManager : public Application
                      std::vector<Ipv4Address> globalIpv4AddrList);
     ~CybertwinManager();
 
+    // registration statistics, used to report the end of the boot phase
+    uint64_t GetRegisteredCount() const;
+    Time GetLastRegistrationTime() const;
+
   protected:
     void DoDispose() override;
 
@@ -45,11 +52,18 @@ class CybertwinManager : public Application
 
     void StartProxy();
 
+    // shared listener mode
+    void StartSharedListeners();
+    void SharedConnCreated(Ptr<Socket>, const Address&);
+    void DemuxSharedConnection(Ptr<Socket>);
+
     void AssignInterfaces(CYBERTWIN_INTERFACE_LIST_t&);
 
-    void HandleCybertwinRegistration(Ptr<Socket>, Ptr<Packet>);
-    void HandleCybertwinDestruction(Ptr<Socket>, Ptr<Packet>);
-    void HandleCybertwinReconnect(Ptr<Socket>, Ptr<Packet>);
+    // registration pipeline
+    void HandleCybertwinRegistration(Ptr<Socket>, const CybertwinManagerHeader&);
+    void FlushRegistrations();
+    void HandleCybertwinDestruction(Ptr<Socket>, const CybertwinManagerHeader&);
+    void HandleCybertwinReconnect(Ptr<Socket>, const CybertwinManagerHeader&);
 
     std::vector<Ipv4Address> m_localIpv4AddrList;
     std::vector<Ipv4Address> m_globalIpv4AddrList;
@@ -62,6 +76,28 @@ class CybertwinManager : public Application
     std::unordered_set<uint16_t> m_assignedPorts;
     uint16_t m_lastAssignedPort;
 
+    // one listener per interface, demultiplexed by cuid
+    bool m_sharedListener;
+    std::vector<Ptr<Socket>> m_sharedListenSockets;
+
+    // registrations waiting for the next batch
+    struct PendingRegistration
+    {
+        Ptr<Socket> socket;
+        std::string name;
+    };
+
+    uint32_t m_registrationBatchSize;
+    Time m_registrationBatchDelay;
+    std::vector<PendingRegistration> m_pendingRegistrations;
+    EventId m_registrationFlushEvent;
+    uint64_t m_registeredCount;
+    uint64_t m_registrationBatches;
+    Time m_lastRegistrationTime;
+
+    // partially received manager headers of each host connection
+    std::map<Ptr<Socket>, Ptr<Packet>> m_rxBuffers;
+
     std::string m_nodeName;
 };
 
@@ -3,7 +3,7 @@
 namespace ns3
 {
 
-NS_LOG_COMPONENT_DEFINE("CybertwinNode");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinNode", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinNode);
 
 TypeId
@@ -43,6 +43,12 @@ CybertwinNode::CybertwinNode()
     NS_LOG_DEBUG("Created a CybertwinNode.");
 }
 
+CybertwinNode::CybertwinNode(uint32_t systemId)
+    : Node(systemId)
+{
+    NS_LOG_DEBUG("Created a CybertwinNode on system " << systemId << ".");
+}
+
 CybertwinNode::~CybertwinNode()
 {
     NS_LOG_DEBUG("Destroyed a CybertwinNode.");
@@ -250,6 +256,13 @@ CybertwinCoreServer::CybertwinCoreServer()
     NS_LOG_FUNCTION(this);
 }
 
+CybertwinCoreServer::CybertwinCoreServer(uint32_t systemId)
+    : CybertwinNode(systemId),
+      cybertwinCNRSApp(nullptr)
+{
+    NS_LOG_FUNCTION(this << systemId);
+}
+
 void
 CybertwinCoreServer::PowerOn()
 {
@@ -288,6 +301,14 @@ CybertwinEdgeServer::CybertwinEdgeServer()
     NS_LOG_FUNCTION(this);
 }
 
+CybertwinEdgeServer::CybertwinEdgeServer(uint32_t systemId)
+    : CybertwinNode(systemId),
+      m_cybertwinCNRSApp(nullptr),
+      m_CybertwinManagerApp(nullptr)
+{
+    NS_LOG_FUNCTION(this << systemId);
+}
+
 CybertwinEdgeServer::~CybertwinEdgeServer()
 {
     NS_LOG_FUNCTION(this);
@@ -335,6 +356,13 @@ CybertwinEndHost::CybertwinEndHost()
     m_isConnected = false;    
 }
 
+CybertwinEndHost::CybertwinEndHost(uint32_t systemId)
+    : CybertwinNode(systemId)
+{
+    NS_LOG_FUNCTION(this << systemId);
+    m_isConnected = false;
+}
+
 CybertwinEndHost::~CybertwinEndHost()
 {
     NS_LOG_FUNCTION(this);
@@ -22,6 +22,7 @@ class CybertwinNode : public Node
 {
   public:
     CybertwinNode();
+    CybertwinNode(uint32_t systemId); // system id, i.e. the MPI rank, of the node
     ~CybertwinNode();
 
     static TypeId GetTypeId();
@@ -94,6 +95,7 @@ class CybertwinEdgeServer : public CybertwinNode
 {
   public:
     CybertwinEdgeServer();
+    CybertwinEdgeServer(uint32_t systemId);
     ~CybertwinEdgeServer();
 
     static TypeId GetTypeId();
@@ -114,6 +116,7 @@ class CybertwinCoreServer : public CybertwinNode
 {
   public:
     CybertwinCoreServer();
+    CybertwinCoreServer(uint32_t systemId);
     ~CybertwinCoreServer();
 
     static TypeId GetTypeId();
@@ -134,6 +137,7 @@ class CybertwinEndHost : public CybertwinNode
 {
   public:
     CybertwinEndHost();
+    CybertwinEndHost(uint32_t systemId);
     ~CybertwinEndHost();
 
     static TypeId GetTypeId();
@@ -9,6 +9,7 @@ NS_LOG_COMPONENT_DEFINE("CybertwinCert");
 NS_OBJECT_ENSURE_REGISTERED(CybertwinTag);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinCreditTag);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinCertTag);
+NS_OBJECT_ENSURE_REGISTERED(MdtpFlowTag);
 
 CybertwinTag::CybertwinTag(CYBERTWINID_t cuid)
     : m_cuid(cuid)
@@ -297,6 +298,95 @@ CybertwinCertTag::GetUserInitialCredit() const
 //*****************************************************************************
 //*                 Multipath Connection Tag                                  *
 //*****************************************************************************
+MdtpFlowTag::MdtpFlowTag(CYBERTWINID_t cuid, CYBERTWINID_t peer, MP_CONN_ID_t connId)
+    : CybertwinTag(cuid),
+      m_peer(peer),
+      m_connId(connId)
+{
+}
+
+bool MdtpFlowTag::s_enabled = false;
+
+void
+MdtpFlowTag::Enable()
+{
+    s_enabled = true;
+}
+
+bool
+MdtpFlowTag::IsEnabled()
+{
+    return s_enabled;
+}
+
+TypeId
+MdtpFlowTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MdtpFlowTag")
+                            .SetParent<CybertwinTag>()
+                            .SetGroupName("cybertwin")
+                            .AddConstructor<MdtpFlowTag>();
+    return tid;
+}
+
+TypeId
+MdtpFlowTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+MdtpFlowTag::GetSerializedSize() const
+{
+    return sizeof(m_cuid) + sizeof(m_peer) + sizeof(m_connId);
+}
+
+void
+MdtpFlowTag::Serialize(TagBuffer i) const
+{
+    i.WriteU64(m_cuid);
+    i.WriteU64(m_peer);
+    i.WriteU64(m_connId);
+}
+
+void
+MdtpFlowTag::Deserialize(TagBuffer i)
+{
+    m_cuid = i.ReadU64();
+    m_peer = i.ReadU64();
+    m_connId = i.ReadU64();
+}
+
+void
+MdtpFlowTag::Print(std::ostream& os) const
+{
+    os << "cybertwin=" << m_cuid << ", peer=" << m_peer << ", connection=" << m_connId;
+}
+
+void
+MdtpFlowTag::SetPeer(CYBERTWINID_t val)
+{
+    m_peer = val;
+}
+
+CYBERTWINID_t
+MdtpFlowTag::GetPeer() const
+{
+    return m_peer;
+}
+
+void
+MdtpFlowTag::SetConnId(MP_CONN_ID_t val)
+{
+    m_connId = val;
+}
+
+MP_CONN_ID_t
+MdtpFlowTag::GetConnId() const
+{
+    return m_connId;
+}
+
 NS_OBJECT_ENSURE_REGISTERED(MultipathTagConn);
 
 TypeId MultipathTagConn::GetTypeId (void)
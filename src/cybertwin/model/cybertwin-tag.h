@@ -87,6 +87,35 @@ class CybertwinCertTag : public CybertwinTag
     uint16_t m_usrInitialCredit;
 };
 
+// Byte tag of the data of an MDTP connection: the cybertwin sending it, its
+// peer and the connection, for the flow monitor. Unlike the headers, it
+// survives the segmentation of the subflows. The connections add it only
+// once a CybertwinFlowClassifier enables it.
+class MdtpFlowTag : public CybertwinTag
+{
+  public:
+    MdtpFlowTag(CYBERTWINID_t cuid = 0, CYBERTWINID_t peer = 0, MP_CONN_ID_t connId = 0);
+    static void Enable();
+    static bool IsEnabled();
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer) const override;
+    void Deserialize(TagBuffer) override;
+    void Print(std::ostream&) const override;
+
+    void SetPeer(CYBERTWINID_t);
+    CYBERTWINID_t GetPeer() const;
+    void SetConnId(MP_CONN_ID_t);
+    MP_CONN_ID_t GetConnId() const;
+
+  private:
+    static bool s_enabled; // a flow monitor reads the tags
+
+    CYBERTWINID_t m_peer;
+    MP_CONN_ID_t m_connId;
+};
+
 class MultipathTagConn : public ns3::Tag
 {
 public:
@@ -7,7 +7,7 @@
 
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("Cybertwin");
+NS_LOG_COMPONENT_DEFINE_FLOOR("Cybertwin", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(Cybertwin);
 
 TypeId
@@ -22,7 +22,8 @@ Cybertwin::GetTypeId()
 
 Cybertwin::Cybertwin()
     : m_cybertwinId(0),
-      m_localSocket(nullptr)
+      m_localSocket(nullptr),
+      m_publishedByManager(false)
 {
 }
 
@@ -33,6 +34,7 @@ Cybertwin::Cybertwin(CYBERTWINID_t cuid,
       m_localSocket(nullptr),
       m_localInterface(l_interface),
       m_globalInterfaces(g_interfaces),
+      m_publishedByManager(false),
       m_isStartTrafficOpt(false),
       m_comm_test_total_bytes(0),
       m_comm_test_interval_bytes(0)
@@ -66,7 +68,10 @@ Cybertwin::StartApplication()
     // report interfaces to CNRS
     m_cnrs = DynamicCast<CybertwinNode>(GetNode())->GetCNRSApp();
     NS_ASSERT(m_cnrs != nullptr);
-    m_cnrs->InsertCybertwinInterfaceName(m_cybertwinId, m_globalInterfaces);
+    if (!m_publishedByManager)
+    {
+        m_cnrs->InsertCybertwinInterfaceName(m_cybertwinId, m_globalInterfaces);
+    }
 
     // open log
     OpenLogFile(DynamicCast<CybertwinNode>(GetNode())->GetLogDir(), "cybertwin.log");
@@ -105,6 +110,12 @@ Cybertwin::DoDispose()
 void
 Cybertwin::LocallyListen()
 {
+    if (m_localInterface.second == CYBERTWIN_SHARED_LISTEN_PORT)
+    {
+        // end hosts reach us through the manager's shared listener
+        return;
+    }
+
     NS_LOG_DEBUG("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
                      << "]: Cybertwin starts listening at local port " << m_localInterface.second);
     if (!m_localSocket)
@@ -144,6 +155,23 @@ Cybertwin::LocalConnCreatedCallback(Ptr<Socket> socket, const Address& address)
     socket->SetRecvCallback(MakeCallback(&Cybertwin::LocalRecvCallback, this));
 }
 
+void
+Cybertwin::AcceptLocalConnection(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Address peer;
+    socket->GetPeerName(peer);
+    LocalConnCreatedCallback(socket, peer);
+    socket->SetCloseCallbacks(MakeCallback(&Cybertwin::LocalNormalCloseCallback, this),
+                              MakeCallback(&Cybertwin::LocalErrorCloseCallback, this));
+
+    // the request may have arrived together with the demultiplexing header
+    if (socket->GetRxAvailable() > 0)
+    {
+        LocalRecvCallback(socket);
+    }
+}
+
 void
 Cybertwin::LocalNormalCloseCallback(Ptr<Socket> socket)
 {
@@ -181,6 +209,10 @@ Cybertwin::StartDownloadProcess(Ptr<Socket> endHostSock, CYBERTWINID_t targetID,
 
     InetSocketAddress targetAddr = InetSocketAddress(targetInterfaces[0].first, targetInterfaces[0].second);
     socket->Connect(targetAddr);
+    SendCybertwinDemuxHeader(socket,
+                             targetInterfaces[0].second,
+                             CybertwinDemuxHeader::CYBERTWIN_DEMUX_GLOBAL,
+                             targetID);
 
     // Set callbacks
     socket->SetAcceptCallback(MakeCallback(&Cybertwin::DownloadSocketAcceptCallback, this),
@@ -745,6 +777,30 @@ Cybertwin::SpErrorCloseCallback(Ptr<Socket> sock)
 //***************************************************************************************
 //*                     Handle incoming connections from cloud                          *
 //***************************************************************************************
+void
+Cybertwin::AcceptGlobalConnection(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+#if MDTP_ENABLED
+    // MDTP paths keep their dedicated listeners
+    NS_LOG_ERROR("Cybertwin[" << m_cybertwinId << "]: shared global listener is not used by MDTP");
+    socket->Close();
+#else
+    NewSpConnectionCreatedCallback(socket);
+    if (socket->GetRxAvailable() > 0)
+    {
+        SpConnectionRecvCallback(socket);
+    }
+#endif
+}
+
+void
+Cybertwin::SetPublishedByManager(bool published)
+{
+    NS_LOG_FUNCTION(this << published);
+    m_publishedByManager = published;
+}
+
 void
 Cybertwin::GloballyListen()
 {
@@ -756,6 +812,12 @@ Cybertwin::GloballyListen()
     m_dtServer->SetNewConnectCreatedCallback(
         MakeCallback(&Cybertwin::NewMpConnectionCreatedCallback, this));
 #else
+    if (m_globalInterfaces.empty() || m_globalInterfaces[0].second == CYBERTWIN_SHARED_LISTEN_PORT)
+    {
+        // cloud peers reach us through the manager's shared listeners
+        return;
+    }
+
     // init data server and listen for incoming connections
     m_dtServer = Socket::CreateSocket(GetNode(), TypeId::LookupByName("ns3::TcpSocketFactory"));
     // FIXME: attention, the port number is hard-coded here
@@ -1109,6 +1171,10 @@ CybertwinFullDuplexStream::DuplexStreamCloudConnect(CYBERTWINID_t cuid,
         MakeCallback(&CybertwinFullDuplexStream::DuplexStreamCloudConnectCallback, this),
         MakeCallback(&CybertwinFullDuplexStream::DuplexStreamCloudConnectErrorCallback, this));
     m_cloudSocket->Connect(InetSocketAddress(cloudIf.first, cloudIf.second));
+    SendCybertwinDemuxHeader(m_cloudSocket,
+                             cloudIf.second,
+                             CybertwinDemuxHeader::CYBERTWIN_DEMUX_GLOBAL,
+                             cuid);
 }
 
 void
@@ -123,6 +123,13 @@ class Cybertwin : public CybertwinApp
     static TypeId GetTypeId();
     void DoDispose() override;
 
+    // connections handed over by the CybertwinManager's shared listeners
+    void AcceptLocalConnection(Ptr<Socket> socket);
+    void AcceptGlobalConnection(Ptr<Socket> socket);
+
+    // the CybertwinManager publishes batch-created cybertwins to CNRS itself
+    void SetPublishedByManager(bool published);
+
   private:
     void StartApplication() override;
     void StopApplication() override;
@@ -214,6 +221,7 @@ private:
     CYBERTWIN_INTERFACE_LIST_t m_globalInterfaces;
 
     Ptr<NameResolutionService> m_cnrs;
+    bool m_publishedByManager;
     std::unordered_map<CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t> nameResolutionCache;
     // Cybertwin multiple interfaces
 
@@ -270,7 +270,15 @@ NameResolutionService::ServiceRecvHandler(Ptr<Socket> socket)
             break;
         case CNRS_INSERT:
             NS_LOG_DEBUG("CNRS: insert request.");
-            ProcessInsert(rcvHeader, socket);
+            if (packet->GetSize() > 0)
+            {
+                // several insert headers packed into one report
+                ProcessInsertBatch(rcvHeader, packet, socket, from);
+            }
+            else
+            {
+                ProcessInsert(rcvHeader, socket);
+            }
             break;
         default:
             NS_LOG_DEBUG("CNRS: Unknown request.");
@@ -457,6 +465,37 @@ NameResolutionService::ProcessInsert(CNRSHeader& rcvHeader, Ptr<Socket> socket)
     socket->Send(rspPacket);
 }
 
+void
+NameResolutionService::ProcessInsertBatch(CNRSHeader& rcvHeader,
+                                          Ptr<Packet> packet,
+                                          Ptr<Socket> socket,
+                                          Address& from)
+{
+    NS_LOG_DEBUG(this << "CNRS: handle batched insert request.");
+
+    CNRSItemList_t items;
+    items.push_back(std::make_pair(rcvHeader.GetCuid(), rcvHeader.GetInterfaceList()));
+    while (packet->GetSize() > 0)
+    {
+        CNRSHeader header;
+        packet->RemoveHeader(header);
+        if (header.GetMethod() != CNRS_INSERT)
+        {
+            NS_LOG_DEBUG("CNRS: unexpected method in batched insert.");
+            break;
+        }
+        items.push_back(std::make_pair(header.GetCuid(), header.GetInterfaceList()));
+    }
+
+    // one response for the whole batch
+    Ptr<Packet> rspPacket = Create<Packet>();
+    CNRSHeader rspHeader;
+    rspHeader.SetMethod(InsertCybertwinInterfaceNameBatch(items) < 0 ? CNRS_INSERT_FAIL
+                                                                      : CNRS_INSERT_OK);
+    rspPacket->AddHeader(rspHeader);
+    socket->SendTo(rspPacket, 0, from);
+}
+
 void
 NameResolutionService::ReportName2Superior(CYBERTWINID_t id, CYBERTWIN_INTERFACE_LIST_t interfaces)
 {
@@ -481,6 +520,43 @@ NameResolutionService::ReportName2Superior(CYBERTWINID_t id, CYBERTWIN_INTERFACE
     clientSocket->Send(pack);
 }
 
+void
+NameResolutionService::ReportNames2Superior(CNRSItemList_t items)
+{
+    NS_LOG_DEBUG("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                     << "][CNRS]: Report " << items.size() << " new items to superior.");
+    if (InitClientUDPSocket() < 0)
+    {
+        NS_LOG_DEBUG("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                         << "][CNRS]: Report new items to superior fail.");
+        return;
+    }
+    NS_ASSERT_MSG(clientSocket != nullptr, "clientSocket is nullptr.");
+
+    // pack the headers back to front, so they are read in insertion order
+    Ptr<Packet> pack = Create<Packet>();
+    for (auto it = items.rbegin(); it != items.rend(); ++it)
+    {
+        CNRSHeader header;
+        header.SetMethod(CNRS_INSERT);
+        header.SetCuid(it->first);
+        header.SetInterfaceList(it->second);
+
+        if (pack->GetSize() > 0 &&
+            pack->GetSize() + header.GetSerializedSize() > CNRS_BATCH_MAX_BYTES)
+        {
+            clientSocket->Send(pack);
+            pack = Create<Packet>();
+        }
+        pack->AddHeader(header);
+    }
+
+    if (pack->GetSize() > 0)
+    {
+        clientSocket->Send(pack);
+    }
+}
+
 /**
  * @brief get cybertwin interface by name call by application
  *
@@ -557,6 +633,37 @@ NameResolutionService::InsertCybertwinInterfaceName(CYBERTWINID_t name,
     return 0;
 }
 
+/**
+ * @brief insert new items to database and report them to superior in batch
+ */
+int32_t
+NameResolutionService::InsertCybertwinInterfaceNameBatch(const CNRSItemList_t& items)
+{
+    NS_LOG_DEBUG("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName
+                     << "][CNRS]: Insert " << items.size() << " Cybertwin Interface Names.");
+
+    CNRSItemList_t newItems;
+    for (const auto& item : items)
+    {
+        // to prevent circle, skip items already known
+        auto it = itemCache.find(item.first);
+        if (it != itemCache.end() && it->second == item.second)
+        {
+            continue;
+        }
+        itemCache[item.first] = item.second;
+        newItems.push_back(item);
+    }
+
+    // if not root, report to superior
+    if (!m_isCNRSRoot && !newItems.empty())
+    {
+        Simulator::ScheduleNow(&NameResolutionService::ReportNames2Superior, this, newItems);
+    }
+
+    return 0;
+}
+
 QUERY_ID_t
 NameResolutionService::GetQueryID()
 {
@@ -6,10 +6,12 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace ns3
 {
 typedef std::pair<Ptr<Socket>, Address> PeerInfo_t;
+typedef std::vector<std::pair<CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t>> CNRSItemList_t;
 
 class NameResolutionService : public Application
 {
@@ -34,6 +36,16 @@ class NameResolutionService : public Application
                                         Callback<void, CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t>);
     int32_t InsertCybertwinInterfaceName(CYBERTWINID_t name, CYBERTWIN_INTERFACE_LIST_t& interface);
 
+    /**
+     * @brief insert several items at once, new items are reported to the
+     * superior packed into as few datagrams as possible
+     *
+     * @param items  cybertwin names and their interfaces
+     *
+     * @return int32_t 0: success, -1: fail
+     */
+    int32_t InsertCybertwinInterfaceNameBatch(const CNRSItemList_t& items);
+
   private:
     void StartApplication() override;
     void StopApplication() override;
@@ -49,7 +61,9 @@ class NameResolutionService : public Application
     void ProcessQuery(CNRSHeader& rcvHeader, Ptr<Socket> socekt, Address& from);
     void QueryResponseHandler(bool status, CNRSHeader& rcvHeader);
     void ProcessInsert(CNRSHeader& rcvHeader, Ptr<Socket> socket);
+    void ProcessInsertBatch(CNRSHeader& rcvHeader, Ptr<Packet> packet, Ptr<Socket> socket, Address& from);
     void ReportName2Superior(CYBERTWINID_t id, CYBERTWIN_INTERFACE_LIST_t interfaces);
+    void ReportNames2Superior(CNRSItemList_t items);
 
     void InformCNRSResult(CYBERTWINID_t id, QUERY_ID_t qId, Ptr<Socket> socket, Address& from);
 
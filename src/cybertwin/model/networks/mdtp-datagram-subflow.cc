@@ -0,0 +1,532 @@
+#include "ns3/mdtp-datagram-subflow.h"
+
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE_FLOOR("MdtpDatagramSubflow", CYBERTWIN_LOG_FLOOR);
+NS_OBJECT_ENSURE_REGISTERED(MdtpDatagramSubflow);
+
+TypeId
+MdtpDatagramSubflow::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MdtpDatagramSubflow")
+            .SetParent<Object>()
+            .SetGroupName("Cybertwin")
+            .AddConstructor<MdtpDatagramSubflow>()
+            .AddAttribute("TxBufferSize",
+                          "Bytes queued or unacknowledged beyond which Send fails.",
+                          UintegerValue(131072),
+                          MakeUintegerAccessor(&MdtpDatagramSubflow::m_txBufferSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PacingRate",
+                          "The rate at which datagrams are paced onto the subflow.",
+                          DataRateValue(DataRate("1Gbps")),
+                          MakeDataRateAccessor(&MdtpDatagramSubflow::m_pacingRate),
+                          MakeDataRateChecker())
+            .AddAttribute("InitialWindow",
+                          "Initial congestion window in datagrams.",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&MdtpDatagramSubflow::m_initialWindow),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxWindow",
+                          "Upper bound of datagrams in flight.",
+                          UintegerValue(256),
+                          MakeUintegerAccessor(&MdtpDatagramSubflow::m_maxWindow),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("DupAckThreshold",
+                          "Duplicate ACKs that trigger a fast retransmission.",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&MdtpDatagramSubflow::m_dupAckThreshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("AckFrequency",
+                          "Number of in-order datagrams acknowledged by one ACK.",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&MdtpDatagramSubflow::m_ackFrequency),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("DelAckTimeout",
+                          "Timeout of a delayed ACK.",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&MdtpDatagramSubflow::m_delAckTimeout),
+                          MakeTimeChecker())
+            .AddAttribute("InitialRto",
+                          "Retransmission timeout before the first RTT sample.",
+                          TimeValue(MilliSeconds(200)),
+                          MakeTimeAccessor(&MdtpDatagramSubflow::m_initialRto),
+                          MakeTimeChecker())
+            .AddAttribute("MinRto",
+                          "Lower bound of the retransmission timeout.",
+                          TimeValue(MilliSeconds(10)),
+                          MakeTimeAccessor(&MdtpDatagramSubflow::m_minRto),
+                          MakeTimeChecker())
+            .AddAttribute("MaxRto",
+                          "Upper bound of the backed-off retransmission timeout.",
+                          TimeValue(Seconds(2)),
+                          MakeTimeAccessor(&MdtpDatagramSubflow::m_maxRto),
+                          MakeTimeChecker());
+    return tid;
+}
+
+TypeId
+MdtpDatagramSubflow::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+MdtpDatagramSubflow::MdtpDatagramSubflow()
+    : m_socket(nullptr),
+      m_closed(false),
+      m_txBufferBytes(0),
+      m_nextTxSeq(0),
+      m_sndUna(0),
+      m_recover(0),
+      m_inRecovery(false),
+      m_dupAcks(0),
+      m_cwnd(0),
+      m_ssthresh(UINT32_MAX),
+      m_rxNext(0),
+      m_lastRxSeq(0),
+      m_unackedRx(0),
+      m_txDatagrams(0),
+      m_retxDatagrams(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_rtt = CreateObject<RttMeanDeviation>();
+}
+
+MdtpDatagramSubflow::~MdtpDatagramSubflow()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MdtpDatagramSubflow::DoDispose()
+{
+    Close();
+    m_socket = nullptr;
+    m_recvCallback = MakeNullCallback<void, Ptr<MdtpDatagramSubflow>>();
+    m_sendCallback = MakeNullCallback<void, Ptr<MdtpDatagramSubflow>, uint32_t>();
+    Object::DoDispose();
+}
+
+void
+MdtpDatagramSubflow::SetSocket(Ptr<Socket> sock, Address peer, bool owned)
+{
+    NS_LOG_FUNCTION(this << sock << peer << owned);
+    m_socket = sock;
+    m_peer = peer;
+    m_cwnd = m_initialWindow;
+    m_rto = m_initialRto;
+    if (owned)
+    {
+        m_socket->SetRecvCallback(MakeCallback(&MdtpDatagramSubflow::HandleRead, this));
+    }
+}
+
+void
+MdtpDatagramSubflow::SetRecvCallback(Callback<void, Ptr<MdtpDatagramSubflow>> recvCb)
+{
+    m_recvCallback = recvCb;
+}
+
+void
+MdtpDatagramSubflow::SetSendCallback(Callback<void, Ptr<MdtpDatagramSubflow>, uint32_t> sendCb)
+{
+    m_sendCallback = sendCb;
+}
+
+int32_t
+MdtpDatagramSubflow::Send(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+    if (m_socket == nullptr || m_closed)
+    {
+        NS_LOG_ERROR("Datagram subflow is not usable.");
+        return -1;
+    }
+
+    if (packet->GetSize() > GetTxAvailable())
+    {
+        NS_LOG_LOGIC("Datagram subflow buffer is full.");
+        return -1;
+    }
+
+    m_txQueue.push_back(packet);
+    m_txBufferBytes += packet->GetSize();
+    TrySend();
+    return packet->GetSize();
+}
+
+Ptr<Packet>
+MdtpDatagramSubflow::Recv()
+{
+    if (m_rxBuffer.empty())
+    {
+        return nullptr;
+    }
+
+    Ptr<Packet> packet = m_rxBuffer.front();
+    m_rxBuffer.pop();
+    return packet;
+}
+
+void
+MdtpDatagramSubflow::Close()
+{
+    NS_LOG_FUNCTION(this);
+    m_closed = true;
+    m_rtoEvent.Cancel();
+    m_paceEvent.Cancel();
+    m_delAckEvent.Cancel();
+}
+
+uint32_t
+MdtpDatagramSubflow::GetTxAvailable() const
+{
+    return m_txBufferBytes < m_txBufferSize ? m_txBufferSize - m_txBufferBytes : 0;
+}
+
+uint32_t
+MdtpDatagramSubflow::GetInFlight() const
+{
+    return m_inflight.size();
+}
+
+uint64_t
+MdtpDatagramSubflow::GetTxDatagrams() const
+{
+    return m_txDatagrams;
+}
+
+uint64_t
+MdtpDatagramSubflow::GetRetransmissions() const
+{
+    return m_retxDatagrams;
+}
+
+uint32_t
+MdtpDatagramSubflow::GetWindow() const
+{
+    return std::min(std::max(static_cast<uint32_t>(m_cwnd), 1U), m_maxWindow);
+}
+
+//*****************************************************************************
+//*                              Sender                                       *
+//*****************************************************************************
+void
+MdtpDatagramSubflow::TrySend()
+{
+    if (m_closed || m_paceEvent.IsRunning())
+    {
+        return;
+    }
+
+    while (!m_txQueue.empty() && m_inflight.size() < GetWindow())
+    {
+        Time now = Simulator::Now();
+        if (m_nextSendTime > now)
+        {
+            m_paceEvent =
+                Simulator::Schedule(m_nextSendTime - now, &MdtpDatagramSubflow::TrySend, this);
+            return;
+        }
+
+        Ptr<Packet> packet = m_txQueue.front();
+        m_txQueue.pop_front();
+
+        SequenceNumber32 seq = m_nextTxSeq++;
+        m_inflight[seq] = TxItem{packet, now, 0};
+        Transmit(seq, packet);
+    }
+}
+
+void
+MdtpDatagramSubflow::Transmit(SequenceNumber32 seq, Ptr<Packet> packet)
+{
+    // every data datagram piggybacks the receiver state
+    MdtpDatagramHeader header;
+    header.SetFlags(MdtpDatagramHeader::MDTP_DGRAM_DATA | MdtpDatagramHeader::MDTP_DGRAM_ACK);
+    header.SetSeq(seq.GetValue());
+    header.SetAck(m_rxNext.GetValue());
+    header.SetSack(m_lastRxSeq.GetValue());
+
+    Ptr<Packet> datagram = packet->Copy();
+    datagram->AddHeader(header);
+    m_socket->SendTo(datagram, 0, m_peer);
+    m_txDatagrams++;
+
+    m_unackedRx = 0;
+    m_delAckEvent.Cancel();
+
+    Time now = Simulator::Now();
+    m_nextSendTime = std::max(m_nextSendTime, now) +
+                     m_pacingRate.CalculateBytesTxTime(datagram->GetSize());
+
+    if (!m_rtoEvent.IsRunning())
+    {
+        RestartRtoTimer();
+    }
+}
+
+void
+MdtpDatagramSubflow::Retransmit(SequenceNumber32 seq)
+{
+    auto it = m_inflight.find(seq);
+    if (it == m_inflight.end())
+    {
+        return;
+    }
+
+    NS_LOG_DEBUG("Subflow " << this << " retransmits datagram " << seq);
+    it->second.retx++;
+    it->second.sentTime = Simulator::Now();
+    m_retxDatagrams++;
+    Transmit(seq, it->second.packet);
+}
+
+void
+MdtpDatagramSubflow::ProcessAck(const MdtpDatagramHeader& header)
+{
+    SequenceNumber32 ack(header.GetAck());
+    SequenceNumber32 sack(header.GetSack());
+    bool newAck = false;
+    uint32_t acked = 0;
+    Time now = Simulator::Now();
+
+    if (ack > m_sndUna)
+    {
+        // cumulative ACK, sample RTT on the newest never-retransmitted datagram (Karn)
+        auto it = m_inflight.begin();
+        while (it != m_inflight.end() && it->first < ack)
+        {
+            if (it->second.retx == 0 && it->first + 1 == ack)
+            {
+                m_rtt->Measurement(now - it->second.sentTime);
+            }
+            m_txBufferBytes -= it->second.packet->GetSize();
+            it = m_inflight.erase(it);
+            acked++;
+        }
+        m_sndUna = ack;
+        m_dupAcks = 0;
+        newAck = true;
+    }
+
+    // the datagram that triggered this ACK arrived out of order
+    if (sack > ack)
+    {
+        auto it = m_inflight.find(sack);
+        if (it != m_inflight.end())
+        {
+            if (it->second.retx == 0)
+            {
+                m_rtt->Measurement(now - it->second.sentTime);
+            }
+            m_txBufferBytes -= it->second.packet->GetSize();
+            m_inflight.erase(it);
+            acked++;
+        }
+    }
+
+    if (newAck)
+    {
+        if (m_inRecovery && ack >= m_recover)
+        {
+            m_inRecovery = false;
+        }
+        else if (m_inRecovery)
+        {
+            // partial ACK, the next hole is lost as well
+            Retransmit(m_sndUna);
+        }
+
+        if (m_rtt->GetNSamples() > 0)
+        {
+            m_rto = std::min(std::max(m_rtt->GetEstimate() + m_rtt->GetVariation() * 4, m_minRto),
+                             m_maxRto);
+        }
+        RestartRtoTimer();
+    }
+    else if (!header.IsData() && !m_inflight.empty() && ack == m_sndUna && sack > ack)
+    {
+        if (++m_dupAcks == m_dupAckThreshold && !m_inRecovery)
+        {
+            EnterLossRecovery();
+            Retransmit(m_sndUna);
+        }
+    }
+
+    if (!m_inRecovery && acked > 0)
+    {
+        if (m_cwnd < m_ssthresh)
+        {
+            m_cwnd += acked;
+        }
+        else
+        {
+            m_cwnd += static_cast<double>(acked) / m_cwnd;
+        }
+        m_cwnd = std::min(m_cwnd, static_cast<double>(m_maxWindow));
+    }
+
+    if (m_inflight.empty())
+    {
+        m_rtoEvent.Cancel();
+    }
+
+    TrySend();
+    if (acked > 0 && !m_sendCallback.IsNull())
+    {
+        m_sendCallback(this, GetTxAvailable());
+    }
+}
+
+void
+MdtpDatagramSubflow::EnterLossRecovery()
+{
+    m_ssthresh = std::max<uint32_t>(m_inflight.size() / 2, 2);
+    m_cwnd = m_ssthresh;
+    m_inRecovery = true;
+    m_recover = m_nextTxSeq;
+}
+
+void
+MdtpDatagramSubflow::RestartRtoTimer()
+{
+    m_rtoEvent.Cancel();
+    if (!m_closed && !m_inflight.empty())
+    {
+        m_rtoEvent =
+            Simulator::Schedule(m_rto, &MdtpDatagramSubflow::RetransmitTimeout, this);
+    }
+}
+
+void
+MdtpDatagramSubflow::RetransmitTimeout()
+{
+    if (m_inflight.empty())
+    {
+        return;
+    }
+
+    NS_LOG_DEBUG("Subflow " << this << " retransmission timeout, rto = " << m_rto);
+    m_ssthresh = std::max<uint32_t>(m_inflight.size() / 2, 2);
+    m_cwnd = 1;
+    m_inRecovery = false;
+    m_dupAcks = 0;
+    m_rto = std::min(m_rto * 2, m_maxRto);
+
+    Retransmit(m_inflight.begin()->first);
+    RestartRtoTimer();
+}
+
+//*****************************************************************************
+//*                             Receiver                                      *
+//*****************************************************************************
+void
+MdtpDatagramSubflow::HandleRead(Ptr<Socket> sock)
+{
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = sock->RecvFrom(from)))
+    {
+        Receive(packet);
+    }
+}
+
+void
+MdtpDatagramSubflow::Receive(Ptr<Packet> packet)
+{
+    if (m_closed)
+    {
+        return;
+    }
+
+    MdtpDatagramHeader header;
+    if (packet->RemoveHeader(header) == 0)
+    {
+        NS_LOG_DEBUG("Unknown datagram, except MDTP datagram header.");
+        return;
+    }
+
+    if (header.IsAck())
+    {
+        ProcessAck(header);
+    }
+    if (header.IsData())
+    {
+        ProcessData(header, packet);
+    }
+}
+
+void
+MdtpDatagramSubflow::ProcessData(const MdtpDatagramHeader& header, Ptr<Packet> packet)
+{
+    SequenceNumber32 seq(header.GetSeq());
+    m_lastRxSeq = seq;
+
+    if (seq < m_rxNext)
+    {
+        // duplicate, the peer missed our ACK
+        SendAck();
+        return;
+    }
+
+    if (seq > m_rxNext)
+    {
+        // out of order, acknowledge at once so the sender sees the hole
+        m_rxOutOfOrder.emplace(seq, packet);
+        SendAck();
+        return;
+    }
+
+    bool fillHole = !m_rxOutOfOrder.empty();
+    m_rxBuffer.push(packet);
+    m_rxNext++;
+    while (!m_rxOutOfOrder.empty() && m_rxOutOfOrder.begin()->first == m_rxNext)
+    {
+        m_rxBuffer.push(m_rxOutOfOrder.begin()->second);
+        m_rxOutOfOrder.erase(m_rxOutOfOrder.begin());
+        m_rxNext++;
+    }
+
+    if (fillHole || ++m_unackedRx >= m_ackFrequency)
+    {
+        SendAck();
+    }
+    else if (!m_delAckEvent.IsRunning())
+    {
+        m_delAckEvent =
+            Simulator::Schedule(m_delAckTimeout, &MdtpDatagramSubflow::SendAck, this);
+    }
+
+    if (!m_recvCallback.IsNull())
+    {
+        m_recvCallback(this);
+    }
+}
+
+void
+MdtpDatagramSubflow::SendAck()
+{
+    if (m_closed)
+    {
+        return;
+    }
+
+    MdtpDatagramHeader header;
+    header.SetFlags(MdtpDatagramHeader::MDTP_DGRAM_ACK);
+    header.SetAck(m_rxNext.GetValue());
+    header.SetSack(m_lastRxSeq.GetValue());
+
+    Ptr<Packet> ack = Create<Packet>();
+    ack->AddHeader(header);
+    m_socket->SendTo(ack, 0, m_peer);
+
+    m_unackedRx = 0;
+    m_delAckEvent.Cancel();
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+#ifndef CYBERTWIN_MDTP_DATAGRAM_SUBFLOW_H
+#define CYBERTWIN_MDTP_DATAGRAM_SUBFLOW_H
+#include "../cybertwin-common.h"
+#include "../cybertwin-header.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/sequence-number.h"
+#include "ns3/socket.h"
+#include <deque>
+#include <map>
+#include <queue>
+
+namespace ns3
+{
+
+//*****************************************************************************
+//*                      MDTP Datagram Subflow                                *
+//*****************************************************************************
+// A lightweight reliable subflow over a UDP socket, used by SinglePath in
+// place of a full TCP socket. Every datagram carries a MdtpDatagramHeader;
+// the receiver delivers in order and acknowledges cumulatively (plus the
+// triggering sequence number), the sender recovers losses by duplicate ACKs
+// and a retransmission timer, and paces transmissions at PacingRate within
+// a simple AIMD window. Like a TCP socket, Send() fails once TxBufferSize
+// bytes are queued or unacknowledged, and the send callback reports the
+// room freed by the ACKs.
+class MdtpDatagramSubflow : public Object
+{
+  public:
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    MdtpDatagramSubflow();
+    ~MdtpDatagramSubflow() override;
+
+    // socket binding: an owned socket is read by the subflow itself, a shared
+    // one (server side) is read by its owner which calls Receive()
+    void SetSocket(Ptr<Socket> sock, Address peer, bool owned);
+    void SetRecvCallback(Callback<void, Ptr<MdtpDatagramSubflow>> recvCb);
+    void SetSendCallback(Callback<void, Ptr<MdtpDatagramSubflow>, uint32_t> sendCb);
+
+    // data transfer
+    int32_t Send(Ptr<Packet> packet);
+    Ptr<Packet> Recv();
+    void Receive(Ptr<Packet> packet);
+    void Close();
+
+    // statistics
+    uint32_t GetTxAvailable() const;
+    uint32_t GetInFlight() const;
+    uint64_t GetTxDatagrams() const;
+    uint64_t GetRetransmissions() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    struct TxItem
+    {
+        Ptr<Packet> packet;
+        Time sentTime;
+        uint32_t retx;
+    };
+
+    void HandleRead(Ptr<Socket> sock);
+    void TrySend();
+    void Transmit(SequenceNumber32 seq, Ptr<Packet> packet);
+    void Retransmit(SequenceNumber32 seq);
+    void ProcessAck(const MdtpDatagramHeader& header);
+    void ProcessData(const MdtpDatagramHeader& header, Ptr<Packet> packet);
+    void SendAck();
+    void RetransmitTimeout();
+    void RestartRtoTimer();
+    void EnterLossRecovery();
+    uint32_t GetWindow() const;
+
+    Ptr<Socket> m_socket;
+    Address m_peer;
+    bool m_closed;
+    Callback<void, Ptr<MdtpDatagramSubflow>> m_recvCallback;
+    Callback<void, Ptr<MdtpDatagramSubflow>, uint32_t> m_sendCallback;
+
+    // attributes
+    uint32_t m_txBufferSize;
+    DataRate m_pacingRate;
+    uint32_t m_initialWindow;
+    uint32_t m_maxWindow;
+    uint32_t m_dupAckThreshold;
+    uint32_t m_ackFrequency;
+    Time m_delAckTimeout;
+    Time m_initialRto;
+    Time m_minRto;
+    Time m_maxRto;
+
+    // sender
+    std::deque<Ptr<Packet>> m_txQueue;
+    uint32_t m_txBufferBytes; // bytes queued or unacknowledged
+    std::map<SequenceNumber32, TxItem> m_inflight;
+    SequenceNumber32 m_nextTxSeq;
+    SequenceNumber32 m_sndUna;
+    SequenceNumber32 m_recover;
+    bool m_inRecovery;
+    uint32_t m_dupAcks;
+    double m_cwnd;
+    uint32_t m_ssthresh;
+    Ptr<RttEstimator> m_rtt;
+    Time m_rto;
+    Time m_nextSendTime;
+    EventId m_rtoEvent;
+    EventId m_paceEvent;
+
+    // receiver
+    SequenceNumber32 m_rxNext;
+    SequenceNumber32 m_lastRxSeq;
+    std::map<SequenceNumber32, Ptr<Packet>> m_rxOutOfOrder;
+    std::queue<Ptr<Packet>> m_rxBuffer;
+    uint32_t m_unackedRx;
+    EventId m_delAckEvent;
+
+    // log information
+    uint64_t m_txDatagrams;
+    uint64_t m_retxDatagrams;
+};
+
+} // namespace ns3
+
+#endif
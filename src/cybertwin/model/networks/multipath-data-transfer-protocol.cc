@@ -1,8 +1,10 @@
 #include "ns3/multipath-data-transfer-protocol.h"
 
+#include "ns3/abort.h"
+
 namespace ns3
 {
-NS_LOG_COMPONENT_DEFINE("CybertwinMultipathTransfer");
+NS_LOG_COMPONENT_DEFINE_FLOOR("CybertwinMultipathTransfer", CYBERTWIN_LOG_FLOOR);
 NS_OBJECT_ENSURE_REGISTERED(CybertwinDataTransferServer);
 NS_OBJECT_ENSURE_REGISTERED(MultipathConnection);
 NS_OBJECT_ENSURE_REGISTERED(SinglePath);
@@ -71,7 +73,8 @@ CybertwinDataTransferServer::Listen()
 
         // bind socket
         InetSocketAddress inetAddress = InetSocketAddress(interface.first, interface.second);
-        NS_ASSERT(cyberEar->Bind(inetAddress) >= 0);
+        int32_t ret = cyberEar->Bind(inetAddress);
+        NS_ABORT_MSG_IF(ret < 0, "Failed to bind " << interface.first << ":" << interface.second);
 
         cyberEar->SetAcceptCallback(
             MakeCallback(&CybertwinDataTransferServer::PathRequestCallback, this),
@@ -80,6 +83,16 @@ CybertwinDataTransferServer::Listen()
         cyberEar->Listen();
         
         NS_LOG_DEBUG("Start listen in " << interface.first << ":" << interface.second);
+
+        // datagram subflows share one UDP socket per interface
+        Ptr<Socket> dgramEar = Socket::CreateSocket(m_node, UdpSocketFactory::GetTypeId());
+        dgramEar->BindToNetDevice(netDevice);
+        ret = dgramEar->Bind(inetAddress);
+        NS_ABORT_MSG_IF(ret < 0,
+                        "Failed to bind datagrams to " << interface.first << ":"
+                                                       << interface.second);
+        dgramEar->SetRecvCallback(
+            MakeCallback(&CybertwinDataTransferServer::DatagramRecvCallback, this));
     }
 }
 
@@ -101,6 +114,59 @@ CybertwinDataTransferServer::PathCreatedCallback(Ptr<Socket> sock, const Address
 {
     NS_LOG_FUNCTION(this << sock << addr);
 
+    SinglePath* path = CreateListenPath(sock, addr);
+    path->PathListen();
+}
+
+void
+CybertwinDataTransferServer::DatagramRecvCallback(Ptr<Socket> sock)
+{
+    NS_LOG_FUNCTION(this << sock);
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = sock->RecvFrom(from)))
+    {
+        auto it = m_datagramSubflows.find(from);
+        if (it == m_datagramSubflows.end())
+        {
+            // only the first datagram of a subflow, carrying the build or
+            // join request, opens a path; late datagrams of a closed path
+            // would leave a listening path nobody frees
+            MdtpDatagramHeader header;
+            if (packet->PeekHeader(header) == 0 || !header.IsData() || header.GetSeq() != 0)
+            {
+                NS_LOG_DEBUG("Drop a datagram of an unknown subflow from " << from);
+                continue;
+            }
+            // first datagram from this peer, born a new path on the shared socket
+            SinglePath* path = CreateListenPath(sock, from);
+            Ptr<MdtpDatagramSubflow> subflow = CreateObject<MdtpDatagramSubflow>();
+            subflow->SetSocket(sock, from, false);
+            path->SetDatagramSubflow(subflow);
+            path->PathListen();
+            it = m_datagramSubflows.emplace(from, subflow).first;
+        }
+        it->second->Receive(packet);
+    }
+}
+
+void
+CybertwinDataTransferServer::DatagramPathClosed(const Address& peer)
+{
+    NS_LOG_FUNCTION(this << peer);
+    // the next datagram from this peer starts a new path
+    m_datagramSubflows.erase(peer);
+}
+
+uint32_t
+CybertwinDataTransferServer::GetDatagramPathCount() const
+{
+    return m_datagramSubflows.size();
+}
+
+SinglePath*
+CybertwinDataTransferServer::CreateListenPath(Ptr<Socket> sock, const Address& addr)
+{
     // create new SinglePath
     NS_LOG_DEBUG("Server born new path.");
     SinglePath* path = new SinglePath();
@@ -111,7 +177,7 @@ CybertwinDataTransferServer::PathCreatedCallback(Ptr<Socket> sock, const Address
     path->SetLocalCybertwinID(m_localCybertwinID);
     path->SetPathState(SinglePath::SINGLE_PATH_LISTEN);
 
-    path->PathListen();
+    return path;
 }
 
 MP_CONN_KEY_t
@@ -244,7 +310,17 @@ MultipathConnection::GetTypeId()
                           "The callback function when receiving report.",
                           CallbackValue(),
                           MakeCallbackAccessor(&MultipathConnection::m_recvReportCallback),
-                          MakeCallbackChecker());
+                          MakeCallbackChecker())
+            .AddAttribute("SubflowTransport",
+                          "The transport carrying the subflows of this connection, by "
+                          "default the one MDTP_DATAGRAM_SUBFLOW_ENABLED selects.",
+                          EnumValue(MDTP_DATAGRAM_SUBFLOW_ENABLED ? MDTP_SUBFLOW_DATAGRAM
+                                                                  : MDTP_SUBFLOW_TCP),
+                          MakeEnumAccessor(&MultipathConnection::m_subflowTransport),
+                          MakeEnumChecker(MDTP_SUBFLOW_TCP,
+                                          "Tcp",
+                                          MDTP_SUBFLOW_DATAGRAM,
+                                          "Datagram"));
         
     return tid;
 }
@@ -258,6 +334,8 @@ MultipathConnection::GetInstanceTypeId() const
 MultipathConnection::MultipathConnection()
 {
     NS_LOG_FUNCTION("MultipathConnection constructor.");
+    // connections are created with new, apply the attribute defaults here
+    ConstructSelf(AttributeConstructionList());
     m_node = nullptr;
     m_localCyberID = 0;
     m_peerCyberID = 0;
@@ -288,6 +366,7 @@ MultipathConnection::MultipathConnection(SinglePath* path)
     NS_ASSERT_MSG(path, "path is null.");
     NS_ASSERT_MSG(path->GetPathState() == SinglePath::SINGLE_PATH_CONNECTED,
                   "path state is not connected.");
+    ConstructSelf(AttributeConstructionList());
     m_node = nullptr; // currently not used
     m_localCyberID = path->GetLocalCybertwinID();
     m_peerCyberID = path->GetRemoteCybertwinID();
@@ -297,6 +376,7 @@ MultipathConnection::MultipathConnection(SinglePath* path)
     m_recvSeqNum = m_connID;
     m_connState = MP_CONN_CONNECT;
     m_pathNum = 0;
+    m_subflowTransport = path->GetTransport();
 
     m_paths.push_back(path);
 
@@ -366,7 +446,10 @@ MultipathConnection::OnCybertwinInterfaceResolved(CYBERTWINID_t peerId,
     {
         NS_LOG_DEBUG("Using interface : "<<itf);
         SinglePath* path = new SinglePath();
-        Ptr<Socket> sock = Socket::CreateSocket(m_node, TcpSocketFactory::GetTypeId());
+        TypeId factory = m_subflowTransport == MDTP_SUBFLOW_DATAGRAM
+                             ? UdpSocketFactory::GetTypeId()
+                             : TcpSocketFactory::GetTypeId();
+        Ptr<Socket> sock = Socket::CreateSocket(m_node, factory);
 
         // find netdevice by ipaddr and bind socket to it
         netDevice = ipv4->GetNetDevice(ipv4->GetInterfaceForAddress(itf.first));
@@ -374,7 +457,17 @@ MultipathConnection::OnCybertwinInterfaceResolved(CYBERTWINID_t peerId,
         sock->BindToNetDevice(netDevice);
         
         path->SetSocket(sock);
-        path->SetRemoteInteface(interfaces[pathNum++]);
+        path->SetRemoteInteface(interfaces[pathNum]);
+        if (m_subflowTransport == MDTP_SUBFLOW_DATAGRAM)
+        {
+            Ptr<MdtpDatagramSubflow> subflow = CreateObject<MdtpDatagramSubflow>();
+            subflow->SetSocket(
+                sock,
+                InetSocketAddress(interfaces[pathNum].first, interfaces[pathNum].second),
+                true);
+            path->SetDatagramSubflow(subflow);
+        }
+        pathNum++;
         path->SetLocalKey(m_localKey);
         path->SetLocalCybertwinID(m_localCyberID);
         path->SetConnection(this);
@@ -406,6 +499,11 @@ MultipathConnection::Send(Ptr<Packet> packet)
     header.SetDataSeqNum(m_sendSeqNum);
     header.SetDataLen(pktSize);
     packet->AddHeader(header);
+    // lets the flow monitor tell the streams apart, whatever the subflows
+    if (MdtpFlowTag::IsEnabled())
+    {
+        packet->AddByteTag(MdtpFlowTag(m_localCyberID, m_peerCyberID, m_connID));
+    }
 
     // update send sequence number
     m_sendSeqNum += pktSize;
@@ -441,7 +539,12 @@ MultipathConnection::SendData()
     while (counter < MULTIPATH_MAXSENT_PACKET_ONCE && !m_txBuffer.empty())
     {
         Ptr<Packet> pkt = m_txBuffer.front();
-        m_paths[pathIndex]->Send(pkt);
+        if (m_paths[pathIndex]->Send(pkt) < 0)
+        {
+            // the subflow is full, resume when it frees room
+            NS_LOG_DEBUG("No room in path " << pathIndex << ", wait.");
+            break;
+        }
         m_txBuffer.pop();
 
         counter++;
@@ -721,6 +824,19 @@ MultipathConnection::GetConnID()
     return m_connID;
 }
 
+void
+MultipathConnection::SetSubflowTransport(MdtpSubflowTransport transport)
+{
+    NS_ASSERT_MSG(m_paths.empty(), "Subflow transport must be chosen before connecting.");
+    m_subflowTransport = transport;
+}
+
+MdtpSubflowTransport
+MultipathConnection::GetSubflowTransport() const
+{
+    return m_subflowTransport;
+}
+
 void
 MultipathConnection::SetConnectCallback(Callback<void, MultipathConnection*> succeedCb,
                                         Callback<void, MultipathConnection*> failCb)
@@ -850,6 +966,8 @@ SinglePath::GetInstanceTypeId() const
 
 SinglePath::SinglePath()
     : m_socket(nullptr),
+      m_transport(MDTP_SUBFLOW_TCP),
+      m_dgramSubflow(nullptr),
       m_localKey(0),
       m_remoteKey(0),
       m_localCybertwinID(0),
@@ -883,7 +1001,7 @@ SinglePath::Send(Ptr<Packet> pkt)
     int32_t ret = 0;
     //NS_LOG_DEBUG("SinglePath[" << m_pathId << "] send packet. Size: " << pkt->GetSize());
     //NS_LOG_UNCOND("SinglePath[" << m_pathId << "] send packet. Size: " << pkt->GetSize());
-    ret = m_socket->Send(pkt);
+    ret = PathSendPacket(pkt);
     if (ret <= 0)
     {
         //NS_LOG_ERROR("SinglePath[" << m_pathId << "] send packet failed.");
@@ -907,10 +1025,8 @@ SinglePath::Recv()
         return nullptr;
     }
 
-    Ptr<Packet> packet = m_rxBuffer.front();
+    Ptr<Packet> packet = m_rxBuffer.front().second;
     m_rxBuffer.pop();
-    MultipathHeaderDSN pktHeader;
-    packet->RemoveHeader(pktHeader);
 
     return packet;
 }
@@ -926,11 +1042,8 @@ SinglePath::HeadPacketSeqNum()
         return headSeq;
     }
 
-    Ptr<Packet> pack = m_rxBuffer.front();
-    MultipathHeaderDSN header;
     NS_LOG_DEBUG("SinglePath[" << m_pathId << "] rx buffer size: " << m_rxBuffer.size());
-    pack->PeekHeader(header);
-    headSeq = header.GetDataSeqNum();
+    headSeq = m_rxBuffer.front().first;
 
     return headSeq;
 }
@@ -962,6 +1075,12 @@ SinglePath::PathConnect()
 
     //m_socket->Bind();
     NS_LOG_DEBUG("SinglePath[" << m_pathId << "] connecting to " << m_remoteIf.first << ":" << m_remoteIf.second);
+    if (m_transport == MDTP_SUBFLOW_DATAGRAM)
+    {
+        // no handshake below MDTP, the path is ready at once
+        Simulator::ScheduleNow(&SinglePath::PathConnectSucceeded, this, m_socket);
+        return 0;
+    }
     m_socket->Connect(InetSocketAddress(m_remoteIf.first, m_remoteIf.second));
 
     m_socket->SetConnectCallback(MakeCallback(&SinglePath::PathConnectSucceeded, this),
@@ -981,7 +1100,11 @@ SinglePath::PathListen()
     }
 
     m_pathState = SINGLE_PATH_LISTEN;
-    m_socket->SetRecvCallback(MakeCallback(&SinglePath::PathRecvHandler, this));
+    if (m_transport == MDTP_SUBFLOW_TCP)
+    {
+        m_socket->SetRecvCallback(MakeCallback(&SinglePath::PathRecvHandler, this));
+        m_socket->SetSendCallback(MakeCallback(&SinglePath::PathSendHandler, this));
+    }
 
     return 0;
 }
@@ -995,6 +1118,18 @@ SinglePath::PathClose()
         return -1;
     }
 
+    if (m_transport == MDTP_SUBFLOW_DATAGRAM)
+    {
+        // the socket may be shared with other paths, only stop the subflow
+        m_dgramSubflow->Close();
+        if (m_server)
+        {
+            m_server->DatagramPathClosed(m_peerAddr);
+        }
+        Simulator::ScheduleNow(&SinglePath::PathCloseSucceeded, this, m_socket);
+        return 0;
+    }
+
     m_socket->Close();
     return 0;
 }
@@ -1010,7 +1145,11 @@ SinglePath::PathConnectSucceeded(Ptr<Socket> sock)
 {
     NS_LOG_DEBUG("Path connect success.");
     // set receive handler
-    sock->SetRecvCallback(MakeCallback(&SinglePath::PathRecvHandler, this));
+    if (m_transport == MDTP_SUBFLOW_TCP)
+    {
+        sock->SetRecvCallback(MakeCallback(&SinglePath::PathRecvHandler, this));
+        sock->SetSendCallback(MakeCallback(&SinglePath::PathSendHandler, this));
+    }
     // m_socket = sock;
 
     // change state
@@ -1036,6 +1175,52 @@ SinglePath::PathRecvHandler(Ptr<Socket> socket)
     StateProcesser();
 }
 
+void
+SinglePath::PathDatagramRecvHandler(Ptr<MdtpDatagramSubflow> subflow)
+{
+    NS_LOG_FUNCTION(this);
+    StateProcesser();
+}
+
+void
+SinglePath::PathSendHandler(Ptr<Socket> socket, uint32_t available)
+{
+    // the connection may have data held back by a full subflow
+    if (m_connection && m_pathState == SINGLE_PATH_CONNECTED)
+    {
+        m_connection->SendData();
+    }
+}
+
+void
+SinglePath::PathDatagramSendHandler(Ptr<MdtpDatagramSubflow> subflow, uint32_t available)
+{
+    PathSendHandler(m_socket, available);
+}
+
+Ptr<Packet>
+SinglePath::PathRecvPacket()
+{
+    if (m_transport == MDTP_SUBFLOW_DATAGRAM)
+    {
+        return m_dgramSubflow->Recv();
+    }
+
+    Address from;
+    return m_socket->RecvFrom(from);
+}
+
+int32_t
+SinglePath::PathSendPacket(Ptr<Packet> packet)
+{
+    if (m_transport == MDTP_SUBFLOW_DATAGRAM)
+    {
+        return m_dgramSubflow->Send(packet);
+    }
+
+    return m_socket->Send(packet);
+}
+
 void
 SinglePath::PathCloseSucceeded(Ptr<Socket> socket)
 {
@@ -1093,7 +1278,7 @@ SinglePath::SendPacketWithHeader(MultipathHeader header)
     Ptr<Packet> packet = Create<Packet>();
     packet->AddHeader(header);
 
-    return m_socket->Send(packet);
+    return PathSendPacket(packet);
 }
 
 void
@@ -1133,8 +1318,7 @@ SinglePath::ProcessBuildSent()
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("ProcessBuildSent");
     Ptr<Packet> packet;
-    Address from;
-    while ((packet = m_socket->RecvFrom(from)))
+    while ((packet = PathRecvPacket()))
     {
         MultipathHeader rcvHeader;
         if (packet->PeekHeader(rcvHeader) == 0)
@@ -1185,21 +1369,23 @@ SinglePath::ProcessConnected()
 {
     NS_LOG_FUNCTION(this);
     Ptr<Packet> packet;
-    Address from;
-    while ((packet = m_socket->RecvFrom(from)))
+    while ((packet = PathRecvPacket()))
     {
-        MultipathHeaderDSN dsnHeader;
-        packet->PeekHeader(dsnHeader);
+        // strip the header once, the connection asks for the head
+        // sequence number several times per packet
+        std::optional<MultipathHeaderDSN> dsnHeader = StripHeader<MultipathHeaderDSN>(packet);
+        if (!dsnHeader)
+        {
+            NS_LOG_DEBUG("Packet shorter than the DSN header.");
+            continue;
+        }
 
         // check whether the packet Header and payload match
-        //NS_ASSERT_MSG(dsnHeader.GetDataLen() + dsnHeader.GetSerializedSize() == packet->GetSize(),
+        //NS_ASSERT_MSG(dsnHeader->GetDataLen() == packet->GetSize(),
         //              "Path Header and Payload don't match.");
-        
-        //dsnHeader.Print(std::cout);
 
-        Ptr<Packet> rcvPacket = packet->Copy();
-        m_rxBuffer.push(rcvPacket);
-        m_rxTotalBytes += rcvPacket->GetSize() - dsnHeader.GetSerializedSize();
+        m_rxBuffer.push({dsnHeader->GetDataSeqNum(), packet});
+        m_rxTotalBytes += packet->GetSize();
     }
 
     // Notify connection
@@ -1212,8 +1398,7 @@ SinglePath::ProcessJoinSent()
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("Process Join Sent.");
     Ptr<Packet> packet;
-    Address from;
-    while ((packet = m_socket->RecvFrom(from)))
+    while ((packet = PathRecvPacket()))
     {
         MultipathHeader recvHeader;
         MP_CONN_ID_t connID;
@@ -1255,8 +1440,7 @@ SinglePath::ProcessListen()
 {
     NS_LOG_FUNCTION(this);
     Ptr<Packet> packet;
-    Address from;
-    while ((packet = m_socket->RecvFrom(from)))
+    while ((packet = PathRecvPacket()))
     {
         MultipathHeader rcvHeader;
         MultipathHeader rspHeader;
@@ -1323,7 +1507,7 @@ SinglePath::SendPacketWithJoinTag(MultipathTagConn tag)
 {
     Ptr<Packet> rspPacket = Create<Packet>(128);
     rspPacket->AddPacketTag(tag);
-    if (m_socket->Send(rspPacket) < 0)
+    if (PathSendPacket(rspPacket) < 0)
     {
         NS_LOG_ERROR("Response error.");
         return -1;
@@ -1368,6 +1552,21 @@ SinglePath::SetSocket(Ptr<Socket> sock)
     m_socket = sock;
 }
 
+void
+SinglePath::SetDatagramSubflow(Ptr<MdtpDatagramSubflow> subflow)
+{
+    m_transport = MDTP_SUBFLOW_DATAGRAM;
+    m_dgramSubflow = subflow;
+    m_dgramSubflow->SetRecvCallback(MakeCallback(&SinglePath::PathDatagramRecvHandler, this));
+    m_dgramSubflow->SetSendCallback(MakeCallback(&SinglePath::PathDatagramSendHandler, this));
+}
+
+MdtpSubflowTransport
+SinglePath::GetTransport() const
+{
+    return m_transport;
+}
+
 void
 SinglePath::SetServer(CybertwinDataTransferServer* server)
 {
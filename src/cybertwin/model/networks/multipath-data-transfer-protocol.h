@@ -3,9 +3,11 @@
 #include "../cybertwin-common.h"
 #include "../cybertwin-header.h"
 #include "../cybertwin-tag.h"
+#include "mdtp-datagram-subflow.h"
 #include "ns3/cybertwin-node.h"
 #include "ns3/log.h"
 #include "ns3/random-variable-stream.h"
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -21,6 +23,13 @@ namespace ns3
 class SinglePath;
 class MultipathConnection;
 
+// transport carrying the subflows of a multipath connection
+enum MdtpSubflowTransport
+{
+    MDTP_SUBFLOW_TCP,
+    MDTP_SUBFLOW_DATAGRAM,
+};
+
 //*****************************************************************************
 //*                    Cybertwin Data Transfer Server                         *
 //*****************************************************************************
@@ -41,6 +50,8 @@ public:
     void NewConnectionBuilt(SinglePath *path);
     bool ValidConnectionID(MP_CONN_ID_t connid);
     void NewPathJoinConnection(SinglePath* path);
+    void DatagramPathClosed(const Address& peer);
+    uint32_t GetDatagramPathCount() const;
 
     void SetNewConnectCreatedCallback(Callback<void, MultipathConnection*> newConnCb);
     void DtServerBulkSend(MultipathConnection* conn);
@@ -50,6 +61,8 @@ private:
     // callbacks
     bool PathRequestCallback(Ptr<Socket> scok, const Address &addr);
     void PathCreatedCallback(Ptr<Socket> sock, const Address &addr);
+    void DatagramRecvCallback(Ptr<Socket> sock);
+    SinglePath* CreateListenPath(Ptr<Socket> sock, const Address& addr);
 
     MP_CONN_KEY_t GenerateKey();
 
@@ -71,6 +84,9 @@ private:
     //std::unordered_map<SP_CONNID_t, MultipathConnection*> mpConnections
     std::unordered_set<MultipathConnection*> m_connections;
     std::unordered_map<MP_CONN_ID_t, MultipathConnection*> m_connectionIDs;
+
+    // datagram subflows demultiplexed by peer address
+    std::map<Address, Ptr<MdtpDatagramSubflow>> m_datagramSubflows;
     
     // test number
     //uint64_t m_testNum;
@@ -126,6 +142,8 @@ public:
     void SetConnID(MP_CONN_ID_t id);
     MP_CONN_ID_t GetConnID();
     void SetConnState(MP_CONN_STATE state);
+    void SetSubflowTransport(MdtpSubflowTransport transport);
+    MdtpSubflowTransport GetSubflowTransport() const;
 
     //callback
     void SetConnectCallback(Callback<void, MultipathConnection*> succeedCb,
@@ -153,6 +171,7 @@ private:
     CYBERTWINID_t m_localCyberID;
     CYBERTWINID_t m_peerCyberID;
     CYBERTWIN_INTERFACE_LIST_t m_interfaces;
+    MdtpSubflowTransport m_subflowTransport;
 
     // interfaces
     std::vector<Ipv4Interface> m_Ipv4Ifs;
@@ -233,6 +252,9 @@ public:
 
     //socket processer
     void PathRecvHandler(Ptr<Socket> socket);
+    void PathDatagramRecvHandler(Ptr<MdtpDatagramSubflow> subflow);
+    void PathSendHandler(Ptr<Socket> socket, uint32_t available);
+    void PathDatagramSendHandler(Ptr<MdtpDatagramSubflow> subflow, uint32_t available);
     void PathCloseSucceeded(Ptr<Socket> socket);
     void PathCloseFailed(Ptr<Socket> socket);
 
@@ -257,6 +279,8 @@ public:
     void SetPathId(MP_PATH_ID_t id);
     MP_PATH_ID_t GetPathId();
     void SetSocket(Ptr<Socket> sock);
+    void SetDatagramSubflow(Ptr<MdtpDatagramSubflow> subflow);
+    MdtpSubflowTransport GetTransport() const;
     void SetServer(CybertwinDataTransferServer* server);
     MP_CONN_KEY_t GetLocalKey();
     void SetLocalKey(MP_CONN_KEY_t key);
@@ -280,8 +304,14 @@ public:
     int32_t SendPacketWithHeader(MultipathHeader header);
     
 private:
+    // transport independent I/O used by the state machine
+    Ptr<Packet> PathRecvPacket();
+    int32_t PathSendPacket(Ptr<Packet> packet);
+
     MP_PATH_ID_t m_pathId;
     Ptr<Socket> m_socket;
+    MdtpSubflowTransport m_transport;
+    Ptr<MdtpDatagramSubflow> m_dgramSubflow;
     MP_CONN_KEY_t m_localKey;
     MP_CONN_KEY_t m_remoteKey;
     CYBERTWINID_t m_localCybertwinID;
@@ -294,8 +324,9 @@ private:
     PathStatus m_pathState;
     MP_CONN_ID_t m_connID;
 
-    // test data transfer
-    std::queue<Ptr<Packet>> m_rxBuffer;
+    // test data transfer, the payloads with the data sequence numbers
+    // of their stripped MultipathHeaderDSN
+    std::queue<std::pair<MpDataSeqNum, Ptr<Packet>>> m_rxBuffer;
     Callback<void, SinglePath*> m_recvCallback;
 
     // log information
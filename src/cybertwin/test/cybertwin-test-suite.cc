@@ -1,6 +1,25 @@
 
 // Include a header file from your module to test.
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/cybertwin-flow-classifier.h"
+#include "ns3/cybertwin-header.h"
+#include "ns3/cybertwin-manager.h"
+#include "ns3/cybertwin-node.h"
+#include "ns3/cybertwin-tag.h"
 #include "ns3/cybertwin.h"
+#include "ns3/error-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mdtp-datagram-subflow.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -45,6 +64,703 @@ CybertwinTestCase1::DoRun()
     NS_TEST_ASSERT_MSG_EQ_TOL(0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * Check that the fixed layouts of the Cybertwin headers keep the wire
+ * format, in network order, and that StripHeader parses and removes a
+ * header in one step.
+ */
+class CybertwinHeaderLayoutTestCase : public TestCase
+{
+  public:
+    CybertwinHeaderLayoutTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CybertwinHeaderLayoutTestCase::CybertwinHeaderLayoutTestCase()
+    : TestCase("Cybertwin header fixed layouts")
+{
+}
+
+void
+CybertwinHeaderLayoutTestCase::DoRun()
+{
+    CybertwinHeader header;
+    header.SetCommand(CYBERTWIN_HEADER_DATA);
+    header.SetSelfID(0x0102030405060708);
+    header.SetPeerID(0x1112131415161718);
+    header.SetSize(0x21222324);
+    header.SetCybertwinPort(0x3132);
+    header.SetRecvRate(0x41);
+    NS_TEST_ASSERT_MSG_EQ(header.GetSerializedSize(), 24, "wrong size of CybertwinHeader");
+
+    Ptr<Packet> packet = Create<Packet>(100);
+    packet->AddHeader(header);
+    uint8_t bytes[24];
+    packet->CopyData(bytes, sizeof(bytes));
+    const uint8_t expected[24] = {CYBERTWIN_HEADER_DATA,
+                                  0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                                  0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                                  0x21, 0x22, 0x23, 0x24,
+                                  0x31, 0x32,
+                                  0x41};
+    for (uint32_t i = 0; i < sizeof(bytes); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(uint32_t(bytes[i]), uint32_t(expected[i]), "wrong byte " << i);
+    }
+
+    std::optional<CybertwinHeader> stripped = StripHeader<CybertwinHeader>(packet);
+    NS_TEST_ASSERT_MSG_EQ(stripped.has_value(), true, "header not stripped");
+    NS_TEST_ASSERT_MSG_EQ(packet->GetSize(), 100, "header not removed");
+    NS_TEST_ASSERT_MSG_EQ(stripped->GetSelfID(), header.GetSelfID(), "wrong cybertwin");
+    NS_TEST_ASSERT_MSG_EQ(stripped->GetPeerID(), header.GetPeerID(), "wrong peer");
+    NS_TEST_ASSERT_MSG_EQ(stripped->GetSize(), header.GetSize(), "wrong size");
+    NS_TEST_ASSERT_MSG_EQ(stripped->GetCybertwinPort(), 0x3132, "wrong port");
+    NS_TEST_ASSERT_MSG_EQ(uint32_t(stripped->GetRecvRate()), 0x41, "wrong rate");
+
+    Ptr<Packet> shortPacket = Create<Packet>(10);
+    NS_TEST_ASSERT_MSG_EQ(StripHeader<MultipathHeaderDSN>(shortPacket).has_value(),
+                          false,
+                          "header stripped from a short packet");
+    NS_TEST_ASSERT_MSG_EQ(shortPacket->GetSize(), 10, "short packet modified");
+
+    MultipathHeaderDSN dsn;
+    dsn.SetCuid(7);
+    dsn.SetDataSeqNum(MpDataSeqNum(0x100000000));
+    dsn.SetDataLen(1400);
+    packet->AddHeader(dsn);
+    std::optional<MultipathHeaderDSN> strippedDsn = StripHeader<MultipathHeaderDSN>(packet);
+    NS_TEST_ASSERT_MSG_EQ(strippedDsn->GetDataSeqNum(), dsn.GetDataSeqNum(), "wrong sequence");
+    NS_TEST_ASSERT_MSG_EQ(strippedDsn->GetDataLen(), 1400, "wrong length");
+
+    CybertwinManagerHeader manager;
+    manager.SetCommand(CYBERTWIN_REGISTRATION);
+    manager.SetCName("host-42");
+    manager.SetCUID(42);
+    manager.SetPort(6000);
+    packet->AddHeader(manager);
+    CybertwinManagerHeader parsed;
+    packet->RemoveHeader(parsed);
+    NS_TEST_ASSERT_MSG_EQ(parsed.GetCName(), "host-42", "wrong name");
+    NS_TEST_ASSERT_MSG_EQ(parsed.GetCUID(), 42, "wrong cuid");
+    NS_TEST_ASSERT_MSG_EQ(parsed.GetPort(), 6000, "wrong port");
+    NS_TEST_ASSERT_MSG_EQ(packet->GetSize(), 100, "manager header not removed");
+}
+
+/**
+ * Check that a stream of CybertwinManagerHeader split across segments at any
+ * byte is framed back into the same headers.
+ */
+class CybertwinManagerFramingTestCase : public TestCase
+{
+  public:
+    CybertwinManagerFramingTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CybertwinManagerFramingTestCase::CybertwinManagerFramingTestCase()
+    : TestCase("Cybertwin manager header framing across segments")
+{
+}
+
+void
+CybertwinManagerFramingTestCase::DoRun()
+{
+    const std::string names[] = {"host-1", "", "a-much-longer-host-name-0123456789"};
+    Ptr<Packet> stream = Create<Packet>();
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        CybertwinManagerHeader header;
+        header.SetCommand(CYBERTWIN_REGISTRATION_ACK);
+        header.SetCName(names[i]);
+        header.SetCUID(100 + i);
+        header.SetPort(6000 + i);
+        Ptr<Packet> packet = Create<Packet>();
+        packet->AddHeader(header);
+        stream->AddAtEnd(packet);
+    }
+
+    for (uint32_t split = 0; split <= stream->GetSize(); split++)
+    {
+        Ptr<Packet> buffer = Create<Packet>();
+        uint32_t parsed = 0;
+        for (Ptr<Packet> segment : {stream->CreateFragment(0, split),
+                                    stream->CreateFragment(split, stream->GetSize() - split)})
+        {
+            buffer->AddAtEnd(segment);
+            uint32_t headerSize;
+            while ((headerSize = CybertwinManagerHeader::PeekSerializedSize(buffer)) > 0)
+            {
+                CybertwinManagerHeader header;
+                buffer->RemoveHeader(header, headerSize);
+                NS_TEST_ASSERT_MSG_EQ(header.GetCName(), names[parsed], "wrong name");
+                NS_TEST_ASSERT_MSG_EQ(header.GetCUID(), 100 + parsed, "wrong cuid");
+                NS_TEST_ASSERT_MSG_EQ(header.GetPort(), 6000 + parsed, "wrong port");
+                parsed++;
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(parsed, 3, "headers lost when split at " << split);
+        NS_TEST_ASSERT_MSG_EQ(buffer->GetSize(), 0, "bytes left when split at " << split);
+    }
+}
+
+/**
+ * Check that the shared listener of a CybertwinManager closes the
+ * connections naming a cybertwin it has not registered, whether their
+ * demultiplexing header arrives whole or split, and keeps listening.
+ */
+class CybertwinSharedListenerTestCase : public TestCase
+{
+  public:
+    CybertwinSharedListenerTestCase();
+
+  private:
+    void DoRun() override;
+    void Connect(Ptr<Node> node, Address server, bool split);
+    void Connected(Ptr<Socket> socket);
+    void SendRest(Ptr<Socket> socket, Ptr<Packet> rest);
+    void Closed(Ptr<Socket> socket);
+
+    std::map<Ptr<Socket>, bool> m_split; // whether each client splits its header
+    uint32_t m_closed;                   // connections closed by the manager
+};
+
+CybertwinSharedListenerTestCase::CybertwinSharedListenerTestCase()
+    : TestCase("Cybertwin manager shared listener with an unregistered cybertwin"),
+      m_closed(0)
+{
+}
+
+void
+CybertwinSharedListenerTestCase::Connect(Ptr<Node> node, Address server, bool split)
+{
+    Ptr<Socket> socket = Socket::CreateSocket(node, TcpSocketFactory::GetTypeId());
+    socket->Bind();
+    socket->SetConnectCallback(MakeCallback(&CybertwinSharedListenerTestCase::Connected, this),
+                               MakeNullCallback<void, Ptr<Socket>>());
+    socket->SetCloseCallbacks(MakeCallback(&CybertwinSharedListenerTestCase::Closed, this),
+                              MakeCallback(&CybertwinSharedListenerTestCase::Closed, this));
+    socket->Connect(server);
+    m_split[socket] = split;
+}
+
+void
+CybertwinSharedListenerTestCase::Connected(Ptr<Socket> socket)
+{
+    CybertwinDemuxHeader header;
+    header.SetChannel(CybertwinDemuxHeader::CYBERTWIN_DEMUX_LOCAL);
+    header.SetCuid(42);
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(header);
+    if (!m_split[socket])
+    {
+        socket->Send(packet);
+        return;
+    }
+    // the manager has to wait for the rest of the header
+    socket->Send(packet->CreateFragment(0, 3));
+    Simulator::Schedule(MilliSeconds(50),
+                        &CybertwinSharedListenerTestCase::SendRest,
+                        this,
+                        socket,
+                        packet->CreateFragment(3, packet->GetSize() - 3));
+}
+
+void
+CybertwinSharedListenerTestCase::SendRest(Ptr<Socket> socket, Ptr<Packet> rest)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_closed, 0, "connection closed on a partial header");
+    socket->Send(rest);
+}
+
+void
+CybertwinSharedListenerTestCase::Closed(Ptr<Socket> socket)
+{
+    m_closed++;
+}
+
+void
+CybertwinSharedListenerTestCase::DoRun()
+{
+    Ptr<CybertwinNode> server = CreateObject<CybertwinNode>();
+    server->SetName("edge");
+    Ptr<Node> host = CreateObject<Node>();
+    NodeContainer nodes;
+    nodes.Add(host);
+    nodes.Add(server);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    SimpleNetDeviceHelper link;
+    NetDeviceContainer devices = link.Install(nodes);
+    Ipv4AddressHelper address("10.1.4.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    Ptr<CybertwinManager> manager =
+        CreateObject<CybertwinManager>(std::vector<Ipv4Address>{interfaces.GetAddress(1)},
+                                       std::vector<Ipv4Address>());
+    manager->SetAttribute("SharedListener", BooleanValue(true));
+    server->AddApplication(manager);
+
+    InetSocketAddress listener(interfaces.GetAddress(1), CYBERTWIN_SHARED_LISTEN_PORT);
+    Simulator::Schedule(MilliSeconds(100),
+                        &CybertwinSharedListenerTestCase::Connect,
+                        this,
+                        host,
+                        listener,
+                        true);
+    Simulator::Schedule(MilliSeconds(500),
+                        &CybertwinSharedListenerTestCase::Connect,
+                        this,
+                        host,
+                        listener,
+                        false);
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_closed, 2, "connections to an unregistered cybertwin not closed");
+    NS_TEST_ASSERT_MSG_EQ(manager->GetRegisteredCount(), 0, "cybertwin created by a connection");
+
+    m_split.clear();
+    Simulator::Destroy();
+}
+
+/**
+ * Check that the connections created with new follow the SubflowTransport
+ * attribute default.
+ */
+class MdtpSubflowTransportTestCase : public TestCase
+{
+  public:
+    MdtpSubflowTransportTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MdtpSubflowTransportTestCase::MdtpSubflowTransportTestCase()
+    : TestCase("MDTP connection subflow transport attribute")
+{
+}
+
+void
+MdtpSubflowTransportTestCase::DoRun()
+{
+    MdtpSubflowTransport expected =
+        MDTP_DATAGRAM_SUBFLOW_ENABLED ? MDTP_SUBFLOW_DATAGRAM : MDTP_SUBFLOW_TCP;
+    MultipathConnection* conn = new MultipathConnection();
+    NS_TEST_ASSERT_MSG_EQ(conn->GetSubflowTransport(), expected, "wrong compile-time default");
+    delete conn;
+
+    Config::SetDefault("ns3::MultipathConnection::SubflowTransport", StringValue("Datagram"));
+    conn = new MultipathConnection();
+    NS_TEST_ASSERT_MSG_EQ(conn->GetSubflowTransport(), MDTP_SUBFLOW_DATAGRAM, "default ignored");
+    delete conn;
+    Config::Reset();
+}
+
+/**
+ * Check that a MdtpDatagramSubflow delivers every packet once and in order
+ * over UDP, retransmitting the datagrams and ACKs the links lose.
+ */
+class MdtpDatagramSubflowTestCase : public TestCase
+{
+  public:
+    MdtpDatagramSubflowTestCase(uint32_t lossPercent);
+
+  private:
+    void DoRun() override;
+    void Received(Ptr<MdtpDatagramSubflow> subflow);
+
+    uint32_t m_lossPercent;
+    std::vector<uint32_t> m_received; // sizes of the packets delivered
+};
+
+MdtpDatagramSubflowTestCase::MdtpDatagramSubflowTestCase(uint32_t lossPercent)
+    : TestCase("MDTP datagram subflow losing " + std::to_string(lossPercent) + "% of datagrams"),
+      m_lossPercent(lossPercent)
+{
+}
+
+void
+MdtpDatagramSubflowTestCase::Received(Ptr<MdtpDatagramSubflow> subflow)
+{
+    Ptr<Packet> packet;
+    while ((packet = subflow->Recv()))
+    {
+        m_received.push_back(packet->GetSize());
+    }
+}
+
+void
+MdtpDatagramSubflowTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    SimpleNetDeviceHelper link;
+    link.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    NetDeviceContainer devices = link.Install(nodes);
+    Ipv4AddressHelper address("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // lose data one way and ACKs the other way
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        Ptr<RateErrorModel> loss = CreateObject<RateErrorModel>();
+        loss->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+        loss->SetRate(m_lossPercent / 100.0);
+        loss->AssignStreams(i);
+        DynamicCast<SimpleNetDevice>(devices.Get(i))->SetReceiveErrorModel(loss);
+    }
+
+    Ptr<MdtpDatagramSubflow> subflows[2];
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        Ptr<Socket> socket = Socket::CreateSocket(nodes.Get(i), UdpSocketFactory::GetTypeId());
+        socket->Bind(InetSocketAddress(interfaces.GetAddress(i), 9000));
+        // a single datagram waits for ARP, which queues only a few, and the
+        // whole burst is queued at once
+        subflows[i] = CreateObjectWithAttributes<MdtpDatagramSubflow>("InitialWindow",
+                                                                       UintegerValue(1),
+                                                                       "TxBufferSize",
+                                                                       UintegerValue(1 << 20));
+        subflows[i]->SetSocket(socket, InetSocketAddress(interfaces.GetAddress(1 - i), 9000), true);
+    }
+    subflows[1]->SetRecvCallback(MakeCallback(&MdtpDatagramSubflowTestCase::Received, this));
+
+    const uint32_t packets = 500;
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        subflows[0]->Send(Create<Packet>(100 + i));
+    }
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), packets, "packets lost or duplicated");
+    for (uint32_t i = 0; i < m_received.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_received[i], 100 + i, "packet " << i << " out of order");
+    }
+    NS_TEST_ASSERT_MSG_EQ(subflows[0]->GetInFlight(), 0, "datagrams left unacknowledged");
+    if (m_lossPercent > 0)
+    {
+        NS_TEST_ASSERT_MSG_GT(subflows[0]->GetRetransmissions(), 0, "nothing retransmitted");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_EQ(subflows[0]->GetRetransmissions(), 0, "spurious retransmission");
+    }
+
+    subflows[0]->Dispose();
+    subflows[1]->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * Check that a MdtpDatagramSubflow refuses data beyond TxBufferSize, like a
+ * full TCP socket, and reports the room the ACKs free.
+ */
+class MdtpDatagramBufferTestCase : public TestCase
+{
+  public:
+    MdtpDatagramBufferTestCase();
+
+  private:
+    void DoRun() override;
+    void SendReady(Ptr<MdtpDatagramSubflow> subflow, uint32_t available);
+
+    uint32_t m_available; // room last reported by the send callback
+};
+
+MdtpDatagramBufferTestCase::MdtpDatagramBufferTestCase()
+    : TestCase("MDTP datagram subflow send buffer"),
+      m_available(0)
+{
+}
+
+void
+MdtpDatagramBufferTestCase::SendReady(Ptr<MdtpDatagramSubflow> subflow, uint32_t available)
+{
+    m_available = available;
+}
+
+void
+MdtpDatagramBufferTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    SimpleNetDeviceHelper link;
+    NetDeviceContainer devices = link.Install(nodes);
+    Ipv4AddressHelper address("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    Ptr<MdtpDatagramSubflow> subflows[2];
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        Ptr<Socket> socket = Socket::CreateSocket(nodes.Get(i), UdpSocketFactory::GetTypeId());
+        socket->Bind(InetSocketAddress(interfaces.GetAddress(i), 9000));
+        subflows[i] = CreateObjectWithAttributes<MdtpDatagramSubflow>("TxBufferSize",
+                                                                       UintegerValue(1000),
+                                                                       "InitialWindow",
+                                                                       UintegerValue(1));
+        subflows[i]->SetSocket(socket, InetSocketAddress(interfaces.GetAddress(1 - i), 9000), true);
+    }
+    subflows[0]->SetSendCallback(MakeCallback(&MdtpDatagramBufferTestCase::SendReady, this));
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(subflows[0]->Send(Create<Packet>(300)), 300, "send refused");
+    }
+    NS_TEST_ASSERT_MSG_EQ(subflows[0]->GetTxAvailable(), 100, "wrong room left");
+    NS_TEST_ASSERT_MSG_EQ(subflows[0]->Send(Create<Packet>(300)), -1, "buffer overrun");
+    NS_TEST_ASSERT_MSG_EQ(subflows[0]->Send(Create<Packet>(100)), 100, "room not used");
+
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(subflows[0]->GetInFlight(), 0, "datagrams left unacknowledged");
+    NS_TEST_ASSERT_MSG_EQ(subflows[0]->GetTxAvailable(), 1000, "room not freed");
+    NS_TEST_ASSERT_MSG_EQ(m_available, 1000, "freed room not reported");
+
+    subflows[0]->Dispose();
+    subflows[1]->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * Check that the datagram server opens a path only for the first datagram
+ * of a subflow, and drops the stray ACKs and data of unknown peers.
+ */
+class MdtpDatagramServerTestCase : public TestCase
+{
+  public:
+    MdtpDatagramServerTestCase();
+
+  private:
+    void DoRun() override;
+    void NewConnection(MultipathConnection* conn);
+    void SendStray(Ptr<Socket> socket, Address to, uint8_t flags, uint32_t seq);
+    void CheckPaths(Ptr<CybertwinDataTransferServer> server, uint32_t expected);
+
+    uint32_t m_connections; // connections notified by the server
+};
+
+MdtpDatagramServerTestCase::MdtpDatagramServerTestCase()
+    : TestCase("MDTP datagram server opens paths on handshakes only"),
+      m_connections(0)
+{
+}
+
+void
+MdtpDatagramServerTestCase::NewConnection(MultipathConnection* conn)
+{
+    m_connections++;
+}
+
+void
+MdtpDatagramServerTestCase::SendStray(Ptr<Socket> socket, Address to, uint8_t flags, uint32_t seq)
+{
+    MdtpDatagramHeader header;
+    header.SetFlags(flags);
+    header.SetSeq(seq);
+    Ptr<Packet> packet = Create<Packet>(100);
+    packet->AddHeader(header);
+    socket->SendTo(packet, 0, to);
+}
+
+void
+MdtpDatagramServerTestCase::CheckPaths(Ptr<CybertwinDataTransferServer> server, uint32_t expected)
+{
+    NS_TEST_EXPECT_MSG_EQ(server->GetDatagramPathCount(),
+                          expected,
+                          "wrong number of paths at " << Simulator::Now().As(Time::MS));
+}
+
+void
+MdtpDatagramServerTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    SimpleNetDeviceHelper link;
+    NetDeviceContainer devices = link.Install(nodes);
+    Ipv4AddressHelper address("10.1.3.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    Ptr<CybertwinDataTransferServer> server = CreateObject<CybertwinDataTransferServer>();
+    server->Setup(nodes.Get(1), 42, {{interfaces.GetAddress(1), 9000}});
+    server->SetNewConnectCreatedCallback(
+        MakeCallback(&MdtpDatagramServerTestCase::NewConnection, this));
+    server->Listen();
+    InetSocketAddress serverAddress(interfaces.GetAddress(1), 9000);
+
+    // a pure ACK and a retransmission of a path the server already closed
+    Ptr<Socket> stray = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+    stray->Bind(InetSocketAddress(interfaces.GetAddress(0), 9001));
+    Simulator::Schedule(MilliSeconds(10),
+                        &MdtpDatagramServerTestCase::SendStray,
+                        this,
+                        stray,
+                        serverAddress,
+                        MdtpDatagramHeader::MDTP_DGRAM_ACK,
+                        0);
+    Simulator::Schedule(MilliSeconds(20),
+                        &MdtpDatagramServerTestCase::SendStray,
+                        this,
+                        stray,
+                        serverAddress,
+                        MdtpDatagramHeader::MDTP_DGRAM_DATA | MdtpDatagramHeader::MDTP_DGRAM_ACK,
+                        3);
+    Simulator::Schedule(MilliSeconds(50),
+                        &MdtpDatagramServerTestCase::CheckPaths,
+                        this,
+                        server,
+                        0);
+
+    // a subflow whose first datagram asks to build a connection
+    Ptr<Socket> socket = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+    socket->Bind(InetSocketAddress(interfaces.GetAddress(0), 9002));
+    Ptr<MdtpDatagramSubflow> client = CreateObject<MdtpDatagramSubflow>();
+    client->SetSocket(socket, serverAddress, true);
+    MultipathHeader build;
+    build.SetCuid(7);
+    build.SetSenderKey(1234);
+    build.SetRecverKey(0);
+    build.SetConnId(0);
+    Ptr<Packet> request = Create<Packet>();
+    request->AddHeader(build);
+    Simulator::Schedule(MilliSeconds(100), &MdtpDatagramSubflow::Send, client, request);
+
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(server->GetDatagramPathCount(), 1, "handshake did not open a path");
+    NS_TEST_ASSERT_MSG_EQ(m_connections, 1, "connection not built");
+    Ptr<Packet> response = client->Recv();
+    NS_TEST_ASSERT_MSG_NE(response, nullptr, "no response to the handshake");
+
+    client->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * Check that CybertwinFlowClassifier labels the flows carrying tagged MDTP
+ * data, sums their statistics per stream, and that a sampling FlowMonitor
+ * tracks one packet in N of every flow.
+ */
+class CybertwinFlowClassifierTestCase : public TestCase
+{
+  public:
+    CybertwinFlowClassifierTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CybertwinFlowClassifierTestCase::CybertwinFlowClassifierTestCase()
+    : TestCase("Cybertwin flow classifier and sampled flow monitor")
+{
+}
+
+void
+CybertwinFlowClassifierTestCase::DoRun()
+{
+    Ptr<CybertwinFlowClassifier> classifier = Create<CybertwinFlowClassifier>();
+    NS_TEST_ASSERT_MSG_EQ(MdtpFlowTag::IsEnabled(), true, "MDTP data not tagged");
+
+    // UDP datagrams of 1000 flows, with the ports in the first bytes
+    auto datagram = [](uint16_t srcPort, uint16_t dstPort) {
+        uint8_t ports[8] = {uint8_t(srcPort >> 8),
+                            uint8_t(srcPort),
+                            uint8_t(dstPort >> 8),
+                            uint8_t(dstPort),
+                            0,
+                            8,
+                            0,
+                            0};
+        return Create<Packet>(ports, sizeof(ports));
+    };
+    Ipv4Header ipHeader;
+    ipHeader.SetSource(Ipv4Address("10.0.0.1"));
+    ipHeader.SetDestination(Ipv4Address("10.0.0.2"));
+    ipHeader.SetProtocol(17);
+    FlowId flowId;
+    FlowPacketId packetId;
+    for (uint32_t round = 0; round < 3; round++)
+    {
+        for (uint16_t port = 0; port < 1000; port++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(
+                classifier->Classify(ipHeader, datagram(port, 9), &flowId, &packetId),
+                true,
+                "datagram not classified");
+            NS_TEST_ASSERT_MSG_EQ(flowId, port + 1U, "wrong flow");
+            NS_TEST_ASSERT_MSG_EQ(packetId, round, "wrong packet");
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(classifier->FindFlow(500).sourcePort, 499, "wrong tuple");
+
+    // the first flow carries no tag until its second packet
+    CybertwinFlowClassifier::FlowLabel label;
+    NS_TEST_ASSERT_MSG_EQ(classifier->FindLabel(1, label), false, "untagged flow labeled");
+    Ptr<Packet> tagged = datagram(0, 9);
+    tagged->AddByteTag(MdtpFlowTag(7, 8, 42));
+    classifier->Classify(ipHeader, tagged, &flowId, &packetId);
+    Ptr<Packet> subflow = datagram(2000, 9);
+    subflow->AddByteTag(MdtpFlowTag(7, 8, 42));
+    classifier->Classify(ipHeader, subflow, &flowId, &packetId);
+    NS_TEST_ASSERT_MSG_EQ(flowId, 1001, "wrong subflow");
+    NS_TEST_ASSERT_MSG_EQ(classifier->FindLabel(1, label), true, "tagged flow not labeled");
+    NS_TEST_ASSERT_MSG_EQ(label.cuid, 7, "wrong cybertwin");
+    NS_TEST_ASSERT_MSG_EQ(label.peer, 8, "wrong peer");
+    NS_TEST_ASSERT_MSG_EQ(label.connId, 42, "wrong connection");
+
+    FlowMonitor::FlowStatsContainer flowStats;
+    flowStats[1].txPackets = 10;
+    flowStats[1].rxPackets = 9;
+    flowStats[1].txBytes = 10000;
+    flowStats[1].rxBytes = 9000;
+    flowStats[1].lostPackets = 1;
+    flowStats[1].delaySum = MilliSeconds(90);
+    flowStats[1001] = flowStats[1];
+    flowStats[2] = flowStats[1];
+    auto streams = classifier->GetStreamStats(flowStats);
+    NS_TEST_ASSERT_MSG_EQ(streams.size(), 1, "wrong number of streams");
+    const CybertwinFlowClassifier::StreamStats& stream = streams.begin()->second;
+    NS_TEST_ASSERT_MSG_EQ(stream.flows, 2, "wrong number of subflows");
+    NS_TEST_ASSERT_MSG_EQ(stream.rxPackets, 18, "wrong received packets");
+    NS_TEST_ASSERT_MSG_EQ(stream.lostPackets, 2, "wrong lost packets");
+    NS_TEST_ASSERT_MSG_EQ(stream.delaySum, MilliSeconds(180), "wrong delay");
+
+    // one packet in 4 of every flow, evenly spaced
+    Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor>();
+    monitor->SetAttribute("SamplingRatio", UintegerValue(4));
+    for (FlowId id = 1; id <= 100; id++)
+    {
+        uint32_t sampled = 0;
+        uint32_t last = 0;
+        for (FlowPacketId packet = 0; packet < 100; packet++)
+        {
+            if (monitor->IsSampled(id, packet))
+            {
+                NS_TEST_ASSERT_MSG_EQ((sampled == 0 || packet - last == 4), true, "uneven sample");
+                sampled++;
+                last = packet;
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(sampled, 25, "wrong sample of flow " << id);
+    }
+    monitor->Dispose();
+    Simulator::Destroy();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -60,6 +776,15 @@ CybertwinTestSuite::CybertwinTestSuite()
 {
     // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new CybertwinTestCase1, TestCase::QUICK);
+    AddTestCase(new CybertwinHeaderLayoutTestCase, TestCase::QUICK);
+    AddTestCase(new CybertwinManagerFramingTestCase, TestCase::QUICK);
+    AddTestCase(new CybertwinSharedListenerTestCase, TestCase::QUICK);
+    AddTestCase(new MdtpSubflowTransportTestCase, TestCase::QUICK);
+    AddTestCase(new MdtpDatagramSubflowTestCase(0), TestCase::QUICK);
+    AddTestCase(new MdtpDatagramSubflowTestCase(5), TestCase::QUICK);
+    AddTestCase(new MdtpDatagramBufferTestCase, TestCase::QUICK);
+    AddTestCase(new MdtpDatagramServerTestCase, TestCase::QUICK);
+    AddTestCase(new CybertwinFlowClassifierTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -19,6 +19,7 @@
 
 #include "flow-monitor-helper.h"
 
+#include "ns3/abort.h"
 #include "ns3/flow-monitor.h"
 #include "ns3/ipv4-flow-classifier.h"
 #include "ns3/ipv4-flow-probe.h"
@@ -60,10 +61,8 @@ FlowMonitorHelper::GetMonitor()
     if (!m_flowMonitor)
     {
         m_flowMonitor = m_monitorFactory.Create<FlowMonitor>();
-        m_flowClassifier4 = Create<Ipv4FlowClassifier>();
-        m_flowMonitor->AddFlowClassifier(m_flowClassifier4);
-        m_flowClassifier6 = Create<Ipv6FlowClassifier>();
-        m_flowMonitor->AddFlowClassifier(m_flowClassifier6);
+        m_flowMonitor->AddFlowClassifier(GetClassifier());
+        m_flowMonitor->AddFlowClassifier(GetClassifier6());
     }
     return m_flowMonitor;
 }
@@ -78,6 +77,13 @@ FlowMonitorHelper::GetClassifier()
     return m_flowClassifier4;
 }
 
+void
+FlowMonitorHelper::SetClassifier(Ptr<Ipv4FlowClassifier> classifier)
+{
+    NS_ABORT_MSG_IF(m_flowMonitor, "The classifier must be set before the FlowMonitor is created");
+    m_flowClassifier4 = classifier;
+}
+
 Ptr<FlowClassifier>
 FlowMonitorHelper::GetClassifier6()
 {
@@ -84,6 +84,15 @@ class FlowMonitorHelper
      */
     Ptr<FlowClassifier> GetClassifier();
 
+    /**
+     * \brief Classify the IPv4 packets with a classifier derived from
+     * Ipv4FlowClassifier, e.g. one that labels the flows
+     *
+     * Must be called before the FlowMonitor is created.
+     * \param classifier the FlowClassifier object for IPv4
+     */
+    void SetClassifier(Ptr<Ipv4FlowClassifier> classifier);
+
     /**
      * \brief Retrieve the FlowClassifier object for IPv6 created by the Install* methods
      * \returns a pointer to the FlowClassifier object
@@ -0,0 +1,271 @@
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_HASH_TABLE_H
+#define FLOW_HASH_TABLE_H
+
+#include <functional>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup flow-monitor
+ * \brief Hash table with open addressing, for the per-packet lookups of
+ * the flow monitor.
+ *
+ * The entries are stored in a single array and collisions are resolved
+ * by linear probing, so a lookup touches one or two cache lines instead
+ * of the log(n) nodes of a std::map.  The table doubles when it is half
+ * full, and entries are erased by shifting the following ones back, so
+ * no tombstone is left behind.
+ *
+ * Pointers to the values are invalidated by the next Insert or Erase.
+ *
+ * \tparam Key the key, default constructible and equality comparable
+ * \tparam Value the value, default constructible
+ * \tparam Hash the hash function of the keys
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlowHashTable
+{
+  public:
+    FlowHashTable()
+        : m_slots(MIN_CAPACITY),
+          m_size(0)
+    {
+    }
+
+    /**
+     * \param key the key
+     * \returns the value of the key, or nullptr if the key is not in the table
+     */
+    Value* Find(const Key& key)
+    {
+        std::size_t mask = m_slots.size() - 1;
+        for (std::size_t i = Home(key);; i = (i + 1) & mask)
+        {
+            Slot& slot = m_slots[i];
+            if (!slot.used)
+            {
+                return nullptr;
+            }
+            if (slot.key == key)
+            {
+                return &slot.value;
+            }
+        }
+    }
+
+    /**
+     * \param key the key
+     * \returns the value of the key, or nullptr if the key is not in the table
+     */
+    const Value* Find(const Key& key) const
+    {
+        return const_cast<FlowHashTable*>(this)->Find(key);
+    }
+
+    /**
+     * Insert a key with a default value, unless it is already in the table.
+     *
+     * \param key the key
+     * \returns the value of the key, and true if the key was inserted
+     */
+    std::pair<Value*, bool> Insert(const Key& key)
+    {
+        if (2 * (m_size + 1) > m_slots.size())
+        {
+            Grow();
+        }
+        std::size_t mask = m_slots.size() - 1;
+        for (std::size_t i = Home(key);; i = (i + 1) & mask)
+        {
+            Slot& slot = m_slots[i];
+            if (!slot.used)
+            {
+                slot.used = true;
+                slot.key = key;
+                slot.value = Value();
+                m_size++;
+                return std::make_pair(&slot.value, true);
+            }
+            if (slot.key == key)
+            {
+                return std::make_pair(&slot.value, false);
+            }
+        }
+    }
+
+    /**
+     * \param key the key
+     * \returns true if the key was in the table
+     */
+    bool Erase(const Key& key)
+    {
+        std::size_t mask = m_slots.size() - 1;
+        for (std::size_t i = Home(key);; i = (i + 1) & mask)
+        {
+            if (!m_slots[i].used)
+            {
+                return false;
+            }
+            if (m_slots[i].key == key)
+            {
+                EraseSlot(i);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Erase the entries for which a predicate is true.
+     *
+     * \param pred called with the key and the value of every entry
+     */
+    template <typename Predicate>
+    void EraseIf(Predicate pred)
+    {
+        std::vector<Key> erased;
+        for (Slot& slot : m_slots)
+        {
+            if (slot.used && pred(slot.key, slot.value))
+            {
+                erased.push_back(slot.key);
+            }
+        }
+        for (const Key& key : erased)
+        {
+            Erase(key);
+        }
+    }
+
+    /**
+     * \param f called with the key and the value of every entry, in no
+     *        particular order
+     */
+    template <typename Function>
+    void ForEach(Function f) const
+    {
+        for (const Slot& slot : m_slots)
+        {
+            if (slot.used)
+            {
+                f(slot.key, slot.value);
+            }
+        }
+    }
+
+    /**
+     * \returns the number of entries
+     */
+    std::size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Erase every entry.
+     */
+    void Clear()
+    {
+        m_slots.assign(MIN_CAPACITY, Slot());
+        m_size = 0;
+    }
+
+  private:
+    /// Initial number of slots, a power of two
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    /// An entry of the table
+    struct Slot
+    {
+        Key key;           //!< the key
+        Value value;       //!< the value
+        bool used = false; //!< the slot holds an entry
+    };
+
+    /**
+     * \param key the key
+     * \returns the first slot probed for the key
+     */
+    std::size_t Home(const Key& key) const
+    {
+        // the hashes of small integers are often the integers themselves,
+        // so mix the bits before keeping the low ones
+        uint64_t h = static_cast<uint64_t>(Hash()(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h) & (m_slots.size() - 1);
+    }
+
+    /**
+     * Empty a slot and move back the entries probed after it.
+     *
+     * \param i the slot
+     */
+    void EraseSlot(std::size_t i)
+    {
+        std::size_t mask = m_slots.size() - 1;
+        for (std::size_t j = (i + 1) & mask; m_slots[j].used; j = (j + 1) & mask)
+        {
+            // the entry in j can fill the hole in i unless its home lies
+            // cyclically in (i, j]
+            std::size_t home = Home(m_slots[j].key);
+            if (((j - home) & mask) >= ((j - i) & mask))
+            {
+                m_slots[i] = std::move(m_slots[j]);
+                i = j;
+            }
+        }
+        m_slots[i] = Slot();
+        m_size--;
+    }
+
+    /**
+     * Double the number of slots and insert the entries again.
+     */
+    void Grow()
+    {
+        std::vector<Slot> old(m_slots.size() * 2);
+        old.swap(m_slots);
+        std::size_t mask = m_slots.size() - 1;
+        for (Slot& slot : old)
+        {
+            if (slot.used)
+            {
+                std::size_t i = Home(slot.key);
+                while (m_slots[i].used)
+                {
+                    i = (i + 1) & mask;
+                }
+                m_slots[i] = std::move(slot);
+            }
+        }
+    }
+
+    std::vector<Slot> m_slots; //!< the slots, a power of two
+    std::size_t m_size;        //!< number of entries
+};
+
+} // namespace ns3
+
+#endif /* FLOW_HASH_TABLE_H */
@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <fstream>
 #include <sstream>
@@ -80,7 +81,13 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("SamplingRatio",
+                          ("Track one packet in this number of every flow.  With a ratio "
+                           "greater than one, the statistics describe the sampled packets only."),
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&FlowMonitor::m_samplingRatio),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -91,7 +98,8 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_samplingRatio(1),
+      m_enabled(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -120,11 +128,11 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    FlowStatsContainerI iter;
-    iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+    std::pair<FlowStats**, bool> index = m_flowStatsIndex.Insert(flowId);
+    if (index.second)
     {
         FlowMonitor::FlowStats& ref = m_flowStats[flowId];
+        *index.first = &ref;
         ref.delaySum = Seconds(0);
         ref.jitterSum = Seconds(0);
         ref.lastDelay = Seconds(0);
@@ -142,10 +150,22 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
     }
     else
     {
-        return iter->second;
+        return **index.first;
     }
 }
 
+inline uint64_t
+FlowMonitor::GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
+}
+
+uint32_t
+FlowMonitor::GetSamplingRatio() const
+{
+    return m_samplingRatio;
+}
+
 void
 FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
                            uint32_t flowId,
@@ -159,7 +179,7 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         return;
     }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
+    TrackedPacket& tracked = *m_trackedPackets.Insert(GetTrackedPacketKey(flowId, packetId)).first;
     tracked.firstSeenTime = now;
     tracked.lastSeenTime = tracked.firstSeenTime;
     tracked.timesForwarded = 0;
@@ -190,19 +210,18 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(key);
-    if (tracked == m_trackedPackets.end())
+    TrackedPacket* tracked = m_trackedPackets.Find(GetTrackedPacketKey(flowId, packetId));
+    if (!tracked)
     {
         NS_LOG_WARN("Received packet forward report (flowId="
                     << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
         return;
     }
 
-    tracked->second.timesForwarded++;
-    tracked->second.lastSeenTime = Simulator::Now();
+    tracked->timesForwarded++;
+    tracked->lastSeenTime = Simulator::Now();
 
-    Time delay = (Simulator::Now() - tracked->second.firstSeenTime);
+    Time delay = (Simulator::Now() - tracked->firstSeenTime);
     probe->AddPacketStats(flowId, packetSize, delay);
 }
 
@@ -218,8 +237,9 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked == m_trackedPackets.end())
+    uint64_t key = GetTrackedPacketKey(flowId, packetId);
+    TrackedPacket* tracked = m_trackedPackets.Find(key);
+    if (!tracked)
     {
         NS_LOG_WARN("Received packet last-tx report (flowId="
                     << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
@@ -227,7 +247,7 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
     }
 
     Time now = Simulator::Now();
-    Time delay = (now - tracked->second.firstSeenTime);
+    Time delay = (now - tracked->firstSeenTime);
     probe->AddPacketStats(flowId, packetSize, delay);
 
     FlowStats& stats = GetStatsForFlow(flowId);
@@ -266,12 +286,12 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         }
     }
     stats.timeLastRxPacket = now;
-    stats.timesForwarded += tracked->second.timesForwarded;
+    stats.timesForwarded += tracked->timesForwarded;
 
     NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
                                                                   << packetId << ").");
 
-    m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
+    m_trackedPackets.Erase(key); // we don't need to track this packet anymore
 }
 
 void
@@ -302,14 +322,12 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked != m_trackedPackets.end())
+    if (m_trackedPackets.Erase(GetTrackedPacketKey(flowId, packetId)))
     {
         // we don't need to track this packet anymore
         // FIXME: this will not necessarily be true with broadcast/multicast
-        NS_LOG_DEBUG("ReportDrop: removing tracked packet (flowId=" << flowId << ", packetId="
-                                                                    << packetId << ").");
-        m_trackedPackets.erase(tracked);
+        NS_LOG_DEBUG("ReportDrop: removed tracked packet (flowId=" << flowId << ", packetId="
+                                                                   << packetId << ").");
     }
 }
 
@@ -325,24 +343,19 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
     NS_LOG_FUNCTION(this << maxDelay.As(Time::S));
     Time now = Simulator::Now();
 
-    for (TrackedPacketMap::iterator iter = m_trackedPackets.begin();
-         iter != m_trackedPackets.end();)
-    {
-        if (now - iter->second.lastSeenTime >= maxDelay)
+    m_trackedPackets.EraseIf([this, now, maxDelay](uint64_t key, const TrackedPacket& tracked) {
+        if (now - tracked.lastSeenTime < maxDelay)
         {
-            // packet is considered lost, add it to the loss statistics
-            FlowStatsContainerI flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
-
-            // we won't track it anymore
-            m_trackedPackets.erase(iter++);
-        }
-        else
-        {
-            iter++;
+            return false;
         }
-    }
+        // packet is considered lost, add it to the loss statistics
+        FlowStats** flow = m_flowStatsIndex.Find(static_cast<FlowId>(key >> 32));
+        NS_ASSERT(flow);
+        (*flow)->lostPackets++;
+
+        // we won't track it anymore
+        return true;
+    });
 }
 
 void
@@ -440,7 +453,12 @@ FlowMonitor::SerializeToXmlStream(std::ostream& os,
     NS_LOG_FUNCTION(this << indent << enableHistograms << enableProbes);
     CheckForLostPackets();
 
-    os << std::string(indent, ' ') << "<FlowMonitor>\n";
+    os << std::string(indent, ' ') << "<FlowMonitor";
+    if (m_samplingRatio > 1)
+    {
+        os << " samplingRatio=\"" << m_samplingRatio << "\"";
+    }
+    os << ">\n";
     indent += 2;
     os << std::string(indent, ' ') << "<FlowStats>\n";
     indent += 2;
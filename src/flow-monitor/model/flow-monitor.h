@@ -22,6 +22,7 @@
 
 #include "ns3/event-id.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 #include "ns3/flow-probe.h"
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
@@ -46,6 +47,14 @@ namespace ns3
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * With a SamplingRatio of N greater than one, the probes only track one
+ * packet in N of every flow, and the other packets cost a classification
+ * only.  The packets sampled are evenly spaced within each flow, at an
+ * offset given by a hash of the flow identifier, so that all the probes
+ * agree on them.  The flow statistics then describe the sampled packets:
+ * counts and sums are about N times smaller than the real ones, while
+ * ratios such as the loss rate or the mean delay are estimates of the
+ * real ones.
  */
 class FlowMonitor : public Object
 {
@@ -215,6 +224,17 @@ class FlowMonitor : public Object
                     uint32_t packetSize,
                     uint32_t reasonCode);
 
+    /// FlowProbe implementations are supposed to call this method to
+    /// know if a new packet is tracked, before reporting its first
+    /// transmission.
+    /// \param flowId flow identification
+    /// \param packetId Packet ID
+    /// \returns true if the packet is in the sample
+    bool IsSampled(FlowId flowId, FlowPacketId packetId) const;
+
+    /// \returns the number of packets of a flow per packet tracked
+    uint32_t GetSamplingRatio() const;
+
     /// Check right now for packets that appear to be lost
     void CheckForLostPackets();
 
@@ -289,11 +309,15 @@ class FlowMonitor : public Object
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
 
-    /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+    /// FlowId --> FlowStats in m_flowStats, for the per-packet lookups
+    FlowHashTable<FlowId, FlowStats*> m_flowStatsIndex;
+
+    /// (FlowId << 32 | PacketId) --> TrackedPacket
+    typedef FlowHashTable<uint64_t, TrackedPacket> TrackedPacketMap;
     TrackedPacketMap m_trackedPackets; //!< Tracked packets
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
+    uint32_t m_samplingRatio;          //!< Packets of a flow per packet tracked
 
     // note: this is needed only for serialization
     std::list<Ptr<FlowClassifier>> m_classifiers; //!< the FlowClassifiers
@@ -312,10 +336,22 @@ class FlowMonitor : public Object
     /// \returns the stats of the flow
     FlowStats& GetStatsForFlow(FlowId flowId);
 
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet identification
+    /// \returns the key of the packet in m_trackedPackets
+    static uint64_t GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId);
+
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
 };
 
+inline bool
+FlowMonitor::IsSampled(FlowId flowId, FlowPacketId packetId) const
+{
+    // evenly spaced packets, from an offset that depends on the flow
+    return m_samplingRatio <= 1 || (packetId + flowId * 2654435761U) % m_samplingRatio == 0;
+}
+
 } // namespace ns3
 
 #endif /* FLOW_MONITOR_H */
@@ -91,6 +91,16 @@ operator==(const Ipv4FlowClassifier::FiveTuple& t1, const Ipv4FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
+std::size_t
+Ipv4FlowClassifier::FiveTupleHash::operator()(const FiveTuple& t) const
+{
+    uint64_t h = t.sourceAddress.Get();
+    h = (h << 32) | t.destinationAddress.Get();
+    h ^= (static_cast<uint64_t>(t.sourcePort) << 40) ^
+         (static_cast<uint64_t>(t.destinationPort) << 16) ^ t.protocol;
+    return static_cast<std::size_t>(h ^ (h >> 29));
+}
+
 Ipv4FlowClassifier::Ipv4FlowClassifier()
 {
 }
@@ -145,36 +155,45 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
     tuple.destinationPort = dstPort;
 
     // try to insert the tuple, but check if it already exists
-    std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert =
-        m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
+    std::pair<FlowId*, bool> insert = m_flowMap.Insert(tuple);
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
+    FlowInfo* flow;
     if (insert.second)
     {
         FlowId newFlowId = GetNewFlowId();
-        insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        *insert.first = newFlowId;
+        NS_ASSERT(newFlowId == m_flows.size() + 1);
+        m_flows.emplace_back();
+        flow = &m_flows.back();
+        flow->tuple = tuple;
+        flow->lastPacketId = 0;
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        flow = &m_flows[*insert.first - 1];
+        flow->lastPacketId++;
     }
 
-    // increment the counter of packets with the same DSCP value
+    // increment the counter of packets with the same DSCP value; a flow
+    // seldom has more than one
     Ipv4Header::DscpType dscp = ipHeader.GetDscp();
-    std::pair<std::map<Ipv4Header::DscpType, uint32_t>::iterator, bool> dscpInserter =
-        m_flowDscpMap[insert.first->second].insert(
-            std::pair<Ipv4Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
+    auto dscpCount = std::find_if(flow->dscpCounts.begin(),
+                                  flow->dscpCounts.end(),
+                                  [dscp](const std::pair<Ipv4Header::DscpType, uint32_t>& count) {
+                                      return count.first == dscp;
+                                  });
+    if (dscpCount == flow->dscpCounts.end())
     {
-        m_flowDscpMap[insert.first->second][dscp]++;
+        flow->dscpCounts.emplace_back(dscp, 1);
+    }
+    else
+    {
+        dscpCount->second++;
     }
 
-    *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_flowId = *insert.first;
+    *out_packetId = flow->lastPacketId;
 
     return true;
 }
@@ -182,14 +201,9 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow(FlowId flowId) const
 {
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    if (flowId >= 1 && flowId <= m_flows.size())
     {
-        if (iter->second == flowId)
-        {
-            return iter->first;
-        }
+        return m_flows[flowId - 1].tuple;
     }
     NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     FiveTuple retval = {Ipv4Address::GetZero(), Ipv4Address::GetZero(), 0, 0, 0};
@@ -206,17 +220,14 @@ Ipv4FlowClassifier::SortByCount::operator()(std::pair<Ipv4Header::DscpType, uint
 std::vector<std::pair<Ipv4Header::DscpType, uint32_t>>
 Ipv4FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
-    std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>>::const_iterator flow =
-        m_flowDscpMap.find(flowId);
-
-    if (flow == m_flowDscpMap.end())
+    if (flowId < 1 || flowId > m_flows.size())
     {
         NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
 
-    std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v(flow->second.begin(),
-                                                             flow->second.end());
-    std::sort(v.begin(), v.end(), SortByCount());
+    std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v(m_flows[flowId - 1].dscpCounts);
+    std::sort(v.begin(), v.end());
+    std::stable_sort(v.begin(), v.end(), SortByCount());
     return v;
 }
 
@@ -227,32 +238,25 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "<Ipv4FlowClassifier>\n";
 
     indent += 2;
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    for (FlowId flowId = 1; flowId <= m_flows.size(); flowId++)
     {
+        const FlowInfo& flow = m_flows[flowId - 1];
         Indent(os, indent);
-        os << "<Flow flowId=\"" << iter->second << "\""
-           << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-           << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-           << " protocol=\"" << int(iter->first.protocol) << "\""
-           << " sourcePort=\"" << iter->first.sourcePort << "\""
-           << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+        os << "<Flow flowId=\"" << flowId << "\""
+           << " sourceAddress=\"" << flow.tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << flow.tuple.destinationAddress << "\""
+           << " protocol=\"" << int(flow.tuple.protocol) << "\""
+           << " sourcePort=\"" << flow.tuple.sourcePort << "\""
+           << " destinationPort=\"" << flow.tuple.destinationPort << "\">\n";
 
         indent += 2;
-        std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>>::const_iterator flow =
-            m_flowDscpMap.find(iter->second);
-
-        if (flow != m_flowDscpMap.end())
+        std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> dscpCounts(flow.dscpCounts);
+        std::sort(dscpCounts.begin(), dscpCounts.end());
+        for (const auto& count : dscpCounts)
         {
-            for (std::map<Ipv4Header::DscpType, uint32_t>::const_iterator i = flow->second.begin();
-                 i != flow->second.end();
-                 i++)
-            {
-                Indent(os, indent);
-                os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(i->first) << "\""
-                   << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+            Indent(os, indent);
+            os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(count.first) << "\""
+               << " packets=\"" << std::dec << count.second << "\" />\n";
         }
 
         indent -= 2;
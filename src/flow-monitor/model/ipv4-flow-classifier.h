@@ -21,10 +21,11 @@
 #define IPV4_FLOW_CLASSIFIER_H
 
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 #include "ns3/ipv4-header.h"
 
-#include <map>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -48,6 +49,14 @@ class Ipv4FlowClassifier : public FlowClassifier
         uint16_t destinationPort;       //!< Destination port
     };
 
+    /// Hash function of the FiveTuple
+    struct FiveTupleHash
+    {
+        /// \param t the tuple
+        /// \returns the hash of the tuple
+        std::size_t operator()(const FiveTuple& t) const;
+    };
+
     Ipv4FlowClassifier();
 
     /// \brief try to classify the packet into flow-id and packet-id
@@ -60,10 +69,10 @@ class Ipv4FlowClassifier : public FlowClassifier
     /// \param ipPayload packet's IP payload
     /// \param out_flowId packet's FlowId
     /// \param out_packetId packet's identifier
-    bool Classify(const Ipv4Header& ipHeader,
-                  Ptr<const Packet> ipPayload,
-                  uint32_t* out_flowId,
-                  uint32_t* out_packetId);
+    virtual bool Classify(const Ipv4Header& ipHeader,
+                          Ptr<const Packet> ipPayload,
+                          uint32_t* out_flowId,
+                          uint32_t* out_packetId);
 
     /// Searches for the FiveTuple corresponding to the given flowId
     /// \param flowId the FlowId to search for
@@ -92,12 +101,19 @@ class Ipv4FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
+    /// State of a flow
+    struct FlowInfo
+    {
+        FiveTuple tuple;           //!< Flow identifier
+        FlowPacketId lastPacketId; //!< Identifier of the last packet
+        /// (DSCP value, packet count) pairs, in the order they were seen
+        std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> dscpCounts;
+    };
+
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>> m_flowDscpMap;
+    FlowHashTable<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// State of the flows, indexed by FlowId - 1
+    std::vector<FlowInfo> m_flows;
 };
 
 /**
@@ -343,6 +343,11 @@ Ipv4FlowProbe::SendOutgoingLogger(const Ipv4Header& ipHeader,
 
     if (m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId))
     {
+        if (!m_flowMonitor->IsSampled(flowId, packetId))
+        {
+            // not tracked: neither reported nor tagged
+            return;
+        }
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportFirstTx (" << this << ", " << flowId << ", " << packetId << ", " << size
                                        << "); " << ipHeader << *ipPayload);
@@ -286,6 +286,11 @@ Ipv6FlowProbe::SendOutgoingLogger(const Ipv6Header& ipHeader,
 
     if (m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId))
     {
+        if (!m_flowMonitor->IsSampled(flowId, packetId))
+        {
+            // not tracked: neither reported nor tagged
+            return;
+        }
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportFirstTx (" << this << ", " << flowId << ", " << packetId << ", " << size
                                        << "); " << ipHeader << *ipPayload);
@@ -0,0 +1,194 @@
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/flow-hash-table.h"
+#include "ns3/test.h"
+
+#include <map>
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor
+ * \defgroup flow-monitor-test flow monitor module tests
+ */
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Hash sending every key to the same slot, so that every entry is
+ * found by probing.
+ */
+struct CollidingHash
+{
+    /**
+     * \returns zero, whatever the key
+     */
+    std::size_t operator()(uint32_t) const
+    {
+        return 0;
+    }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Check FlowHashTable against a std::map through a sequence of
+ * inserts and erases, with the standard hash and with a hash colliding on
+ * every key.
+ *
+ * \tparam Hash the hash function of the table
+ */
+template <typename Hash>
+class FlowHashTableTestCase : public TestCase
+{
+  public:
+    /**
+     * \param name the name of the test case
+     * \param keys keys are drawn in [0, keys)
+     */
+    FlowHashTableTestCase(const std::string& name, uint32_t keys);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check that the table holds the entries of the reference.
+     *
+     * \param table the table
+     * \param reference the expected entries
+     */
+    void CheckSame(const FlowHashTable<uint32_t, uint32_t, Hash>& table,
+                   const std::map<uint32_t, uint32_t>& reference);
+
+    uint32_t m_keys; //!< keys are drawn in [0, m_keys)
+};
+
+template <typename Hash>
+FlowHashTableTestCase<Hash>::FlowHashTableTestCase(const std::string& name, uint32_t keys)
+    : TestCase(name),
+      m_keys(keys)
+{
+}
+
+template <typename Hash>
+void
+FlowHashTableTestCase<Hash>::CheckSame(const FlowHashTable<uint32_t, uint32_t, Hash>& table,
+                                       const std::map<uint32_t, uint32_t>& reference)
+{
+    NS_TEST_ASSERT_MSG_EQ(table.GetSize(), reference.size(), "wrong size");
+    std::size_t visited = 0;
+    table.ForEach([&](const uint32_t& key, const uint32_t& value) {
+        auto it = reference.find(key);
+        NS_TEST_EXPECT_MSG_EQ((it != reference.end()), true, "stray key " << key);
+        if (it != reference.end())
+        {
+            NS_TEST_EXPECT_MSG_EQ(value, it->second, "wrong value of key " << key);
+        }
+        visited++;
+    });
+    NS_TEST_ASSERT_MSG_EQ(visited, reference.size(), "wrong number of entries visited");
+    for (uint32_t key = 0; key < m_keys; key++)
+    {
+        const uint32_t* value = table.Find(key);
+        auto it = reference.find(key);
+        NS_TEST_ASSERT_MSG_EQ((value != nullptr), (it != reference.end()), "key " << key);
+        if (value)
+        {
+            NS_TEST_ASSERT_MSG_EQ(*value, it->second, "wrong value of key " << key);
+        }
+    }
+}
+
+template <typename Hash>
+void
+FlowHashTableTestCase<Hash>::DoRun()
+{
+    FlowHashTable<uint32_t, uint32_t, Hash> table;
+    std::map<uint32_t, uint32_t> reference;
+
+    // a fixed linear congruential sequence of keys, biased towards inserts
+    // so the table grows several times
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1103515245 + 12345;
+        return state >> 8;
+    };
+    for (uint32_t step = 0; step < 20 * m_keys; step++)
+    {
+        uint32_t key = next() % m_keys;
+        if (next() % 3)
+        {
+            auto inserted = table.Insert(key);
+            bool isNew = reference.find(key) == reference.end();
+            NS_TEST_ASSERT_MSG_EQ(inserted.second, isNew, "wrong insertion of key " << key);
+            if (isNew)
+            {
+                NS_TEST_ASSERT_MSG_EQ(*inserted.first, 0, "value not default");
+            }
+            *inserted.first = step;
+            reference[key] = step;
+        }
+        else
+        {
+            NS_TEST_ASSERT_MSG_EQ(table.Erase(key),
+                                  (reference.erase(key) == 1),
+                                  "wrong erasure of key " << key);
+        }
+        if (step % m_keys == 0)
+        {
+            CheckSame(table, reference);
+        }
+    }
+    CheckSame(table, reference);
+
+    table.EraseIf([](const uint32_t& key, const uint32_t&) { return key % 2 == 0; });
+    for (auto it = reference.begin(); it != reference.end();)
+    {
+        it = it->first % 2 == 0 ? reference.erase(it) : std::next(it);
+    }
+    CheckSame(table, reference);
+
+    table.Clear();
+    reference.clear();
+    CheckSame(table, reference);
+    NS_TEST_ASSERT_MSG_EQ(table.Insert(1).second, true, "table unusable after Clear");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowHashTable TestSuite
+ */
+class FlowHashTableTestSuite : public TestSuite
+{
+  public:
+    FlowHashTableTestSuite();
+};
+
+FlowHashTableTestSuite::FlowHashTableTestSuite()
+    : TestSuite("flow-hash-table", UNIT)
+{
+    AddTestCase(
+        new FlowHashTableTestCase<std::hash<uint32_t>>("Check with the standard hash", 1000),
+        TestCase::QUICK);
+    AddTestCase(new FlowHashTableTestCase<CollidingHash>("Check with colliding keys", 100),
+                TestCase::QUICK);
+}
+
+static FlowHashTableTestSuite g_flowHashTableTestSuite; //!< Static variable for test initialization
@@ -88,6 +88,17 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      *
      */
     static void RecomputeRoutingTables();
+
+    /**
+     * \brief Update the routing tables after links or addresses changed.
+     *
+     * Like RecomputeRoutingTables(), but when the
+     * GlobalRoutingIncrementalUpdates global value is set, only the nodes
+     * whose shortest path tree may have changed run the SPF computation
+     * again; the others merely update the routes to the changed routers and
+     * networks.  Users must first call PopulateRoutingTables().
+     */
+    static void UpdateRoutingTables();
 };
 
 } // namespace ns3
@@ -28,16 +28,23 @@
 #include "ipv4-global-routing.h"
 
 #include "ns3/assert.h"
+#include "ns3/boolean.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <queue>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -46,6 +53,27 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * The number of threads running the per-root SPF calculations.
+ */
+static GlobalValue g_spfThreads("GlobalRoutingSpfThreads",
+                                "The number of threads running the per-root SPF calculations "
+                                "of global routing, 0 for one per hardware thread",
+                                UintegerValue(1),
+                                MakeUintegerChecker<uint32_t>());
+
+/**
+ * \ingroup globalrouting
+ * Whether to keep the shortest path trees for incremental route updates.
+ */
+static GlobalValue g_incrementalUpdates(
+    "GlobalRoutingIncrementalUpdates",
+    "Keep the shortest path trees of global routing, so that a change of links or "
+    "addresses only recomputes the roots it may affect",
+    BooleanValue(false),
+    MakeBooleanChecker());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -299,6 +327,18 @@ SPFVertex::SetRootExitDirection(SPFVertex::NodeExit_t exit)
     SetRootExitDirection(exit.first, exit.second);
 }
 
+void
+SPFVertex::AddRootExitDirection(SPFVertex::NodeExit_t exit)
+{
+    NS_LOG_FUNCTION(this << exit);
+    m_ecmpRootExits.push_back(exit);
+    if (m_ecmpRootExits.size() == 1)
+    {
+        m_nextHop = exit.first;
+        m_rootOif = exit.second;
+    }
+}
+
 SPFVertex::NodeExit_t
 SPFVertex::GetRootExitDirection(uint32_t i) const
 {
@@ -476,7 +516,29 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     }
     else
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        if (!m_database.insert(LSDBPair_t(addr, lsa)).second)
+        {
+            return;
+        }
+        // index transit network records, the lowest link state ID wins as in
+        // a walk of the database
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                continue;
+            }
+            auto it = m_linkDataIndex.find(lr->GetLinkData());
+            if (it == m_linkDataIndex.end())
+            {
+                m_linkDataIndex.insert(LSDBPair_t(lr->GetLinkData(), lsa));
+            }
+            else if (addr < it->second->GetLinkStateId())
+            {
+                it->second = lsa;
+            }
+        }
     }
 }
 
@@ -501,13 +563,10 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    LSDBMap_t::const_iterator i;
-    for (i = m_database.begin(); i != m_database.end(); i++)
+    LSDBMap_t::const_iterator i = m_database.find(addr);
+    if (i != m_database.end())
     {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
+        return i->second;
     }
     return nullptr;
 }
@@ -517,24 +576,104 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the link data of its transit network records.
     //
-    LSDBMap_t::const_iterator i;
-    for (i = m_database.begin(); i != m_database.end(); i++)
+    LSDBMap_t::const_iterator i = m_linkDataIndex.find(addr);
+    if (i != m_linkDataIndex.end())
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
+        return i->second;
+    }
+    return nullptr;
+}
+
+GlobalRouteManagerLSDB*
+GlobalRouteManagerLSDB::Clone() const
+{
+    NS_LOG_FUNCTION(this);
+    GlobalRouteManagerLSDB* lsdb = new GlobalRouteManagerLSDB();
+    for (LSDBMap_t::const_iterator i = m_database.begin(); i != m_database.end(); i++)
+    {
+        lsdb->Insert(i->first, new GlobalRoutingLSA(*i->second));
+    }
+    for (uint32_t j = 0; j < m_extdatabase.size(); j++)
+    {
+        GlobalRoutingLSA* lsa = m_extdatabase.at(j);
+        lsdb->Insert(lsa->GetLinkStateId(), new GlobalRoutingLSA(*lsa));
+    }
+    return lsdb;
+}
+
+/**
+ * \brief Compare two LSAs, ignoring their SPF status.
+ *
+ * \param a the first LSA
+ * \param b the second LSA
+ * \returns true if the LSAs advertise the same links
+ */
+static bool
+IsSameLSA(const GlobalRoutingLSA* a, const GlobalRoutingLSA* b)
+{
+    if (a->GetLSType() != b->GetLSType() || a->GetLinkStateId() != b->GetLinkStateId() ||
+        a->GetAdvertisingRouter() != b->GetAdvertisingRouter() ||
+        a->GetNetworkLSANetworkMask() != b->GetNetworkLSANetworkMask() ||
+        a->GetNLinkRecords() != b->GetNLinkRecords() ||
+        a->GetNAttachedRouters() != b->GetNAttachedRouters())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->GetNLinkRecords(); i++)
+    {
+        GlobalRoutingLinkRecord* la = a->GetLinkRecord(i);
+        GlobalRoutingLinkRecord* lb = b->GetLinkRecord(i);
+        if (la->GetLinkType() != lb->GetLinkType() || la->GetLinkId() != lb->GetLinkId() ||
+            la->GetLinkData() != lb->GetLinkData() || la->GetMetric() != lb->GetMetric())
         {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
-            {
-                return temp;
-            }
+            return false;
         }
     }
-    return nullptr;
+    for (uint32_t i = 0; i < a->GetNAttachedRouters(); i++)
+    {
+        if (a->GetAttachedRouter(i) != b->GetAttachedRouter(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+GlobalRouteManagerLSDB::Diff(const GlobalRouteManagerLSDB* other,
+                             std::set<Ipv4Address>& changed) const
+{
+    NS_LOG_FUNCTION(this << other);
+    for (LSDBMap_t::const_iterator i = m_database.begin(); i != m_database.end(); i++)
+    {
+        GlobalRoutingLSA* lsa = other->GetLSA(i->first);
+        if (!lsa || !IsSameLSA(i->second, lsa))
+        {
+            changed.insert(i->first);
+        }
+    }
+    for (LSDBMap_t::const_iterator i = other->m_database.begin(); i != other->m_database.end();
+         i++)
+    {
+        if (!GetLSA(i->first))
+        {
+            changed.insert(i->first);
+        }
+    }
+    if (m_extdatabase.size() != other->m_extdatabase.size())
+    {
+        return true;
+    }
+    for (uint32_t j = 0; j < m_extdatabase.size(); j++)
+    {
+        if (!IsSameLSA(m_extdatabase.at(j), other->m_extdatabase.at(j)))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 // ---------------------------------------------------------------------------
@@ -544,7 +683,8 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 // ---------------------------------------------------------------------------
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl()
-    : m_spfroot(nullptr)
+    : m_spfroot(nullptr),
+      m_spfctx(nullptr)
 {
     NS_LOG_FUNCTION(this);
     m_lsdb = new GlobalRouteManagerLSDB();
@@ -597,6 +737,7 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         }
         NS_LOG_LOGIC("Deleted " << j << " global routes from node " << node->GetId());
     }
+    m_rootStates.clear();
     if (m_lsdb)
     {
         NS_LOG_LOGIC("Deleting LSDB, creating new one");
@@ -701,10 +842,23 @@ void
 GlobalRouteManagerImpl::InitializeRoutes()
 {
     NS_LOG_FUNCTION(this);
+    NS_LOG_INFO("About to start SPF calculation");
+    m_rootStates.clear();
+    std::vector<SPFRootContext> contexts;
+    CollectRoots(contexts);
+    ComputeRoots(contexts);
+    NS_LOG_INFO("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::CollectRoots(std::vector<SPFRootContext>& contexts) const
+{
+    NS_LOG_FUNCTION(this);
+    BooleanValue incremental;
+    g_incrementalUpdates.GetValue(incremental);
     //
     // Walk the list of nodes in the system.
     //
-    NS_LOG_INFO("About to start SPF calculation");
     NodeList::Iterator listEnd = NodeList::End();
     for (NodeList::Iterator i = NodeList::Begin(); i != listEnd; i++)
     {
@@ -728,10 +882,524 @@ GlobalRouteManagerImpl::InitializeRoutes()
         //
         if (rtr && rtr->GetNumLSAs())
         {
-            SPFCalculate(rtr->GetRouterId());
+            contexts.emplace_back();
+            ResolveRootContext(node, rtr->GetRouterId(), contexts.back());
+            contexts.back().record = incremental.Get();
         }
     }
-    NS_LOG_INFO("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::ComputeRoots(std::vector<SPFRootContext>& contexts)
+{
+    NS_LOG_FUNCTION(this << contexts.size());
+    //
+    // The SPF calculations of different roots are independent; they may run
+    // concurrently, while the routes are installed in node order afterwards so
+    // that the routing tables do not depend on the number of threads.
+    //
+    UintegerValue threadsValue;
+    g_spfThreads.GetValue(threadsValue);
+    uint32_t nThreads = threadsValue.Get();
+    if (nThreads == 0)
+    {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (!g_log.IsNoneEnabled())
+    {
+        // logging is not thread safe
+        nThreads = 1;
+    }
+    nThreads = std::min<uint32_t>(nThreads, contexts.size());
+
+    if (nThreads > 1)
+    {
+        SPFComputeParallel(contexts, nThreads);
+    }
+    for (auto& ctx : contexts)
+    {
+        if (nThreads <= 1)
+        {
+            SPFCompute(ctx);
+        }
+        InstallRoutes(ctx);
+        if (ctx.record)
+        {
+            KeepRootState(ctx);
+        }
+        ctx.routes.clear();
+    }
+}
+
+void
+GlobalRouteManagerImpl::ResolveRootContext(Ptr<Node> node,
+                                           Ipv4Address root,
+                                           SPFRootContext& ctx) const
+{
+    NS_LOG_FUNCTION(this << node << root);
+    ctx.routerId = root;
+    ctx.checkStub = NodeList::GetNNodes() > 0;
+    ctx.routing = nullptr;
+    ctx.localAddrs.clear();
+    ctx.routes.clear();
+    ctx.record = false;
+    ctx.stub = false;
+    ctx.tree.clear();
+
+    //
+    // Unless we were given the node, we need to walk the list of nodes looking
+    // for the one that has the router ID corresponding to the root vertex.
+    // This is the one we're going to write the routing information to.
+    //
+    NodeList::Iterator listEnd = NodeList::End();
+    for (NodeList::Iterator i = NodeList::Begin(); !node && i != listEnd; i++)
+    {
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == root)
+        {
+            node = *i;
+        }
+    }
+    if (!node)
+    {
+        NS_LOG_LOGIC("Can't find root node " << root);
+        return;
+    }
+
+    NS_LOG_LOGIC("Resolved root " << root << " to node " << node->GetId());
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4,
+                  "GlobalRouteManagerImpl::ResolveRootContext (): "
+                  "GetObject for <Ipv4> interface failed");
+    for (uint32_t j = 0; j < ipv4->GetNInterfaces(); j++)
+    {
+        for (uint32_t k = 0; k < ipv4->GetNAddresses(j); k++)
+        {
+            ctx.localAddrs.emplace_back(ipv4->GetAddress(j, k).GetLocal(), j);
+        }
+    }
+    Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
+    NS_ASSERT(router);
+    ctx.routing = router->GetRoutingProtocol();
+    NS_ASSERT(ctx.routing);
+}
+
+void
+GlobalRouteManagerImpl::SPFComputeParallel(std::vector<SPFRootContext>& contexts,
+                                           uint32_t nThreads)
+{
+    NS_LOG_FUNCTION(this << contexts.size() << nThreads);
+    //
+    // Every worker explores its own copy of the LSDB; the copies are made and
+    // freed here, in the calling thread.
+    //
+    std::vector<std::unique_ptr<GlobalRouteManagerImpl>> workers;
+    for (uint32_t t = 0; t < nThreads; t++)
+    {
+        workers.emplace_back(new GlobalRouteManagerImpl());
+        workers.back()->DebugUseLsdb(m_lsdb->Clone());
+    }
+
+    std::atomic<uint32_t> next(0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < nThreads; t++)
+    {
+        GlobalRouteManagerImpl* worker = workers[t].get();
+        threads.emplace_back([worker, &contexts, &next]() {
+            for (uint32_t i = next++; i < contexts.size(); i = next++)
+            {
+                worker->SPFCompute(contexts[i]);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void
+GlobalRouteManagerImpl::InstallRoutes(const SPFRootContext& ctx)
+{
+    NS_LOG_FUNCTION(this << ctx.routerId << ctx.routes.size());
+    if (!ctx.routing)
+    {
+        return;
+    }
+    for (const auto& route : ctx.routes)
+    {
+        switch (route.kind)
+        {
+        case SPFRoute::HOST_ROUTE:
+            ctx.routing->AddHostRouteTo(route.dest, route.nextHop, route.outIf);
+            break;
+        case SPFRoute::NETWORK_ROUTE:
+            ctx.routing->AddNetworkRouteTo(route.dest, route.mask, route.nextHop, route.outIf);
+            break;
+        case SPFRoute::EXTERNAL_ROUTE:
+            ctx.routing->AddASExternalRouteTo(route.dest, route.mask, route.nextHop, route.outIf);
+            break;
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::AddRoute(SPFRoute::Kind kind,
+                                 Ipv4Address vertex,
+                                 Ipv4Address dest,
+                                 Ipv4Mask mask,
+                                 Ipv4Address nextHop,
+                                 uint32_t outIf)
+{
+    NS_LOG_FUNCTION(this << kind << vertex << dest << mask << nextHop << outIf);
+    NS_ASSERT_MSG(m_spfctx, "GlobalRouteManagerImpl::AddRoute (): no SPF calculation in progress");
+    m_spfctx->routes.push_back({kind, vertex, dest, mask, nextHop, outIf});
+}
+
+void
+GlobalRouteManagerImpl::KeepRootState(SPFRootContext& ctx)
+{
+    NS_LOG_FUNCTION(this << ctx.routerId);
+    if (!ctx.routing)
+    {
+        return;
+    }
+    SPFRootState& state = m_rootStates[ctx.routerId];
+    state.routing = ctx.routing;
+    state.localAddrs = ctx.localAddrs;
+    state.stub = ctx.stub;
+    state.tree.swap(ctx.tree);
+    state.routes.swap(ctx.routes);
+}
+
+void
+GlobalRouteManagerImpl::RemoveRoutes(Ptr<Ipv4GlobalRouting> routing) const
+{
+    NS_LOG_FUNCTION(this << routing);
+    // Each time we delete route 0, the route index shifts downward
+    uint32_t nRoutes = routing->GetNRoutes();
+    for (uint32_t j = 0; j < nRoutes; j++)
+    {
+        routing->RemoveRoute(0);
+    }
+}
+
+/**
+ * \brief The transit edges leaving the vertex of an LSA.
+ *
+ * \param lsa the router or network LSA, may be null
+ * \param lsdb the database the LSA belongs to
+ * \returns the link state IDs of the neighbor vertices and the edge costs
+ */
+static std::map<Ipv4Address, uint32_t>
+GetTransitEdges(const GlobalRoutingLSA* lsa, const GlobalRouteManagerLSDB* lsdb)
+{
+    std::map<Ipv4Address, uint32_t> edges;
+    if (!lsa)
+    {
+        return edges;
+    }
+    if (lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA)
+    {
+        for (uint32_t i = 0; i < lsa->GetNAttachedRouters(); i++)
+        {
+            GlobalRoutingLSA* router = lsdb->GetLSAByLinkData(lsa->GetAttachedRouter(i));
+            if (router)
+            {
+                edges.emplace(router->GetLinkStateId(), 0);
+            }
+        }
+        return edges;
+    }
+    for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
+    {
+        GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+        if (l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint ||
+            l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+            auto inserted = edges.emplace(l->GetLinkId(), l->GetMetric());
+            if (!inserted.second)
+            {
+                inserted.first->second = std::min<uint32_t>(inserted.first->second, l->GetMetric());
+            }
+        }
+    }
+    return edges;
+}
+
+bool
+GlobalRouteManagerImpl::IsTreeAffected(Ipv4Address root,
+                                       const SPFRootState& state,
+                                       const std::set<Ipv4Address>& changed,
+                                       const GlobalRouteManagerLSDB* oldLsdb,
+                                       std::vector<Ipv4Address>& patch) const
+{
+    NS_LOG_FUNCTION(this << root << changed.size());
+    patch.clear();
+    if (changed.count(root))
+    {
+        return true;
+    }
+    if (state.stub)
+    {
+        //
+        // Only the default route towards the single neighbor was installed.
+        //
+        for (const auto& edge : GetTransitEdges(m_lsdb->GetLSA(root), m_lsdb))
+        {
+            if (changed.count(edge.first))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto isParent = [&state](Ipv4Address parent, Ipv4Address child) {
+        auto it = state.tree.find(child);
+        return it != state.tree.end() && std::find(it->second.parents.begin(),
+                                                   it->second.parents.end(),
+                                                   parent) != it->second.parents.end();
+    };
+
+    for (const auto& id : changed)
+    {
+        GlobalRoutingLSA* oldLsa = oldLsdb->GetLSA(id);
+        GlobalRoutingLSA* newLsa = m_lsdb->GetLSA(id);
+        auto oldEdges = GetTransitEdges(oldLsa, oldLsdb);
+        auto newEdges = GetTransitEdges(newLsa, m_lsdb);
+
+        auto it = state.tree.find(id);
+        if (it == state.tree.end())
+        {
+            //
+            // A vertex outside of the tree only matters if it is, or now
+            // becomes, adjacent to the tree.
+            //
+            for (const auto* edges : {&oldEdges, &newEdges})
+            {
+                for (const auto& edge : *edges)
+                {
+                    if (state.tree.count(edge.first))
+                    {
+                        return true;
+                    }
+                }
+            }
+            continue;
+        }
+        if (!newLsa)
+        {
+            return true;
+        }
+        //
+        // The next hops of the vertices next to the root, directly or through a
+        // network, come from the LSAs of those vertices.
+        //
+        const SPFTreeVertex& vertex = it->second;
+        for (const auto& parent : vertex.parents)
+        {
+            if (parent == root || isParent(root, parent))
+            {
+                return true;
+            }
+        }
+        //
+        // Removing or lengthening an edge of the tree may change it, as may
+        // adding or shortening an edge which leads to a vertex at least as
+        // close through it.
+        //
+        for (const auto& edge : oldEdges)
+        {
+            auto found = newEdges.find(edge.first);
+            if ((found == newEdges.end() || found->second > edge.second) &&
+                (isParent(id, edge.first) || isParent(edge.first, id)))
+            {
+                return true;
+            }
+        }
+        for (const auto& edge : newEdges)
+        {
+            auto found = oldEdges.find(edge.first);
+            if (found != oldEdges.end() && found->second <= edge.second)
+            {
+                continue;
+            }
+            auto neighbor = state.tree.find(edge.first);
+            if (neighbor == state.tree.end() ||
+                uint64_t(vertex.distance) + edge.second <= neighbor->second.distance)
+            {
+                return true;
+            }
+        }
+        patch.push_back(id);
+    }
+    return false;
+}
+
+void
+GlobalRouteManagerImpl::PatchRoutes(SPFRootContext& ctx,
+                                    SPFRootState& state,
+                                    const std::vector<Ipv4Address>& patch)
+{
+    NS_LOG_FUNCTION(this << ctx.routerId << patch.size());
+    //
+    // The tree is unchanged, so the routes derived from the changed vertices
+    // are found again from their new LSAs and the exit directions kept.
+    //
+    std::map<Ipv4Address, std::vector<SPFRoute>> patched;
+    m_spfctx = &ctx;
+    m_spfroot = new SPFVertex(m_lsdb->GetLSA(ctx.routerId));
+    for (const auto& id : patch)
+    {
+        const SPFTreeVertex& entry = state.tree.at(id);
+        SPFVertex v(m_lsdb->GetLSA(id));
+        v.SetDistanceFromRoot(entry.distance);
+        for (const auto& exit : entry.exits)
+        {
+            v.AddRootExitDirection(exit);
+        }
+        ctx.routes.clear();
+        if (entry.type == SPFVertex::VertexRouter)
+        {
+            SPFIntraAddRouter(&v);
+            GlobalRoutingLSA* lsa = v.GetLSA();
+            for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
+            {
+                GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+                if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                    SPFIntraAddStub(l, &v);
+                }
+            }
+        }
+        else
+        {
+            SPFIntraAddTransit(&v);
+        }
+        patched[id].swap(ctx.routes);
+    }
+    delete m_spfroot;
+    m_spfroot = nullptr;
+    m_spfctx = nullptr;
+
+    //
+    // Replace the old routes of every changed vertex where the first of them
+    // was, keeping the order of all the other routes.
+    //
+    std::vector<SPFRoute> routes;
+    std::set<Ipv4Address> placed;
+    routes.reserve(state.routes.size());
+    for (const auto& route : state.routes)
+    {
+        auto it = patched.find(route.vertex);
+        if (it == patched.end() || route.kind == SPFRoute::EXTERNAL_ROUTE)
+        {
+            routes.push_back(route);
+        }
+        else if (placed.insert(route.vertex).second)
+        {
+            routes.insert(routes.end(), it->second.begin(), it->second.end());
+        }
+    }
+    for (const auto& entry : patched)
+    {
+        if (!placed.count(entry.first))
+        {
+            routes.insert(routes.end(), entry.second.begin(), entry.second.end());
+        }
+    }
+    state.routes.swap(routes);
+
+    RemoveRoutes(state.routing);
+    ctx.routes = state.routes;
+    InstallRoutes(ctx);
+    ctx.routes.clear();
+}
+
+void
+GlobalRouteManagerImpl::UpdateRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_rootStates.empty())
+    {
+        NS_LOG_LOGIC("No shortest path trees kept, rebuilding all the routes");
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
+
+    GlobalRouteManagerLSDB* oldLsdb = m_lsdb;
+    m_lsdb = new GlobalRouteManagerLSDB();
+    BuildGlobalRoutingDatabase();
+    std::set<Ipv4Address> changed;
+    bool externalsChanged = oldLsdb->Diff(m_lsdb, changed);
+    NS_LOG_INFO("Updating routes, " << changed.size() << " LSAs changed");
+
+    std::map<Ipv4Address, SPFRootState> states;
+    states.swap(m_rootStates);
+    std::vector<SPFRootContext> contexts;
+    CollectRoots(contexts);
+    std::vector<SPFRootContext> recompute;
+    std::vector<Ipv4Address> patch;
+    uint32_t nPatched = 0;
+    for (auto& ctx : contexts)
+    {
+        auto it = states.find(ctx.routerId);
+        if (it != states.end() && !externalsChanged && it->second.routing == ctx.routing &&
+            it->second.localAddrs == ctx.localAddrs &&
+            !IsTreeAffected(ctx.routerId, it->second, changed, oldLsdb, patch))
+        {
+            if (!patch.empty())
+            {
+                PatchRoutes(ctx, it->second, patch);
+                nPatched++;
+            }
+            m_rootStates[ctx.routerId] = std::move(it->second);
+            states.erase(it);
+            continue;
+        }
+        if (it != states.end())
+        {
+            states.erase(it);
+        }
+        if (ctx.routing)
+        {
+            RemoveRoutes(ctx.routing);
+        }
+        recompute.push_back(std::move(ctx));
+    }
+    //
+    // Routers which are no longer roots lose their routes.
+    //
+    for (auto& state : states)
+    {
+        RemoveRoutes(state.second.routing);
+    }
+    NS_LOG_INFO("Recomputing " << recompute.size() << " of " << contexts.size()
+                               << " roots, patching " << nPatched);
+    ComputeRoots(recompute);
+    delete oldLsdb;
+}
+
+void
+GlobalRouteManagerImpl::NotifyTopologyChange()
+{
+    NS_LOG_FUNCTION(this);
+    BooleanValue incremental;
+    g_incrementalUpdates.GetValue(incremental);
+    if (!incremental.Get())
+    {
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
+    if (!m_updateEvent.IsRunning())
+    {
+        m_updateEvent = Simulator::ScheduleNow(&GlobalRouteManagerImpl::UpdateRoutes, this);
+    }
 }
 
 //
@@ -1317,14 +1985,12 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                    NS_ASSERT(gr);
-                    gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
-                                          Ipv4Mask("0.0.0.0"),
-                                          lr->GetLinkData(),
-                                          FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                    AddRoute(SPFRoute::NETWORK_ROUTE,
+                             root,
+                             Ipv4Address("0.0.0.0"),
+                             Ipv4Mask("0.0.0.0"),
+                             lr->GetLinkData(),
+                             FindOutgoingInterfaceId(transitLink->GetLinkData()));
                     NS_LOG_LOGIC("Inserting default route for node "
                                  << myRouterId << " to next hop " << lr->GetLinkData()
                                  << " via interface "
@@ -1337,13 +2003,25 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
     return false;
 }
 
-// quagga ospf_spf_calculate
 void
 GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
+    SPFRootContext ctx;
+    ResolveRootContext(nullptr, root, ctx);
+    SPFCompute(ctx);
+    InstallRoutes(ctx);
+}
+
+// quagga ospf_spf_calculate
+void
+GlobalRouteManagerImpl::SPFCompute(SPFRootContext& ctx)
+{
+    Ipv4Address root = ctx.routerId;
+    NS_LOG_FUNCTION(this << root);
 
     SPFVertex* v;
+    m_spfctx = &ctx;
     //
     // Initialize the Link State Database.
     //
@@ -1377,10 +2055,15 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // reached.  Instead, short-circuit this computation and just install
     // a default route in the CheckForStubNode() method.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    ctx.stub = false;
+    ctx.tree.clear();
+    if (ctx.checkStub && CheckForStubNode(root))
     {
         NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
+        ctx.stub = true;
         delete m_spfroot;
+        m_spfroot = nullptr;
+        m_spfctx = nullptr;
         return;
     }
 
@@ -1497,11 +2180,45 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 
     //
     // We're all done setting the routing information for the node at the root of
-    // the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-    // possibly do it again for the next router.
+    // the SPF tree.  Keep the shape of the tree if incremental updates need it,
+    // then delete all of the vertices and corresponding resources.  Go possibly
+    // do it again for the next router.
     //
+    if (ctx.record)
+    {
+        std::vector<SPFVertex*> pending(1, m_spfroot);
+        while (!pending.empty())
+        {
+            SPFVertex* vertex = pending.back();
+            pending.pop_back();
+            auto inserted = ctx.tree.emplace(vertex->GetVertexId(), SPFTreeVertex());
+            if (!inserted.second)
+            {
+                continue;
+            }
+            SPFTreeVertex& entry = inserted.first->second;
+            entry.type = vertex->GetVertexType();
+            entry.distance = vertex->GetDistanceFromRoot();
+            for (uint32_t i = 0; vertex->GetParent(i); i++)
+            {
+                entry.parents.push_back(vertex->GetParent(i)->GetVertexId());
+            }
+            if (vertex != m_spfroot)
+            {
+                for (uint32_t i = 0; i < vertex->GetNRootExitDirections(); i++)
+                {
+                    entry.exits.push_back(vertex->GetRootExitDirection(i));
+                }
+            }
+            for (uint32_t i = 0; i < vertex->GetNChildren(); i++)
+            {
+                pending.push_back(vertex->GetChild(i));
+            }
+        }
+    }
     delete m_spfroot;
     m_spfroot = nullptr;
+    m_spfctx = nullptr;
 }
 
 void
@@ -1553,110 +2270,42 @@ GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
     }
     NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
                                                 << "; installing");
+    NS_LOG_LOGIC("Vertex ID = " << m_spfroot->GetVertexId());
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFAddASExternal (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
 
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routes are recorded in the SPF context of the root and written to
+    // its routing table once the calculation is complete.  The vertex <v> has
+    // the next hops and outgoing interfaces precalculated for us.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            AddRoute(SPFRoute::EXTERNAL_ROUTE, v->GetVertexId(), tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " add external network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
@@ -1713,116 +2362,41 @@ GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v
         return;
     }
     NS_LOG_LOGIC("Stub is on remote host: " << v->GetVertexId() << "; installing");
-    //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    NS_LOG_LOGIC("Vertex ID = " << m_spfroot->GetVertexId());
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddStub (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routes are recorded in the SPF context of the root and written to
+    // its routing table once the calculation is complete.  The vertex <v> has
+    // the next hops and outgoing interfaces precalculated for us.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            AddRoute(SPFRoute::NETWORK_ROUTE, v->GetVertexId(), tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " add network route to " << tempip << " using next hop "
+                                   << nextHop << " via interface " << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
@@ -1836,69 +2410,27 @@ int32_t
 GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
 {
     NS_LOG_FUNCTION(this << a << amask);
+    NS_ASSERT_MSG(m_spfctx,
+                  "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
+                  "no SPF calculation in progress");
     //
-    // We have an IP address <a> and a vertex ID of the root of the SPF tree.
-    // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    // The addresses of the root node were resolved before the calculation
+    // started, in (interface, address) order.  Return the first interface
+    // with an address in the same prefix, as Ipv4::GetInterfaceForPrefix does.
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
-    //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    Ipv4Address prefix = a.CombineMask(amask);
+    for (const auto& local : m_spfctx->localAddrs)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
+        if (local.first.CombineMask(amask) == prefix)
         {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
+            return local.second;
         }
     }
     //
     // Couldn't find it.
     //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
+    NS_LOG_LOGIC("FindOutgoingInterfaceId(): no interface of " << m_spfctx->routerId
+                                                               << " in prefix " << prefix);
     return -1;
 }
 
@@ -1924,141 +2456,76 @@ GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
     NS_LOG_FUNCTION(this << v);
 
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
+    NS_LOG_LOGIC("Vertex ID = " << m_spfroot->GetVertexId());
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresping to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    NS_LOG_LOGIC(" Root " << m_spfroot->GetVertexId() << " found " << nLinkRecords
+                          << " link records in LSA " << lsa << "with LinkStateId "
+                          << lsa->GetLinkStateId());
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // We're going to add a host route to the host address found in the
+        // m_linkData field of the point-to-point link record.  In the case of a
+        // point-to-point link, this is the local IP address of the node connected
+        // to the link.  The vertex <v> has the next hops and outgoing interfaces
+        // (on the root) precalculated for us.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        // walk through all available exit directions due to ECMP,
+        // and add host route for each of the exit direction toward
+        // the vertex 'v'
+        for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresping to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+            Ipv4Address nextHop = exit.first;
+            int32_t outIf = exit.second;
+            if (outIf >= 0)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+                AddRoute(SPFRoute::HOST_ROUTE,
+                         v->GetVertexId(),
+                         lr->GetLinkData(),
+                         Ipv4Mask::GetOnes(),
+                         nextHop,
+                         outIf);
+                NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                       << " adding host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " and outgoing interface " << outIf);
             }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+            else
+            {
+                NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                       << " NOT able to add host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 
@@ -2068,102 +2535,40 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
     NS_LOG_FUNCTION(this << v);
 
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
+    NS_LOG_LOGIC("Vertex ID = " << m_spfroot->GetVertexId());
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  For a transit network this is the network LSA.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    // walk through all available exit directions due to ECMP,
+    // and add host route for each of the exit direction toward
+    // the vertex 'v'
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
 
-        if (!rtr)
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            AddRoute(SPFRoute::NETWORK_ROUTE, v->GetVertexId(), tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " add network route to " << tempip << " using next hop "
+                                   << nextHop << " via interface " << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
         }
     }
 }
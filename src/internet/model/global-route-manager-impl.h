@@ -23,6 +23,7 @@
 
 #include "global-router-interface.h"
 
+#include "ns3/event-id.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -30,6 +31,7 @@
 #include <list>
 #include <map>
 #include <queue>
+#include <set>
 #include <stdint.h>
 #include <vector>
 
@@ -338,6 +340,14 @@ class SPFVertex
      * forwarding packets to the host or network represented by "this" SPFVertex.
      */
     void SetRootExitDirection(SPFVertex::NodeExit_t exit);
+
+    /**
+     * \brief Append an exit direction from root to the ones of "this" vertex,
+     * keeping their order.
+     *
+     * \param exit The pair of next-hop-IP and outgoing-interface-index
+     */
+    void AddRootExitDirection(SPFVertex::NodeExit_t exit);
     /**
      * \brief Obtain a pair indicating the exit direction from the root
      *
@@ -672,6 +682,26 @@ class GlobalRouteManagerLSDB
      */
     uint32_t GetNumExtLSAs() const;
 
+    /**
+     * @brief Make a deep copy of the database.
+     *
+     * SPF calculations mark the LSAs they explore, so every thread computing
+     * routes works on its own snapshot of the database.
+     *
+     * @returns a newly allocated copy, owned by the caller
+     */
+    GlobalRouteManagerLSDB* Clone() const;
+
+    /**
+     * \brief Compare the LSAs of this database with those of another one.
+     *
+     * \param other the database to compare with
+     * \param changed the link state IDs of the router and network LSAs which
+     * were added, removed or modified
+     * \returns true if the AS external LSAs differ
+     */
+    bool Diff(const GlobalRouteManagerLSDB* other, std::set<Ipv4Address>& changed) const;
+
   private:
     typedef std::map<Ipv4Address, GlobalRoutingLSA*>
         LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
@@ -681,6 +711,7 @@ class GlobalRouteManagerLSDB
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
+    LSDBMap_t m_linkDataIndex; //!< LSAs by the link data of their transit network records
 };
 
 /**
@@ -725,6 +756,26 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Recompute the routes after links or addresses changed, running
+     * the SPF calculation again only for the roots whose shortest path tree
+     * may have changed, and patching the routing tables of the others.
+     *
+     * The shortest path trees are only kept when the
+     * GlobalRoutingIncrementalUpdates global value is set; without them all
+     * the routes are rebuilt.
+     */
+    virtual void UpdateRoutes();
+
+    /**
+     * @brief React to an interface going up or down, or to an address being
+     * added or removed.
+     *
+     * With incremental updates, the changes of a time step are coalesced into
+     * one UpdateRoutes (); otherwise all the routes are rebuilt at once.
+     */
+    void NotifyTopologyChange();
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -738,8 +789,180 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
+    /**
+     * \brief A route found by the SPF calculation, to be installed in the
+     * routing table of the root node.
+     */
+    struct SPFRoute
+    {
+        /// Route kinds, one per Ipv4GlobalRouting method adding them
+        enum Kind
+        {
+            HOST_ROUTE,     //!< AddHostRouteTo
+            NETWORK_ROUTE,  //!< AddNetworkRouteTo
+            EXTERNAL_ROUTE, //!< AddASExternalRouteTo
+        };
+
+        Kind kind;           //!< the route kind
+        Ipv4Address vertex;  //!< the SPF vertex the route was derived from
+        Ipv4Address dest;    //!< the destination host or network
+        Ipv4Mask mask;       //!< the destination network mask
+        Ipv4Address nextHop; //!< the next hop
+        uint32_t outIf;      //!< the outgoing interface
+    };
+
+    /**
+     * \brief A vertex of a shortest path tree kept for incremental updates.
+     */
+    struct SPFTreeVertex
+    {
+        SPFVertex::VertexType type;                //!< router or network vertex
+        uint32_t distance;                         //!< the distance from the root
+        std::vector<Ipv4Address> parents;          //!< the parents on equal cost paths
+        std::vector<SPFVertex::NodeExit_t> exits;  //!< the exit directions from the root
+    };
+
+    /**
+     * \brief What an SPF calculation needs to know about its root node.
+     *
+     * The context is resolved before the calculation starts, so that the
+     * calculation itself neither walks the node list nor touches the node's
+     * objects, and several calculations can run concurrently.
+     */
+    struct SPFRootContext
+    {
+        Ipv4Address routerId;           //!< router ID of the root
+        bool checkStub;                 //!< whether the stub node shortcut may be taken
+        Ptr<Ipv4GlobalRouting> routing; //!< routing table of the root node, if any
+        std::vector<std::pair<Ipv4Address, int32_t>>
+            localAddrs;               //!< local addresses of the root and their interfaces
+        std::vector<SPFRoute> routes; //!< routes found, in the order they were found
+        bool record;                  //!< whether to keep the shortest path tree
+        bool stub;                    //!< whether the stub node shortcut was taken
+        std::map<Ipv4Address, SPFTreeVertex> tree; //!< the shortest path tree, if kept
+    };
+
+    /**
+     * \brief What incremental updates need to know about the last SPF
+     * calculation of a root.
+     */
+    struct SPFRootState
+    {
+        Ptr<Ipv4GlobalRouting> routing; //!< routing table of the root node
+        std::vector<std::pair<Ipv4Address, int32_t>>
+            localAddrs;                            //!< local addresses the routes were based on
+        bool stub;                                 //!< whether the stub node shortcut was taken
+        std::map<Ipv4Address, SPFTreeVertex> tree; //!< the shortest path tree
+        std::vector<SPFRoute> routes;              //!< the installed routes, in order
+    };
+
     SPFVertex* m_spfroot;           //!< the root node
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    SPFRootContext* m_spfctx;       //!< the context of the SPF calculation in progress
+    std::map<Ipv4Address, SPFRootState> m_rootStates; //!< SPF results kept for incremental updates
+    EventId m_updateEvent;                            //!< the pending incremental update
+
+    /**
+     * \brief Resolve the root node of an SPF calculation
+     * \param node the root node, or null to look it up by router ID
+     * \param root the router ID of the root node
+     * \param ctx the context to fill in
+     */
+    void ResolveRootContext(Ptr<Node> node, Ipv4Address root, SPFRootContext& ctx) const;
+
+    /**
+     * \brief Resolve the contexts of all the routers of this system, in node
+     * order
+     * \param contexts the contexts
+     */
+    void CollectRoots(std::vector<SPFRootContext>& contexts) const;
+
+    /**
+     * \brief Run the SPF calculations of several roots, sequentially or on a
+     * pool of threads, install their routes in order and keep their trees
+     * if requested
+     * \param contexts the resolved contexts of the roots
+     */
+    void ComputeRoots(std::vector<SPFRootContext>& contexts);
+
+    /**
+     * \brief Keep the result of the SPF calculation of a root for incremental
+     * updates
+     * \param ctx the context of the calculation; its routes and tree are moved
+     */
+    void KeepRootState(SPFRootContext& ctx);
+
+    /**
+     * \brief Delete all the routes of a routing table
+     * \param routing the routing table
+     */
+    void RemoveRoutes(Ptr<Ipv4GlobalRouting> routing) const;
+
+    /**
+     * \brief Check whether changed LSAs may alter the shortest path tree of a
+     * root, or only the routes derived from some of its vertices.
+     * \param root the router ID of the root
+     * \param state the kept state of the root
+     * \param changed the link state IDs of the changed LSAs
+     * \param oldLsdb the database the kept state was computed from
+     * \param patch the changed vertices of the tree whose routes need to be
+     * derived again, when the tree itself is not affected
+     * \returns true if the SPF calculation has to run again
+     */
+    bool IsTreeAffected(Ipv4Address root,
+                        const SPFRootState& state,
+                        const std::set<Ipv4Address>& changed,
+                        const GlobalRouteManagerLSDB* oldLsdb,
+                        std::vector<Ipv4Address>& patch) const;
+
+    /**
+     * \brief Derive again the routes of some vertices of a kept shortest path
+     * tree, and reinstall the routing table of the root
+     * \param ctx the resolved context of the root
+     * \param state the kept state of the root
+     * \param patch the vertices whose LSAs changed
+     */
+    void PatchRoutes(SPFRootContext& ctx,
+                     SPFRootState& state,
+                     const std::vector<Ipv4Address>& patch);
+
+    /**
+     * \brief Run the SPF calculation of a root, collecting its routes in the
+     * context rather than installing them
+     * \param ctx the resolved context of the root
+     */
+    void SPFCompute(SPFRootContext& ctx);
+
+    /**
+     * \brief Run the SPF calculations of several roots on a pool of threads,
+     * each with its own snapshot of the LSDB
+     * \param contexts the resolved contexts of the roots
+     * \param nThreads the number of threads
+     */
+    void SPFComputeParallel(std::vector<SPFRootContext>& contexts, uint32_t nThreads);
+
+    /**
+     * \brief Install the routes collected in a context into the routing table
+     * of its root node
+     * \param ctx the context
+     */
+    void InstallRoutes(const SPFRootContext& ctx);
+
+    /**
+     * \brief Record a route of the SPF calculation in progress
+     * \param kind the route kind
+     * \param vertex the SPF vertex the route is derived from
+     * \param dest the destination host or network
+     * \param mask the destination network mask
+     * \param nextHop the next hop
+     * \param outIf the outgoing interface
+     */
+    void AddRoute(SPFRoute::Kind kind,
+                  Ipv4Address vertex,
+                  Ipv4Address dest,
+                  Ipv4Mask mask,
+                  Ipv4Address nextHop,
+                  uint32_t outIf);
 
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
@@ -910,8 +1133,8 @@ class GlobalRouteManagerImpl
     /**
      * \brief Return the interface number corresponding to a given IP address and mask
      *
-     * This is a wrapper around GetInterfaceForPrefix(), but we first
-     * have to find the right node pointer to pass to that function.
+     * This is equivalent to GetInterfaceForPrefix() on the root node, using the
+     * addresses resolved in the context of the SPF calculation in progress.
      * If no such interface is found, return -1 (note:  unit test framework
      * for routing assumes -1 to be a legal return value)
      *
@@ -57,6 +57,20 @@ GlobalRouteManager::InitializeRoutes()
     SimulationSingleton<GlobalRouteManagerImpl>::Get()->InitializeRoutes();
 }
 
+void
+GlobalRouteManager::UpdateRoutes()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    SimulationSingleton<GlobalRouteManagerImpl>::Get()->UpdateRoutes();
+}
+
+void
+GlobalRouteManager::NotifyTopologyChange()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    SimulationSingleton<GlobalRouteManagerImpl>::Get()->NotifyTopologyChange();
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId()
 {
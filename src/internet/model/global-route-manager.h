@@ -70,6 +70,18 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Recompute the routes after links or addresses changed, only
+     * running the SPF computation again for the nodes it may affect
+     */
+    static void UpdateRoutes();
+
+    /**
+     * @brief Notify that an interface went up or down, or that an address
+     * was added or removed, on a router
+     */
+    static void NotifyTopologyChange();
 };
 
 } // namespace ns3
@@ -55,16 +55,53 @@ Ipv4GlobalRouting::GetTypeId()
                           MakeBooleanChecker())
             .AddAttribute("RespondToInterfaceEvents",
                           "Set to true if you want to dynamically recompute the global routes upon "
-                          "Interface notification events (up/down, or add/remove address)",
+                          "Interface notification events (up/down, or add/remove address); see "
+                          "GlobalRoutingIncrementalUpdates to only recompute the affected routes",
                           BooleanValue(false),
                           MakeBooleanAccessor(&Ipv4GlobalRouting::m_respondToInterfaceEvents),
+                          MakeBooleanChecker())
+            .AddAttribute("PrefixTrieLookup",
+                          "Set to true to look routes up by longest prefix match in prefix tries; "
+                          "set to false to walk the route lists and take the first match",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&Ipv4GlobalRouting::m_prefixTrieLookup),
+                          MakeBooleanChecker())
+            .AddAttribute("RouteCache",
+                          "Set to true to return the same Ipv4Route object for every lookup "
+                          "selecting a given routing table entry; set to false to create a new "
+                          "Ipv4Route for every lookup",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&Ipv4GlobalRouting::m_routeCache),
                           MakeBooleanChecker());
     return tid;
 }
 
+/**
+ * \brief A routing table entry, with the Ipv4Route handed out for it.
+ */
+struct Ipv4GlobalRouting::RouteEntry : public Ipv4RoutingTableEntry
+{
+    /**
+     * \brief Constructor
+     * \param entry the routing table entry
+     */
+    explicit RouteEntry(const Ipv4RoutingTableEntry& entry)
+        : Ipv4RoutingTableEntry(entry),
+          m_generation(0)
+    {
+    }
+
+    Ptr<Ipv4Route> m_route; //!< Ipv4Route of the entry, if any
+    uint64_t m_generation;  //!< Value of m_routeGeneration when m_route was created
+};
+
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_prefixTrieLookup(true),
+      m_routeCache(false),
+      m_lookupIndexValid(false),
+      m_routeGeneration(1)
 {
     NS_LOG_FUNCTION(this);
 
@@ -80,18 +117,19 @@ void
 Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_t interface)
 {
     NS_LOG_FUNCTION(this << dest << nextHop << interface);
-    Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
-    *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
+    RouteEntry* route =
+        new RouteEntry(Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface));
     m_hostRoutes.push_back(route);
+    InvalidateLookupIndex();
 }
 
 void
 Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
 {
     NS_LOG_FUNCTION(this << dest << interface);
-    Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
-    *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
+    RouteEntry* route = new RouteEntry(Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface));
     m_hostRoutes.push_back(route);
+    InvalidateLookupIndex();
 }
 
 void
@@ -101,18 +139,20 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
                                      uint32_t interface)
 {
     NS_LOG_FUNCTION(this << network << networkMask << nextHop << interface);
-    Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
-    *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
+    RouteEntry* route = new RouteEntry(
+        Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface));
     m_networkRoutes.push_back(route);
+    InvalidateLookupIndex();
 }
 
 void
 Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask, uint32_t interface)
 {
     NS_LOG_FUNCTION(this << network << networkMask << interface);
-    Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
-    *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
+    RouteEntry* route = new RouteEntry(
+        Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface));
     m_networkRoutes.push_back(route);
+    InvalidateLookupIndex();
 }
 
 void
@@ -122,9 +162,10 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
                                         uint32_t interface)
 {
     NS_LOG_FUNCTION(this << network << networkMask << nextHop << interface);
-    Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
-    *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
+    RouteEntry* route = new RouteEntry(
+        Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface));
     m_ASexternalRoutes.push_back(route);
+    InvalidateLookupIndex();
 }
 
 Ptr<Ipv4Route>
@@ -132,7 +173,49 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << oif);
     NS_LOG_LOGIC("Looking for route for destination " << dest);
-    Ptr<Ipv4Route> rtentry = nullptr;
+    Ipv4RoutingTableEntry* route =
+        m_prefixTrieLookup ? LookupTrie(dest, oif) : LookupLinear(dest, oif);
+    if (route) // if route is found
+    {
+        if (!m_routeCache)
+        {
+            return CreateRoute(route);
+        }
+        // the Ipv4Route objects of the routing table entries are created once
+        // and shared by all the packets they route, until the table changes
+        RouteEntry* entry = static_cast<RouteEntry*>(route);
+        if (entry->m_generation != m_routeGeneration)
+        {
+            entry->m_route = CreateRoute(route);
+            entry->m_generation = m_routeGeneration;
+        }
+        return entry->m_route;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::CreateRoute(const Ipv4RoutingTableEntry* route) const
+{
+    NS_LOG_FUNCTION(this << route);
+    // create a Ipv4Route object from the selected routing table entry
+    Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
+    rtentry->SetDestination(route->GetDest());
+    /// \todo handle multi-address case
+    rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
+    rtentry->SetGateway(route->GetGateway());
+    uint32_t interfaceIdx = route->GetInterface();
+    rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+    return rtentry;
+}
+
+Ipv4RoutingTableEntry*
+Ipv4GlobalRouting::LookupLinear(Ipv4Address dest, Ptr<NetDevice> oif)
+{
+    NS_LOG_FUNCTION(this << dest << oif);
     // store all available routes that bring packets to their destination
     typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
     RouteVec_t allRoutes;
@@ -213,21 +296,139 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
         {
             selectIndex = 0;
         }
-        Ipv4RoutingTableEntry* route = allRoutes.at(selectIndex);
-        // create a Ipv4Route object from the selected routing table entry
-        rtentry = Create<Ipv4Route>();
-        rtentry->SetDestination(route->GetDest());
-        /// \todo handle multi-address case
-        rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
-        rtentry->SetGateway(route->GetGateway());
-        uint32_t interfaceIdx = route->GetInterface();
-        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-        return rtentry;
+        return allRoutes.at(selectIndex);
     }
-    else
+    return nullptr;
+}
+
+Ipv4RoutingTableEntry*
+Ipv4GlobalRouting::LookupTrie(Ipv4Address dest, Ptr<NetDevice> oif)
+{
+    NS_LOG_FUNCTION(this << dest << oif);
+    if (!m_lookupIndexValid)
+    {
+        BuildLookupIndex();
+    }
+
+    auto host = m_hostIndex.find(dest);
+    if (host != m_hostIndex.end())
+    {
+        Ipv4RoutingTableEntry* route = SelectRoute(host->second, oif, false);
+        if (route)
+        {
+            NS_LOG_LOGIC("Found global host route" << route);
+            return route;
+        }
+    }
+
+    //
+    // Without an output interface, the longest matching prefix wins.  With
+    // one, the longest matching prefix with a route through it.
+    //
+    const Ipv4RouteTrie::RouteGroup_t* matches[Ipv4RouteTrie::MAX_MATCHES];
+    uint32_t nMatches = 0;
+    if (oif)
+    {
+        nMatches = m_networkTrie.LookupAll(dest, matches);
+    }
+    else if ((matches[0] = m_networkTrie.Lookup(dest)))
+    {
+        nMatches = 1;
+    }
+    for (uint32_t i = 0; i < nMatches; i++)
+    {
+        Ipv4RoutingTableEntry* route = SelectRoute(*matches[i], oif, false);
+        if (route)
+        {
+            NS_LOG_LOGIC("Found global network route" << route);
+            return route;
+        }
+    }
+
+    // consider external if no host/network found
+    nMatches = m_externalTrie.LookupAll(dest, matches);
+    for (uint32_t i = 0; i < nMatches; i++)
+    {
+        Ipv4RoutingTableEntry* route = SelectRoute(*matches[i], oif, true);
+        if (route)
+        {
+            NS_LOG_LOGIC("Found external route" << route);
+            return route;
+        }
+    }
+    return nullptr;
+}
+
+Ipv4RoutingTableEntry*
+Ipv4GlobalRouting::SelectRoute(const Ipv4RouteTrie::RouteGroup_t& group,
+                               Ptr<NetDevice> oif,
+                               bool firstOnly)
+{
+    uint32_t nRoutes = 0;
+    for (Ipv4RoutingTableEntry* route : group)
+    {
+        if (!oif || oif == m_ipv4->GetNetDevice(route->GetInterface()))
+        {
+            nRoutes++;
+        }
+    }
+    if (nRoutes == 0)
     {
         return nullptr;
     }
+    if (firstOnly)
+    {
+        nRoutes = 1;
+    }
+    // pick up one of the routes uniformly at random if random
+    // ECMP routing is enabled, or always select the first route
+    // consistently if random ECMP routing is disabled
+    uint32_t selectIndex = m_randomEcmpRouting ? m_rand->GetInteger(0, nRoutes - 1) : 0;
+    for (Ipv4RoutingTableEntry* route : group)
+    {
+        if (!oif || oif == m_ipv4->GetNetDevice(route->GetInterface()))
+        {
+            if (selectIndex-- == 0)
+            {
+                return route;
+            }
+        }
+    }
+    NS_ASSERT(false);
+    return nullptr;
+}
+
+void
+Ipv4GlobalRouting::InvalidateLookupIndex()
+{
+    NS_LOG_FUNCTION(this);
+    m_lookupIndexValid = false;
+    m_routeGeneration++;
+}
+
+void
+Ipv4GlobalRouting::BuildLookupIndex()
+{
+    NS_LOG_FUNCTION(this);
+    m_hostIndex.clear();
+    m_networkTrie.Clear();
+    m_externalTrie.Clear();
+    for (HostRoutesCI i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    {
+        m_hostIndex[(*i)->GetDest()].push_back(*i);
+    }
+    for (NetworkRoutesCI j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    {
+        m_networkTrie.Insert(*j);
+    }
+    for (ASExternalRoutesCI k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end(); k++)
+    {
+        m_externalTrie.Insert(*k);
+    }
+    m_lookupIndexValid = true;
+    NS_LOG_LOGIC("Indexed " << m_hostIndex.size() << " hosts, " << m_networkTrie.GetNPrefixes()
+                            << " network prefixes and " << m_externalTrie.GetNPrefixes()
+                            << " external prefixes");
 }
 
 uint32_t
@@ -289,6 +490,7 @@ void
 Ipv4GlobalRouting::RemoveRoute(uint32_t index)
 {
     NS_LOG_FUNCTION(this << index);
+    InvalidateLookupIndex();
     if (index < m_hostRoutes.size())
     {
         uint32_t tmp = 0;
@@ -365,6 +567,10 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    m_hostIndex.clear();
+    m_networkTrie.Clear();
+    m_externalTrie.Clear();
+    m_lookupIndexValid = false;
 
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -557,11 +763,10 @@ void
 Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
 {
     NS_LOG_FUNCTION(this << i);
+    m_routeGeneration++;
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::NotifyTopologyChange();
     }
 }
 
@@ -569,11 +774,10 @@ void
 Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
 {
     NS_LOG_FUNCTION(this << i);
+    m_routeGeneration++;
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::NotifyTopologyChange();
     }
 }
 
@@ -581,11 +785,10 @@ void
 Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    m_routeGeneration++;
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::NotifyTopologyChange();
     }
 }
 
@@ -593,11 +796,10 @@ void
 Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    m_routeGeneration++;
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::NotifyTopologyChange();
     }
 }
 
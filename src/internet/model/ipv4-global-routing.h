@@ -19,6 +19,8 @@
 #ifndef IPV4_GLOBAL_ROUTING_H
 #define IPV4_GLOBAL_ROUTING_H
 
+#include "ipv4-route-trie.h"
+
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-routing-protocol.h"
@@ -28,6 +30,7 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -245,29 +248,36 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// Set to true if this interface should respond to interface events by globallly recomputing
     /// routes
     bool m_respondToInterfaceEvents;
+    /// Set to true to look routes up in prefix tries rather than walking the route lists
+    bool m_prefixTrieLookup;
+    /// Set to true to share one Ipv4Route object per routing table entry between lookups
+    bool m_routeCache;
     /// A uniform random number generator for randomly routing packets among ECMP
     Ptr<UniformRandomVariable> m_rand;
 
+    /// A routing table entry, with the Ipv4Route handed out for it
+    struct RouteEntry;
+
     /// container of Ipv4RoutingTableEntry (routes to hosts)
-    typedef std::list<Ipv4RoutingTableEntry*> HostRoutes;
+    typedef std::list<RouteEntry*> HostRoutes;
     /// const iterator of container of Ipv4RoutingTableEntry (routes to hosts)
-    typedef std::list<Ipv4RoutingTableEntry*>::const_iterator HostRoutesCI;
+    typedef std::list<RouteEntry*>::const_iterator HostRoutesCI;
     /// iterator of container of Ipv4RoutingTableEntry (routes to hosts)
-    typedef std::list<Ipv4RoutingTableEntry*>::iterator HostRoutesI;
+    typedef std::list<RouteEntry*>::iterator HostRoutesI;
 
     /// container of Ipv4RoutingTableEntry (routes to networks)
-    typedef std::list<Ipv4RoutingTableEntry*> NetworkRoutes;
+    typedef std::list<RouteEntry*> NetworkRoutes;
     /// const iterator of container of Ipv4RoutingTableEntry (routes to networks)
-    typedef std::list<Ipv4RoutingTableEntry*>::const_iterator NetworkRoutesCI;
+    typedef std::list<RouteEntry*>::const_iterator NetworkRoutesCI;
     /// iterator of container of Ipv4RoutingTableEntry (routes to networks)
-    typedef std::list<Ipv4RoutingTableEntry*>::iterator NetworkRoutesI;
+    typedef std::list<RouteEntry*>::iterator NetworkRoutesI;
 
     /// container of Ipv4RoutingTableEntry (routes to external AS)
-    typedef std::list<Ipv4RoutingTableEntry*> ASExternalRoutes;
+    typedef std::list<RouteEntry*> ASExternalRoutes;
     /// const iterator of container of Ipv4RoutingTableEntry (routes to external AS)
-    typedef std::list<Ipv4RoutingTableEntry*>::const_iterator ASExternalRoutesCI;
+    typedef std::list<RouteEntry*>::const_iterator ASExternalRoutesCI;
     /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
-    typedef std::list<Ipv4RoutingTableEntry*>::iterator ASExternalRoutesI;
+    typedef std::list<RouteEntry*>::iterator ASExternalRoutesI;
 
     /**
      * \brief Lookup in the forwarding table for destination.
@@ -277,10 +287,70 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      */
     Ptr<Ipv4Route> LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
 
+    /**
+     * \brief Create the Ipv4Route object of a routing table entry.
+     * \param route the routing table entry
+     * \return the new Ipv4Route
+     */
+    Ptr<Ipv4Route> CreateRoute(const Ipv4RoutingTableEntry* route) const;
+
+    /**
+     * \brief Lookup in the route lists for destination, taking the first
+     * matching host route, else the first matching network route regardless
+     * of its prefix length, else the first matching external route.
+     * \param dest destination address
+     * \param oif output interface if any (put 0 otherwise)
+     * \return the selected routing table entry, or null
+     */
+    Ipv4RoutingTableEntry* LookupLinear(Ipv4Address dest, Ptr<NetDevice> oif);
+
+    /**
+     * \brief Lookup in the prefix tries for destination, taking a host route,
+     * else a route to the longest matching network prefix, else a route to
+     * the longest matching external prefix.
+     * \param dest destination address
+     * \param oif output interface if any (put 0 otherwise)
+     * \return the selected routing table entry, or null
+     */
+    Ipv4RoutingTableEntry* LookupTrie(Ipv4Address dest, Ptr<NetDevice> oif);
+
+    /**
+     * \brief Choose one of the equal cost routes to a prefix.
+     * \param group the routes to the prefix
+     * \param oif output interface if any (put 0 otherwise)
+     * \param firstOnly only consider the first route going through oif
+     * \return the selected routing table entry, or null if no route goes
+     * through oif
+     */
+    Ipv4RoutingTableEntry* SelectRoute(const Ipv4RouteTrie::RouteGroup_t& group,
+                                       Ptr<NetDevice> oif,
+                                       bool firstOnly);
+
+    /**
+     * \brief Rebuild the host route index and the prefix tries from the
+     * route lists.
+     */
+    void BuildLookupIndex();
+
+    /**
+     * \brief Mark the host route index, the prefix tries and the Ipv4Route
+     * objects of the entries as stale, after a change of the route lists.
+     */
+    void InvalidateLookupIndex();
+
     HostRoutes m_hostRoutes;             //!< Routes to hosts
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    /// Routes to hosts, grouped by destination
+    std::unordered_map<Ipv4Address, Ipv4RouteTrie::RouteGroup_t, Ipv4AddressHash> m_hostIndex;
+    Ipv4RouteTrie m_networkTrie;  //!< Routes to networks, by prefix
+    Ipv4RouteTrie m_externalTrie; //!< External routes, by prefix
+    bool m_lookupIndexValid;      //!< Whether the index and tries match the route lists
+
+    /// Generation of the Ipv4Route objects of the entries, the older ones are stale
+    uint64_t m_routeGeneration;
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -39,6 +39,7 @@
 #include "ns3/packet.h"
 #include "ns3/socket.h"
 #include "ns3/string.h"
+#include "ns3/super-segment-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
@@ -1078,7 +1079,10 @@ void Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route,
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
-        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
+        // Super-segments are only split by the devices
+        SuperSegmentTag superSegment;
+        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu() &&
+            !packet->PeekPacketTag(superSegment))
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
             DoFragmentation(packet, ipHeader, outInterface->GetDevice()->GetMtu(), listFragments);
@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-route-trie.h"
+
+#include "ipv4-routing-table-entry.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Ipv4RouteTrie");
+
+/**
+ * \brief The mask of a prefix length.
+ * \param length the prefix length, 0 to 32
+ * \returns the mask, in host order
+ */
+static inline uint32_t
+PrefixMask(uint32_t length)
+{
+    return length == 0 ? 0 : 0xffffffff << (32 - length);
+}
+
+/**
+ * \brief A bit of an address.
+ * \param address the address, in host order
+ * \param position the bit position, 0 being the most significant bit
+ * \returns the bit
+ */
+static inline uint32_t
+AddressBit(uint32_t address, uint32_t position)
+{
+    return (address >> (31 - position)) & 1;
+}
+
+Ipv4RouteTrie::Ipv4RouteTrie()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+}
+
+void
+Ipv4RouteTrie::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_nodes.clear();
+    m_groups.clear();
+    NewNode(0, 0);
+}
+
+uint32_t
+Ipv4RouteTrie::NewNode(uint32_t prefix, uint32_t length)
+{
+    Node node;
+    node.prefix = prefix & PrefixMask(length);
+    node.length = length;
+    node.child[0] = NONE;
+    node.child[1] = NONE;
+    node.group = NONE;
+    m_nodes.push_back(node);
+    return m_nodes.size() - 1;
+}
+
+void
+Ipv4RouteTrie::AddToGroup(uint32_t node, Ipv4RoutingTableEntry* route)
+{
+    if (m_nodes[node].group == NONE)
+    {
+        m_nodes[node].group = m_groups.size();
+        m_groups.emplace_back();
+    }
+    m_groups[m_nodes[node].group].push_back(route);
+}
+
+void
+Ipv4RouteTrie::Insert(Ipv4RoutingTableEntry* route)
+{
+    NS_LOG_FUNCTION(this << route);
+    uint32_t length = route->GetDestNetworkMask().GetPrefixLength();
+    uint32_t prefix = route->GetDestNetwork().Get() & PrefixMask(length);
+
+    //
+    // Walk down from the root, whose empty prefix matches everything.  The
+    // prefix of the current node is always a prefix of the new one.
+    //
+    uint32_t current = 0;
+    while (true)
+    {
+        if (m_nodes[current].length == length)
+        {
+            AddToGroup(current, route);
+            return;
+        }
+        uint32_t bit = AddressBit(prefix, m_nodes[current].length);
+        uint32_t next = m_nodes[current].child[bit];
+        if (next == NONE)
+        {
+            uint32_t leaf = NewNode(prefix, length);
+            AddToGroup(leaf, route);
+            m_nodes[current].child[bit] = leaf;
+            return;
+        }
+
+        //
+        // Length of the prefix shared by the new prefix and the child.
+        //
+        uint32_t childPrefix = m_nodes[next].prefix;
+        uint32_t childLength = m_nodes[next].length;
+        uint32_t maxCommon = std::min(length, childLength);
+        uint32_t diff = (prefix ^ childPrefix) & PrefixMask(maxCommon);
+        uint32_t common = diff ? __builtin_clz(diff) : maxCommon;
+
+        if (common == childLength)
+        {
+            current = next;
+            continue;
+        }
+        if (common == length)
+        {
+            // the new prefix sits between the current node and its child
+            uint32_t node = NewNode(prefix, length);
+            AddToGroup(node, route);
+            m_nodes[node].child[AddressBit(childPrefix, length)] = next;
+            m_nodes[current].child[bit] = node;
+            return;
+        }
+        // the new prefix and the child diverge: add a branching node
+        uint32_t branch = NewNode(prefix, common);
+        uint32_t leaf = NewNode(prefix, length);
+        AddToGroup(leaf, route);
+        m_nodes[branch].child[AddressBit(childPrefix, common)] = next;
+        m_nodes[branch].child[AddressBit(prefix, common)] = leaf;
+        m_nodes[current].child[bit] = branch;
+        return;
+    }
+}
+
+const Ipv4RouteTrie::RouteGroup_t*
+Ipv4RouteTrie::Lookup(Ipv4Address dest) const
+{
+    uint32_t address = dest.Get();
+    const RouteGroup_t* best = nullptr;
+    uint32_t current = 0;
+    while (current != NONE)
+    {
+        const Node& node = m_nodes[current];
+        if ((address ^ node.prefix) & PrefixMask(node.length))
+        {
+            break;
+        }
+        if (node.group != NONE)
+        {
+            best = &m_groups[node.group];
+        }
+        if (node.length == 32)
+        {
+            break;
+        }
+        current = node.child[AddressBit(address, node.length)];
+    }
+    return best;
+}
+
+uint32_t
+Ipv4RouteTrie::LookupAll(Ipv4Address dest, const RouteGroup_t* matches[]) const
+{
+    uint32_t address = dest.Get();
+    uint32_t n = 0;
+    uint32_t current = 0;
+    while (current != NONE)
+    {
+        const Node& node = m_nodes[current];
+        if ((address ^ node.prefix) & PrefixMask(node.length))
+        {
+            break;
+        }
+        if (node.group != NONE)
+        {
+            NS_ASSERT(n < MAX_MATCHES);
+            matches[n++] = &m_groups[node.group];
+        }
+        if (node.length == 32)
+        {
+            break;
+        }
+        current = node.child[AddressBit(address, node.length)];
+    }
+    // longest prefix first
+    for (uint32_t i = 0; i < n / 2; i++)
+    {
+        std::swap(matches[i], matches[n - 1 - i]);
+    }
+    return n;
+}
+
+uint32_t
+Ipv4RouteTrie::GetNPrefixes() const
+{
+    return m_groups.size();
+}
+
+} // namespace ns3
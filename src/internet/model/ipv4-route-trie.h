@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTE_TRIE_H
+#define IPV4_ROUTE_TRIE_H
+
+#include "ns3/ipv4-address.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Longest prefix match table of IPv4 routing table entries.
+ *
+ * The destination prefixes are stored in a path compressed binary trie,
+ * laid out in a flat array, so that a table with n prefixes has less than
+ * 2n nodes.  The routes to the same prefix form one group, in insertion
+ * order, which is the set of equal cost multipath choices for that prefix.
+ *
+ * Lookups visit at most one node per prefix length and never allocate.  The
+ * table does not own the routing table entries.
+ */
+class Ipv4RouteTrie
+{
+  public:
+    /// The routes to one prefix, in insertion order
+    typedef std::vector<Ipv4RoutingTableEntry*> RouteGroup_t;
+
+    /// The maximum number of groups matching an address, one per prefix length
+    static const uint32_t MAX_MATCHES = 33;
+
+    Ipv4RouteTrie();
+
+    /**
+     * \brief Remove all the routes.
+     */
+    void Clear();
+
+    /**
+     * \brief Add a route, to the destination network of the entry.
+     * \param route the routing table entry
+     */
+    void Insert(Ipv4RoutingTableEntry* route);
+
+    /**
+     * \brief Find the routes to the longest prefix matching an address.
+     * \param dest the address
+     * \returns the routes, or null if no prefix matches
+     */
+    const RouteGroup_t* Lookup(Ipv4Address dest) const;
+
+    /**
+     * \brief Find the routes to all the prefixes matching an address.
+     * \param dest the address
+     * \param matches array of at least MAX_MATCHES elements, filled with the
+     * route groups, longest prefix first
+     * \returns the number of matching prefixes
+     */
+    uint32_t LookupAll(Ipv4Address dest, const RouteGroup_t* matches[]) const;
+
+    /**
+     * \returns the number of distinct prefixes
+     */
+    uint32_t GetNPrefixes() const;
+
+  private:
+    /// Index of a missing child
+    static const uint32_t NONE = 0xffffffff;
+
+    /// A trie node, covering all the addresses starting with its prefix
+    struct Node
+    {
+        uint32_t prefix;   //!< the prefix, host bits cleared
+        uint32_t length;   //!< the prefix length
+        uint32_t child[2]; //!< the subtries for the next bit being 0 and 1
+        uint32_t group;    //!< the routes to this prefix, or NONE
+    };
+
+    /**
+     * \brief Create a node.
+     * \param prefix the prefix
+     * \param length the prefix length
+     * \returns the index of the node
+     */
+    uint32_t NewNode(uint32_t prefix, uint32_t length);
+
+    /**
+     * \brief Add a route to the group of a node, creating the group if needed.
+     * \param node the index of the node
+     * \param route the routing table entry
+     */
+    void AddToGroup(uint32_t node, Ipv4RoutingTableEntry* route);
+
+    std::vector<Node> m_nodes;          //!< the nodes, the root being the first one
+    std::vector<RouteGroup_t> m_groups; //!< the route groups
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTE_TRIE_H */
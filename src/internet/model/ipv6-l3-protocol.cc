@@ -41,6 +41,7 @@
 #include "ns3/mac64-address.h"
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
+#include "ns3/super-segment-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
@@ -1263,7 +1264,10 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
         targetMtu = dev->GetMtu();
     }
 
-    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu)
+    // Super-segments are only split by the devices
+    SuperSegmentTag superSegment;
+    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu &&
+        !packet->PeekPacketTag(superSegment))
     {
         // Router => drop
         if (!fromMe)
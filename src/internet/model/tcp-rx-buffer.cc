@@ -22,6 +22,8 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <iterator>
+
 namespace ns3
 {
 
@@ -205,12 +207,12 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     {
         uint32_t start = static_cast<uint32_t>(headSeq - tcph.GetSequenceNumber());
         uint32_t length = static_cast<uint32_t>(tailSeq - headSeq);
-        p = p->CreateFragment(start, length);
+        p = p->IsVirtualPayload() ? Create<Packet>(length) : p->CreateFragment(start, length);
         NS_ASSERT(length == p->GetSize());
     }
     // Insert packet into buffer
     NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
-    m_data[headSeq] = p;
+    InsertData(headSeq, p);
 
     if (headSeq > m_nextRxSeq)
     {
@@ -223,7 +225,9 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     m_size += p->GetSize(); // Occupancy
     for (i = m_data.begin(); i != m_data.end(); ++i)
     {
-        if (i->first < m_nextRxSeq)
+        // Merged virtual payload may start before m_nextRxSeq
+        SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
+        if (lastByteSeq <= m_nextRxSeq)
         {
             continue;
         }
@@ -231,8 +235,8 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
         {
             break;
         };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
+        m_availBytes += static_cast<uint32_t>(lastByteSeq - m_nextRxSeq);
+        m_nextRxSeq = lastByteSeq;
         ClearSackList(m_nextRxSeq);
     }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -243,6 +247,38 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     return true;
 }
 
+void
+TcpRxBuffer::InsertData(const SequenceNumber32& seq, Ptr<Packet> p)
+{
+    NS_LOG_FUNCTION(this << seq << p);
+    if (!p->IsVirtualPayload())
+    {
+        m_data[seq] = p;
+        return;
+    }
+
+    SequenceNumber32 headSeq = seq;
+    uint32_t size = p->GetSize();
+    BufIterator next = m_data.lower_bound(seq);
+    if (next != m_data.end() && next->first == seq + SequenceNumber32(size) &&
+        next->second->IsVirtualPayload())
+    {
+        size += next->second->GetSize();
+        next = m_data.erase(next);
+    }
+    if (next != m_data.begin())
+    {
+        BufIterator prev = std::prev(next);
+        if (prev->first + SequenceNumber32(prev->second->GetSize()) == seq &&
+            prev->second->IsVirtualPayload())
+        {
+            headSeq = prev->first;
+            size += prev->second->GetSize();
+        }
+    }
+    m_data[headSeq] = size == p->GetSize() ? p : Create<Packet>(size);
+}
+
 uint32_t
 TcpRxBuffer::GetSackListSize() const
 {
@@ -390,6 +426,7 @@ TcpRxBuffer::Extract(uint32_t maxSize)
     }
     NS_ASSERT(m_data.size());              // At least we have something to extract
     Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
+    uint32_t virtualSize = 0; // Virtual payload not yet added to outPkt
     BufIterator i;
     while (extractSize)
     { // Check the buffered data for delivery
@@ -397,23 +434,40 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
         // Check if we send the whole pkt or just a partial
         uint32_t pktSize = i->second->GetSize();
-        if (pktSize <= extractSize)
-        { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
-            m_data.erase(i);
-            m_size -= pktSize;
-            m_availBytes -= pktSize;
-            extractSize -= pktSize;
+        uint32_t size = std::min(pktSize, extractSize);
+        if (i->second->IsVirtualPayload())
+        { // Only count the bytes, outPkt gets them in one piece
+            virtualSize += size;
         }
         else
+        {
+            if (virtualSize > 0)
+            {
+                outPkt->AddAtEnd(Create<Packet>(virtualSize));
+                virtualSize = 0;
+            }
+            outPkt->AddAtEnd(size == pktSize ? i->second : i->second->CreateFragment(0, size));
+        }
+        if (size < pktSize)
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
-            m_data[i->first + SequenceNumber32(extractSize)] =
-                i->second->CreateFragment(extractSize, pktSize - extractSize);
-            m_data.erase(i);
-            m_size -= extractSize;
-            m_availBytes -= extractSize;
-            extractSize = 0;
+            m_data[i->first + SequenceNumber32(size)] =
+                i->second->IsVirtualPayload() ? Create<Packet>(pktSize - size)
+                                     : i->second->CreateFragment(size, pktSize - size);
+        }
+        m_data.erase(i);
+        m_size -= size;
+        m_availBytes -= size;
+        extractSize -= size;
+    }
+    if (virtualSize > 0)
+    {
+        if (outPkt->GetSize() == 0)
+        {
+            outPkt = Create<Packet>(virtualSize);
+        }
+        else
+        {
+            outPkt->AddAtEnd(Create<Packet>(virtualSize));
         }
     }
     if (outPkt->GetSize() == 0)
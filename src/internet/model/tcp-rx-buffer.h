@@ -219,6 +219,18 @@ class TcpRxBuffer : public Object
      */
     void ClearSackList(const SequenceNumber32& seq);
 
+    /**
+     * \brief Store a packet in the buffer
+     *
+     * Virtual payload (see Packet::IsVirtualPayload) is merged with the
+     * virtual payload right before and after it, so that bulk transfers keep
+     * a few byte counts instead of a packet per segment.
+     *
+     * \param seq Sequence number of the first byte of the packet
+     * \param p Packet, which must not overlap the stored data
+     */
+    void InsertData(const SequenceNumber32& seq, Ptr<Packet> p);
+
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
     /// container for data stored in the buffer
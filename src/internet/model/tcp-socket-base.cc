@@ -46,6 +46,7 @@
 #include "ns3/double.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-interface-address.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-protocol.h"
@@ -60,6 +61,7 @@
 #include "ns3/pointer.h"
 #include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
+#include "ns3/super-segment-tag.h"
 #include "ns3/tcp-rate-ops.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
@@ -163,6 +165,14 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_limitedTx),
                           MakeBooleanChecker())
+            .AddAttribute("MaxSuperSegmentSize",
+                          "Maximum size of the data sent at once as a super-segment when "
+                          "the window allows several full segments (segmentation offload); "
+                          "0 sends each segment on its own. Super-segments never exceed the "
+                          "largest IP packet",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TcpSocketBase::m_maxSuperSegmentSize),
+                          MakeUintegerChecker<uint32_t>())
             .AddAttribute("UseEcn",
                           "Parameter to set ECN functionality",
                           EnumValue(TcpSocketState::Off),
@@ -370,6 +380,7 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_recoverActive(sock.m_recoverActive),
       m_retxThresh(sock.m_retxThresh),
       m_limitedTx(sock.m_limitedTx),
+      m_maxSuperSegmentSize(sock.m_maxSuperSegmentSize),
       m_isFirstPartialAck(sock.m_isFirstPartialAck),
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
@@ -3174,6 +3185,10 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     }
 
     AddSocketTags(p);
+    if (sz > m_tcb->m_segmentSize)
+    {
+        p->AddPacketTag(SuperSegmentTag((sz + m_tcb->m_segmentSize - 1) / m_tcb->m_segmentSize, sz));
+    }
 
     if (m_closeOnEmpty && (remainingData == 0))
     {
@@ -3374,6 +3389,10 @@ TcpSocketBase::SendPendingData(bool withAck)
             // NextSeg () may have further constrained the segment size
             uint32_t maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
+            if (s == m_tcb->m_segmentSize && next == m_tcb->m_highTxMark)
+            {
+                s = std::max(s, SuperSegmentSize(next, availableWindow));
+            }
 
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
@@ -3448,6 +3467,28 @@ TcpSocketBase::SendPendingData(bool withAck)
     return nPacketsSent;
 }
 
+uint32_t
+TcpSocketBase::SuperSegmentSize(SequenceNumber32 seq, uint32_t availableWindow) const
+{
+    NS_LOG_FUNCTION(this << seq << availableWindow);
+    if (m_maxSuperSegmentSize <= m_tcb->m_segmentSize)
+    {
+        return 0;
+    }
+    // the 16-bit IP length must cover the TCP header with the largest options,
+    // and the IPv4 header too
+    static const uint32_t maxTcpHeaderSize = 60;
+    static const uint32_t ipv4HeaderSize = Ipv4Header().GetSerializedSize();
+    uint32_t maxSize = 65535 - maxTcpHeaderSize - (m_endPoint6 ? 0 : ipv4HeaderSize);
+    uint32_t sentSize = static_cast<uint32_t>(seq - m_txBuffer->HeadSequence());
+    uint32_t size = std::min({availableWindow,
+                              m_maxSuperSegmentSize,
+                              maxSize,
+                              m_txBuffer->SizeFromSequence(seq),
+                              m_rWnd.Get() > sentSize ? m_rWnd.Get() - sentSize : 0});
+    return size - size % m_tcb->m_segmentSize;
+}
+
 uint32_t
 TcpSocketBase::UnAckDataCount() const
 {
@@ -3584,7 +3625,10 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
     else
     { // In-sequence packet: ACK if delayed ack count allows
-        if (++m_delAckCount >= m_delAckMaxCount)
+        // (a super-segment counts as the segments it stands for)
+        SuperSegmentTag superSegment;
+        m_delAckCount += p->PeekPacketTag(superSegment) ? superSegment.GetSegments() : 1;
+        if (m_delAckCount >= m_delAckMaxCount)
         {
             m_delAckEvent.Cancel();
             m_delAckCount = 0;
@@ -797,6 +797,21 @@ class TcpSocketBase : public TcpSocket
      */
     uint32_t SendPendingData(bool withAck = false);
 
+    /**
+     * \brief Get the size of the super-segment of new data to send at a
+     * sequence number, when segmentation offload is enabled.
+     *
+     * The size is the largest multiple of the segment size allowed by the
+     * available window, the receiver window, the data in the TxBuffer and
+     * the MaxSuperSegmentSize attribute, and never makes an IP packet larger
+     * than 65535 bytes.
+     *
+     * \param seq the sequence number of the first byte to send
+     * \param availableWindow the available congestion window
+     * \returns the size of the super-segment, or 0 if offload is disabled
+     */
+    uint32_t SuperSegmentSize(SequenceNumber32 seq, uint32_t availableWindow) const;
+
     /**
      * \brief Extract at most maxSize bytes from the TxBuffer at sequence seq, add the
      *        TCP header, and send to TcpL4Protocol
@@ -1363,6 +1378,8 @@ class TcpSocketBase : public TcpSocket
     uint32_t m_retxThresh{3};    //!< Fast Retransmit threshold
     bool m_limitedTx{true};      //!< perform limited transmit
 
+    uint32_t m_maxSuperSegmentSize{0}; //!< Maximum size of a super-segment, 0 if disabled
+
     // Transmission Control Block
     Ptr<TcpSocketState> m_tcb;                 //!< Congestion control information
     Ptr<TcpCongestionOps> m_congestionControl; //!< Congestion control
@@ -187,7 +187,19 @@ TcpTxBuffer::Add(Ptr<Packet> p)
                                   << m_firstByteSeq << ", availSize=" << Available());
     if (p->GetSize() <= Available())
     {
-        if (p->GetSize() > 0)
+        if (p->GetSize() > 0 && IsVirtualPayload(p) && !m_appList.empty() &&
+            IsVirtualPayload(m_appList.back()->m_packet))
+        {
+            // Bulk virtual payload is kept as a single byte count, extended
+            // by recreating the last packet with the new size
+            TcpTxItem* item = m_appList.back();
+            item->m_packet = Create<Packet>(item->m_packet->GetSize() + p->GetSize());
+            m_size += p->GetSize();
+
+            NS_LOG_LOGIC("Updated size=" << m_size << ", lastSeq="
+                                         << m_firstByteSeq + SequenceNumber32(m_size));
+        }
+        else if (p->GetSize() > 0)
         {
             TcpTxItem* item = new TcpTxItem();
             item->m_packet = p->Copy();
@@ -384,8 +396,17 @@ TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
     NS_ASSERT(t1 != nullptr && t2 != nullptr);
     NS_LOG_FUNCTION(this << *t2 << size);
 
-    t1->m_packet = t2->m_packet->CreateFragment(0, size);
-    t2->m_packet->RemoveAtStart(size);
+    if (IsVirtualPayload(t2->m_packet))
+    {
+        // No fragment needed, only sizes
+        t1->m_packet = Create<Packet>(size);
+        t2->m_packet = Create<Packet>(t2->m_packet->GetSize() - size);
+    }
+    else
+    {
+        t1->m_packet = t2->m_packet->CreateFragment(0, size);
+        t2->m_packet->RemoveAtStart(size);
+    }
 
     t1->m_startSeq = t2->m_startSeq;
     t1->m_sacked = t2->m_sacked;
@@ -621,7 +642,14 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
         t1->m_lastSent = t2->m_lastSent;
     }
 
-    t1->m_packet->AddAtEnd(t2->m_packet);
+    if (IsVirtualPayload(t1->m_packet) && IsVirtualPayload(t2->m_packet))
+    {
+        t1->m_packet = Create<Packet>(t1->m_packet->GetSize() + t2->m_packet->GetSize());
+    }
+    else
+    {
+        t1->m_packet->AddAtEnd(t2->m_packet);
+    }
 
     NS_LOG_INFO("Situation after the merge: " << *t1);
 }
@@ -726,7 +754,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             pktSize -= offset;
             NS_LOG_INFO(*item);
             // PacketTags are preserved when fragmenting
-            item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
+            item->m_packet = IsVirtualPayload(item->m_packet)
+                                 ? Create<Packet>(pktSize)
+                                 : item->m_packet->CreateFragment(offset, pktSize);
             item->m_startSeq += offset;
             m_size -= offset;
             m_sentSize -= offset;
@@ -1425,6 +1455,12 @@ TcpTxBuffer::AddRenoSack()
     ConsistencyCheck();
 }
 
+bool
+TcpTxBuffer::IsVirtualPayload(Ptr<const Packet> p)
+{
+    return p->IsVirtualPayload() && !p->GetPacketTagIterator().HasNext();
+}
+
 void
 TcpTxBuffer::ConsistencyCheck() const
 {
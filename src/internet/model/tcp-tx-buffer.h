@@ -589,6 +589,18 @@ class TcpTxBuffer : public Object
      */
     void SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const;
 
+    /**
+     * \brief Check if a packet is virtual payload without packet tags
+     *
+     * Such packets, e.g. the zero-filled payload of bulk senders, are split
+     * and merged by creating new packets of the resulting sizes, and
+     * consecutive ones are stored as a single item of the application list.
+     *
+     * \param p Packet to check
+     * \returns true if the packet can be replaced by a new packet of its size
+     */
+    static bool IsVirtualPayload(Ptr<const Packet> p);
+
     /**
      * \brief Check if the values of sacked, lost, retrans, are in sync
      * with the sent list.
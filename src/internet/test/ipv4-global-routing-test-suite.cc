@@ -41,6 +41,8 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -400,6 +402,30 @@ TwoLinkTest::DoRun()
     NS_TEST_ASSERT_MSG_EQ(route->GetDest(), Ipv4Address("0.0.0.0"), "Error-- wrong destination");
     NS_TEST_ASSERT_MSG_EQ(route->GetGateway(), Ipv4Address("10.1.2.1"), "Error-- wrong gateway");
 
+    // With RouteCache, the Ipv4Route objects are shared between lookups
+    // until the routes change
+    globalRouting0->SetAttribute("RouteCache", BooleanValue(true));
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address("10.1.2.2"));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> rtentry = globalRouting0->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_NE(rtentry, nullptr, "Error-- no route");
+    NS_TEST_ASSERT_MSG_EQ(rtentry->GetGateway(), Ipv4Address("10.1.1.2"), "Error-- wrong gateway");
+    NS_TEST_ASSERT_MSG_EQ(rtentry->GetSource(), Ipv4Address("10.1.1.1"), "Error-- wrong source");
+    NS_TEST_ASSERT_MSG_EQ(globalRouting0->RouteOutput(nullptr, header, nullptr, sockerr),
+                          rtentry,
+                          "Error-- route not cached");
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    Ptr<Ipv4Route> recomputed = globalRouting0->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_NE(recomputed, rtentry, "Error-- cached route not invalidated");
+    NS_TEST_ASSERT_MSG_EQ(recomputed->GetGateway(),
+                          Ipv4Address("10.1.1.2"),
+                          "Error-- wrong gateway");
+    globalRouting0->SetAttribute("RouteCache", BooleanValue(false));
+    NS_TEST_ASSERT_MSG_NE(globalRouting0->RouteOutput(nullptr, header, nullptr, sockerr),
+                          recomputed,
+                          "Error-- route cached while disabled");
+
     Simulator::Destroy();
 }
 
@@ -1321,6 +1347,225 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the incremental route updates give the routing tables a
+ * full recomputation gives, after interfaces go down or up.
+ *
+ * The routers form a 4x4 grid of point-to-point links, with a LAN between
+ * three of them.  Each change is followed by an incremental update, whose
+ * tables are compared with those of a full recomputation.
+ */
+class Ipv4GlobalRoutingIncrementalUpdateTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingIncrementalUpdateTestCase();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief List the global routes of all the routers, sorted, so that
+     * tables holding the same routes in a different order compare equal.
+     * \returns One line per route.
+     */
+    std::vector<std::string> GetRoutes() const;
+
+    /**
+     * \brief Update the routes incrementally and compare them with those of
+     * a full recomputation.
+     * \param change The change made, for the messages.
+     * \param update The incremental update; nullptr if already done.
+     */
+    void CheckUpdate(const std::string& change, void (*update)());
+
+    /**
+     * \brief Take an interface down or up.
+     * \param node The node index.
+     * \param interface The interface index.
+     * \param up Whether to take the interface up.
+     */
+    void SetInterface(uint32_t node, uint32_t interface, bool up);
+
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+Ipv4GlobalRoutingIncrementalUpdateTestCase::Ipv4GlobalRoutingIncrementalUpdateTestCase()
+    : TestCase("Incremental global route updates match full recomputations")
+{
+}
+
+void
+Ipv4GlobalRoutingIncrementalUpdateTestCase::DoSetup()
+{
+    const uint32_t side = 4;
+    m_nodes.Create(side * side);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.2.0.0", "255.255.255.252");
+    auto connect = [&](uint32_t a, uint32_t b) {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        NetDeviceContainer net = simpleHelper.Install(m_nodes.Get(a), channel);
+        net.Add(simpleHelper.Install(m_nodes.Get(b), channel));
+        ipv4.Assign(net);
+        ipv4.NewNetwork();
+    };
+    for (uint32_t row = 0; row < side; row++)
+    {
+        for (uint32_t col = 0; col < side; col++)
+        {
+            uint32_t id = row * side + col;
+            if (col + 1 < side)
+            {
+                connect(id, id + 1);
+            }
+            if (row + 1 < side)
+            {
+                connect(id, id + side);
+            }
+        }
+    }
+
+    Ptr<SimpleChannel> lan = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper lanHelper;
+    NetDeviceContainer lanNet;
+    for (uint32_t id : {0, 5, 10})
+    {
+        lanNet.Add(lanHelper.Install(m_nodes.Get(id), lan));
+    }
+    ipv4.SetBase("10.3.0.0", "255.255.255.0");
+    ipv4.Assign(lanNet);
+}
+
+void
+Ipv4GlobalRoutingIncrementalUpdateTestCase::DoTeardown()
+{
+    Config::SetGlobal("GlobalRoutingIncrementalUpdates", BooleanValue(false));
+    m_nodes = NodeContainer();
+    Simulator::Destroy();
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingIncrementalUpdateTestCase::GetRoutes() const
+{
+    std::vector<std::string> routes;
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> routing = m_nodes.Get(i)
+                                             ->GetObject<Ipv4L3Protocol>()
+                                             ->GetRoutingProtocol()
+                                             ->GetObject<Ipv4GlobalRouting>();
+        for (uint32_t j = 0; j < routing->GetNRoutes(); j++)
+        {
+            Ipv4RoutingTableEntry* route = routing->GetRoute(j);
+            std::ostringstream oss;
+            oss << "n" << i << " " << route->GetDest() << "/"
+                << route->GetDestNetworkMask().GetPrefixLength() << " gw " << route->GetGateway()
+                << " if " << route->GetInterface();
+            routes.push_back(oss.str());
+        }
+    }
+    std::sort(routes.begin(), routes.end());
+    return routes;
+}
+
+void
+Ipv4GlobalRoutingIncrementalUpdateTestCase::CheckUpdate(const std::string& change,
+                                                        void (*update)())
+{
+    if (update)
+    {
+        update();
+    }
+    std::vector<std::string> incremental = GetRoutes();
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    std::vector<std::string> full = GetRoutes();
+    NS_TEST_ASSERT_MSG_EQ(incremental.size(),
+                          full.size(),
+                          "Wrong number of routes after " << change);
+    for (std::size_t i = 0; i < full.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(incremental[i], full[i], "Wrong route after " << change);
+    }
+}
+
+void
+Ipv4GlobalRoutingIncrementalUpdateTestCase::SetInterface(uint32_t node,
+                                                         uint32_t interface,
+                                                         bool up)
+{
+    Ptr<Ipv4> ip = m_nodes.Get(node)->GetObject<Ipv4>();
+    if (up)
+    {
+        ip->SetUp(interface);
+    }
+    else
+    {
+        ip->SetDown(interface);
+    }
+}
+
+void
+Ipv4GlobalRoutingIncrementalUpdateTestCase::DoRun()
+{
+    Config::SetGlobal("GlobalRoutingIncrementalUpdates", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::vector<std::string> initial = GetRoutes();
+
+    // updates asked for explicitly: a grid link of the central router, then
+    // its LAN interface, and both back up
+    SetInterface(5, 1, false);
+    CheckUpdate("grid link down", &Ipv4GlobalRoutingHelper::UpdateRoutingTables);
+    NS_TEST_ASSERT_MSG_EQ((GetRoutes() != initial), true, "Routes not changed by the link");
+    SetInterface(5, 5, false);
+    CheckUpdate("LAN interface down", &Ipv4GlobalRoutingHelper::UpdateRoutingTables);
+    SetInterface(5, 1, true);
+    CheckUpdate("grid link up", &Ipv4GlobalRoutingHelper::UpdateRoutingTables);
+    SetInterface(5, 5, true);
+    CheckUpdate("LAN interface up", &Ipv4GlobalRoutingHelper::UpdateRoutingTables);
+    std::vector<std::string> restored = GetRoutes();
+    NS_TEST_ASSERT_MSG_EQ((restored == initial), true, "Routes not restored");
+
+    // updates made by the routers reacting to the interface events, the
+    // changes of a time step being coalesced
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        m_nodes.Get(i)
+            ->GetObject<Ipv4L3Protocol>()
+            ->GetRoutingProtocol()
+            ->SetAttribute("RespondToInterfaceEvents", BooleanValue(true));
+    }
+    Simulator::Schedule(Seconds(1),
+                        &Ipv4GlobalRoutingIncrementalUpdateTestCase::SetInterface,
+                        this,
+                        6,
+                        2,
+                        false);
+    Simulator::Schedule(Seconds(1),
+                        &Ipv4GlobalRoutingIncrementalUpdateTestCase::SetInterface,
+                        this,
+                        9,
+                        1,
+                        false);
+    Simulator::Schedule(Seconds(2),
+                        &Ipv4GlobalRoutingIncrementalUpdateTestCase::CheckUpdate,
+                        this,
+                        "interface events",
+                        nullptr);
+    Simulator::Run();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -1344,6 +1589,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingIncrementalUpdateTestCase, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
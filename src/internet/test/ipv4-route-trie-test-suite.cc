@@ -0,0 +1,143 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-route-trie.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4RouteTrie longest prefix match test.
+ */
+class Ipv4RouteTrieTestCase : public TestCase
+{
+  public:
+    Ipv4RouteTrieTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a network route, to be inserted in the trie.
+     * \param network the destination network
+     * \param mask the network mask
+     * \param interface the outgoing interface, used to tell routes apart
+     */
+    void Add(const char* network, const char* mask, uint32_t interface);
+
+    /**
+     * \brief Look up an address and return the interfaces of the routes of
+     * the longest matching prefix.
+     * \param dest the address
+     * \returns the interfaces, in route order
+     */
+    std::vector<uint32_t> Find(const char* dest) const;
+
+    Ipv4RouteTrie m_trie;                        //!< the trie under test
+    std::vector<Ipv4RoutingTableEntry> m_routes; //!< the routes, owned here
+};
+
+Ipv4RouteTrieTestCase::Ipv4RouteTrieTestCase()
+    : TestCase("Longest prefix match in Ipv4RouteTrie")
+{
+}
+
+void
+Ipv4RouteTrieTestCase::Add(const char* network, const char* mask, uint32_t interface)
+{
+    m_routes.push_back(Ipv4RoutingTableEntry::CreateNetworkRouteTo(Ipv4Address(network),
+                                                                   Ipv4Mask(mask),
+                                                                   Ipv4Address("10.0.0.1"),
+                                                                   interface));
+}
+
+std::vector<uint32_t>
+Ipv4RouteTrieTestCase::Find(const char* dest) const
+{
+    std::vector<uint32_t> interfaces;
+    const Ipv4RouteTrie::RouteGroup_t* group = m_trie.Lookup(Ipv4Address(dest));
+    if (group)
+    {
+        for (const auto* route : *group)
+        {
+            interfaces.push_back(route->GetInterface());
+        }
+    }
+    return interfaces;
+}
+
+void
+Ipv4RouteTrieTestCase::DoRun()
+{
+    m_routes.reserve(16);
+    Add("10.1.0.0", "255.255.0.0", 1);
+    Add("10.1.2.0", "255.255.255.0", 2);
+    Add("10.1.2.0", "255.255.255.0", 3); // equal cost route
+    Add("10.1.2.128", "255.255.255.128", 4);
+    Add("10.1.3.0", "255.255.255.252", 5);
+    Add("192.168.0.0", "255.255.0.0", 6);
+    for (auto& route : m_routes)
+    {
+        m_trie.Insert(&route);
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(m_trie.GetNPrefixes(), 5, "Wrong number of prefixes");
+    NS_TEST_EXPECT_MSG_EQ(Find("11.0.0.1").empty(), true, "No route expected");
+    NS_TEST_EXPECT_MSG_EQ((Find("10.1.9.9") == std::vector<uint32_t>{1}), true, "Expected /16");
+    NS_TEST_EXPECT_MSG_EQ((Find("10.1.2.1") == std::vector<uint32_t>{2, 3}),
+                          true,
+                          "Expected the /24 ECMP group, in insertion order");
+    NS_TEST_EXPECT_MSG_EQ((Find("10.1.2.200") == std::vector<uint32_t>{4}), true, "Expected /25");
+    NS_TEST_EXPECT_MSG_EQ((Find("10.1.3.2") == std::vector<uint32_t>{5}), true, "Expected /30");
+    NS_TEST_EXPECT_MSG_EQ((Find("10.1.3.4") == std::vector<uint32_t>{1}), true, "Expected /16");
+    NS_TEST_EXPECT_MSG_EQ((Find("192.168.7.7") == std::vector<uint32_t>{6}), true, "Expected /16");
+
+    const Ipv4RouteTrie::RouteGroup_t* matches[Ipv4RouteTrie::MAX_MATCHES];
+    uint32_t nMatches = m_trie.LookupAll(Ipv4Address("10.1.2.130"), matches);
+    NS_TEST_EXPECT_MSG_EQ(nMatches, 3, "Expected /25, /24 and /16");
+    NS_TEST_EXPECT_MSG_EQ(matches[0]->front()->GetInterface(), 4, "Longest prefix first");
+    NS_TEST_EXPECT_MSG_EQ(matches[2]->front()->GetInterface(), 1, "Shortest prefix last");
+
+    // a default route matches everything, after all the longer prefixes
+    Add("0.0.0.0", "0.0.0.0", 7);
+    m_trie.Insert(&m_routes.back());
+    NS_TEST_EXPECT_MSG_EQ((Find("11.0.0.1") == std::vector<uint32_t>{7}), true, "Expected /0");
+    NS_TEST_EXPECT_MSG_EQ((Find("10.1.2.1") == std::vector<uint32_t>{2, 3}), true, "Expected /24");
+
+    m_trie.Clear();
+    NS_TEST_EXPECT_MSG_EQ(Find("10.1.2.1").empty(), true, "No route expected after Clear");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4RouteTrie TestSuite
+ */
+class Ipv4RouteTrieTestSuite : public TestSuite
+{
+  public:
+    Ipv4RouteTrieTestSuite()
+        : TestSuite("ipv4-route-trie", UNIT)
+    {
+        AddTestCase(new Ipv4RouteTrieTestCase(), TestCase::QUICK);
+    }
+};
+
+static Ipv4RouteTrieTestSuite g_ipv4RouteTrieTestSuite; //!< Static variable for test initialization
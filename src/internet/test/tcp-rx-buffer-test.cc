@@ -19,6 +19,8 @@
 #include "ns3/tcp-rx-buffer.h"
 #include "ns3/test.h"
 
+#include <cstring>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TcpRxBufferTestSuite");
@@ -42,6 +44,10 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+    /**
+     * \brief Test virtual payload, kept as byte counts, mixed with real bytes.
+     */
+    void TestVirtualPayload();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -53,6 +59,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestVirtualPayload();
 }
 
 void
@@ -289,6 +296,83 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestVirtualPayload()
+{
+    TcpRxBuffer rxBuf;
+    TcpHeader h;
+    rxBuf.SetMaxBufferSize(65535);
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+
+    uint8_t bytes[500];
+    memset(bytes, 'b', sizeof(bytes));
+
+    // In order virtual segment
+    h.SetSequenceNumber(SequenceNumber32(1));
+    rxBuf.Add(Create<Packet>(500), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 500, "Available bytes differ from expected");
+
+    // Out of order virtual segments, merged into a single run
+    h.SetSequenceNumber(SequenceNumber32(1001));
+    rxBuf.Add(Create<Packet>(500), h);
+    h.SetSequenceNumber(SequenceNumber32(1501));
+    rxBuf.Add(Create<Packet>(500), h);
+    // Out of order real segment
+    h.SetSequenceNumber(SequenceNumber32(2001));
+    rxBuf.Add(Create<Packet>(bytes, sizeof(bytes)), h);
+
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(501),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 2000, "Buffer occupancy differs from expected");
+    TcpOptionSack::SackList sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 1, "SACK list should contain one element");
+    NS_TEST_ASSERT_MSG_EQ(sackList.begin()->first,
+                          SequenceNumber32(1001),
+                          "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(sackList.begin()->second,
+                          SequenceNumber32(2501),
+                          "SACK block different than expected");
+
+    // Virtual segment filling the hole, merged with both its neighbours
+    h.SetSequenceNumber(SequenceNumber32(501));
+    rxBuf.Add(Create<Packet>(500), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(2501),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 2500, "Available bytes differ from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should contain no element");
+
+    // Partial extraction from the middle of the virtual run
+    Ptr<Packet> p = rxBuf.Extract(700);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), 700, "Extracted size differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(p->IsVirtualPayload(), true, "Virtual payload not kept virtual");
+
+    // The rest of the virtual run, followed by the real bytes
+    p = rxBuf.Extract(10000);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), 1800, "Extracted size differs from expected");
+    uint8_t out[1800];
+    p->CopyData(out, sizeof(out));
+    uint32_t zeros = 0;
+    uint32_t reals = 0;
+    for (uint32_t i = 0; i < sizeof(out); i++)
+    {
+        zeros += (i < 1300 && out[i] == 0) ? 1 : 0;
+        reals += (i >= 1300 && out[i] == 'b') ? 1 : 0;
+    }
+    NS_TEST_ASSERT_MSG_EQ(zeros, 1300, "Virtual payload differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(reals, 500, "Real payload differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Buffer should be empty");
+
+    // Virtual retransmission partly received already, trimmed to the new bytes
+    h.SetSequenceNumber(SequenceNumber32(2201));
+    rxBuf.Add(Create<Packet>(600), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(2801),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 300, "Available bytes differ from expected");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
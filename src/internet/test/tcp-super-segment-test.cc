@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-general-test.h"
+
+#include "ns3/ipv4-header.h"
+#include "ns3/log.h"
+#include "ns3/tcp-header.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpSuperSegmentTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that a super-segment never makes an IP packet larger than
+ * 65535 bytes, whatever the MaxSuperSegmentSize attribute.
+ *
+ * The segment size has a multiple between the limit and 65535 bytes, and the
+ * devices accept any IP packet, so an oversized super-segment would be sent.
+ */
+class TcpSuperSegmentLimitTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param desc Test description.
+     */
+    TcpSuperSegmentLimitTest(const std::string& desc);
+
+  protected:
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void QueueDrop(SocketWho who) override;
+    void PhyDrop(SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    static const uint32_t SEGMENT_SIZE = 1091; //!< 60 segments take 65460 bytes
+    static const uint32_t DATA_SIZE = 100000;  //!< Data sent by the application
+    uint32_t m_maxTxSize{0};                   //!< Largest payload sent
+    uint32_t m_rxSize{0};                      //!< Payload received
+};
+
+TcpSuperSegmentLimitTest::TcpSuperSegmentLimitTest(const std::string& desc)
+    : TcpGeneralTest(desc)
+{
+}
+
+void
+TcpSuperSegmentLimitTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktSize(DATA_SIZE);
+    SetAppPktCount(1);
+    SetMTU(65535);
+}
+
+void
+TcpSuperSegmentLimitTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetSegmentSize(SENDER, SEGMENT_SIZE);
+    SetSegmentSize(RECEIVER, SEGMENT_SIZE);
+    SetInitialCwnd(SENDER, DATA_SIZE / SEGMENT_SIZE + 1);
+    GetSenderSocket()->SetAttribute("MaxSuperSegmentSize", UintegerValue(1 << 20));
+}
+
+void
+TcpSuperSegmentLimitTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER && p->GetSize() > 0)
+    {
+        uint32_t ipSize =
+            Ipv4Header().GetSerializedSize() + h.GetSerializedSize() + p->GetSize();
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(ipSize, 65535, "IP packet too large");
+        m_maxTxSize = std::max(m_maxTxSize, p->GetSize());
+    }
+}
+
+void
+TcpSuperSegmentLimitTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER)
+    {
+        m_rxSize += p->GetSize();
+    }
+}
+
+void
+TcpSuperSegmentLimitTest::QueueDrop(SocketWho who)
+{
+    NS_TEST_ASSERT_MSG_EQ(true, false, "Drop on the queue; unexpected");
+}
+
+void
+TcpSuperSegmentLimitTest::PhyDrop(SocketWho who)
+{
+    NS_TEST_ASSERT_MSG_EQ(true, false, "Drop on the phy; unexpected");
+}
+
+void
+TcpSuperSegmentLimitTest::FinalChecks()
+{
+    // the sender budgets for the TCP header with the largest options
+    uint32_t limit = 65535 - Ipv4Header().GetSerializedSize() - 60;
+    NS_TEST_ASSERT_MSG_EQ(m_maxTxSize,
+                          limit - limit % SEGMENT_SIZE,
+                          "Super-segment not clamped to the largest IP packet");
+    NS_TEST_ASSERT_MSG_EQ(m_rxSize, DATA_SIZE, "Data not received");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * TestSuite for the TCP segmentation offload
+ */
+class TcpSuperSegmentTestSuite : public TestSuite
+{
+  public:
+    TcpSuperSegmentTestSuite()
+        : TestSuite("tcp-super-segment", UNIT)
+    {
+        AddTestCase(new TcpSuperSegmentLimitTest("Super-segment at the IP packet limit"),
+                    TestCase::QUICK);
+    }
+};
+
+static TcpSuperSegmentTestSuite g_tcpSuperSegmentTestSuite; //!< Static variable for test initialization
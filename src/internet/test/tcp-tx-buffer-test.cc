@@ -20,6 +20,7 @@
 #include "ns3/tcp-tx-buffer.h"
 #include "ns3/test.h"
 
+#include <cstring>
 #include <limits>
 
 using namespace ns3;
@@ -53,6 +54,8 @@ class TcpTxBufferTestCase : public TestCase
     /** \brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** \brief Test virtual payload, kept as byte counts, mixed with real bytes */
+    void TestVirtualPayload();
     /**
      * \brief Callback to provide a value of receiver window
      * \returns the receiver window size
@@ -100,6 +103,14 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Cases for virtual payload:
+     * -> consecutive virtual writes are kept as one run, real bytes apart
+     * -> a segment spanning virtual and real payload keeps the real bytes
+     * -> a partial ACK inside a run merged by a retransmission
+     */
+    Simulator::Schedule(Seconds(0.0), &TcpTxBufferTestCase::TestVirtualPayload, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -420,6 +431,77 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestVirtualPayload()
+{
+    TcpTxBuffer txBuf;
+    txBuf.SetHeadSequence(SequenceNumber32(1));
+    txBuf.SetSegmentSize(1000);
+    txBuf.SetMaxBufferSize(10000);
+
+    uint8_t bytes[500];
+    memset(bytes, 'a', sizeof(bytes));
+
+    // 2000 virtual bytes, 500 real ones, then 500 virtual bytes again
+    txBuf.Add(Create<Packet>(1000));
+    txBuf.Add(Create<Packet>(1000));
+    txBuf.Add(Create<Packet>(bytes, sizeof(bytes)));
+    txBuf.Add(Create<Packet>(500));
+    NS_TEST_ASSERT_MSG_EQ(txBuf.Size(), 3000, "Size is different than expected");
+
+    // Two segments sent from the virtual run, then retransmitted as one
+    TcpTxItem* item = txBuf.CopyFromSequence(500, SequenceNumber32(1));
+    NS_TEST_ASSERT_MSG_EQ(item->GetSeqSize(), 500, "Segment size is different than expected");
+    item = txBuf.CopyFromSequence(500, SequenceNumber32(501));
+    NS_TEST_ASSERT_MSG_EQ(item->GetSeqSize(), 500, "Segment size is different than expected");
+    item = txBuf.CopyFromSequence(1000, SequenceNumber32(1));
+    NS_TEST_ASSERT_MSG_EQ(item->GetSeqSize(), 1000, "Merged size is different than expected");
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->IsVirtualPayload(),
+                          true,
+                          "Merged virtual payload not kept virtual");
+
+    // Partial ACK inside the merged run
+    txBuf.DiscardUpTo(SequenceNumber32(301));
+    NS_TEST_ASSERT_MSG_EQ(txBuf.HeadSequence(),
+                          SequenceNumber32(301),
+                          "Head sequence is different than expected");
+    NS_TEST_ASSERT_MSG_EQ(txBuf.Size(), 2700, "Size is different than expected");
+    NS_TEST_ASSERT_MSG_EQ(txBuf.SizeFromSequence(SequenceNumber32(1001)),
+                          2000,
+                          "Unsent size is different than expected");
+    item = txBuf.CopyFromSequence(700, SequenceNumber32(301));
+    NS_TEST_ASSERT_MSG_EQ(item->GetSeqSize(), 700, "Segment size is different than expected");
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->IsVirtualPayload(),
+                          true,
+                          "Trimmed virtual payload not kept virtual");
+
+    // The rest of the virtual run
+    item = txBuf.CopyFromSequence(1000, SequenceNumber32(1001));
+    NS_TEST_ASSERT_MSG_EQ(item->GetSeqSize(), 1000, "Segment size is different than expected");
+    NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->IsVirtualPayload(),
+                          true,
+                          "Virtual payload not kept virtual");
+
+    // A segment of real bytes followed by virtual ones
+    item = txBuf.CopyFromSequence(1000, SequenceNumber32(2001));
+    NS_TEST_ASSERT_MSG_EQ(item->GetSeqSize(), 1000, "Segment size is different than expected");
+    uint8_t out[1000];
+    item->GetPacket()->CopyData(out, sizeof(out));
+    uint32_t reals = 0;
+    uint32_t zeros = 0;
+    for (uint32_t i = 0; i < sizeof(out); i++)
+    {
+        reals += (i < 500 && out[i] == 'a') ? 1 : 0;
+        zeros += (i >= 500 && out[i] == 0) ? 1 : 0;
+    }
+    NS_TEST_ASSERT_MSG_EQ(reals, 500, "Real payload is different than expected");
+    NS_TEST_ASSERT_MSG_EQ(zeros, 500, "Virtual payload is different than expected");
+
+    txBuf.DiscardUpTo(SequenceNumber32(3001));
+    NS_TEST_ASSERT_MSG_EQ(txBuf.Size(), 0, "Size is different than expected");
+    NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight(), 0, "Bytes in flight are different");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
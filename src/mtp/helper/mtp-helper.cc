@@ -0,0 +1,387 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mtp-helper.h"
+
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/config.h"
+#include "ns3/global-value.h"
+#include "ns3/log.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <queue>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MtpHelper implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MtpHelper");
+
+namespace
+{
+
+/**
+ * \ingroup mtp
+ * Get the delay of a point to point channel.
+ *
+ * \param [in] channel The channel.
+ * \param [out] delay The delay.
+ * \returns \c true if the channel is a point to point channel.
+ */
+bool
+GetPointToPointDelay(Ptr<Channel> channel, Time& delay)
+{
+    if (!DynamicCast<PointToPointChannel>(channel))
+    {
+        return false;
+    }
+    TimeValue value;
+    channel->GetAttribute("Delay", value);
+    delay = value.Get();
+    return true;
+}
+
+/**
+ * \ingroup mtp
+ * Find the root of a set, compressing the path.
+ *
+ * \param [in,out] parent The parent of each element.
+ * \param [in] i An element.
+ * \returns The root of the set of the element.
+ */
+uint32_t
+FindRoot(std::vector<uint32_t>& parent, uint32_t i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+} // unnamed namespace
+
+void
+MtpHelper::Enable(uint32_t threads)
+{
+    NS_LOG_FUNCTION(threads);
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(threads));
+}
+
+std::vector<uint32_t>
+MtpHelper::GetPartitionVector(const std::vector<NodeContainer>& partitions)
+{
+    std::vector<uint32_t> partition(NodeList::GetNNodes(), 0);
+    for (uint32_t i = 0; i < partitions.size(); i++)
+    {
+        for (auto it = partitions[i].Begin(); it != partitions[i].End(); it++)
+        {
+            NS_ASSERT_MSG(partition[(*it)->GetId()] == 0,
+                          "Node " << (*it)->GetId() << " in several partitions");
+            partition[(*it)->GetId()] = i + 1;
+        }
+    }
+    return partition;
+}
+
+Time
+MtpHelper::GetLookahead(const std::vector<uint32_t>& partition)
+{
+    Time lookahead = Time::Max();
+    for (auto it = ChannelList::Begin(); it != ChannelList::End(); it++)
+    {
+        Ptr<Channel> channel = *it;
+        bool cut = false;
+        for (std::size_t i = 1; i < channel->GetNDevices(); i++)
+        {
+            cut |= partition[channel->GetDevice(i)->GetNode()->GetId()] !=
+                   partition[channel->GetDevice(0)->GetNode()->GetId()];
+        }
+        if (!cut)
+        {
+            continue;
+        }
+        Time delay;
+        if (!GetPointToPointDelay(channel, delay))
+        {
+            NS_FATAL_ERROR("Channel " << channel->GetId() << " of type "
+                                      << channel->GetInstanceTypeId().GetName()
+                                      << " spans several partitions");
+        }
+        if (!delay.IsStrictlyPositive())
+        {
+            NS_FATAL_ERROR("Point to point channel " << channel->GetId()
+                                                     << " without delay spans two partitions");
+        }
+        lookahead = std::min(lookahead, delay);
+    }
+    return lookahead;
+}
+
+Time
+MtpHelper::GetLookahead(const std::vector<NodeContainer>& partitions)
+{
+    NS_LOG_FUNCTION(partitions.size());
+    return GetLookahead(GetPartitionVector(partitions));
+}
+
+void
+MtpHelper::Install(const std::vector<NodeContainer>& partitions)
+{
+    NS_LOG_FUNCTION(partitions.size());
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (!impl)
+    {
+        NS_FATAL_ERROR("MtpHelper::Enable() must be called before the simulator is used");
+    }
+    std::vector<uint32_t> partition = GetPartitionVector(partitions);
+    Time lookahead = GetLookahead(partition);
+    NS_LOG_INFO(partitions.size() << " partitions, lookahead " << lookahead);
+    impl->SetPartition(partition, lookahead);
+}
+
+void
+MtpHelper::Install(NodeContainer nodes, uint32_t nPartitions)
+{
+    NS_LOG_FUNCTION(nodes.GetN() << nPartitions);
+    Install(Partition(nodes, nPartitions));
+}
+
+std::vector<NodeContainer>
+MtpHelper::Partition(NodeContainer nodes, uint32_t nPartitions)
+{
+    NS_LOG_FUNCTION(nodes.GetN() << nPartitions);
+    const uint32_t none = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> index(NodeList::GetNNodes(), none);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        index[nodes.Get(i)->GetId()] = i;
+    }
+
+    // Merge the nodes which cannot be separated, and list the links which
+    // can be cut
+    std::vector<uint32_t> parent(nodes.GetN());
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<std::pair<uint32_t, uint32_t>> links;
+    for (auto it = ChannelList::Begin(); it != ChannelList::End(); it++)
+    {
+        Ptr<Channel> channel = *it;
+        std::vector<uint32_t> ends;
+        for (std::size_t i = 0; i < channel->GetNDevices(); i++)
+        {
+            uint32_t node = index[channel->GetDevice(i)->GetNode()->GetId()];
+            if (node != none)
+            {
+                ends.push_back(node);
+            }
+        }
+        Time delay;
+        if (ends.size() == 2 && GetPointToPointDelay(channel, delay) &&
+            delay.IsStrictlyPositive())
+        {
+            links.emplace_back(ends[0], ends[1]);
+            continue;
+        }
+        for (std::size_t i = 1; i < ends.size(); i++)
+        {
+            parent[FindRoot(parent, ends[i])] = FindRoot(parent, ends[0]);
+        }
+    }
+
+    // The graph of the merged groups, weighted by their number of nodes
+    std::vector<uint32_t> group(nodes.GetN());
+    std::vector<uint32_t> weight;
+    std::map<uint32_t, uint32_t> groupOfRoot;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        auto it = groupOfRoot.emplace(FindRoot(parent, i), weight.size());
+        if (it.second)
+        {
+            weight.push_back(0);
+        }
+        group[i] = it.first->second;
+        weight[group[i]]++;
+    }
+    uint32_t nGroups = weight.size();
+    std::vector<std::map<uint32_t, uint32_t>> adjacency(nGroups);
+    for (const auto& [a, b] : links)
+    {
+        if (group[a] != group[b])
+        {
+            adjacency[group[a]][group[b]]++;
+            adjacency[group[b]][group[a]]++;
+        }
+    }
+    uint32_t k = std::min(nPartitions, nGroups);
+    if (k == 0)
+    {
+        return {};
+    }
+
+    // Seeds far apart: each new seed is the group farthest from the
+    // previous ones, in hops, the unreachable groups first
+    std::vector<uint32_t> seeds;
+    seeds.push_back(std::max_element(weight.begin(), weight.end()) - weight.begin());
+    std::vector<uint32_t> distance(nGroups, none);
+    while (seeds.size() < k)
+    {
+        std::queue<uint32_t> queue;
+        distance[seeds.back()] = 0;
+        queue.push(seeds.back());
+        while (!queue.empty())
+        {
+            uint32_t g = queue.front();
+            queue.pop();
+            for (const auto& [neighbor, count] : adjacency[g])
+            {
+                if (distance[neighbor] > distance[g] + 1)
+                {
+                    distance[neighbor] = distance[g] + 1;
+                    queue.push(neighbor);
+                }
+            }
+        }
+        seeds.push_back(std::max_element(distance.begin(), distance.end()) - distance.begin());
+    }
+
+    // Grow the smallest partition by one group at a time, breadth first
+    std::vector<uint32_t> part(nGroups, none);
+    std::vector<uint32_t> partWeight(k, 0);
+    std::vector<std::queue<uint32_t>> frontier(k);
+    for (uint32_t p = 0; p < k; p++)
+    {
+        frontier[p].push(seeds[p]);
+    }
+    for (uint32_t assigned = 0; assigned < nGroups;)
+    {
+        uint32_t best = none;
+        for (uint32_t p = 0; p < k; p++)
+        {
+            while (!frontier[p].empty() && part[frontier[p].front()] != none)
+            {
+                frontier[p].pop();
+            }
+            if (!frontier[p].empty() && (best == none || partWeight[p] < partWeight[best]))
+            {
+                best = p;
+            }
+        }
+        if (best == none)
+        {
+            // A component no partition reaches goes to the smallest one
+            best = std::min_element(partWeight.begin(), partWeight.end()) - partWeight.begin();
+            frontier[best].push(std::find(part.begin(), part.end(), none) - part.begin());
+            continue;
+        }
+        uint32_t g = frontier[best].front();
+        frontier[best].pop();
+        part[g] = best;
+        partWeight[best] += weight[g];
+        assigned++;
+        for (const auto& [neighbor, count] : adjacency[g])
+        {
+            if (part[neighbor] == none)
+            {
+                frontier[best].push(neighbor);
+            }
+        }
+    }
+
+    // Move the boundary groups to the partition they have the most links
+    // with, within 5% of the average partition weight
+    uint32_t limit = nodes.GetN() / k + nodes.GetN() / (20 * k) + 1;
+    for (uint32_t pass = 0; pass < 4; pass++)
+    {
+        bool moved = false;
+        for (uint32_t g = 0; g < nGroups; g++)
+        {
+            uint32_t p = part[g];
+            if (partWeight[p] == weight[g])
+            {
+                continue;
+            }
+            std::map<uint32_t, uint32_t> linksTo;
+            for (const auto& [neighbor, count] : adjacency[g])
+            {
+                linksTo[part[neighbor]] += count;
+            }
+            int64_t internal = linksTo[p];
+            uint32_t best = p;
+            int64_t bestGain = 0;
+            for (const auto& [q, count] : linksTo)
+            {
+                int64_t gain = static_cast<int64_t>(count) - internal;
+                if (q == p || partWeight[q] + weight[g] > limit)
+                {
+                    continue;
+                }
+                if (gain > bestGain ||
+                    (gain == bestGain && gain == 0 && partWeight[q] + weight[g] < partWeight[p]))
+                {
+                    best = q;
+                    bestGain = gain;
+                }
+            }
+            if (best != p)
+            {
+                part[g] = best;
+                partWeight[p] -= weight[g];
+                partWeight[best] += weight[g];
+                moved = true;
+            }
+        }
+        if (!moved)
+        {
+            break;
+        }
+    }
+
+    std::vector<NodeContainer> partitions(k);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        partitions[part[group[i]]].Add(nodes.Get(i));
+    }
+    uint32_t cut = 0;
+    for (const auto& [a, b] : links)
+    {
+        cut += part[group[a]] != part[group[b]];
+    }
+    NS_LOG_INFO(nodes.GetN() << " nodes in " << nGroups << " groups, " << k << " partitions, "
+                             << cut << " of " << links.size() << " links cut");
+    return partitions;
+}
+
+} // namespace ns3
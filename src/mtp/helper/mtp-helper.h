@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MTP_HELPER_H
+#define MTP_HELPER_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MtpHelper declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup mtp
+ * \brief Set up a multithreaded simulation.
+ *
+ * Enable() must be called before anything is scheduled, that is before
+ * the nodes are created.  Once the topology is built, Install() assigns
+ * the nodes to logical processes, either as given or by partitioning the
+ * graph of the links, and sets the lookahead to the smallest delay of the
+ * point to point links cut by the partition.
+ *
+ * Only point to point links can be cut: the nodes sharing another kind of
+ * channel, or a point to point link without delay, are always in the same
+ * logical process.
+ */
+class MtpHelper
+{
+  public:
+    /**
+     * Use MultithreadedSimulatorImpl for the simulation.
+     *
+     * \param [in] threads The maximum number of threads; 0 for the number
+     * of hardware threads.
+     */
+    static void Enable(uint32_t threads = 0);
+
+    /**
+     * Assign each group of nodes to its own logical process.  The nodes of
+     * no group stay in the global logical process, whose events run alone.
+     *
+     * \param [in] partitions The groups of nodes.
+     */
+    static void Install(const std::vector<NodeContainer>& partitions);
+    /**
+     * Partition the graph of the links between nodes, then assign each
+     * partition to its own logical process.
+     *
+     * \param [in] nodes The nodes.
+     * \param [in] nPartitions The number of partitions.
+     */
+    static void Install(NodeContainer nodes, uint32_t nPartitions);
+
+    /**
+     * Partition the graph of the links between nodes into groups of
+     * about the same number of nodes, with few point to point links
+     * between the groups.
+     *
+     * The nodes which cannot be separated are merged first.  The groups
+     * are then grown by breadth first search, from seeds far apart, one
+     * node at a time for the smallest group, and finally refined by moving
+     * the nodes at their boundaries when this cuts fewer links.
+     *
+     * \param [in] nodes The nodes.
+     * \param [in] nPartitions The number of partitions.
+     * \returns The partitions, which may be fewer than requested.
+     */
+    static std::vector<NodeContainer> Partition(NodeContainer nodes, uint32_t nPartitions);
+    /**
+     * Get the lookahead of a partition.
+     *
+     * \param [in] partitions The groups of nodes.
+     * \returns The smallest delay of the point to point links between
+     * groups, or Time::Max() if there is none.
+     */
+    static Time GetLookahead(const std::vector<NodeContainer>& partitions);
+
+  private:
+    /**
+     * \param [in] partitions The groups of nodes.
+     * \returns The logical process of each node, by node id.
+     */
+    static std::vector<uint32_t> GetPartitionVector(const std::vector<NodeContainer>& partitions);
+    /**
+     * \param [in] partition The logical process of each node, by node id.
+     * \returns The smallest delay of the point to point links between
+     * logical processes, or Time::Max() if there is none.
+     */
+    static Time GetLookahead(const std::vector<uint32_t>& partition);
+};
+
+} // namespace ns3
+
+#endif /* MTP_HELPER_H */
@@ -0,0 +1,224 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "logical-process.h"
+
+#include "ns3/assert.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <limits>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::LogicalProcess implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("LogicalProcess");
+
+LogicalProcess::LogicalProcess(uint32_t id, uint32_t nLps)
+    : m_id(id),
+      m_events(nullptr),
+      m_currentTs(0),
+      m_currentContext(Simulator::NO_CONTEXT),
+      m_currentUid(EventId::UID::INVALID),
+      m_uid(EventId::UID::VALID),
+      m_eventCount(0),
+      m_parity(0),
+      m_minSentTs(std::numeric_limits<uint64_t>::max())
+{
+    NS_LOG_FUNCTION(this << id << nLps);
+    m_mailboxes[0].resize(nLps);
+    m_mailboxes[1].resize(nLps);
+}
+
+LogicalProcess::~LogicalProcess()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_events)
+    {
+        while (!m_events->IsEmpty())
+        {
+            m_events->RemoveNext().impl->Unref();
+        }
+    }
+    ClearMailboxes();
+}
+
+void
+LogicalProcess::ClearMailboxes()
+{
+    for (auto& mailboxes : m_mailboxes)
+    {
+        for (auto& mailbox : mailboxes)
+        {
+            for (const Message& message : mailbox)
+            {
+                message.event->Unref();
+            }
+            mailbox.clear();
+        }
+    }
+}
+
+void
+LogicalProcess::SetScheduler(Ptr<Scheduler> scheduler)
+{
+    NS_LOG_FUNCTION(this << scheduler);
+    if (m_events)
+    {
+        while (!m_events->IsEmpty())
+        {
+            scheduler->Insert(m_events->RemoveNext());
+        }
+    }
+    m_events = scheduler;
+}
+
+void
+LogicalProcess::SetClock(uint64_t ts, uint32_t uid)
+{
+    NS_LOG_FUNCTION(this << ts << uid);
+    m_currentTs = ts;
+    m_uid = uid;
+}
+
+EventId
+LogicalProcess::Schedule(uint64_t ts, uint32_t context, EventImpl* event)
+{
+    NS_ASSERT_MSG(ts >= m_currentTs, "LogicalProcess::Schedule(): Event in the past");
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_events->Insert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+LogicalProcess::Insert(const Scheduler::Event& ev)
+{
+    m_events->Insert(ev);
+}
+
+Scheduler::Event
+LogicalProcess::RemoveNext()
+{
+    return m_events->RemoveNext();
+}
+
+void
+LogicalProcess::Remove(const EventId& id)
+{
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    m_events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+}
+
+bool
+LogicalProcess::IsExpired(const EventId& id) const
+{
+    return id.PeekEventImpl() == nullptr || id.GetTs() < m_currentTs ||
+           (id.GetTs() == m_currentTs && id.GetUid() <= m_currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+void
+LogicalProcess::Send(uint32_t destination, uint64_t ts, uint32_t context, EventImpl* event)
+{
+    NS_ASSERT(destination != m_id && destination < m_mailboxes[m_parity].size());
+    m_mailboxes[m_parity][destination].push_back({ts, context, event});
+    if (ts < m_minSentTs)
+    {
+        m_minSentTs = ts;
+    }
+}
+
+void
+LogicalProcess::Receive(const std::vector<LogicalProcess*>& lps, uint32_t parity)
+{
+    // By source, in order, so that the uids, and hence the order of the
+    // simultaneous events, do not depend on the thread timings
+    for (LogicalProcess* source : lps)
+    {
+        std::vector<Message>& mailbox = source->m_mailboxes[parity][m_id];
+        for (const Message& message : mailbox)
+        {
+            Schedule(message.ts, message.context, message.event);
+        }
+        mailbox.clear();
+    }
+}
+
+void
+LogicalProcess::ProcessWindow(const std::vector<LogicalProcess*>& lps,
+                              uint64_t round,
+                              uint64_t window)
+{
+    Receive(lps, (round - 1) & 1);
+    m_parity = round & 1;
+    m_minSentTs = std::numeric_limits<uint64_t>::max();
+    while (!m_events->IsEmpty() && m_events->PeekNext().key.m_ts < window)
+    {
+        ProcessOneEvent();
+    }
+}
+
+void
+LogicalProcess::ProcessOneEvent()
+{
+    Scheduler::Event next = m_events->RemoveNext();
+
+    NS_ASSERT(next.key.m_ts >= m_currentTs);
+    m_eventCount++;
+
+    m_currentTs = next.key.m_ts;
+    m_currentContext = next.key.m_context;
+    m_currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+uint64_t
+LogicalProcess::GetNextTs() const
+{
+    if (m_events->IsEmpty())
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return m_events->PeekNext().key.m_ts;
+}
+
+} // namespace ns3
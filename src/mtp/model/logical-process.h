@@ -0,0 +1,224 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOGICAL_PROCESS_H
+#define LOGICAL_PROCESS_H
+
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::LogicalProcess declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup mtp
+ * \brief A partition of a multithreaded simulation, with its own event
+ * list and clock.
+ *
+ * The events of the nodes of a partition are executed, in timestamp
+ * order, by the thread which processes the logical process in the current
+ * round.  The events scheduled for the nodes of another logical process
+ * are sent through a mailbox per pair of logical processes, which is read
+ * by the destination at the start of the next round.  The mailboxes are
+ * double buffered by round parity, so that, with the barrier between the
+ * rounds, they need no locks: during a round, a mailbox is either written
+ * by its source only, or read by its destination only.
+ */
+class LogicalProcess
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] id The index of the logical process.
+     * \param [in] nLps The number of logical processes of the simulation.
+     */
+    LogicalProcess(uint32_t id, uint32_t nLps);
+    /** Destructor, releasing the pending events. */
+    ~LogicalProcess();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    LogicalProcess(const LogicalProcess&) = delete;
+    LogicalProcess& operator=(const LogicalProcess&) = delete;
+
+    /** \returns The index of the logical process. */
+    uint32_t GetId() const;
+
+    /**
+     * Set the event list, moving the pending events to it.
+     *
+     * \param [in] scheduler The event list.
+     */
+    void SetScheduler(Ptr<Scheduler> scheduler);
+    /**
+     * Set the clock of a logical process which has not run yet.
+     *
+     * \param [in] ts The current timestamp.
+     * \param [in] uid The uid of the next event scheduled.
+     */
+    void SetClock(uint64_t ts, uint32_t uid);
+
+    /**
+     * Schedule an event.
+     *
+     * \param [in] ts The expiry timestamp, not before the current one.
+     * \param [in] context The context of the event.
+     * \param [in] event The event.
+     * \returns The id of the event.
+     */
+    EventId Schedule(uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Insert an event scheduled by another logical process, keeping its
+     * uid.
+     *
+     * \param [in] ev The event.
+     */
+    void Insert(const Scheduler::Event& ev);
+    /**
+     * Remove the earliest event.
+     *
+     * \returns The event.
+     */
+    Scheduler::Event RemoveNext();
+    /**
+     * Remove an event before its expiry.
+     *
+     * \param [in] id The event.
+     */
+    void Remove(const EventId& id);
+    /**
+     * \param [in] id The event.
+     * \returns \c true if the event has expired, or was cancelled.
+     */
+    bool IsExpired(const EventId& id) const;
+
+    /**
+     * Send an event to another logical process, for the next round.
+     *
+     * \param [in] destination The destination logical process.
+     * \param [in] ts The expiry timestamp.
+     * \param [in] context The context of the event.
+     * \param [in] event The event.
+     */
+    void Send(uint32_t destination, uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Schedule the events sent by the other logical processes in a round.
+     *
+     * \param [in] lps The logical processes, by index.
+     * \param [in] parity The parity of the round the events were sent in.
+     */
+    void Receive(const std::vector<LogicalProcess*>& lps, uint32_t parity);
+    /**
+     * Run a round: receive the events sent in the previous round, then
+     * execute the events which expire before the end of the window.
+     *
+     * \param [in] lps The logical processes, by index.
+     * \param [in] round The round number.
+     * \param [in] window The end of the window, excluded.
+     */
+    void ProcessWindow(const std::vector<LogicalProcess*>& lps, uint64_t round, uint64_t window);
+    /** Execute the earliest event. */
+    void ProcessOneEvent();
+
+    /** \returns The expiry timestamp of the earliest event, or the maximum. */
+    uint64_t GetNextTs() const;
+    /**
+     * \returns The earliest expiry timestamp of the events sent since the
+     * start of the last round, or the maximum.
+     */
+    uint64_t GetMinSentTs() const;
+    /** \returns The current timestamp. */
+    uint64_t GetCurrentTs() const;
+    /** \returns The context of the current event. */
+    uint32_t GetContext() const;
+    /** \returns The uid of the next event scheduled. */
+    uint32_t GetUid() const;
+    /** \returns The number of events executed. */
+    uint64_t GetEventCount() const;
+
+  private:
+    /** An event sent to another logical process. */
+    struct Message
+    {
+        uint64_t ts;      //!< The expiry timestamp.
+        uint32_t context; //!< The context.
+        EventImpl* event; //!< The event.
+    };
+
+    /** Release the events of the mailboxes. */
+    void ClearMailboxes();
+
+    uint32_t m_id;             //!< The index of the logical process.
+    Ptr<Scheduler> m_events;   //!< The event list.
+    uint64_t m_currentTs;      //!< The timestamp of the current event.
+    uint32_t m_currentContext; //!< The context of the current event.
+    uint32_t m_currentUid;     //!< The uid of the current event.
+    uint32_t m_uid;            //!< The uid of the next event scheduled.
+    uint64_t m_eventCount;     //!< The number of events executed.
+    uint32_t m_parity;         //!< The parity of the current round.
+    uint64_t m_minSentTs;      //!< The earliest event sent in the current round.
+    /** The mailboxes, by round parity and destination. */
+    std::vector<std::vector<Message>> m_mailboxes[2];
+};
+
+inline uint32_t
+LogicalProcess::GetId() const
+{
+    return m_id;
+}
+
+inline uint64_t
+LogicalProcess::GetCurrentTs() const
+{
+    return m_currentTs;
+}
+
+inline uint32_t
+LogicalProcess::GetContext() const
+{
+    return m_currentContext;
+}
+
+inline uint32_t
+LogicalProcess::GetUid() const
+{
+    return m_uid;
+}
+
+inline uint64_t
+LogicalProcess::GetEventCount() const
+{
+    return m_eventCount;
+}
+
+inline uint64_t
+LogicalProcess::GetMinSentTs() const
+{
+    return m_minSentTs;
+}
+
+} // namespace ns3
+
+#endif /* LOGICAL_PROCESS_H */
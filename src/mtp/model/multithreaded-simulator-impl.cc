@@ -0,0 +1,523 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/assert.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+/** Spins of a thread waiting at the barrier before it yields. */
+static const uint32_t MTP_SPINS_BEFORE_YIELD = 1000;
+
+/** The logical process run by the calling thread, during a round. */
+static thread_local LogicalProcess* g_currentLp = nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The maximum number of threads running the logical processes, "
+                          "with the main one; 0 for the number of hardware threads.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_lookahead(std::numeric_limits<uint64_t>::max()),
+      m_eventCount(0),
+      m_maxThreads(0),
+      m_round(0),
+      m_window(0),
+      m_nextLp(0),
+      m_done(0),
+      m_exit(false),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this);
+    m_lps.push_back(new LogicalProcess(0, 1));
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::NotifyConstructionCompleted()
+{
+    NS_LOG_FUNCTION(this);
+    SimulatorImpl::NotifyConstructionCompleted();
+    // The worker threads enable their own pools
+    EventImpl::SetPoolEnabled(true);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (LogicalProcess* lp : m_lps)
+    {
+        delete lp;
+    }
+    m_lps.clear();
+    // Events still referenced elsewhere are freed to the general purpose
+    // allocator from now on.
+    EventImpl::SetPoolEnabled(false);
+    EventImpl::PurgePool();
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (true)
+    {
+        Ptr<EventImpl> ev;
+        {
+            std::unique_lock lock{m_destroyMutex};
+            if (m_destroyEvents.empty())
+            {
+                break;
+            }
+            ev = m_destroyEvents.front().PeekEventImpl();
+            m_destroyEvents.pop_front();
+        }
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+    for (LogicalProcess* lp : m_lps)
+    {
+        lp->SetScheduler(m_schedulerFactory.Create<Scheduler>());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition(const std::vector<uint32_t>& partition, Time lookahead)
+{
+    NS_LOG_FUNCTION(this << partition.size() << lookahead);
+    NS_ASSERT_MSG(m_workers.empty(), "The partition cannot change during Run()");
+    NS_ASSERT_MSG(lookahead.IsStrictlyPositive(), "The lookahead must be positive");
+
+    uint32_t nLps = 1;
+    for (uint32_t lp : partition)
+    {
+        nLps = std::max(nLps, lp + 1);
+    }
+
+    // The events keep their uids, which stay unique in the new logical
+    // processes as these start from the largest uid
+    std::vector<Scheduler::Event> events;
+    uint64_t ts = 0;
+    uint32_t uid = EventId::UID::VALID;
+    for (LogicalProcess* lp : m_lps)
+    {
+        while (lp->GetNextTs() != std::numeric_limits<uint64_t>::max())
+        {
+            events.push_back(lp->RemoveNext());
+        }
+        ts = std::max(ts, lp->GetCurrentTs());
+        uid = std::max(uid, lp->GetUid());
+        m_eventCount += lp->GetEventCount();
+        delete lp;
+    }
+    m_lps.clear();
+    for (uint32_t i = 0; i < nLps; i++)
+    {
+        LogicalProcess* lp = new LogicalProcess(i, nLps);
+        lp->SetScheduler(m_schedulerFactory.Create<Scheduler>());
+        lp->SetClock(ts, uid);
+        m_lps.push_back(lp);
+    }
+
+    m_partition = partition;
+    m_lookahead = lookahead.GetTimeStep();
+    for (const Scheduler::Event& ev : events)
+    {
+        GetOwner(ev.key.m_context)->Insert(ev);
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetLogicalProcessCount() const
+{
+    return m_lps.size();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return TimeStep(std::min<uint64_t>(m_lookahead, std::numeric_limits<int64_t>::max()));
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetRoundCount() const
+{
+    return m_round;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+LogicalProcess*
+MultithreadedSimulatorImpl::GetCurrent() const
+{
+    return g_currentLp ? g_currentLp : m_lps[0];
+}
+
+LogicalProcess*
+MultithreadedSimulatorImpl::GetOwner(uint32_t context) const
+{
+    return context < m_partition.size() ? m_lps[m_partition[context]] : m_lps[0];
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    for (LogicalProcess* lp : m_lps)
+    {
+        if (lp->GetNextTs() != std::numeric_limits<uint64_t>::max() ||
+            lp->GetMinSentTs() != std::numeric_limits<uint64_t>::max())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessLogicalProcesses()
+{
+    uint32_t i;
+    while ((i = m_nextLp.fetch_add(1)) < m_lps.size())
+    {
+        g_currentLp = m_lps[i];
+        g_currentLp->ProcessWindow(m_lps, m_round, m_window);
+    }
+    g_currentLp = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::Worker(uint64_t round)
+{
+    EventImpl::SetPoolEnabled(true);
+    while (true)
+    {
+        uint32_t spins = 0;
+        while (m_round.load(std::memory_order_acquire) == round &&
+               !m_exit.load(std::memory_order_acquire))
+        {
+            if (++spins > MTP_SPINS_BEFORE_YIELD)
+            {
+                std::this_thread::yield();
+            }
+        }
+        if (m_exit.load(std::memory_order_acquire))
+        {
+            break;
+        }
+        round = m_round;
+        ProcessLogicalProcesses();
+        m_done.fetch_add(1, std::memory_order_release);
+    }
+    EventImpl::SetPoolEnabled(false);
+    EventImpl::PurgePool();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessRound()
+{
+    // The global logical process is not run in the rounds
+    m_nextLp.store(1);
+    m_done.store(0);
+    m_round.fetch_add(1, std::memory_order_release);
+    ProcessLogicalProcesses();
+    uint32_t spins = 0;
+    while (m_done.load(std::memory_order_acquire) < m_workers.size())
+    {
+        if (++spins > MTP_SPINS_BEFORE_YIELD)
+        {
+            std::this_thread::yield();
+        }
+    }
+    // The events sent to the global logical process in the round
+    m_lps[0]->Receive(m_lps, m_round & 1);
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = false;
+    uint32_t nThreads = m_maxThreads ? m_maxThreads : std::thread::hardware_concurrency();
+    nThreads = std::max<uint32_t>(1, std::min<uint32_t>(nThreads, m_lps.size() - 1));
+    NS_LOG_INFO(m_lps.size() - 1 << " logical processes, " << nThreads << " threads");
+    m_exit = false;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        m_workers.emplace_back(&MultithreadedSimulatorImpl::Worker, this, m_round.load());
+    }
+
+    const uint64_t never = std::numeric_limits<uint64_t>::max();
+    LogicalProcess* global = m_lps[0];
+    while (!m_stop)
+    {
+        uint64_t next = never;
+        for (uint32_t i = 1; i < m_lps.size(); i++)
+        {
+            next = std::min({next, m_lps[i]->GetNextTs(), m_lps[i]->GetMinSentTs()});
+        }
+        uint64_t globalNext = global->GetNextTs();
+        if (next == never && globalNext == never)
+        {
+            break;
+        }
+        if (globalNext <= next)
+        {
+            // The global events may access any node, so they run alone
+            global->ProcessOneEvent();
+            continue;
+        }
+        m_window = std::min(next > never - m_lookahead ? never : next + m_lookahead, globalNext);
+        ProcessRound();
+    }
+
+    m_exit.store(true, std::memory_order_release);
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+
+    // Leave the clock of the main program at the latest event executed
+    uint64_t ts = 0;
+    for (LogicalProcess* lp : m_lps)
+    {
+        ts = std::max(ts, lp->GetCurrentTs());
+    }
+    global->SetClock(ts, global->GetUid());
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+    LogicalProcess* lp = GetCurrent();
+    return lp->Schedule(lp->GetCurrentTs() + delay.GetTimeStep(), lp->GetContext(), event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_ASSERT_MSG(delay.IsPositive(),
+                  "MultithreadedSimulatorImpl::ScheduleWithContext(): Negative delay");
+    LogicalProcess* lp = GetCurrent();
+    LogicalProcess* owner = GetOwner(context);
+    uint64_t ts = lp->GetCurrentTs() + delay.GetTimeStep();
+    if (owner == lp || !g_currentLp)
+    {
+        // Outside the rounds, the other logical processes are idle
+        owner->Schedule(ts, context, event);
+        return;
+    }
+    if (static_cast<uint64_t>(delay.GetTimeStep()) < m_lookahead)
+    {
+        NS_FATAL_ERROR("Event scheduled from context " << lp->GetContext() << " for context "
+                                                       << context << " after " << delay
+                                                       << ", less than the lookahead "
+                                                       << GetLookahead());
+    }
+    lp->Send(owner->GetId(), ts, context, event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    EventId id(Ptr<EventImpl>(event, false), GetCurrent()->GetCurrentTs(), 0xffffffff, 2);
+    std::unique_lock lock{m_destroyMutex};
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrent()->GetCurrentTs());
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - GetCurrent()->GetCurrentTs());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_destroyMutex};
+        for (DestroyEvents::iterator i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    LogicalProcess* owner = GetOwner(id.GetContext());
+    NS_ASSERT_MSG(owner == GetCurrent() || !g_currentLp,
+                  "Event of another logical process removed");
+    owner->Remove(id);
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{m_destroyMutex};
+        for (DestroyEvents::const_iterator i = m_destroyEvents.begin(); i != m_destroyEvents.end();
+             i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    return GetOwner(id.GetContext())->IsExpired(id);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrent()->GetContext();
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = m_eventCount;
+    for (LogicalProcess* lp : m_lps)
+    {
+        count += lp->GetEventCount();
+    }
+    return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,181 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "logical-process.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup mtp
+ * \brief Conservative parallel simulator running the partitions of a
+ * simulation in threads of a single process.
+ *
+ * The nodes are assigned to logical processes by SetPartition(),
+ * usually through MtpHelper.  Each logical process has its own event
+ * list; an event belongs to the logical process of the node of its
+ * context.  The events without a node context, such as the ones scheduled
+ * by the main program, belong to the global logical process.
+ *
+ * The simulation advances in rounds.  In each round, the logical
+ * processes execute, in parallel, their events which expire before the end
+ * of a window, which is the earliest pending event plus the lookahead:
+ * the smallest delay of the links between logical processes.  Any event a
+ * logical process schedules for another one therefore expires after the
+ * window; it is sent through a mailbox and received at the start of the
+ * next round.  The global events are executed alone, between rounds, so
+ * they may access any node.
+ *
+ * The order of the events of a logical process only depends on the
+ * partition, not on the number of threads or their timings.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Assign the nodes to logical processes, moving the pending events to
+     * the logical processes of their nodes.  This must be done before
+     * Run().
+     *
+     * \param [in] partition The logical process of each node, by node id,
+     * from 1; 0, or a missing entry, for the global logical process.
+     * \param [in] lookahead The smallest delay of the events scheduled by
+     * a logical process for another one.
+     */
+    void SetPartition(const std::vector<uint32_t>& partition, Time lookahead);
+    /** \returns The number of logical processes, with the global one. */
+    uint32_t GetLogicalProcessCount() const;
+    /** \returns The lookahead. */
+    Time GetLookahead() const;
+    /** \returns The number of rounds run in parallel. */
+    uint64_t GetRoundCount() const;
+
+  private:
+    void NotifyConstructionCompleted() override;
+    void DoDispose() override;
+
+    /**
+     * \returns The logical process of the calling thread, or the global
+     * one outside the rounds.
+     */
+    LogicalProcess* GetCurrent() const;
+    /**
+     * \param [in] context A context.
+     * \returns The logical process of the context.
+     */
+    LogicalProcess* GetOwner(uint32_t context) const;
+    /** Run a round in the calling thread and the worker threads. */
+    void ProcessRound();
+    /** Process logical processes of the current round until none is left. */
+    void ProcessLogicalProcesses();
+    /**
+     * The loop of a worker thread.
+     *
+     * \param [in] round The last round run before the thread started.
+     */
+    void Worker(uint64_t round);
+
+    /** The logical processes; the global one first. */
+    std::vector<LogicalProcess*> m_lps;
+    /** The logical process of each context. */
+    std::vector<uint32_t> m_partition;
+    /** The lookahead, in time steps. */
+    uint64_t m_lookahead;
+    /** The scheduler of the logical processes. */
+    ObjectFactory m_schedulerFactory;
+    /** The events executed by the logical processes before SetPartition(). */
+    uint64_t m_eventCount;
+    /** The maximum number of threads. */
+    uint32_t m_maxThreads;
+
+    /** The worker threads, during Run(). */
+    std::vector<std::thread> m_workers;
+    /** The current round, incremented to start a round. */
+    std::atomic<uint64_t> m_round;
+    /** The end of the window of the current round, excluded. */
+    uint64_t m_window;
+    /** The next logical process to process in the current round. */
+    std::atomic<uint32_t> m_nextLp;
+    /** The number of worker threads done with the current round. */
+    std::atomic<uint32_t> m_done;
+    /** Whether the worker threads must exit. */
+    std::atomic<bool> m_exit;
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+
+    /** Container type for the events to run at Simulator::Destroy(). */
+    typedef std::list<EventId> DestroyEvents;
+    /** The events to run at Simulator::Destroy(). */
+    DestroyEvents m_destroyEvents;
+    /** Mutex of the events to run at Simulator::Destroy(). */
+    mutable std::mutex m_destroyMutex;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,287 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/global-value.h"
+#include "ns3/mtp-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests mtp module tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Check the graph partitioning and the lookahead.
+ */
+class MtpPartitionTestCase : public TestCase
+{
+  public:
+    MtpPartitionTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MtpPartitionTestCase::MtpPartitionTestCase()
+    : TestCase("Check the partitioning of a chain of nodes")
+{
+}
+
+void
+MtpPartitionTestCase::DoRun()
+{
+    // n0 - n1 - n2 = n3 - n4 - n5, with a link without delay between n2
+    // and n3, which cannot be cut
+    NodeContainer nodes;
+    nodes.Create(6);
+    PointToPointHelper p2p;
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        std::string delay = i == 2 ? "0ms" : std::to_string(i + 1) + "ms";
+        p2p.SetChannelAttribute("Delay", StringValue(delay));
+        p2p.Install(nodes.Get(i), nodes.Get(i + 1));
+    }
+
+    std::vector<NodeContainer> partitions = MtpHelper::Partition(nodes, 2);
+    NS_TEST_ASSERT_MSG_EQ(partitions.size(), 2, "Wrong number of partitions");
+    NS_TEST_ASSERT_MSG_EQ(partitions[0].GetN() + partitions[1].GetN(), 6, "Nodes lost");
+    NS_TEST_ASSERT_MSG_GT(partitions[0].GetN(), 1, "Unbalanced partitions");
+    NS_TEST_ASSERT_MSG_GT(partitions[1].GetN(), 1, "Unbalanced partitions");
+    bool together = false;
+    for (const NodeContainer& partition : partitions)
+    {
+        together |= partition.Contains(2) && partition.Contains(3);
+    }
+    NS_TEST_ASSERT_MSG_EQ(together, true, "Link without delay cut");
+
+    // A single link is cut, its delay is the lookahead
+    Time lookahead = MtpHelper::GetLookahead(partitions);
+    NS_TEST_ASSERT_MSG_EQ((lookahead == MilliSeconds(2) || lookahead == MilliSeconds(4)),
+                          true,
+                          "Wrong lookahead " << lookahead);
+    NS_TEST_ASSERT_MSG_EQ(MtpHelper::GetLookahead({nodes}), Time::Max(), "Link cut");
+    NS_TEST_ASSERT_MSG_EQ(MtpHelper::GetLookahead({NodeContainer(nodes.Get(0), nodes.Get(1)),
+                                                   NodeContainer(nodes.Get(2),
+                                                                 nodes.Get(3),
+                                                                 nodes.Get(4),
+                                                                 nodes.Get(5))}),
+                          MilliSeconds(2),
+                          "Wrong lookahead");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Check that a multithreaded run executes the same events as a
+ * sequential one.
+ *
+ * Packets bounce along a chain of nodes, each node forwarding the packets
+ * it receives, 100 bytes shorter, until they are too short.
+ */
+class MtpRunTestCase : public TestCase
+{
+  public:
+    MtpRunTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** The packets received by a node: receive time and size. */
+    typedef std::vector<std::pair<Time, uint32_t>> Receptions;
+
+    /**
+     * Run the simulation.
+     *
+     * \param [in] threads The number of threads; 0 for a sequential run.
+     * \returns The packets received, by node.
+     */
+    std::vector<Receptions> RunSimulation(uint32_t threads);
+    /**
+     * Receive a packet.
+     *
+     * \param [in] device The device receiving the packet.
+     * \param [in] packet The packet.
+     * \param [in] protocol The protocol number.
+     * \param [in] from The sender address.
+     * \returns \c true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    /** The packets received by each node of the current run. */
+    std::vector<Receptions> m_receptions;
+    /** The id of the first node of the current run. */
+    uint32_t m_firstNode;
+};
+
+MtpRunTestCase::MtpRunTestCase()
+    : TestCase("Check a multithreaded run against a sequential one")
+{
+}
+
+bool
+MtpRunTestCase::Receive(Ptr<NetDevice> device,
+                        Ptr<const Packet> packet,
+                        uint16_t protocol,
+                        const Address& from)
+{
+    Ptr<Node> node = device->GetNode();
+    m_receptions[node->GetId() - m_firstNode].emplace_back(Simulator::Now(), packet->GetSize());
+    if (packet->GetSize() > 100)
+    {
+        // Forward away from the sender, if possible
+        Ptr<NetDevice> out = node->GetDevice(node->GetNDevices() - 1);
+        if (out == device)
+        {
+            out = node->GetDevice(0);
+        }
+        out->Send(Create<Packet>(packet->GetSize() - 100), out->GetBroadcast(), protocol);
+    }
+    return true;
+}
+
+std::vector<MtpRunTestCase::Receptions>
+MtpRunTestCase::RunSimulation(uint32_t threads)
+{
+    if (threads)
+    {
+        MtpHelper::Enable(threads);
+    }
+
+    const uint32_t nNodes = 8;
+    NodeContainer nodes;
+    nodes.Create(nNodes);
+    m_firstNode = nodes.Get(0)->GetId();
+    m_receptions.assign(nNodes, Receptions());
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("1ms"));
+    for (uint32_t i = 0; i + 1 < nNodes; i++)
+    {
+        NetDeviceContainer devices = p2p.Install(nodes.Get(i), nodes.Get(i + 1));
+        for (uint32_t j = 0; j < devices.GetN(); j++)
+        {
+            devices.Get(j)->SetReceiveCallback(MakeCallback(&MtpRunTestCase::Receive, this));
+        }
+    }
+
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        Ptr<NetDevice> device = nodes.Get(i)->GetDevice(0);
+        for (uint32_t j = 0; j < 10; j++)
+        {
+            Simulator::ScheduleWithContext(
+                nodes.Get(i)->GetId(),
+                MicroSeconds(137 * i + 1000 * j),
+                [device, i, j]() {
+                    device->Send(Create<Packet>(500 + 100 * ((i + j) % 5)),
+                                 device->GetBroadcast(),
+                                 0x0800);
+                });
+        }
+    }
+
+    if (threads)
+    {
+        MtpHelper::Install(nodes, 4);
+        Ptr<MultithreadedSimulatorImpl> impl =
+            DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+        NS_TEST_EXPECT_MSG_EQ(impl->GetLogicalProcessCount(), 5, "Wrong number of partitions");
+        NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), MilliSeconds(1), "Wrong lookahead");
+    }
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    if (threads)
+    {
+        Ptr<MultithreadedSimulatorImpl> impl =
+            DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+        NS_TEST_EXPECT_MSG_GT(impl->GetRoundCount(), 0, "No rounds run in parallel");
+    }
+    Simulator::Destroy();
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    return m_receptions;
+}
+
+void
+MtpRunTestCase::DoRun()
+{
+    std::vector<Receptions> sequential = RunSimulation(0);
+    std::vector<Receptions> parallel = RunSimulation(3);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < sequential.size(); i++)
+    {
+        // The simultaneous receptions of a node may be in another order
+        std::sort(sequential[i].begin(), sequential[i].end());
+        std::sort(parallel[i].begin(), parallel[i].end());
+        NS_TEST_ASSERT_MSG_EQ(parallel[i].size(),
+                              sequential[i].size(),
+                              "Wrong number of packets received by node " << i);
+        for (uint32_t j = 0; j < sequential[i].size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(parallel[i][j].first,
+                                  sequential[i][j].first,
+                                  "Wrong reception time at node " << i);
+            NS_TEST_ASSERT_MSG_EQ(parallel[i][j].second,
+                                  sequential[i][j].second,
+                                  "Wrong packet size at node " << i);
+        }
+        count += sequential[i].size();
+    }
+    NS_TEST_ASSERT_MSG_GT(count, 100, "Too few packets received");
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief The MultithreadedSimulatorImpl TestSuite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite()
+        : TestSuite("mtp", UNIT)
+    {
+        AddTestCase(new MtpPartitionTestCase, TestCase::QUICK);
+        AddTestCase(new MtpRunTestCase, TestCase::QUICK);
+    }
+};
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
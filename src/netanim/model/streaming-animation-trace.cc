@@ -0,0 +1,597 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "streaming-animation-trace.h"
+
+#include "animation-interface.h"
+
+#include "ns3/abort.h"
+#include "ns3/channel.h"
+#include "ns3/config.h"
+#include "ns3/hash.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("StreamingAnimationTrace");
+
+namespace
+{
+
+/** Magic at the start of a trace */
+const char TRACE_MAGIC[4] = {'C', 'T', 'S', 'A'};
+/** Version of the trace format */
+const uint8_t TRACE_VERSION = 1;
+/** Spacing of the nodes without a mobility model */
+const double GRID_SPACING = 10;
+/** PPP protocol number of IPv4 */
+const uint16_t PPP_IPV4 = 0x0021;
+/** PPP protocol number of IPv6 */
+const uint16_t PPP_IPV6 = 0x0057;
+
+/**
+ * Sequential reader of a binary trace.
+ */
+class TraceReader
+{
+  public:
+    /**
+     * \param f The trace file
+     */
+    TraceReader(std::FILE* f)
+        : m_f(f),
+          m_fail(false)
+    {
+    }
+
+    /**
+     * \param [out] type The record type
+     * \returns false at the end of the file
+     */
+    bool ReadType(uint8_t& type)
+    {
+        int c = std::getc(m_f);
+        type = static_cast<uint8_t>(c);
+        return c != EOF;
+    }
+
+    /**
+     * \returns The next LEB128 integer
+     */
+    uint64_t ReadVarint()
+    {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            int c = std::getc(m_f);
+            if (c == EOF)
+            {
+                m_fail = true;
+                return 0;
+            }
+            value |= static_cast<uint64_t>(c & 0x7f) << shift;
+            if ((c & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        m_fail = true;
+        return 0;
+    }
+
+    /**
+     * \returns The next little endian double
+     */
+    double ReadDouble()
+    {
+        uint8_t bytes[8];
+        if (std::fread(bytes, 1, 8, m_f) != 8)
+        {
+            m_fail = true;
+            return 0;
+        }
+        uint64_t bits = 0;
+        for (int i = 7; i >= 0; i--)
+        {
+            bits = (bits << 8) | bytes[i];
+        }
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * \param size The size of the string
+     * \returns The next string
+     */
+    std::string ReadString(uint64_t size)
+    {
+        std::string s(size, '\0');
+        if (size > 0 && std::fread(&s[0], 1, size, m_f) != size)
+        {
+            m_fail = true;
+        }
+        return s;
+    }
+
+    /**
+     * \returns true if the trace is truncated or corrupted
+     */
+    bool Fail() const
+    {
+        return m_fail;
+    }
+
+  private:
+    std::FILE* m_f; //!< The trace file
+    bool m_fail;    //!< A read failed
+};
+
+/**
+ * \param os The stream
+ * \param t A time, in nanoseconds
+ */
+void
+WriteSeconds(std::ostream& os, int64_t t)
+{
+    os << t / 1e9;
+}
+
+} // namespace
+
+StreamingAnimationTrace::StreamingAnimationTrace(const std::string& filename,
+                                                 const std::set<uint32_t>& nodes)
+    : m_sampleEvery(1),
+      m_sampleMode(SAMPLE_PACKETS),
+      m_startTime(Seconds(0)),
+      m_stopTime(Time::Max()),
+      m_nResources(0),
+      m_lastTime(0),
+      m_packets(0)
+{
+    NS_LOG_FUNCTION(this << filename);
+    NS_ABORT_MSG_UNLESS(m_writer.Open(filename), "Cannot open animation trace " << filename);
+    m_writer.Write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    m_writer.Write(&TRACE_VERSION, 1);
+    if (!nodes.empty())
+    {
+        m_nodes.resize(*nodes.rbegin() + 1, false);
+        for (uint32_t node : nodes)
+        {
+            m_nodes[node] = true;
+        }
+    }
+    WriteTopology();
+    Config::ConnectWithoutContextFailSafe(
+        "/ChannelList/*/TxRxPointToPoint",
+        MakeCallback(&StreamingAnimationTrace::DevTxTrace, this));
+}
+
+StreamingAnimationTrace::~StreamingAnimationTrace()
+{
+    NS_LOG_FUNCTION(this);
+    m_writer.Close();
+    NS_LOG_INFO("Animation trace closed: " << m_packets << " packets, " << m_writer.GetSize()
+                                           << " bytes");
+}
+
+void
+StreamingAnimationTrace::SetSampling(uint32_t every, SamplingMode mode)
+{
+    NS_LOG_FUNCTION(this << every << mode);
+    NS_ABORT_MSG_IF(every == 0, "The sampling ratio must be positive");
+    m_sampleEvery = every;
+    m_sampleMode = mode;
+}
+
+void
+StreamingAnimationTrace::SetStartTime(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_startTime = start;
+}
+
+void
+StreamingAnimationTrace::SetStopTime(Time stop)
+{
+    NS_LOG_FUNCTION(this << stop);
+    m_stopTime = stop;
+}
+
+uint32_t
+StreamingAnimationTrace::AddResource(const std::string& resourcePath)
+{
+    NS_LOG_FUNCTION(this << resourcePath);
+    uint8_t type = 'R';
+    m_writer.Write(&type, 1);
+    WriteVarint(m_nResources);
+    WriteVarint(resourcePath.size());
+    m_writer.Write(resourcePath.data(), resourcePath.size());
+    return m_nResources++;
+}
+
+void
+StreamingAnimationTrace::UpdateNodeSize(uint32_t nodeId, double width, double height)
+{
+    NS_LOG_FUNCTION(this << nodeId << width << height);
+    if (!IsTraced(nodeId))
+    {
+        return;
+    }
+    WriteTimedRecord('S');
+    WriteVarint(nodeId);
+    WriteDouble(width);
+    WriteDouble(height);
+}
+
+void
+StreamingAnimationTrace::UpdateNodeImage(uint32_t nodeId, uint32_t resourceId)
+{
+    NS_LOG_FUNCTION(this << nodeId << resourceId);
+    NS_ASSERT_MSG(resourceId < m_nResources, "Unknown resource " << resourceId);
+    if (!IsTraced(nodeId))
+    {
+        return;
+    }
+    WriteTimedRecord('I');
+    WriteVarint(nodeId);
+    WriteVarint(resourceId);
+}
+
+uint64_t
+StreamingAnimationTrace::GetTracedPackets() const
+{
+    return m_packets;
+}
+
+uint64_t
+StreamingAnimationTrace::GetTraceSize() const
+{
+    return m_writer.GetSize();
+}
+
+bool
+StreamingAnimationTrace::IsTraced(uint32_t node) const
+{
+    return m_nodes.empty() || (node < m_nodes.size() && m_nodes[node]);
+}
+
+bool
+StreamingAnimationTrace::IsSampled(Ptr<const Packet> p) const
+{
+    if (m_sampleEvery == 1)
+    {
+        return true;
+    }
+    if (m_sampleMode == SAMPLE_FLOWS)
+    {
+        // PPP header, then the IP header, options or names included, and the
+        // first 4 bytes of the transport header
+        static const uint32_t ipv4HeaderSize = Ipv4Header().GetSerializedSize();
+        uint8_t buf[2 + 60 + 4];
+        uint32_t size = p->CopyData(buf, sizeof(buf));
+        uint16_t protocol = size >= 2 ? (buf[0] << 8) | buf[1] : 0;
+        const uint8_t* ip = buf + 2;
+        const uint8_t* src = nullptr;
+        const uint8_t* dst = nullptr;
+        uint32_t addressSize = 0;
+        uint32_t l4 = 0;
+        uint8_t l4Protocol = 0;
+        if (protocol == PPP_IPV4 && size >= 2 + 20)
+        {
+            addressSize = 4;
+            src = ip + 12;
+            dst = ip + 16;
+            l4Protocol = ip[9];
+            // the names of name-first routing follow the fixed header
+            l4 = 2 + std::max<uint32_t>((ip[0] & 0x0f) * 4, ipv4HeaderSize);
+        }
+        else if (protocol == PPP_IPV6 && size >= 2 + 40)
+        {
+            addressSize = 16;
+            src = ip + 8;
+            dst = ip + 24;
+            l4Protocol = ip[6];
+            l4 = 2 + 40;
+        }
+        if (src)
+        {
+            // the ports of TCP and UDP, zero for the other protocols
+            uint8_t srcEnd[16 + 2] = {};
+            uint8_t dstEnd[16 + 2] = {};
+            std::memcpy(srcEnd, src, addressSize);
+            std::memcpy(dstEnd, dst, addressSize);
+            if ((l4Protocol == 6 || l4Protocol == 17) && size >= l4 + 4)
+            {
+                std::memcpy(srcEnd + addressSize, buf + l4, 2);
+                std::memcpy(dstEnd + addressSize, buf + l4 + 2, 2);
+            }
+            // both directions of a flow are sampled together
+            uint32_t endSize = addressSize + 2;
+            if (std::memcmp(srcEnd, dstEnd, endSize) > 0)
+            {
+                std::swap(srcEnd, dstEnd);
+            }
+            char key[1 + 2 * (16 + 2)];
+            key[0] = static_cast<char>(l4Protocol);
+            std::memcpy(key + 1, srcEnd, endSize);
+            std::memcpy(key + 1 + endSize, dstEnd, endSize);
+            return Hash32(key, 1 + 2 * endSize) % m_sampleEvery == 0;
+        }
+    }
+    return p->GetUid() % m_sampleEvery == 0;
+}
+
+void
+StreamingAnimationTrace::WriteTopology()
+{
+    NS_LOG_FUNCTION(this);
+    // the nodes without a mobility model go on a grid rather than at
+    // random positions, which would draw from the random streams
+    uint32_t columns = std::max<uint32_t>(1, std::ceil(std::sqrt(NodeList::GetNNodes())));
+    for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
+    {
+        Ptr<Node> n = *i;
+        if (!IsTraced(n->GetId()))
+        {
+            continue;
+        }
+        Vector v(GRID_SPACING * (n->GetId() % columns), GRID_SPACING * (n->GetId() / columns), 0);
+        Ptr<MobilityModel> mobility = n->GetObject<MobilityModel>();
+        if (mobility)
+        {
+            v = mobility->GetPosition();
+        }
+        uint8_t type = 'N';
+        m_writer.Write(&type, 1);
+        WriteVarint(n->GetId());
+        WriteVarint(n->GetSystemId());
+        WriteDouble(v.x);
+        WriteDouble(v.y);
+    }
+    for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
+    {
+        Ptr<Node> n = *i;
+        for (uint32_t d = 0; d < n->GetNDevices(); d++)
+        {
+            Ptr<Channel> ch = n->GetDevice(d)->GetChannel();
+            if (!ch || ch->GetInstanceTypeId().GetName() != "ns3::PointToPointChannel")
+            {
+                continue;
+            }
+            // the links are duplex, write them once
+            for (std::size_t j = 0; j < ch->GetNDevices(); j++)
+            {
+                uint32_t peer = ch->GetDevice(j)->GetNode()->GetId();
+                if (n->GetId() < peer && IsTraced(n->GetId()) && IsTraced(peer))
+                {
+                    uint8_t type = 'L';
+                    m_writer.Write(&type, 1);
+                    WriteVarint(n->GetId());
+                    WriteVarint(peer);
+                }
+            }
+        }
+    }
+}
+
+void
+StreamingAnimationTrace::WriteTimedRecord(uint8_t type)
+{
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    m_writer.Write(&type, 1);
+    WriteVarint(now - m_lastTime);
+    m_lastTime = now;
+}
+
+void
+StreamingAnimationTrace::WriteVarint(uint64_t value)
+{
+    uint8_t buf[10];
+    uint32_t size = 0;
+    do
+    {
+        buf[size] = value & 0x7f;
+        value >>= 7;
+        if (value != 0)
+        {
+            buf[size] |= 0x80;
+        }
+        size++;
+    } while (value != 0);
+    m_writer.Write(buf, size);
+}
+
+void
+StreamingAnimationTrace::WriteDouble(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint8_t buf[8];
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        buf[i] = (bits >> (8 * i)) & 0xff;
+    }
+    m_writer.Write(buf, sizeof(buf));
+}
+
+void
+StreamingAnimationTrace::DevTxTrace(Ptr<const Packet> p,
+                                    Ptr<NetDevice> tx,
+                                    Ptr<NetDevice> rx,
+                                    Time txTime,
+                                    Time rxTime)
+{
+    Time now = Simulator::Now();
+    if (now < m_startTime || now >= m_stopTime)
+    {
+        return;
+    }
+    uint32_t from = tx->GetNode()->GetId();
+    uint32_t to = rx->GetNode()->GetId();
+    if (!IsTraced(from) || !IsTraced(to) || !IsSampled(p))
+    {
+        return;
+    }
+    m_packets++;
+    WriteTimedRecord('P');
+    WriteVarint(from);
+    WriteVarint(to);
+    WriteVarint(txTime.GetNanoSeconds());
+    WriteVarint(rxTime.GetNanoSeconds());
+}
+
+bool
+StreamingAnimationTrace::ConvertToXml(const std::string& input,
+                                      const std::string& output,
+                                      Time start,
+                                      Time stop)
+{
+    NS_LOG_FUNCTION(input << output << start << stop);
+    std::FILE* in = std::fopen(input.c_str(), "rb");
+    if (in == nullptr)
+    {
+        return false;
+    }
+    std::FILE* out = std::fopen(output.c_str(), "w");
+    if (out == nullptr)
+    {
+        std::fclose(in);
+        return false;
+    }
+
+    char magic[sizeof(TRACE_MAGIC)];
+    uint8_t version = 0;
+    bool ok = std::fread(magic, 1, sizeof(magic), in) == sizeof(magic) &&
+              std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0 &&
+              std::fread(&version, 1, 1, in) == 1 && version == TRACE_VERSION;
+
+    int64_t startNs = start.GetNanoSeconds();
+    int64_t stopNs = stop.IsStrictlyPositive() ? stop.GetNanoSeconds() : INT64_MAX;
+    TraceReader reader(in);
+    std::ostringstream oss;
+    oss << std::setprecision(10);
+    oss << "<anim ver=\"" << NETANIM_VERSION << "\" filetype=\"animation\" >\n";
+    int64_t t = 0;
+    uint8_t type;
+    while (ok && t < stopNs && reader.ReadType(type))
+    {
+        switch (type)
+        {
+        case 'R': {
+            uint64_t id = reader.ReadVarint();
+            std::string path = reader.ReadString(reader.ReadVarint());
+            oss << "<res rid=\"" << id << "\" p=\"" << path << "\" />\n";
+            break;
+        }
+        case 'N': {
+            uint64_t id = reader.ReadVarint();
+            uint64_t sysId = reader.ReadVarint();
+            double x = reader.ReadDouble();
+            double y = reader.ReadDouble();
+            oss << "<node id=\"" << id << "\" sysId=\"" << sysId << "\" locX=\"" << x
+                << "\" locY=\"" << y << "\" />\n";
+            break;
+        }
+        case 'L': {
+            uint64_t from = reader.ReadVarint();
+            uint64_t to = reader.ReadVarint();
+            oss << "<link fromId=\"" << from << "\" toId=\"" << to
+                << "\" fd=\"\" td=\"\" ld=\"\" />\n";
+            break;
+        }
+        case 'S': {
+            t += reader.ReadVarint();
+            uint64_t id = reader.ReadVarint();
+            double w = reader.ReadDouble();
+            double h = reader.ReadDouble();
+            if (t >= stopNs)
+            {
+                break;
+            }
+            oss << "<nu p=\"s\" t=\"";
+            WriteSeconds(oss, t);
+            oss << "\" id=\"" << id << "\" w=\"" << w << "\" h=\"" << h << "\" />\n";
+            break;
+        }
+        case 'I': {
+            t += reader.ReadVarint();
+            uint64_t id = reader.ReadVarint();
+            uint64_t rid = reader.ReadVarint();
+            if (t >= stopNs)
+            {
+                break;
+            }
+            oss << "<nu p=\"i\" t=\"";
+            WriteSeconds(oss, t);
+            oss << "\" id=\"" << id << "\" rid=\"" << rid << "\" />\n";
+            break;
+        }
+        case 'P': {
+            t += reader.ReadVarint();
+            uint64_t from = reader.ReadVarint();
+            uint64_t to = reader.ReadVarint();
+            int64_t txTime = reader.ReadVarint();
+            int64_t rxTime = reader.ReadVarint();
+            // the node updates before the window are kept, they set the
+            // state of the nodes in the window
+            if (t < startNs || t >= stopNs)
+            {
+                break;
+            }
+            oss << "<p fId=\"" << from << "\" fbTx=\"";
+            WriteSeconds(oss, t);
+            oss << "\" lbTx=\"";
+            WriteSeconds(oss, t + txTime);
+            oss << "\" tId=\"" << to << "\" fbRx=\"";
+            WriteSeconds(oss, t + rxTime - txTime);
+            oss << "\" lbRx=\"";
+            WriteSeconds(oss, t + rxTime);
+            oss << "\" />\n";
+            break;
+        }
+        default:
+            ok = false;
+            break;
+        }
+        ok = ok && !reader.Fail();
+        if (oss.tellp() > (1 << 20))
+        {
+            std::string s = oss.str();
+            std::fwrite(s.data(), 1, s.size(), out);
+            oss.str("");
+        }
+    }
+    oss << "</anim>\n";
+    std::string s = oss.str();
+    ok = std::fwrite(s.data(), 1, s.size(), out) == s.size() && ok;
+    std::fclose(in);
+    ok = std::fclose(out) == 0 && ok;
+    return ok;
+}
+
+} // namespace ns3
@@ -0,0 +1,214 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compact binary animation trace, converted to NetAnim XML offline
+
+#ifndef STREAMING_ANIMATION_TRACE_H
+#define STREAMING_ANIMATION_TRACE_H
+
+#include "ns3/async-file-writer.h"
+#include "ns3/net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup netanim
+ *
+ * \brief Animation trace of the point-to-point links, in a compact binary
+ * format written by a background thread.
+ *
+ * AnimationInterface writes an XML element for every packet, which makes
+ * the trace of a large run several GB and slows it down.  This trace
+ * writes the same information as a few bytes per packet, through an
+ * AsyncFileWriter, and can keep only a sample of the packets, a time
+ * window and a subset of the nodes.  ConvertToXml turns a trace, or a
+ * window of it, into a file NetAnim reads.
+ *
+ * The file starts with the magic "CTSA" and a version byte, followed by
+ * records made of a type byte and unsigned LEB128 integers:
+ *
+ * - 'R' resource: id, path length, path
+ * - 'N' node: id, system id, x and y as IEEE 754 doubles, little endian
+ * - 'L' link: from node id, to node id
+ * - 'S' node size: time, node id, width and height as doubles
+ * - 'I' node image: time, node id, resource id
+ * - 'P' packet: time, from node id, to node id, transmission time,
+ *   reception time
+ *
+ * The times are in nanoseconds and relative to the time of the previous
+ * timed record; the transmission and reception times of a packet are
+ * relative to the start of its transmission, as in the TxRxPointToPoint
+ * trace source.
+ *
+ * Only the packets of the point-to-point channels are traced.
+ */
+class StreamingAnimationTrace
+{
+  public:
+    /**
+     * How the packets are sampled
+     */
+    enum SamplingMode
+    {
+        SAMPLE_PACKETS, //!< Keep one packet in N
+        SAMPLE_FLOWS    //!< Keep every packet of one flow in N
+    };
+
+    /**
+     * Open the trace file and write the nodes and the links.
+     *
+     * Create the trace after the topology, before the simulation runs.
+     * With a subset of the nodes, only the nodes of the subset and the
+     * links between them are written, and only the packets between them
+     * are traced.
+     *
+     * \param filename The name of the trace file
+     * \param nodes The ids of the nodes traced, empty for every node
+     */
+    StreamingAnimationTrace(const std::string& filename, const std::set<uint32_t>& nodes = {});
+    /**
+     * Write the remaining records and close the file.
+     */
+    ~StreamingAnimationTrace();
+
+    StreamingAnimationTrace(const StreamingAnimationTrace&) = delete;
+    StreamingAnimationTrace& operator=(const StreamingAnimationTrace&) = delete;
+
+    /**
+     * Keep only a sample of the packets.
+     *
+     * In SAMPLE_FLOWS mode, the packets are grouped by their IP addresses,
+     * protocol and ports, regardless of the direction, and the packets
+     * that are not IP are sampled one in N.
+     *
+     * \param every Keep one packet, or one flow, in every; 1 keeps all
+     * \param mode The sampling mode
+     */
+    void SetSampling(uint32_t every, SamplingMode mode = SAMPLE_PACKETS);
+    /**
+     * \param start The time the packets start to be traced
+     */
+    void SetStartTime(Time start);
+    /**
+     * \param stop The time the packets stop being traced
+     */
+    void SetStopTime(Time stop);
+    /**
+     * \param resourcePath The path of an image
+     * \returns The id of the resource
+     */
+    uint32_t AddResource(const std::string& resourcePath);
+    /**
+     * \param nodeId The node
+     * \param width The width of the node
+     * \param height The height of the node
+     */
+    void UpdateNodeSize(uint32_t nodeId, double width, double height);
+    /**
+     * \param nodeId The node
+     * \param resourceId The id of the image, from AddResource
+     */
+    void UpdateNodeImage(uint32_t nodeId, uint32_t resourceId);
+
+    /**
+     * \returns The number of packets traced
+     */
+    uint64_t GetTracedPackets() const;
+    /**
+     * \returns The number of bytes written to the trace
+     */
+    uint64_t GetTraceSize() const;
+
+    /**
+     * Convert a binary trace to NetAnim XML.
+     *
+     * \param input The binary trace
+     * \param output The XML file
+     * \param start The first packets converted
+     * \param stop The end of the packets converted, zero for the end
+     *        of the trace
+     * \returns false if the trace cannot be read or is corrupted
+     */
+    static bool ConvertToXml(const std::string& input,
+                             const std::string& output,
+                             Time start = Seconds(0),
+                             Time stop = Seconds(0));
+
+  private:
+    /**
+     * \param node The node
+     * \returns true if the packets of the node are traced
+     */
+    bool IsTraced(uint32_t node) const;
+    /**
+     * \param p The packet
+     * \returns true if the packet is in the sample
+     */
+    bool IsSampled(Ptr<const Packet> p) const;
+    /**
+     * Write the nodes and the point-to-point links.
+     */
+    void WriteTopology();
+    /**
+     * Write a record type and the time since the previous timed record.
+     *
+     * \param type The record type
+     */
+    void WriteTimedRecord(uint8_t type);
+    /**
+     * \param value The value to write as LEB128
+     */
+    void WriteVarint(uint64_t value);
+    /**
+     * \param value The value to write as a little endian double
+     */
+    void WriteDouble(double value);
+    /**
+     * TxRxPointToPoint trace sink.
+     *
+     * \param p The packet
+     * \param tx The transmitting device
+     * \param rx The receiving device
+     * \param txTime The transmission time
+     * \param rxTime The time until the end of the reception
+     */
+    void DevTxTrace(Ptr<const Packet> p,
+                    Ptr<NetDevice> tx,
+                    Ptr<NetDevice> rx,
+                    Time txTime,
+                    Time rxTime);
+
+    AsyncFileWriter m_writer;  //!< The trace file
+    uint32_t m_sampleEvery;    //!< Sampling ratio
+    SamplingMode m_sampleMode; //!< Sampling mode
+    Time m_startTime;          //!< Start of the time window
+    Time m_stopTime;           //!< End of the time window
+    std::vector<bool> m_nodes; //!< Traced nodes, by id; empty for every node
+    uint32_t m_nResources;     //!< Resources added
+    int64_t m_lastTime;        //!< Time of the previous timed record, in ns
+    uint64_t m_packets;        //!< Packets traced
+};
+
+} // namespace ns3
+
+#endif /* STREAMING_ANIMATION_TRACE_H */
@@ -29,7 +29,10 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/simple-device-energy-model.h"
 
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
 
 using namespace ns3;
 
@@ -241,6 +244,157 @@ AnimationRemainingEnergyTestCase::CheckLogic()
                               "Wrong remaining energy value was traced");
 }
 
+/**
+ * \ingroup netanim-test
+ * \ingroup tests
+ *
+ * \brief Streaming Animation Trace Test Case
+ *
+ * Writes a binary trace of UDP echoes through the AsyncFileWriter, reads
+ * it back with ConvertToXml, whole and for a time window, and checks that
+ * flow sampling keeps or drops both directions of a flow together.
+ */
+class StreamingAnimationTraceTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor.
+     */
+    StreamingAnimationTraceTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run echoes between two nodes, one flow per port, under a trace.
+     *
+     * \param flows The number of flows, each of them echoing every second
+     *        from 2s to 9s
+     * \param sampleFlows Keep one flow in sampleFlows
+     * \returns The number of packets traced
+     */
+    uint64_t RunEchoes(uint32_t flows, uint32_t sampleFlows);
+
+    /**
+     * \param filename The file
+     * \param pattern The text searched
+     * \returns The number of occurrences of pattern in the file
+     */
+    static uint32_t CountInFile(const std::string& filename, const std::string& pattern);
+
+    std::string m_traceFileName; ///< binary trace file name
+    std::string m_xmlFileName;   ///< converted trace file name
+};
+
+StreamingAnimationTraceTestCase::StreamingAnimationTraceTestCase()
+    : TestCase("Verify StreamingAnimationTrace"),
+      m_traceFileName("netanim-streaming-test.ctsa"),
+      m_xmlFileName("netanim-streaming-test.xml")
+{
+}
+
+uint64_t
+StreamingAnimationTraceTestCase::RunEchoes(uint32_t flows, uint32_t sampleFlows)
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    AnimationInterface::SetConstantPosition(nodes.Get(0), 0, 10);
+    AnimationInterface::SetConstantPosition(nodes.Get(1), 1, 10);
+
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("2ms"));
+    NetDeviceContainer devices = pointToPoint.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    Ipv4AddressHelper address("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    for (uint32_t i = 0; i < flows; i++)
+    {
+        UdpEchoServerHelper echoServer(9 + i);
+        echoServer.Install(nodes.Get(1)).Stop(Seconds(10.0));
+        UdpEchoClientHelper echoClient(interfaces.GetAddress(1), 9 + i);
+        echoClient.SetAttribute("MaxPackets", UintegerValue(100));
+        echoClient.SetAttribute("Interval", TimeValue(Seconds(1.0)));
+        echoClient.SetAttribute("PacketSize", UintegerValue(1024));
+        ApplicationContainer clientApps = echoClient.Install(nodes.Get(0));
+        clientApps.Start(Seconds(2.0));
+        clientApps.Stop(Seconds(10.0));
+    }
+
+    auto trace = std::make_unique<StreamingAnimationTrace>(m_traceFileName);
+    trace->SetSampling(sampleFlows, StreamingAnimationTrace::SAMPLE_FLOWS);
+    Simulator::Run();
+    uint64_t packets = trace->GetTracedPackets();
+    uint64_t traceSize = trace->GetTraceSize();
+    trace.reset();
+    Simulator::Destroy();
+    Ipv4AddressGenerator::Reset();
+
+    std::ifstream file(m_traceFileName, std::ios::binary | std::ios::ate);
+    NS_TEST_EXPECT_MSG_EQ(static_cast<uint64_t>(file.tellg()),
+                          traceSize,
+                          "Trace not completely written");
+    return packets;
+}
+
+uint32_t
+StreamingAnimationTraceTestCase::CountInFile(const std::string& filename,
+                                             const std::string& pattern)
+{
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string text = content.str();
+    uint32_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos;
+         pos = text.find(pattern, pos + 1))
+    {
+        count++;
+    }
+    return count;
+}
+
+void
+StreamingAnimationTraceTestCase::DoRun()
+{
+    NS_TEST_ASSERT_MSG_EQ(RunEchoes(1, 1), 16, "Expected 16 packets traced");
+    std::ifstream trace(m_traceFileName, std::ios::binary);
+    char magic[4] = {};
+    trace.read(magic, sizeof(magic));
+    NS_TEST_ASSERT_MSG_EQ(std::string(magic, sizeof(magic)), "CTSA", "Wrong magic");
+
+    NS_TEST_ASSERT_MSG_EQ(StreamingAnimationTrace::ConvertToXml(m_traceFileName, m_xmlFileName),
+                          true,
+                          "Trace not converted");
+    NS_TEST_ASSERT_MSG_EQ(CountInFile(m_xmlFileName, "<node "), 2, "Wrong number of nodes");
+    NS_TEST_ASSERT_MSG_EQ(CountInFile(m_xmlFileName, "<link "), 1, "Wrong number of links");
+    NS_TEST_ASSERT_MSG_EQ(CountInFile(m_xmlFileName, "<p "), 16, "Wrong number of packets");
+    NS_TEST_ASSERT_MSG_EQ(CountInFile(m_xmlFileName, "</anim>"), 1, "XML not closed");
+
+    // the echoes sent at 4s, 5s and 6s, and their replies
+    NS_TEST_ASSERT_MSG_EQ(
+        StreamingAnimationTrace::ConvertToXml(m_traceFileName, m_xmlFileName, Seconds(4), Seconds(7)),
+        true,
+        "Window not converted");
+    NS_TEST_ASSERT_MSG_EQ(CountInFile(m_xmlFileName, "<p "), 6, "Wrong packets in the window");
+    NS_TEST_ASSERT_MSG_EQ(CountInFile(m_xmlFileName, "<p fId=\"0\" fbTx=\"4\""),
+                          1,
+                          "Echo sent at 4s missing");
+    NS_TEST_ASSERT_MSG_EQ(CountInFile(m_xmlFileName, "<node "), 2, "Nodes missing in the window");
+
+    // the flows differ by their ports only, an echo and its reply go together
+    uint64_t sampled = RunEchoes(8, 2);
+    NS_TEST_ASSERT_MSG_EQ(sampled % 16, 0, "Flow partially sampled");
+    NS_TEST_ASSERT_MSG_GT(sampled, 0, "No flow sampled");
+    NS_TEST_ASSERT_MSG_LT(sampled, 8 * 16, "Every flow sampled");
+
+    unlink(m_traceFileName.c_str());
+    unlink(m_xmlFileName.c_str());
+}
+
 /**
  * \ingroup netanim-test
  * \ingroup tests
@@ -255,5 +409,6 @@ static class AnimationInterfaceTestSuite : public TestSuite
     {
         AddTestCase(new AnimationInterfaceTestCase(), TestCase::QUICK);
         AddTestCase(new AnimationRemainingEnergyTestCase(), TestCase::QUICK);
+        AddTestCase(new StreamingAnimationTraceTestCase(), TestCase::QUICK);
     }
 } g_animationInterfaceTestSuite; ///< the test suite
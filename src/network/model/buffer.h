@@ -25,7 +25,12 @@
 #include <stdint.h>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#else
+// The free list is not shared by the threads of multithreaded builds
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3
 {
@@ -490,6 +495,18 @@ class Buffer
      */
     inline uint32_t GetSize() const;
 
+    /**
+     * \return true if all the bytes of this buffer are in its zero-filled
+     * area, that is, no byte was ever added or written.
+     */
+    inline bool IsZeroFilled() const;
+
+    /**
+     * \return the offset of the first byte of the zero-filled area, or
+     * the size of the buffer if the area is empty.
+     */
+    inline uint32_t GetZeroAreaOffset() const;
+
     /**
      * \return a pointer to the start of the internal
      * byte buffer.
@@ -665,7 +682,11 @@ class Buffer
          * The reference count of an instance of this data structure.
          * Each buffer which references an instance holds a count.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /**
          * the size of the m_data field below.
          */
@@ -769,7 +790,11 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
+#ifdef NS3_MTP
+    static thread_local uint32_t g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -1070,6 +1095,18 @@ Buffer::GetSize() const
     return m_end - m_start;
 }
 
+bool
+Buffer::IsZeroFilled() const
+{
+    return m_start == m_zeroAreaStart && m_end == m_zeroAreaEnd;
+}
+
+uint32_t
+Buffer::GetZeroAreaOffset() const
+{
+    return m_zeroAreaStart == m_zeroAreaEnd ? GetSize() : m_zeroAreaStart - m_start;
+}
+
 Buffer::Iterator
 Buffer::Begin() const
 {
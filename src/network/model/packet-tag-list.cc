@@ -30,13 +30,64 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 
+#include <cstdlib>
 #include <cstring>
 
+// Size of the data area of the cached TagData, enough for most tags
+#define TAG_DATA_CACHE_DATA_SIZE 32
+// Maximum number of TagData in the cache of a thread
+#define TAG_DATA_CACHE_SIZE 1000
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("PacketTagList");
 
+/**
+ * \ingroup packet
+ *
+ * \brief Cache of the unused TagData of a thread.
+ *
+ * The cache is per thread, so multithreaded simulations need no lock: a
+ * TagData released by a thread other than the one which allocated it goes
+ * to the cache of the releasing thread.  It is trivially destructible, so
+ * that the packets released by the static destructors still find it; the
+ * TagData it holds are freed by a TagDataCacheDestructor when the thread
+ * exits.
+ *
+ * Internal use only.
+ */
+struct TagDataCache
+{
+    void* blocks[TAG_DATA_CACHE_SIZE]; //!< Unused TagData
+    uint32_t size;                     //!< Number of unused TagData
+    bool destroyed;                    //!< The thread is exiting
+    bool registered;                   //!< The destructor is registered
+    uint64_t allocations;              //!< Number of TagData allocated
+    uint64_t hits;                     //!< Number of TagData taken from the cache
+};
+
+static thread_local TagDataCache g_tagDataCache; //!< Cache of the thread
+
+/**
+ * \ingroup packet
+ *
+ * \brief Free the TagData of the cache of a thread when it exits.
+ */
+struct TagDataCacheDestructor
+{
+    ~TagDataCacheDestructor()
+    {
+        TagDataCache& cache = g_tagDataCache;
+        for (uint32_t i = 0; i < cache.size; i++)
+        {
+            std::free(cache.blocks[i]);
+        }
+        cache.size = 0;
+        cache.destroyed = true;
+    }
+};
+
 PacketTagList::TagData*
 PacketTagList::CreateTagData(size_t dataSize)
 {
@@ -44,14 +95,64 @@ PacketTagList::CreateTagData(size_t dataSize)
                   "Requested TagData size " << dataSize << " exceeds maximum "
                                             << std::numeric_limits<decltype(TagData::size)>::max());
 
-    void* p = std::malloc(sizeof(TagData) + dataSize - 1);
-    // The matching frees are in RemoveAll and RemoveWriter
+    TagDataCache& cache = g_tagDataCache;
+    cache.allocations++;
+    void* p;
+    if (dataSize > TAG_DATA_CACHE_DATA_SIZE)
+    {
+        p = std::malloc(sizeof(TagData) + dataSize - 1);
+    }
+    else if (cache.size == 0)
+    {
+        p = std::malloc(sizeof(TagData) + TAG_DATA_CACHE_DATA_SIZE - 1);
+    }
+    else
+    {
+        p = cache.blocks[--cache.size];
+        cache.hits++;
+    }
+    // The matching frees are in FreeTagData
 
     TagData* tag = new (p) TagData;
     tag->size = dataSize;
     return tag;
 }
 
+void
+PacketTagList::FreeTagData(TagData* tag)
+{
+    bool cacheable = tag->size <= TAG_DATA_CACHE_DATA_SIZE;
+    tag->~TagData();
+    TagDataCache& cache = g_tagDataCache;
+    if (cacheable && !cache.destroyed && cache.size < TAG_DATA_CACHE_SIZE)
+    {
+        if (!cache.registered)
+        {
+            static thread_local TagDataCacheDestructor destructor;
+            cache.registered = true;
+        }
+        cache.blocks[cache.size++] = tag;
+    }
+    else
+    {
+        std::free(tag);
+    }
+}
+
+void
+PacketTagList::GetPoolStatistics(uint64_t& allocations, uint64_t& hits)
+{
+    allocations = g_tagDataCache.allocations;
+    hits = g_tagDataCache.hits;
+}
+
+void
+PacketTagList::ResetPoolStatistics()
+{
+    g_tagDataCache.allocations = 0;
+    g_tagDataCache.hits = 0;
+}
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -195,8 +296,7 @@ PacketTagList::RemoveWriter(Tag& tag,
     if (preMerge)
     {
         // found tid before first merge, so delete cur
-        cur->~TagData();
-        std::free(cur);
+        FreeTagData(cur);
     }
     else
     {
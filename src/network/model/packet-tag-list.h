@@ -29,6 +29,10 @@
 #include <ostream>
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -142,7 +146,11 @@ class PacketTagList
     struct TagData
     {
         struct TagData* next; //!< Pointer to next in list
-        uint32_t count;       //!< Number of incoming links
+#ifdef NS3_MTP
+        std::atomic<uint32_t> count; //!< Number of incoming links
+#else
+        uint32_t count; //!< Number of incoming links
+#endif
         TypeId tid;           //!< Type of the tag serialized into #data
         uint32_t size;        //!< Size of the \c data buffer
         uint8_t data[1];      //!< Serialization buffer
@@ -243,15 +251,37 @@ class PacketTagList
      */
     uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
 
+    /**
+     * Get the statistics of the cache of TagData of the calling thread.
+     *
+     * \param [out] allocations The number of TagData allocated
+     * \param [out] hits The number of TagData taken from the cache
+     */
+    static void GetPoolStatistics(uint64_t& allocations, uint64_t& hits);
+    /**
+     * Reset the statistics of the cache of TagData of the calling thread.
+     */
+    static void ResetPoolStatistics();
+
   private:
     /**
      * Allocate and construct a TagData struct, sizing the data area
      * large enough to serialize dataSize bytes from a Tag.
      *
+     * The small TagData are taken from a cache of the calling thread
+     * when possible.
+     *
      * \param [in] dataSize The serialized size of the Tag.
      * \returns The newly constructed TagData object.
      */
     static TagData* CreateTagData(size_t dataSize);
+    /**
+     * Destroy a TagData struct, and put it back in the cache of the
+     * calling thread if it is small enough.
+     *
+     * \param [in] tag The TagData to destroy.
+     */
+    static void FreeTagData(TagData* tag);
 
     /**
      * Typedef of method function pointer for copy-on-write operations
@@ -358,22 +388,19 @@ PacketTagList::RemoveAll()
     struct TagData* prev = nullptr;
     for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
-        cur->count--;
-        if (cur->count > 0)
+        if (--cur->count > 0)
         {
             break;
         }
         if (prev != nullptr)
         {
-            prev->~TagData();
-            std::free(prev);
+            FreeTagData(prev);
         }
         prev = cur;
     }
     if (prev != nullptr)
     {
-        prev->~TagData();
-        std::free(prev);
+        FreeTagData(prev);
     }
     m_next = nullptr;
 }
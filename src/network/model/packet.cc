@@ -23,14 +23,112 @@
 #include "ns3/simulator.h"
 
 #include <cstdarg>
+#include <new>
 #include <string>
 
+// Maximum number of packets in the cache of a thread
+#define PACKET_CACHE_SIZE 1000
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Packet::m_globalUid(0);
+#else
 uint32_t Packet::m_globalUid = 0;
+#endif
+
+/**
+ * \ingroup packet
+ *
+ * \brief Cache of the memory of the unused packets of a thread.
+ *
+ * Like the cache of PacketTagList::TagData, it is per thread and
+ * trivially destructible, and the memory it holds is freed by a
+ * PacketCacheDestructor when the thread exits.
+ *
+ * Internal use only.
+ */
+struct PacketCache
+{
+    void* blocks[PACKET_CACHE_SIZE]; //!< Unused packets
+    uint32_t size;                   //!< Number of unused packets
+    bool destroyed;                  //!< The thread is exiting
+    bool registered;                 //!< The destructor is registered
+    uint64_t allocations;            //!< Number of packets allocated
+    uint64_t hits;                   //!< Number of packets taken from the cache
+};
+
+static thread_local PacketCache g_packetCache; //!< Cache of the thread
+
+/**
+ * \ingroup packet
+ *
+ * \brief Free the memory of the cache of a thread when it exits.
+ */
+struct PacketCacheDestructor
+{
+    ~PacketCacheDestructor()
+    {
+        PacketCache& cache = g_packetCache;
+        for (uint32_t i = 0; i < cache.size; i++)
+        {
+            ::operator delete(cache.blocks[i]);
+        }
+        cache.size = 0;
+        cache.destroyed = true;
+    }
+};
+
+void*
+Packet::operator new(size_t size)
+{
+    PacketCache& cache = g_packetCache;
+    cache.allocations++;
+    if (size != sizeof(Packet) || cache.size == 0)
+    {
+        return ::operator new(size);
+    }
+    cache.hits++;
+    return cache.blocks[--cache.size];
+}
+
+void
+Packet::operator delete(void* p, size_t size)
+{
+    PacketCache& cache = g_packetCache;
+    if (size != sizeof(Packet) || cache.destroyed || cache.size == PACKET_CACHE_SIZE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    if (!cache.registered)
+    {
+        static thread_local PacketCacheDestructor destructor;
+        cache.registered = true;
+    }
+    cache.blocks[cache.size++] = p;
+}
+
+Packet::PoolStatistics
+Packet::GetPoolStatistics()
+{
+    PoolStatistics statistics;
+    statistics.packets = g_packetCache.allocations;
+    statistics.packetHits = g_packetCache.hits;
+    PacketTagList::GetPoolStatistics(statistics.tags, statistics.tagHits);
+    return statistics;
+}
+
+void
+Packet::ResetPoolStatistics()
+{
+    g_packetCache.allocations = 0;
+    g_packetCache.hits = 0;
+    PacketTagList::ResetPoolStatistics();
+}
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -146,10 +244,9 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -186,10 +283,9 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -213,10 +309,9 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -234,6 +329,18 @@ Packet::Packet(const Buffer& buffer,
 {
 }
 
+bool
+Packet::IsVirtualPayload() const
+{
+    return m_buffer.IsZeroFilled() && !m_byteTagList.Begin(0, GetSize()).HasNext();
+}
+
+uint32_t
+Packet::GetVirtualPayloadOffset() const
+{
+    return m_buffer.GetZeroAreaOffset();
+}
+
 Ptr<Packet>
 Packet::CreateFragment(uint32_t start, uint32_t length) const
 {
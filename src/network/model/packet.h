@@ -36,6 +36,10 @@
 
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -310,6 +314,29 @@ class Packet : public SimpleRefCount<Packet>
      * \returns the size in bytes of the packet
      */
     inline uint32_t GetSize() const;
+    /**
+     * \brief Check whether the packet only holds virtual payload.
+     *
+     * The virtual payload is the zero-filled payload of Packet(uint32_t),
+     * which takes no memory.  The bytes of a packet of virtual payload
+     * without header, trailer nor byte tag can be split or merged by
+     * creating new packets of the resulting sizes, which is much cheaper
+     * than fragments.  The packet tags are not checked.
+     *
+     * \returns true if the packet only holds virtual payload, without
+     * header, trailer nor byte tag.
+     */
+    bool IsVirtualPayload() const;
+    /**
+     * \brief Get the offset of the virtual payload.
+     *
+     * The bytes before are the headers added to the payload, or real
+     * payload; the bytes after, the virtual payload and the trailers.
+     *
+     * \returns the offset of the zero-filled payload of Packet(uint32_t),
+     * or the size of the packet if it has none.
+     */
+    uint32_t GetVirtualPayloadOffset() const;
     /**
      * \brief Add header to this packet.
      *
@@ -539,6 +566,48 @@ class Packet : public SimpleRefCount<Packet>
      */
     static void EnableChecking();
 
+    /**
+     * \brief Statistics of the caches of the packets and packet tags
+     * of a thread.
+     *
+     * The Packet objects and the nodes of their PacketTagList are
+     * allocated from caches of the unused ones, per thread.  The hit
+     * rate is the ratio of the allocations served by the cache.
+     */
+    struct PoolStatistics
+    {
+        uint64_t packets;    //!< Number of packets allocated
+        uint64_t packetHits; //!< Number of packets taken from the cache
+        uint64_t tags;       //!< Number of packet tags allocated
+        uint64_t tagHits;    //!< Number of packet tags taken from the cache
+    };
+
+    /**
+     * \brief Get the statistics of the packet caches of the calling thread.
+     *
+     * \returns the statistics since the start or the last reset
+     */
+    static PoolStatistics GetPoolStatistics();
+    /**
+     * \brief Reset the statistics of the packet caches of the calling thread.
+     */
+    static void ResetPoolStatistics();
+    /**
+     * \brief Allocate a packet, from the cache of the calling thread
+     * when possible.
+     *
+     * \param size the size of the object
+     * \returns the memory of the packet
+     */
+    static void* operator new(size_t size);
+    /**
+     * \brief Release a packet to the cache of the calling thread.
+     *
+     * \param p the memory of the packet
+     * \param size the size of the object
+     */
+    static void operator delete(void* p, size_t size);
+
     /**
      * \brief Returns number of bytes required for packet
      * serialization.
@@ -797,7 +866,11 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/async-file-writer.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that AsyncFileWriter writes the data appended by Write and
+ * Reserve/Commit in order, across many swaps of small buffers.
+ */
+class AsyncFileWriterTestCase : public TestCase
+{
+  public:
+    AsyncFileWriterTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+AsyncFileWriterTestCase::AsyncFileWriterTestCase()
+    : TestCase("Check the data written by AsyncFileWriter")
+{
+}
+
+void
+AsyncFileWriterTestCase::DoRun()
+{
+    const std::string filename = CreateTempDirFilename("async-file-writer-test.bin");
+    std::string expected;
+    AsyncFileWriter writer(16);
+    NS_TEST_ASSERT_MSG_EQ(writer.Open(filename), true, "Cannot open " << filename);
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        // records from 1 to 16 bytes, written or built in place
+        std::string record(1 + i % 16, static_cast<char>('a' + i % 26));
+        if (i % 2)
+        {
+            writer.Write(record.data(), record.size());
+        }
+        else
+        {
+            uint8_t* room = writer.Reserve(record.size());
+            std::copy(record.begin(), record.end(), room);
+            writer.Commit(record.size());
+        }
+        expected += record;
+        if (i == 500)
+        {
+            writer.Flush();
+            std::ifstream partial(filename, std::ios::binary | std::ios::ate);
+            NS_TEST_ASSERT_MSG_EQ(static_cast<uint64_t>(partial.tellg()),
+                                  expected.size(),
+                                  "Data not written by Flush");
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(writer.GetSize(), expected.size(), "Wrong size appended");
+    writer.Close();
+    NS_TEST_ASSERT_MSG_EQ(writer.IsOpen(), false, "File still open");
+    NS_TEST_ASSERT_MSG_EQ(writer.Fail(), false, "Write failed");
+
+    std::ifstream file(filename, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    NS_TEST_ASSERT_MSG_EQ((content.str() == expected), true, "Wrong file content");
+    std::remove(filename.c_str());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief AsyncFileWriter TestSuite
+ */
+class AsyncFileWriterTestSuite : public TestSuite
+{
+  public:
+    AsyncFileWriterTestSuite();
+};
+
+AsyncFileWriterTestSuite::AsyncFileWriterTestSuite()
+    : TestSuite("async-file-writer", UNIT)
+{
+    AddTestCase(new AsyncFileWriterTestCase(), TestCase::QUICK);
+}
+
+static AsyncFileWriterTestSuite g_asyncFileWriterTestSuite; //!< Static variable for test initialization
@@ -1260,6 +1260,96 @@ PacketTagListTest::DoRun()
 } // Timing
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet and packet tag cache statistics tests.
+ */
+class PacketPoolStatisticsTest : public TestCase
+{
+  public:
+    PacketPoolStatisticsTest();
+
+  private:
+    void DoRun() override;
+    /**
+     * Checks the statistics of the caches of the thread
+     * \param packets Expected packet allocations
+     * \param packetHits Expected packets taken from the cache
+     * \param tags Expected tag allocations
+     * \param tagHits Expected tags taken from the cache
+     * \param msg Message
+     */
+    void CheckStatistics(uint64_t packets,
+                         uint64_t packetHits,
+                         uint64_t tags,
+                         uint64_t tagHits,
+                         const char* msg);
+};
+
+PacketPoolStatisticsTest::PacketPoolStatisticsTest()
+    : TestCase("Packet and packet tag cache statistics")
+{
+}
+
+void
+PacketPoolStatisticsTest::CheckStatistics(uint64_t packets,
+                                          uint64_t packetHits,
+                                          uint64_t tags,
+                                          uint64_t tagHits,
+                                          const char* msg)
+{
+    Packet::PoolStatistics statistics = Packet::GetPoolStatistics();
+    NS_TEST_EXPECT_MSG_EQ(statistics.packets, packets, msg << ": wrong packet allocations");
+    NS_TEST_EXPECT_MSG_EQ(statistics.packetHits, packetHits, msg << ": wrong packet hits");
+    NS_TEST_EXPECT_MSG_EQ(statistics.tags, tags, msg << ": wrong tag allocations");
+    NS_TEST_EXPECT_MSG_EQ(statistics.tagHits, tagHits, msg << ": wrong tag hits");
+}
+
+void
+PacketPoolStatisticsTest::DoRun()
+{
+    // fill the caches, so that the allocations below are all hits
+    {
+        Ptr<Packet> warm = Create<Packet>(10);
+        warm->AddPacketTag(ATestTag<1>(1));
+        warm->AddPacketTag(ATestTag<2>(2));
+        warm->AddPacketTag(ATestTag<3>(3));
+    }
+
+    Packet::ResetPoolStatistics();
+    CheckStatistics(0, 0, 0, 0, "Reset");
+
+    Ptr<Packet> p = Create<Packet>(100);
+    CheckStatistics(1, 1, 0, 0, "Create");
+
+    p->AddPacketTag(ATestTag<1>(1));
+    p->AddPacketTag(ATestTag<2>(2));
+    CheckStatistics(1, 1, 2, 2, "AddPacketTag");
+
+    // the copy shares the tags of the original
+    Ptr<Packet> c = p->Copy();
+    CheckStatistics(2, 2, 2, 2, "Copy");
+
+    // removing the older tag from the copy copies the newer one
+    ATestTag<1> t1;
+    NS_TEST_EXPECT_MSG_EQ(c->RemovePacketTag(t1), true, "Tag missing from the copy");
+    CheckStatistics(2, 2, 3, 3, "RemovePacketTag of a shared tag");
+
+    // the newer tag of the original is no longer shared
+    ATestTag<2> t2;
+    NS_TEST_EXPECT_MSG_EQ(p->RemovePacketTag(t2), true, "Tag missing from the original");
+    CheckStatistics(2, 2, 3, 3, "RemovePacketTag of an unshared tag");
+
+    // a tag too large for the cache is allocated apart
+    p->AddPacketTag(ATestTag<40>(4));
+    CheckStatistics(2, 2, 4, 3, "AddPacketTag of a large tag");
+
+    Packet::ResetPoolStatistics();
+    CheckStatistics(0, 0, 0, 0, "Second reset");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1277,6 +1367,7 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::QUICK);
+    AddTestCase(new PacketPoolStatisticsTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -15,14 +15,18 @@
  * Author:  Craig Dowell (craigdo@ee.washington.edu)
  */
 
+#include "ns3/async-pcap-file.h"
 #include "ns3/log.h"
+#include "ns3/packet.h"
 #include "ns3/pcap-file.h"
 #include "ns3/test.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 
 using namespace ns3;
@@ -1373,6 +1377,142 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that AsyncPcapFile writes the same
+ * captures as PcapFile, and stops at the virtual payload on request.
+ */
+class AsyncPcapFileTestCase : public TestCase
+{
+  public:
+    AsyncPcapFileTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \param filename The name of a file
+     * \returns The contents of the file
+     */
+    std::string ReadContents(const std::string& filename);
+};
+
+AsyncPcapFileTestCase::AsyncPcapFileTestCase()
+    : TestCase("Check that AsyncPcapFile writes pcap and pcapng files")
+{
+}
+
+std::string
+AsyncPcapFileTestCase::ReadContents(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void
+AsyncPcapFileTestCase::DoRun()
+{
+    //
+    // Write the known packets with both writers and check that the files
+    // are identical
+    //
+    std::string syncFilename = CreateTempDirFilename("sync.pcap");
+    std::string asyncFilename = CreateTempDirFilename("async.pcap");
+    PcapFile f;
+    f.Open(syncFilename, std::ios::out);
+    f.Init(1, N_PACKET_BYTES);
+
+    // small buffers, so that the records also cross buffer swaps
+    AsyncPcapFile af(64);
+    af.Open(asyncFilename);
+    NS_TEST_ASSERT_MSG_EQ(af.Fail(), false, "Open (" << asyncFilename << ") returns error");
+    af.Init(AsyncPcapFile::PCAP, 1, N_PACKET_BYTES);
+
+    for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+        const PacketEntry& p = knownPackets[i];
+        f.Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+        af.Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+    }
+    f.Close();
+    af.Close();
+    NS_TEST_EXPECT_MSG_EQ(af.Fail(), false, "Write must not fail");
+
+    std::string syncContents = ReadContents(syncFilename);
+    NS_TEST_EXPECT_MSG_EQ(syncContents.size(),
+                          24 + N_KNOWN_PACKETS * (16 + N_PACKET_BYTES),
+                          "Unexpected size of the pcap file");
+    NS_TEST_EXPECT_MSG_EQ((syncContents == ReadContents(asyncFilename)),
+                          true,
+                          "AsyncPcapFile and PcapFile write different files");
+
+    //
+    // A packet made of a 14 bytes header and 100 bytes of virtual payload
+    // is captured up to its virtual payload
+    //
+    uint8_t header[14];
+    for (uint32_t i = 0; i < sizeof(header); ++i)
+    {
+        header[i] = i + 1;
+    }
+    Ptr<Packet> packet = Create<Packet>(header, sizeof(header));
+    packet->AddAtEnd(Create<Packet>(100));
+    NS_TEST_ASSERT_MSG_EQ(packet->GetVirtualPayloadOffset(),
+                          sizeof(header),
+                          "The virtual payload must follow the header");
+
+    std::string truncatedFilename = CreateTempDirFilename("truncated.pcap");
+    af.Open(truncatedFilename);
+    af.Init(AsyncPcapFile::PCAP, 1);
+    af.SetTruncateVirtualPayload(true);
+    af.Write(1, 2, packet);
+    af.Close();
+
+    f.Open(truncatedFilename, std::ios::in);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Open (" << truncatedFilename << ") returns error");
+    uint8_t data[128];
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+    uint32_t readLen;
+    f.Read(data, sizeof(data), tsSec, tsUsec, inclLen, origLen, readLen);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Read() of the truncated capture returns error");
+    NS_TEST_EXPECT_MSG_EQ(tsSec, 1, "Incorrect seconds timestamp");
+    NS_TEST_EXPECT_MSG_EQ(tsUsec, 2, "Incorrect microseconds timestamp");
+    NS_TEST_EXPECT_MSG_EQ(inclLen, sizeof(header), "The capture must stop at the virtual payload");
+    NS_TEST_EXPECT_MSG_EQ(origLen, packet->GetSize(), "Incorrect original length");
+    NS_TEST_EXPECT_MSG_EQ(std::memcmp(data, header, sizeof(header)), 0, "Incorrect header bytes");
+    f.Close();
+
+    //
+    // The same packet in a pcapng file: section header block, interface
+    // description block, then an enhanced packet block padded to 32 bits
+    //
+    std::string pcapngFilename = CreateTempDirFilename("truncated.pcapng");
+    af.Open(pcapngFilename);
+    af.Init(AsyncPcapFile::PCAPNG, 1);
+    af.SetTruncateVirtualPayload(true);
+    af.Write(1, 2, packet);
+    af.Close();
+    NS_TEST_EXPECT_MSG_EQ(af.Fail(), false, "Write must not fail");
+
+    std::string contents = ReadContents(pcapngFilename);
+    const uint32_t epbLen = 28 + 16 + 4;
+    NS_TEST_ASSERT_MSG_EQ(contents.size(), 28 + 32 + epbLen, "Unexpected size of the pcapng file");
+    uint32_t fields[2];
+    std::memcpy(fields, contents.data() + 60, sizeof(fields));
+    NS_TEST_EXPECT_MSG_EQ(fields[0], 6, "Expected an enhanced packet block");
+    NS_TEST_EXPECT_MSG_EQ(fields[1], epbLen, "Incorrect block length");
+    std::memcpy(fields, contents.data() + 60 + 20, sizeof(fields));
+    NS_TEST_EXPECT_MSG_EQ(fields[0], sizeof(header), "Incorrect captured length");
+    NS_TEST_EXPECT_MSG_EQ(fields[1], packet->GetSize(), "Incorrect original length");
+    std::memcpy(fields, contents.data() + contents.size() - 4, 4);
+    NS_TEST_EXPECT_MSG_EQ(fields[0], epbLen, "Incorrect trailing block length");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1396,6 +1536,7 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new AsyncPcapFileTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
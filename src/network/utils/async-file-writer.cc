@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AsyncFileWriter");
+
+AsyncFileWriter::AsyncFileWriter(uint32_t bufferSize)
+    : m_bufferSize(bufferSize),
+      m_frontSize(0),
+      m_backSize(0),
+      m_file(nullptr),
+      m_pending(false),
+      m_stop(false),
+      m_fail(false),
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this << bufferSize);
+    NS_ASSERT(bufferSize > 0);
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+AsyncFileWriter::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    Close();
+    m_file = std::fopen(filename.c_str(), "wb");
+    if (m_file == nullptr)
+    {
+        return false;
+    }
+    m_front.resize(m_bufferSize);
+    m_back.resize(m_bufferSize);
+    m_frontSize = 0;
+    m_pending = false;
+    m_stop = false;
+    m_fail = false;
+    m_size = 0;
+    m_thread = std::thread(&AsyncFileWriter::Run, this);
+    return true;
+}
+
+bool
+AsyncFileWriter::IsOpen() const
+{
+    return m_file != nullptr;
+}
+
+bool
+AsyncFileWriter::Fail() const
+{
+    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(m_mutex));
+    return m_fail;
+}
+
+void
+AsyncFileWriter::Write(const void* data, uint32_t size)
+{
+    NS_ASSERT(IsOpen());
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_size += size;
+    while (size > 0)
+    {
+        uint32_t n = std::min(size, m_bufferSize - m_frontSize);
+        std::memcpy(m_front.data() + m_frontSize, bytes, n);
+        m_frontSize += n;
+        bytes += n;
+        size -= n;
+        if (m_frontSize == m_bufferSize)
+        {
+            Submit();
+        }
+    }
+}
+
+uint8_t*
+AsyncFileWriter::Reserve(uint32_t size)
+{
+    NS_ASSERT(IsOpen());
+    NS_ASSERT_MSG(size <= m_bufferSize, "Record of " << size << " bytes larger than the buffers");
+    if (m_frontSize + size > m_bufferSize)
+    {
+        Submit();
+    }
+    return m_front.data() + m_frontSize;
+}
+
+void
+AsyncFileWriter::Commit(uint32_t size)
+{
+    NS_ASSERT(m_frontSize + size <= m_bufferSize);
+    m_frontSize += size;
+    m_size += size;
+}
+
+void
+AsyncFileWriter::Submit()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_pending; });
+    m_front.swap(m_back);
+    m_backSize = m_frontSize;
+    m_frontSize = 0;
+    m_pending = true;
+    m_cv.notify_all();
+}
+
+void
+AsyncFileWriter::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    if (!IsOpen())
+    {
+        return;
+    }
+    if (m_frontSize > 0)
+    {
+        Submit();
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_pending; });
+    std::fflush(m_file);
+}
+
+void
+AsyncFileWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!IsOpen())
+    {
+        return;
+    }
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+    if (std::fclose(m_file) != 0)
+    {
+        m_fail = true;
+    }
+    m_file = nullptr;
+    m_front = std::vector<uint8_t>();
+    m_back = std::vector<uint8_t>();
+}
+
+uint64_t
+AsyncFileWriter::GetSize() const
+{
+    return m_size;
+}
+
+void
+AsyncFileWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this] { return m_pending || m_stop; });
+        if (!m_pending)
+        {
+            break;
+        }
+        // the simulation thread does not touch the back buffer until it
+        // is released
+        lock.unlock();
+        bool ok = std::fwrite(m_back.data(), 1, m_backSize, m_file) == m_backSize;
+        lock.lock();
+        m_fail = m_fail || !ok;
+        m_pending = false;
+        m_cv.notify_all();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief A file written by a background thread, through two buffers.
+ *
+ * The simulation thread copies the data into the front buffer.  Once it
+ * is full, the buffers are swapped and the writer thread writes the back
+ * one to the file while the front one fills again, so the simulation
+ * thread only waits for the disk when it produces data faster than the
+ * disk takes it.
+ *
+ * A writer is used by a single thread at a time.
+ */
+class AsyncFileWriter
+{
+  public:
+    /**
+     * \param bufferSize The size of each of the two buffers, in bytes
+     */
+    AsyncFileWriter(uint32_t bufferSize = 4 << 20);
+    /**
+     * Close the file, if it is open.
+     */
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * Create or truncate a file, and start the writer thread.
+     *
+     * \param filename The name of the file
+     * \returns false if the file cannot be opened
+     */
+    bool Open(const std::string& filename);
+    /**
+     * \returns true if a file is open
+     */
+    bool IsOpen() const;
+    /**
+     * \returns true if an error occurred while writing the file
+     */
+    bool Fail() const;
+    /**
+     * Append data to the file.
+     *
+     * \param data The data
+     * \param size The size of the data, in bytes
+     */
+    void Write(const void* data, uint32_t size);
+    /**
+     * Get room for a record at the end of the front buffer, so the caller
+     * can build it in place and append it with Commit.
+     *
+     * \param size The size of the record, at most the size of a buffer
+     * \returns The start of the room, valid until the next call
+     */
+    uint8_t* Reserve(uint32_t size);
+    /**
+     * Append the bytes built in the room given by Reserve.
+     *
+     * \param size The number of bytes, at most the size reserved
+     */
+    void Commit(uint32_t size);
+    /**
+     * Wait until all the data appended so far is written to the file.
+     */
+    void Flush();
+    /**
+     * Write the remaining data, stop the writer thread and close the file.
+     */
+    void Close();
+    /**
+     * \returns The number of bytes appended to the file
+     */
+    uint64_t GetSize() const;
+
+  private:
+    /**
+     * Hand the front buffer to the writer thread, once it is done with
+     * the back buffer.
+     */
+    void Submit();
+    /**
+     * Loop of the writer thread.
+     */
+    void Run();
+
+    uint32_t m_bufferSize;         //!< Size of each buffer
+    std::vector<uint8_t> m_front;  //!< Buffer filled by the simulation thread
+    std::vector<uint8_t> m_back;   //!< Buffer written by the writer thread
+    uint32_t m_frontSize;          //!< Bytes in the front buffer
+    uint32_t m_backSize;           //!< Bytes in the back buffer
+    std::FILE* m_file;             //!< The file
+    std::thread m_thread;          //!< The writer thread
+    std::mutex m_mutex;            //!< Protects m_pending, m_stop and m_fail
+    std::condition_variable m_cv;  //!< Signals the changes of m_pending and m_stop
+    bool m_pending;                //!< The back buffer waits to be written
+    bool m_stop;                   //!< The writer thread must exit
+    bool m_fail;                   //!< A write failed
+    uint64_t m_size;               //!< Bytes appended to the file
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
@@ -0,0 +1,297 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-pcap-file.h"
+
+#include "ns3/assert.h"
+#include "ns3/buffer.h"
+#include "ns3/header.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AsyncPcapFile");
+
+namespace
+{
+
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;    //!< pcap, timestamps in microseconds
+const uint32_t PCAP_NS_MAGIC = 0xa1b23c4d; //!< pcap, timestamps in nanoseconds
+const uint32_t PCAP_RECORD_HEADER = 16;    //!< Size of a pcap record header
+
+const uint32_t PCAPNG_SHB = 0x0a0d0d0a;         //!< Section header block type
+const uint32_t PCAPNG_BYTE_ORDER = 0x1a2b3c4d;  //!< Byte order magic
+const uint32_t PCAPNG_IDB = 1;                  //!< Interface description block type
+const uint32_t PCAPNG_EPB = 6;                  //!< Enhanced packet block type
+const uint16_t PCAPNG_IF_TSRESOL = 9;           //!< Timestamp resolution option
+const uint32_t PCAPNG_EPB_HEADER = 28;          //!< Size of the fields before the data
+const uint32_t PCAPNG_BLOCK_TRAILER = 4;        //!< Size of the block total length
+
+/**
+ * \param p Where to write
+ * \param v The value, written in little endian
+ * \returns The end of the value
+ */
+uint8_t*
+PutU16(uint8_t* p, uint16_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+/**
+ * \param p Where to write
+ * \param v The value, written in little endian
+ * \returns The end of the value
+ */
+uint8_t*
+PutU32(uint8_t* p, uint32_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = v >> 24;
+    return p + 4;
+}
+
+/**
+ * \param size A number of bytes
+ * \returns The size padded to 32 bits
+ */
+uint32_t
+Pad4(uint32_t size)
+{
+    return (size + 3) & ~3U;
+}
+
+} // namespace
+
+AsyncPcapFile::AsyncPcapFile(uint32_t bufferSize)
+    : m_writer(bufferSize),
+      m_openFailed(false),
+      m_format(PCAP),
+      m_dataLinkType(0),
+      m_snapLen(PcapFile::SNAPLEN_DEFAULT),
+      m_nanosecMode(false),
+      m_truncateVirtual(false)
+{
+    NS_LOG_FUNCTION(this << bufferSize);
+}
+
+AsyncPcapFile::~AsyncPcapFile()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+AsyncPcapFile::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    m_openFailed = !m_writer.Open(filename);
+}
+
+void
+AsyncPcapFile::Close()
+{
+    NS_LOG_FUNCTION(this);
+    m_writer.Close();
+}
+
+bool
+AsyncPcapFile::Fail() const
+{
+    return m_openFailed || m_writer.Fail();
+}
+
+void
+AsyncPcapFile::Init(Format format,
+                    uint32_t dataLinkType,
+                    uint32_t snapLen,
+                    int32_t timeZoneCorrection,
+                    bool nanosecMode)
+{
+    NS_LOG_FUNCTION(this << format << dataLinkType << snapLen << timeZoneCorrection
+                         << nanosecMode);
+    NS_ASSERT(m_writer.IsOpen());
+    m_format = format;
+    m_dataLinkType = dataLinkType;
+    m_snapLen = snapLen;
+    m_nanosecMode = nanosecMode;
+
+    if (format == PCAP)
+    {
+        uint8_t header[24];
+        uint8_t* p = PutU32(header, nanosecMode ? PCAP_NS_MAGIC : PCAP_MAGIC);
+        p = PutU16(p, 2);
+        p = PutU16(p, 4);
+        p = PutU32(p, timeZoneCorrection);
+        p = PutU32(p, 0);
+        p = PutU32(p, snapLen);
+        PutU32(p, dataLinkType);
+        m_writer.Write(header, sizeof(header));
+        return;
+    }
+
+    // a section header block without options, of unspecified length, then
+    // the interface description block of the timestamp resolution
+    uint8_t blocks[28 + 32];
+    uint8_t* p = PutU32(blocks, PCAPNG_SHB);
+    p = PutU32(p, 28);
+    p = PutU32(p, PCAPNG_BYTE_ORDER);
+    p = PutU16(p, 1);
+    p = PutU16(p, 0);
+    p = PutU32(p, 0xffffffff);
+    p = PutU32(p, 0xffffffff);
+    p = PutU32(p, 28);
+
+    p = PutU32(p, PCAPNG_IDB);
+    p = PutU32(p, 32);
+    p = PutU16(p, dataLinkType);
+    p = PutU16(p, 0);
+    p = PutU32(p, snapLen);
+    p = PutU16(p, PCAPNG_IF_TSRESOL);
+    p = PutU16(p, 1);
+    p = PutU32(p, nanosecMode ? 9 : 6);
+    p = PutU32(p, 0);
+    PutU32(p, 32);
+    m_writer.Write(blocks, sizeof(blocks));
+}
+
+void
+AsyncPcapFile::SetTruncateVirtualPayload(bool truncate)
+{
+    NS_LOG_FUNCTION(this << truncate);
+    m_truncateVirtual = truncate;
+}
+
+uint8_t*
+AsyncPcapFile::BeginRecord(uint32_t tsSec, uint32_t tsFrac, uint32_t inclLen, uint32_t origLen)
+{
+    if (m_format == PCAP)
+    {
+        uint8_t* p = m_writer.Reserve(PCAP_RECORD_HEADER + inclLen);
+        p = PutU32(p, tsSec);
+        p = PutU32(p, tsFrac);
+        p = PutU32(p, inclLen);
+        return PutU32(p, origLen);
+    }
+
+    uint32_t blockLen = PCAPNG_EPB_HEADER + Pad4(inclLen) + PCAPNG_BLOCK_TRAILER;
+    uint64_t ts = static_cast<uint64_t>(tsSec) * (m_nanosecMode ? 1000000000 : 1000000) + tsFrac;
+    uint8_t* p = m_writer.Reserve(blockLen);
+    p = PutU32(p, PCAPNG_EPB);
+    p = PutU32(p, blockLen);
+    p = PutU32(p, 0);
+    p = PutU32(p, ts >> 32);
+    p = PutU32(p, ts & 0xffffffff);
+    p = PutU32(p, inclLen);
+    return PutU32(p, origLen);
+}
+
+void
+AsyncPcapFile::EndRecord(uint8_t* data, uint32_t inclLen)
+{
+    if (m_format == PCAP)
+    {
+        m_writer.Commit(PCAP_RECORD_HEADER + inclLen);
+        return;
+    }
+
+    uint32_t padding = Pad4(inclLen) - inclLen;
+    uint32_t blockLen = PCAPNG_EPB_HEADER + inclLen + padding + PCAPNG_BLOCK_TRAILER;
+    std::memset(data + inclLen, 0, padding);
+    PutU32(data + inclLen + padding, blockLen);
+    m_writer.Commit(blockLen);
+}
+
+void
+AsyncPcapFile::Write(uint32_t tsSec, uint32_t tsFrac, const uint8_t* data, uint32_t totalLen)
+{
+    NS_LOG_FUNCTION(this << tsSec << tsFrac << &data << totalLen);
+    uint32_t inclLen = std::min(totalLen, m_snapLen);
+    uint8_t* p = BeginRecord(tsSec, tsFrac, inclLen, totalLen);
+    std::memcpy(p, data, inclLen);
+    EndRecord(p, inclLen);
+}
+
+void
+AsyncPcapFile::Write(uint32_t tsSec, uint32_t tsFrac, Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(this << tsSec << tsFrac << p);
+    uint32_t totalLen = p->GetSize();
+    uint32_t inclLen = std::min(totalLen, m_snapLen);
+    if (m_truncateVirtual)
+    {
+        inclLen = std::min(inclLen, p->GetVirtualPayloadOffset());
+    }
+    uint8_t* data = BeginRecord(tsSec, tsFrac, inclLen, totalLen);
+    p->CopyData(data, inclLen);
+    EndRecord(data, inclLen);
+}
+
+void
+AsyncPcapFile::Write(uint32_t tsSec, uint32_t tsFrac, const Header& header, Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(this << tsSec << tsFrac << &header << p);
+    uint32_t headerSize = header.GetSerializedSize();
+    uint32_t totalLen = headerSize + p->GetSize();
+    uint32_t inclLen = std::min(totalLen, m_snapLen);
+    if (m_truncateVirtual)
+    {
+        inclLen = std::min(inclLen, headerSize + p->GetVirtualPayloadOffset());
+    }
+
+    Buffer headerBuffer;
+    headerBuffer.AddAtStart(headerSize);
+    header.Serialize(headerBuffer.Begin());
+    uint8_t* data = BeginRecord(tsSec, tsFrac, inclLen, totalLen);
+    uint32_t toCopy = std::min(headerSize, inclLen);
+    headerBuffer.CopyData(data, toCopy);
+    p->CopyData(data + toCopy, inclLen - toCopy);
+    EndRecord(data, inclLen);
+}
+
+AsyncPcapFile::Format
+AsyncPcapFile::GetFormat() const
+{
+    return m_format;
+}
+
+uint32_t
+AsyncPcapFile::GetSnapLen() const
+{
+    return m_snapLen;
+}
+
+uint32_t
+AsyncPcapFile::GetDataLinkType() const
+{
+    return m_dataLinkType;
+}
+
+bool
+AsyncPcapFile::IsNanoSecMode() const
+{
+    return m_nanosecMode;
+}
+
+} // namespace ns3
@@ -0,0 +1,183 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_PCAP_FILE_H
+#define ASYNC_PCAP_FILE_H
+
+#include "async-file-writer.h"
+#include "pcap-file.h"
+
+#include "ns3/ptr.h"
+
+#include <stdint.h>
+#include <string>
+
+namespace ns3
+{
+
+class Packet;
+class Header;
+
+/**
+ * \brief A pcap or pcapng capture written by a background thread
+ *
+ * PcapFile writes every packet to a std::fstream on the simulation
+ * thread.  This class builds the records in place in the buffers of an
+ * AsyncFileWriter instead, so a capture costs the simulation thread a
+ * copy of the captured bytes, and the writer thread does the I/O.
+ *
+ * The capture can also stop at the virtual payload of the packets, the
+ * zero-filled payload of Packet(uint32_t): the records then hold the
+ * headers only, with the original length of the packet.
+ *
+ * The captures are written in little endian, and can only be written;
+ * read them back with PcapFile (pcap) or with the usual tools.
+ */
+class AsyncPcapFile
+{
+  public:
+    /**
+     * The file formats
+     */
+    enum Format
+    {
+        PCAP,  //!< libpcap format, as written by PcapFile
+        PCAPNG //!< pcapng format, with a single interface
+    };
+
+    /**
+     * \param bufferSize The size of each of the two buffers, in bytes
+     */
+    AsyncPcapFile(uint32_t bufferSize = 4 << 20);
+    /**
+     * Close the file, if it is open.
+     */
+    ~AsyncPcapFile();
+
+    AsyncPcapFile(const AsyncPcapFile&) = delete;
+    AsyncPcapFile& operator=(const AsyncPcapFile&) = delete;
+
+    /**
+     * Create or truncate a file for writing.
+     *
+     * \param filename The name of the file
+     */
+    void Open(const std::string& filename);
+    /**
+     * Write the remaining records and close the file.
+     */
+    void Close();
+    /**
+     * \returns true if the file cannot be opened or written
+     */
+    bool Fail() const;
+
+    /**
+     * Write the file header, or the section and interface blocks of a
+     * pcapng file.
+     *
+     * \param format The file format
+     * \param dataLinkType The data link type of the packets
+     * \param snapLen The maximum number of bytes captured per packet
+     * \param timeZoneCorrection The time zone of the timestamps (pcap only)
+     * \param nanosecMode true for timestamps in nanoseconds, false for
+     *        microseconds
+     */
+    void Init(Format format,
+              uint32_t dataLinkType,
+              uint32_t snapLen = PcapFile::SNAPLEN_DEFAULT,
+              int32_t timeZoneCorrection = PcapFile::ZONE_DEFAULT,
+              bool nanosecMode = false);
+    /**
+     * \param truncate true to stop the capture of the packets at their
+     *        virtual payload
+     */
+    void SetTruncateVirtualPayload(bool truncate);
+
+    /**
+     * Write a packet from a buffer.
+     *
+     * \param tsSec The seconds of the timestamp
+     * \param tsFrac The microseconds or nanoseconds of the timestamp
+     * \param data The packet
+     * \param totalLen The size of the packet
+     */
+    void Write(uint32_t tsSec, uint32_t tsFrac, const uint8_t* data, uint32_t totalLen);
+    /**
+     * Write a packet.
+     *
+     * \param tsSec The seconds of the timestamp
+     * \param tsFrac The microseconds or nanoseconds of the timestamp
+     * \param p The packet
+     */
+    void Write(uint32_t tsSec, uint32_t tsFrac, Ptr<const Packet> p);
+    /**
+     * Write a packet with an extra header in front of it.
+     *
+     * \param tsSec The seconds of the timestamp
+     * \param tsFrac The microseconds or nanoseconds of the timestamp
+     * \param header The header
+     * \param p The packet
+     */
+    void Write(uint32_t tsSec, uint32_t tsFrac, const Header& header, Ptr<const Packet> p);
+
+    /**
+     * \returns The file format
+     */
+    Format GetFormat() const;
+    /**
+     * \returns The maximum number of bytes captured per packet
+     */
+    uint32_t GetSnapLen() const;
+    /**
+     * \returns The data link type of the packets
+     */
+    uint32_t GetDataLinkType() const;
+    /**
+     * \returns true if the timestamps are in nanoseconds
+     */
+    bool IsNanoSecMode() const;
+
+  private:
+    /**
+     * Reserve a record and write its header.
+     *
+     * \param tsSec The seconds of the timestamp
+     * \param tsFrac The microseconds or nanoseconds of the timestamp
+     * \param inclLen The number of bytes captured
+     * \param origLen The size of the packet
+     * \returns Where to copy the captured bytes
+     */
+    uint8_t* BeginRecord(uint32_t tsSec, uint32_t tsFrac, uint32_t inclLen, uint32_t origLen);
+    /**
+     * Write the trailer of the record and commit it.
+     *
+     * \param data The captured bytes, as returned by BeginRecord
+     * \param inclLen The number of bytes captured
+     */
+    void EndRecord(uint8_t* data, uint32_t inclLen);
+
+    AsyncFileWriter m_writer;  //!< The file
+    bool m_openFailed;         //!< The file cannot be opened
+    Format m_format;           //!< The file format
+    uint32_t m_dataLinkType;   //!< Data link type of the packets
+    uint32_t m_snapLen;        //!< Maximum number of bytes captured per packet
+    bool m_nanosecMode;        //!< Timestamps in nanoseconds
+    bool m_truncateVirtual;    //!< Stop the capture at the virtual payload
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_PCAP_FILE_H */
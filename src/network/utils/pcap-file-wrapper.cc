@@ -17,8 +17,10 @@
 
 #include "pcap-file-wrapper.h"
 
+#include "ns3/abort.h"
 #include "ns3/boolean.h"
 #include "ns3/buffer.h"
+#include "ns3/enum.h"
 #include "ns3/header.h"
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
@@ -48,6 +50,28 @@ PcapFileWrapper::GetTypeId()
                           "microseconds(default).",
                           BooleanValue(false),
                           MakeBooleanAccessor(&PcapFileWrapper::m_nanosecMode),
+                          MakeBooleanChecker())
+            .AddAttribute("Asynchronous",
+                          "Whether the files opened for writing are written by a background "
+                          "thread, through double buffers.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_asynchronous),
+                          MakeBooleanChecker())
+            .AddAttribute("Format",
+                          "Format of the files opened for writing.  The pcapng files are "
+                          "always written asynchronously.",
+                          EnumValue(AsyncPcapFile::PCAP),
+                          MakeEnumAccessor(&PcapFileWrapper::m_format),
+                          MakeEnumChecker(AsyncPcapFile::PCAP,
+                                          "pcap",
+                                          AsyncPcapFile::PCAPNG,
+                                          "pcapng"))
+            .AddAttribute("TruncateVirtualPayload",
+                          "Whether the captures stop at the zero-filled payload of the "
+                          "packets, keeping their headers only.  The files are then written "
+                          "asynchronously.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_truncateVirtualPayload),
                           MakeBooleanChecker());
     return tid;
 }
@@ -67,6 +91,10 @@ bool
 PcapFileWrapper::Fail() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_asyncFile)
+    {
+        return m_asyncFile->Fail();
+    }
     return m_file.Fail();
 }
 
@@ -88,6 +116,10 @@ void
 PcapFileWrapper::Close()
 {
     NS_LOG_FUNCTION(this);
+    if (m_asyncFile)
+    {
+        m_asyncFile->Close();
+    }
     m_file.Close();
 }
 
@@ -95,6 +127,18 @@ void
 PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
 {
     NS_LOG_FUNCTION(this << filename << mode);
+    if ((mode & std::ios::out) &&
+        (m_asynchronous || m_format == AsyncPcapFile::PCAPNG || m_truncateVirtualPayload))
+    {
+        // the writer truncates the file, so it must not be asked to append
+        NS_ABORT_MSG_IF(mode & std::ios::app,
+                        "Cannot append to " << filename << " through AsyncPcapFile");
+        m_asyncFile = std::make_unique<AsyncPcapFile>();
+        m_asyncFile->Open(filename);
+        m_asyncFile->SetTruncateVirtualPayload(m_truncateVirtualPayload);
+        return;
+    }
+    m_asyncFile.reset();
     m_file.Open(filename, mode);
 }
 
@@ -107,13 +151,34 @@ PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrect
     // a snaplen, we use the one provided.
     //
     NS_LOG_FUNCTION(this << dataLinkType << snapLen << tzCorrection);
-    if (snapLen != std::numeric_limits<uint32_t>::max())
+    if (snapLen == std::numeric_limits<uint32_t>::max())
+    {
+        snapLen = m_snapLen;
+    }
+    if (m_asyncFile)
+    {
+        m_asyncFile->Init(m_format, dataLinkType, snapLen, tzCorrection, m_nanosecMode);
+    }
+    else
     {
         m_file.Init(dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
     }
+}
+
+void
+PcapFileWrapper::GetTimestamp(Time t, uint32_t& s, uint32_t& frac)
+{
+    if (m_asyncFile ? m_asyncFile->IsNanoSecMode() : m_file.IsNanoSecMode())
+    {
+        uint64_t current = t.GetNanoSeconds();
+        s = current / 1000000000;
+        frac = current % 1000000000;
+    }
     else
     {
-        m_file.Init(dataLinkType, m_snapLen, tzCorrection, false, m_nanosecMode);
+        uint64_t current = t.GetMicroSeconds();
+        s = current / 1000000;
+        frac = current % 1000000;
     }
 }
 
@@ -121,19 +186,16 @@ void
 PcapFileWrapper::Write(Time t, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << t << p);
-    if (m_file.IsNanoSecMode())
+    uint32_t s;
+    uint32_t frac;
+    GetTimestamp(t, s, frac);
+    if (m_asyncFile)
     {
-        uint64_t current = t.GetNanoSeconds();
-        uint64_t s = current / 1000000000;
-        uint64_t ns = current % 1000000000;
-        m_file.Write(s, ns, p);
+        m_asyncFile->Write(s, frac, p);
     }
     else
     {
-        uint64_t current = t.GetMicroSeconds();
-        uint64_t s = current / 1000000;
-        uint64_t us = current % 1000000;
-        m_file.Write(s, us, p);
+        m_file.Write(s, frac, p);
     }
 }
 
@@ -141,19 +203,16 @@ void
 PcapFileWrapper::Write(Time t, const Header& header, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << t << &header << p);
-    if (m_file.IsNanoSecMode())
+    uint32_t s;
+    uint32_t frac;
+    GetTimestamp(t, s, frac);
+    if (m_asyncFile)
     {
-        uint64_t current = t.GetNanoSeconds();
-        uint64_t s = current / 1000000000;
-        uint64_t ns = current % 1000000000;
-        m_file.Write(s, ns, header, p);
+        m_asyncFile->Write(s, frac, header, p);
     }
     else
     {
-        uint64_t current = t.GetMicroSeconds();
-        uint64_t s = current / 1000000;
-        uint64_t us = current % 1000000;
-        m_file.Write(s, us, header, p);
+        m_file.Write(s, frac, header, p);
     }
 }
 
@@ -161,19 +220,16 @@ void
 PcapFileWrapper::Write(Time t, const uint8_t* buffer, uint32_t length)
 {
     NS_LOG_FUNCTION(this << t << &buffer << length);
-    if (m_file.IsNanoSecMode())
+    uint32_t s;
+    uint32_t frac;
+    GetTimestamp(t, s, frac);
+    if (m_asyncFile)
     {
-        uint64_t current = t.GetNanoSeconds();
-        uint64_t s = current / 1000000000;
-        uint64_t ns = current % 1000000000;
-        m_file.Write(s, ns, buffer, length);
+        m_asyncFile->Write(s, frac, buffer, length);
     }
     else
     {
-        uint64_t current = t.GetMicroSeconds();
-        uint64_t s = current / 1000000;
-        uint64_t us = current % 1000000;
-        m_file.Write(s, us, buffer, length);
+        m_file.Write(s, frac, buffer, length);
     }
 }
 
@@ -246,6 +302,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen()
 {
     NS_LOG_FUNCTION(this);
+    if (m_asyncFile)
+    {
+        return m_asyncFile->GetSnapLen();
+    }
     return m_file.GetSnapLen();
 }
 
@@ -253,6 +313,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType()
 {
     NS_LOG_FUNCTION(this);
+    if (m_asyncFile)
+    {
+        return m_asyncFile->GetDataLinkType();
+    }
     return m_file.GetDataLinkType();
 }
 
@@ -18,6 +18,7 @@
 #ifndef PCAP_FILE_WRAPPER_H
 #define PCAP_FILE_WRAPPER_H
 
+#include "async-pcap-file.h"
 #include "pcap-file.h"
 
 #include "ns3/nstime.h"
@@ -28,6 +29,7 @@
 #include <cstring>
 #include <fstream>
 #include <limits>
+#include <memory>
 
 namespace ns3
 {
@@ -71,6 +73,10 @@ class PcapFileWrapper : public Object
      * selected as a binary file (fstream::binary is automatically ored with the mode
      * field).
      *
+     * The files written through AsyncPcapFile (the Asynchronous attribute,
+     * the pcapng Format or TruncateVirtualPayload) are always created anew,
+     * so std::ios::app is refused for them.
+     *
      * \param filename String containing the name of the file.
      *
      * \param mode String containing the access mode for the file.
@@ -222,9 +228,22 @@ class PcapFileWrapper : public Object
     uint32_t GetDataLinkType();
 
   private:
-    PcapFile m_file;    //!< Pcap file
-    uint32_t m_snapLen; //!< max length of saved packets
-    bool m_nanosecMode; //!< Timestamps in nanosecond mode
+    /**
+     * Split a time into the fields of a timestamp.
+     *
+     * \param t The time
+     * \param [out] s The seconds
+     * \param [out] frac The microseconds or nanoseconds
+     */
+    void GetTimestamp(Time t, uint32_t& s, uint32_t& frac);
+
+    PcapFile m_file;                           //!< Pcap file
+    std::unique_ptr<AsyncPcapFile> m_asyncFile; //!< File written asynchronously, if any
+    uint32_t m_snapLen;                        //!< max length of saved packets
+    bool m_nanosecMode;                        //!< Timestamps in nanosecond mode
+    bool m_asynchronous;                       //!< Write the files from a background thread
+    AsyncPcapFile::Format m_format;            //!< Format of the files written
+    bool m_truncateVirtualPayload;             //!< Stop the captures at the virtual payload
 };
 
 } // namespace ns3
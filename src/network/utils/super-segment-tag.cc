@@ -0,0 +1,127 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "super-segment-tag.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SuperSegmentTag");
+
+NS_OBJECT_ENSURE_REGISTERED(SuperSegmentTag);
+
+TypeId
+SuperSegmentTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SuperSegmentTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Network")
+                            .AddConstructor<SuperSegmentTag>();
+    return tid;
+}
+
+TypeId
+SuperSegmentTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SuperSegmentTag::GetSerializedSize() const
+{
+    NS_LOG_FUNCTION(this);
+    return 8;
+}
+
+void
+SuperSegmentTag::Serialize(TagBuffer buf) const
+{
+    NS_LOG_FUNCTION(this << &buf);
+    buf.WriteU32(m_segments);
+    buf.WriteU32(m_payloadSize);
+}
+
+void
+SuperSegmentTag::Deserialize(TagBuffer buf)
+{
+    NS_LOG_FUNCTION(this << &buf);
+    m_segments = buf.ReadU32();
+    m_payloadSize = buf.ReadU32();
+}
+
+void
+SuperSegmentTag::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    os << "Segments=" << m_segments << " PayloadSize=" << m_payloadSize;
+}
+
+SuperSegmentTag::SuperSegmentTag()
+    : Tag(),
+      m_segments(1),
+      m_payloadSize(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SuperSegmentTag::SuperSegmentTag(uint32_t segments, uint32_t payloadSize)
+    : Tag(),
+      m_segments(segments),
+      m_payloadSize(payloadSize)
+{
+    NS_LOG_FUNCTION(this << segments << payloadSize);
+}
+
+void
+SuperSegmentTag::SetSegments(uint32_t segments)
+{
+    NS_LOG_FUNCTION(this << segments);
+    m_segments = segments;
+}
+
+uint32_t
+SuperSegmentTag::GetSegments() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_segments;
+}
+
+void
+SuperSegmentTag::SetPayloadSize(uint32_t payloadSize)
+{
+    NS_LOG_FUNCTION(this << payloadSize);
+    m_payloadSize = payloadSize;
+}
+
+uint32_t
+SuperSegmentTag::GetPayloadSize() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_payloadSize;
+}
+
+uint32_t
+SuperSegmentTag::GetWireSize(uint32_t packetSize) const
+{
+    NS_LOG_FUNCTION(this << packetSize);
+    if (m_segments <= 1 || packetSize < m_payloadSize)
+    {
+        return packetSize;
+    }
+    return packetSize + (m_segments - 1) * (packetSize - m_payloadSize);
+}
+
+} // namespace ns3
@@ -0,0 +1,92 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SUPER_SEGMENT_TAG_H
+#define SUPER_SEGMENT_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup packet
+ *
+ * \brief Mark a packet as a super-segment, standing for a train of
+ * segments sent back to back.
+ *
+ * A transport protocol with segmentation offload sends the data of several
+ * segments as a single packet, with a single copy of its headers and of
+ * the headers of the lower layers.  The packet is carried as such by the
+ * network layer, which must not fragment it, and by the queues.  The net
+ * devices which support the tag transmit it for the time the train of
+ * segments would take, each of them with its own copy of the headers.
+ */
+class SuperSegmentTag : public Tag
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer buf) const override;
+    void Deserialize(TagBuffer buf) override;
+    void Print(std::ostream& os) const override;
+    SuperSegmentTag();
+
+    /**
+     * Constructs a SuperSegmentTag.
+     *
+     * \param segments The number of segments of the train
+     * \param payloadSize The size of the payload of all the segments
+     */
+    SuperSegmentTag(uint32_t segments, uint32_t payloadSize);
+    /**
+     * \param segments The number of segments of the train
+     */
+    void SetSegments(uint32_t segments);
+    /**
+     * \returns The number of segments of the train
+     */
+    uint32_t GetSegments() const;
+    /**
+     * \param payloadSize The size of the payload of all the segments,
+     * without the headers of the transport protocol
+     */
+    void SetPayloadSize(uint32_t payloadSize);
+    /**
+     * \returns The size of the payload of all the segments
+     */
+    uint32_t GetPayloadSize() const;
+    /**
+     * Get the number of bytes the train of segments takes on the wire,
+     * each segment with its own copy of the headers of the packet.
+     *
+     * \param packetSize The size of the super-segment packet, with the
+     * headers of the device
+     * \returns The size of the train
+     */
+    uint32_t GetWireSize(uint32_t packetSize) const;
+
+  private:
+    uint32_t m_segments;    //!< Number of segments
+    uint32_t m_payloadSize; //!< Size of the payload of all the segments
+};
+
+} // namespace ns3
+
+#endif /* SUPER_SEGMENT_TAG_H */
@@ -107,6 +107,53 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
     return true;
 }
 
+bool
+PointToPointChannel::TransmitTrain(const std::vector<Ptr<Packet>>& train,
+                                   Ptr<PointToPointNetDevice> src,
+                                   const std::vector<Time>& txStarts,
+                                   const std::vector<Time>& txTimes)
+{
+    NS_LOG_FUNCTION(this << train.size() << src);
+    NS_ASSERT(!train.empty() && train.size() == txStarts.size() && train.size() == txTimes.size());
+
+    NS_ASSERT(m_link[0].m_state != INITIALIZING);
+    NS_ASSERT(m_link[1].m_state != INITIALIZING);
+
+    uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+    Ptr<PointToPointNetDevice> dst = m_link[wire].m_dst;
+
+    std::vector<Ptr<Packet>> copies;
+    std::vector<Time> arrivals;
+    copies.reserve(train.size());
+    arrivals.reserve(train.size());
+    Time firstTxEnd = txStarts[0] + txTimes[0];
+    for (std::size_t i = 0; i < train.size(); i++)
+    {
+        copies.push_back(train[i]->Copy());
+        arrivals.push_back(txStarts[i] + txTimes[i] - firstTxEnd);
+    }
+    Simulator::ScheduleWithContext(dst->GetNode()->GetId(),
+                                   firstTxEnd + m_delay,
+                                   &PointToPointNetDevice::ReceiveTrain,
+                                   dst,
+                                   copies,
+                                   arrivals);
+
+    // Call the tx anim callback when the transmission of each packet starts
+    if (!m_txrxPointToPoint.IsEmpty())
+    {
+        for (std::size_t i = 0; i < train.size(); i++)
+        {
+            Ptr<const Packet> p = train[i];
+            Time txTime = txTimes[i];
+            Simulator::Schedule(txStarts[i], [this, p, src, dst, txTime]() {
+                m_txrxPointToPoint(p, src, dst, txTime, txTime + m_delay);
+            });
+        }
+    }
+    return true;
+}
+
 std::size_t
 PointToPointChannel::GetNDevices() const
 {
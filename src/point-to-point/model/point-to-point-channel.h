@@ -25,6 +25,7 @@
 #include "ns3/traced-callback.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3
 {
@@ -81,6 +82,24 @@ class PointToPointChannel : public Channel
      */
     virtual bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+    /**
+     * \brief Transmit a train of packets sent back to back over this channel
+     *
+     * The packets are delivered to the peer in a single event, at the
+     * arrival of the first one.
+     *
+     * \param train Packets to transmit
+     * \param src Source PointToPointNetDevice
+     * \param txStarts Start of the transmission of each packet, relative
+     * to now
+     * \param txTimes Transmit time of each packet
+     * \returns true if successful (currently always true)
+     */
+    virtual bool TransmitTrain(const std::vector<Ptr<Packet>>& train,
+                               Ptr<PointToPointNetDevice> src,
+                               const std::vector<Time>& txStarts,
+                               const std::vector<Time>& txTimes);
+
     /**
      * \brief Get number of devices on this channel
      * \returns number of devices on this channel
@@ -27,6 +27,7 @@
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
+#include "ns3/super-segment-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
@@ -71,6 +72,13 @@ PointToPointNetDevice::GetTypeId()
                           TimeValue(Seconds(0.0)),
                           MakeTimeAccessor(&PointToPointNetDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("MaxTrainSize",
+                          "The maximum number of queued packets transmitted back to back "
+                          "as a train, with a single transmit complete event and a single "
+                          "receive event at the peer; 1 transmits the packets one by one",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&PointToPointNetDevice::m_maxTrainSize),
+                          MakeUintegerChecker<uint32_t>(1))
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -176,6 +184,7 @@ PointToPointNetDevice::GetTypeId()
 
 PointToPointNetDevice::PointToPointNetDevice()
     : m_txMachineState(READY),
+      m_maxTrainSize(1),
       m_channel(nullptr),
       m_linkUp(false),
       m_currentPkt(nullptr)
@@ -249,7 +258,11 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     m_currentPkt = p;
     m_phyTxBeginTrace(m_currentPkt);
 
-    Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
+    Time txTime = GetTransmissionTime(p);
+    if (m_maxTrainSize > 1 && !m_queue->IsEmpty())
+    {
+        return TransmitTrain(txTime);
+    }
     Time txCompleteTime = txTime + m_tInterframeGap;
 
     NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
@@ -263,6 +276,89 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     return result;
 }
 
+bool
+PointToPointNetDevice::TransmitTrain(Time txTime)
+{
+    NS_LOG_FUNCTION(this << txTime);
+
+    //
+    // The packets already waiting in the queue are sent right after the
+    // current one, each after an interframe gap.  Their transmission times
+    // are known now, so a single event completes the transmission of the
+    // whole train.  The transmit traces of the packets are fired when their
+    // transmission starts, if anything listens to them.
+    //
+    bool traced = !m_phyTxBeginTrace.IsEmpty() || !m_phyTxEndTrace.IsEmpty() ||
+                  !m_snifferTrace.IsEmpty() || !m_promiscSnifferTrace.IsEmpty();
+    std::vector<Ptr<Packet>> train{m_currentPkt};
+    std::vector<Time> txStarts{Time(0)};
+    std::vector<Time> txTimes{txTime};
+    Time start = txTime + m_tInterframeGap;
+    while (train.size() < m_maxTrainSize)
+    {
+        Ptr<Packet> p = m_queue->Dequeue();
+        if (!p)
+        {
+            break;
+        }
+        if (traced)
+        {
+            Simulator::Schedule(start,
+                                &PointToPointNetDevice::TraceTrainTransmit,
+                                this,
+                                train.back(),
+                                p);
+        }
+        txTime = GetTransmissionTime(p);
+        train.push_back(p);
+        txStarts.push_back(start);
+        txTimes.push_back(txTime);
+        start += txTime + m_tInterframeGap;
+    }
+    m_currentPkt = train.back();
+
+    NS_LOG_LOGIC("Schedule TransmitCompleteEvent of a train of " << train.size() << " packets in "
+                                                                 << start.As(Time::S));
+    Simulator::Schedule(start, &PointToPointNetDevice::TransmitComplete, this);
+
+    bool result = m_channel->TransmitTrain(train, this, txStarts, txTimes);
+    if (result == false)
+    {
+        for (const auto& p : train)
+        {
+            m_phyTxDropTrace(p);
+        }
+    }
+    return result;
+}
+
+Time
+PointToPointNetDevice::GetTransmissionTime(Ptr<const Packet> p) const
+{
+    //
+    // A super-segment is transmitted as the train of segments it stands for,
+    // each with its own headers and followed by an interframe gap, and
+    // delivered to the peer as a whole at the end of the train.
+    //
+    SuperSegmentTag superSegment;
+    if (p->PeekPacketTag(superSegment) && superSegment.GetSegments() > 1)
+    {
+        return m_bps.CalculateBytesTxTime(superSegment.GetWireSize(p->GetSize())) +
+               m_tInterframeGap * (superSegment.GetSegments() - 1);
+    }
+    return m_bps.CalculateBytesTxTime(p->GetSize());
+}
+
+void
+PointToPointNetDevice::TraceTrainTransmit(Ptr<const Packet> previous, Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(this << previous << p);
+    m_phyTxEndTrace(previous);
+    m_snifferTrace(p);
+    m_promiscSnifferTrace(p);
+    m_phyTxBeginTrace(p);
+}
+
 void
 PointToPointNetDevice::TransmitComplete()
 {
@@ -333,55 +429,103 @@ void
 PointToPointNetDevice::Receive(Ptr<Packet> packet)
 {
     NS_LOG_FUNCTION(this << packet);
-    uint16_t protocol = 0;
 
-    if (m_receiveErrorModel && m_receiveErrorModel->IsCorrupt(packet))
+    //
+    // If we have an error model and it indicates that it is time to lose a
+    // corrupted packet, don't forward this packet up, let it go.
+    //
+    bool corrupt = m_receiveErrorModel && m_receiveErrorModel->IsCorrupt(packet);
+    TraceReceive(packet, corrupt);
+    if (!corrupt)
     {
-        //
-        // If we have an error model and it indicates that it is time to lose a
-        // corrupted packet, don't forward this packet up, let it go.
-        //
-        m_phyRxDropTrace(packet);
+        ForwardUp(packet);
     }
-    else
+}
+
+void
+PointToPointNetDevice::ReceiveTrain(const std::vector<Ptr<Packet>>& train,
+                                    const std::vector<Time>& arrivals)
+{
+    NS_LOG_FUNCTION(this << train.size());
+    bool traced = !m_phyRxDropTrace.IsEmpty() || !m_snifferTrace.IsEmpty() ||
+                  !m_promiscSnifferTrace.IsEmpty() || !m_phyRxEndTrace.IsEmpty();
+    for (std::size_t i = 0; i < train.size(); i++)
     {
-        //
-        // Hit the trace hooks.  All of these hooks are in the same place in this
-        // device because it is so simple, but this is not usually the case in
-        // more complicated devices.
-        //
-        m_snifferTrace(packet);
-        m_promiscSnifferTrace(packet);
-        m_phyRxEndTrace(packet);
+        Ptr<Packet> packet = train[i];
+        bool corrupt = m_receiveErrorModel && m_receiveErrorModel->IsCorrupt(packet);
+        if (arrivals[i].IsZero())
+        {
+            TraceReceive(packet, corrupt);
+        }
+        else if (traced)
+        {
+            // The packet is modified on its way up the stack
+            Simulator::Schedule(arrivals[i],
+                                &PointToPointNetDevice::TraceReceive,
+                                this,
+                                packet->Copy(),
+                                corrupt);
+        }
+        if (!corrupt)
+        {
+            ForwardUp(packet);
+        }
+    }
+}
 
-        //
-        // Trace sinks will expect complete packets, not packets without some of the
-        // headers.
-        //
-        Ptr<Packet> originalPacket = packet->Copy();
+void
+PointToPointNetDevice::TraceReceive(Ptr<const Packet> packet, bool corrupt)
+{
+    NS_LOG_FUNCTION(this << packet << corrupt);
+    if (corrupt)
+    {
+        m_phyRxDropTrace(packet);
+        return;
+    }
 
-        //
-        // Strip off the point-to-point protocol header and forward this packet
-        // up the protocol stack.  Since this is a simple point-to-point link,
-        // there is no difference in what the promisc callback sees and what the
-        // normal receive callback sees.
-        //
-        ProcessHeader(packet, protocol);
+    //
+    // Hit the trace hooks.  All of these hooks are in the same place in this
+    // device because it is so simple, but this is not usually the case in
+    // more complicated devices.
+    //
+    m_snifferTrace(packet);
+    m_promiscSnifferTrace(packet);
+    m_phyRxEndTrace(packet);
+}
 
-        if (!m_promiscCallback.IsNull())
-        {
-            m_macPromiscRxTrace(originalPacket);
-            m_promiscCallback(this,
-                              packet,
-                              protocol,
-                              GetRemote(),
-                              GetAddress(),
-                              NetDevice::PACKET_HOST);
-        }
+void
+PointToPointNetDevice::ForwardUp(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+    uint16_t protocol = 0;
+
+    //
+    // Trace sinks will expect complete packets, not packets without some of the
+    // headers.
+    //
+    Ptr<Packet> originalPacket = packet->Copy();
 
-        m_macRxTrace(originalPacket);
-        m_rxCallback(this, packet, protocol, GetRemote());
+    //
+    // Strip off the point-to-point protocol header and forward this packet
+    // up the protocol stack.  Since this is a simple point-to-point link,
+    // there is no difference in what the promisc callback sees and what the
+    // normal receive callback sees.
+    //
+    ProcessHeader(packet, protocol);
+
+    if (!m_promiscCallback.IsNull())
+    {
+        m_macPromiscRxTrace(originalPacket);
+        m_promiscCallback(this,
+                          packet,
+                          protocol,
+                          GetRemote(),
+                          GetAddress(),
+                          NetDevice::PACKET_HOST);
     }
+
+    m_macRxTrace(originalPacket);
+    m_rxCallback(this, packet, protocol, GetRemote());
 }
 
 Ptr<Queue<Packet>>
@@ -31,6 +31,7 @@
 #include "ns3/traced-callback.h"
 
 #include <cstring>
+#include <vector>
 
 namespace ns3
 {
@@ -154,6 +155,19 @@ class PointToPointNetDevice : public NetDevice
      */
     void Receive(Ptr<Packet> p);
 
+    /**
+     * Receive a train of packets from a connected PointToPointChannel.
+     *
+     * The packets are forwarded up the protocol stack at once, when the
+     * first one has arrived.  The receive traces of the others are fired at
+     * the time of their own arrival.
+     *
+     * \param train The packets, in transmission order.
+     * \param arrivals The time of the arrival of each packet, relative to
+     * the arrival of the first one.
+     */
+    void ReceiveTrain(const std::vector<Ptr<Packet>>& train, const std::vector<Time>& arrivals);
+
     // The remaining methods are documented in ns3::NetDevice*
 
     void SetIfIndex(const uint32_t index) override;
@@ -261,6 +275,50 @@ class PointToPointNetDevice : public NetDevice
      */
     void TransmitComplete();
 
+    /**
+     * Send the packets waiting in the queue after the current one down the
+     * wire as a train, back to back, with a single transmit complete event.
+     *
+     * \see PointToPointChannel::TransmitTrain ()
+     * \param txTime the transmission time of the current packet
+     * \returns true if success, false on failure
+     */
+    bool TransmitTrain(Time txTime);
+
+    /**
+     * Get the time to transmit a packet, or the train of segments a
+     * super-segment stands for.
+     *
+     * \param p the packet
+     * \returns the transmission time
+     */
+    Time GetTransmissionTime(Ptr<const Packet> p) const;
+
+    /**
+     * Fire the transmit traces of a packet of a train when its transmission
+     * starts, and the end trace of the previous one.
+     *
+     * \param previous the previous packet of the train
+     * \param p the packet
+     */
+    void TraceTrainTransmit(Ptr<const Packet> previous, Ptr<const Packet> p);
+
+    /**
+     * Fire the receive traces of a packet.
+     *
+     * \param p the packet, with its point-to-point header
+     * \param corrupt whether the error model dropped the packet
+     */
+    void TraceReceive(Ptr<const Packet> p, bool corrupt);
+
+    /**
+     * Strip the point-to-point header of a received packet and forward it
+     * up the protocol stack.
+     *
+     * \param packet the packet
+     */
+    void ForwardUp(Ptr<Packet> packet);
+
     /**
      * \brief Make the link up and running
      *
@@ -294,6 +352,12 @@ class PointToPointNetDevice : public NetDevice
      */
     Time m_tInterframeGap;
 
+    /**
+     * The maximum number of packets transmitted back to back as a train;
+     * 1 to transmit the packets one by one
+     */
+    uint32_t m_maxTrainSize;
+
     /**
      * The PointToPointChannel to which this PointToPointNetDevice has been
      * attached.
@@ -73,4 +73,28 @@ PointToPointRemoteChannel::TransmitStart(Ptr<const Packet> p,
     return true;
 }
 
+bool
+PointToPointRemoteChannel::TransmitTrain(const std::vector<Ptr<Packet>>& train,
+                                         Ptr<PointToPointNetDevice> src,
+                                         const std::vector<Time>& txStarts,
+                                         const std::vector<Time>& txTimes)
+{
+    NS_LOG_FUNCTION(this << train.size() << src);
+
+    IsInitialized();
+
+    uint32_t wire = src == GetSource(0) ? 0 : 1;
+    Ptr<PointToPointNetDevice> dst = GetDestination(wire);
+
+    for (std::size_t i = 0; i < train.size(); i++)
+    {
+        Time rxTime = Simulator::Now() + txStarts[i] + txTimes[i] + GetDelay();
+        MpiInterface::SendPacket(train[i]->Copy(),
+                                 rxTime,
+                                 dst->GetNode()->GetId(),
+                                 dst->GetIfIndex());
+    }
+    return true;
+}
+
 } // namespace ns3
@@ -67,6 +67,20 @@ class PointToPointRemoteChannel : public PointToPointChannel
      * \returns true if successful (currently always true)
      */
     bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override;
+
+    /**
+     * \brief Transmit a train of packets to the remote system, one by one
+     * \param train Packets to transmit
+     * \param src Source PointToPointNetDevice
+     * \param txStarts Start of the transmission of each packet, relative
+     * to now
+     * \param txTimes Transmit time of each packet
+     * \returns true if successful (currently always true)
+     */
+    bool TransmitTrain(const std::vector<Ptr<Packet>>& train,
+                       Ptr<PointToPointNetDevice> src,
+                       const std::vector<Time>& txStarts,
+                       const std::vector<Time>& txTimes) override;
 };
 
 } // namespace ns3
@@ -23,8 +23,10 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -139,6 +141,166 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test the transmission of the queued packets as trains
+ *
+ * It sends a burst of packets from one NetDevice to another, with and
+ * without trains, and checks that the trains do not change the times of
+ * the transmit and receive traces, and take fewer events without traces.
+ */
+class PointToPointTrainTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointTrainTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /** The times of the traces of a run. */
+    struct Times
+    {
+        std::vector<Time> txBegin;   //!< PhyTxBegin trace of the sender
+        std::vector<Time> rxEnd;     //!< PhyRxEnd trace of the receiver
+        std::vector<Time> delivered; //!< Reception by the receive callback
+        uint64_t events;             //!< Number of events executed
+    };
+
+    /**
+     * \brief Send a burst of packets
+     *
+     * \param maxTrainSize The MaxTrainSize attribute of the devices.
+     * \param traced Whether to connect the PHY traces.
+     * \returns The times of the traces.
+     */
+    Times Run(uint32_t maxTrainSize, bool traced);
+    /**
+     * \brief Record the time of a trace
+     *
+     * \param times The times of the trace.
+     * \param packet The packet.
+     */
+    static void Record(std::vector<Time>* times, Ptr<const Packet> packet);
+    /**
+     * \brief Callback function which records the time of the reception
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+
+    Times m_times; //!< The times of the current run
+};
+
+PointToPointTrainTest::PointToPointTrainTest()
+    : TestCase("PointToPoint packet trains")
+{
+}
+
+void
+PointToPointTrainTest::Record(std::vector<Time>* times, Ptr<const Packet> packet)
+{
+    times->push_back(Simulator::Now());
+}
+
+bool
+PointToPointTrainTest::RxPacket(Ptr<NetDevice> dev,
+                                Ptr<const Packet> pkt,
+                                uint16_t mode,
+                                const Address& sender)
+{
+    m_times.delivered.push_back(Simulator::Now());
+    return true;
+}
+
+PointToPointTrainTest::Times
+PointToPointTrainTest::Run(uint32_t maxTrainSize, bool traced)
+{
+    m_times = Times();
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MilliSeconds(2)));
+
+    for (auto dev : {devA, devB})
+    {
+        dev->Attach(channel);
+        dev->SetAddress(Mac48Address::Allocate());
+        dev->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev->SetDataRate(DataRate("8Mbps"));
+        dev->SetInterframeGap(MicroSeconds(10));
+        dev->SetAttribute("MaxTrainSize", UintegerValue(maxTrainSize));
+    }
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    if (traced)
+    {
+        devA->TraceConnectWithoutContext("PhyTxBegin",
+                                         MakeBoundCallback(&PointToPointTrainTest::Record,
+                                                           &m_times.txBegin));
+        devB->TraceConnectWithoutContext("PhyRxEnd",
+                                         MakeBoundCallback(&PointToPointTrainTest::Record,
+                                                           &m_times.rxEnd));
+    }
+    devB->SetReceiveCallback(MakeCallback(&PointToPointTrainTest::RxPacket, this));
+
+    Simulator::Schedule(Seconds(1.0), [devA]() {
+        for (uint32_t i = 0; i < 10; i++)
+        {
+            devA->Send(Create<Packet>(998 - i * 50), devA->GetBroadcast(), 0x800);
+        }
+    });
+
+    Simulator::Run();
+    m_times.events = Simulator::GetEventCount();
+    Simulator::Destroy();
+    return m_times;
+}
+
+void
+PointToPointTrainTest::DoRun()
+{
+    Times single = Run(1, true);
+    Times trains = Run(4, true);
+
+    NS_TEST_ASSERT_MSG_EQ(single.txBegin.size(), 10, "Packets not transmitted");
+    NS_TEST_ASSERT_MSG_EQ(single.rxEnd.size(), 10, "Packets not received");
+    NS_TEST_ASSERT_MSG_EQ(single.delivered.size(), 10, "Packets not delivered");
+    // The first packet (1000 bytes with the header) is received 1 ms after
+    // it is sent, plus the delay
+    NS_TEST_ASSERT_MSG_EQ(single.rxEnd[0], Seconds(1) + MilliSeconds(3), "Wrong reception time");
+
+    NS_TEST_ASSERT_MSG_EQ(trains.txBegin.size(), 10, "Packets not transmitted in trains");
+    NS_TEST_ASSERT_MSG_EQ(trains.rxEnd.size(), 10, "Packets not received in trains");
+    NS_TEST_ASSERT_MSG_EQ(trains.delivered.size(), 10, "Packets not delivered in trains");
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(trains.txBegin[i], single.txBegin[i], "Wrong PhyTxBegin time");
+        NS_TEST_EXPECT_MSG_EQ(trains.rxEnd[i], single.rxEnd[i], "Wrong PhyRxEnd time");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(trains.delivered[i],
+                                    single.delivered[i],
+                                    "Packet delivered after its reception");
+    }
+
+    // Without traces, the packets of a train take no events of their own
+    single = Run(1, false);
+    trains = Run(4, false);
+    NS_TEST_ASSERT_MSG_EQ(trains.delivered.size(), 10, "Packets not delivered in trains");
+    NS_TEST_EXPECT_MSG_LT(trains.events, single.events, "No events saved by the trains");
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +317,7 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::QUICK);
+    AddTestCase(new PointToPointTrainTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -18,6 +18,7 @@ CybertwinTopologyReader::GetTypeId()
 }
 
 CybertwinTopologyReader::CybertwinTopologyReader()
+    : m_systemCount(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -145,7 +146,7 @@ CybertwinTopologyReader::ParseCoreCloud(const YAML::Node& coreCloudConfig)
         m_coreNodesList.push_back(nodeInfo);
 
         // create nodes
-        Ptr<Node> n = CreateObject<CybertwinCoreServer>();
+        Ptr<Node> n = CreateObject<CybertwinCoreServer>(GetNodeSystemId(nodeInfo->name));
         nodeInfo->node = n;
         m_nodes.Add(n);
         m_coreNodes.Add(n);
@@ -233,7 +234,7 @@ CybertwinTopologyReader::ParseEdgeCloud(const YAML::Node& edgeCloudConfig)
         m_edgeNodesList.push_back(nodeInfo);
 
         // create nodes
-        Ptr<Node> n = CreateObject<CybertwinEdgeServer>();
+        Ptr<Node> n = CreateObject<CybertwinEdgeServer>(GetNodeSystemId(nodeInfo->name));
         nodeInfo->node = n;
         m_nodes.Add(n);
         m_edgeNodes.Add(n);
@@ -292,6 +293,7 @@ CybertwinTopologyReader::ParseAccessNetwork(const YAML::Node& accessLayerConfig)
     {
         // print node
         NodeInfo_t* nodeInfo = CreateEndClusterNodeInfo(node);
+        m_endNodesList.push_back(nodeInfo);
         m_nodeInfoMap[nodeInfo->name] = nodeInfo;
 
         // Create different access network according to the network type
@@ -315,6 +317,7 @@ CybertwinTopologyReader::ParseAccessNetwork(const YAML::Node& accessLayerConfig)
         {
             NS_LOG_ERROR("Unknown network type: " << node["network_type"].as<std::string>());
         }
+        nodeInfo->nodes = endNodes;
 
         // TODO: add multiple gateways support
         // connect end cluster to the edge cloud
@@ -405,11 +408,12 @@ CybertwinTopologyReader::CreateP2PLink(Ptr<Node> sourceNode,
 NodeContainer
 CybertwinTopologyReader::CreateCsmaNetwork(NodeInfo* csma, Ptr<Node>& leader)
 {
-    // Create nodes
+    // Create nodes, a cluster is never split between systems
+    uint32_t systemId = GetNodeSystemId(csma->name);
     NodeContainer nodes;
     for (int i = 0; i < csma->num_nodes; i++)
     {
-        Ptr<Node> n = CreateObject<CybertwinEndHost>();
+        Ptr<Node> n = CreateObject<CybertwinEndHost>(systemId);
         nodes.Add(n);
         m_nodes.Add(n);
         m_endNodes.Add(n);
@@ -473,9 +477,10 @@ CybertwinTopologyReader::CreateWifiNetwork(NodeInfo* wifi, Ptr<Node>& leader)
     NodeContainer apNode;
     NodeContainer staNodes;
     NodeContainer allNodes;
+    uint32_t systemId = GetNodeSystemId(wifi->name);
     for (int i = 0; i < wifi->num_nodes; i++)
     {
-        Ptr<Node> n = CreateObject<CybertwinEndHost>();
+        Ptr<Node> n = CreateObject<CybertwinEndHost>(systemId);
         m_nodes.Add(n);
         m_endNodes.Add(n);
         (i == 0) ? apNode.Add(n) : staNodes.Add(n);
@@ -653,6 +658,359 @@ CybertwinTopologyReader::GetStaNodes()
     return m_staNodes;
 }
 
+// Partition the nodes by layer: the core cloud, then each edge server
+// with the end clusters it is the gateway of
+std::vector<NodeContainer>
+CybertwinTopologyReader::GetLayerPartitions()
+{
+    std::vector<NodeContainer> partitions;
+    partitions.push_back(m_coreNodes);
+    std::unordered_map<std::string, uint32_t> edgePartition;
+    for (NodeInfo_t* edge : m_edgeNodesList)
+    {
+        edgePartition[edge->name] = partitions.size();
+        partitions.push_back(NodeContainer(edge->node));
+    }
+    for (NodeInfo_t* cluster : m_endNodesList)
+    {
+        auto it = edgePartition.find(cluster->gateways[0].name);
+        NS_ASSERT_MSG(it != edgePartition.end(),
+                      "Gateway " << cluster->gateways[0].name << " is not an edge server");
+        partitions[it->second].Add(cluster->nodes);
+    }
+    return partitions;
+}
+
+void
+CybertwinTopologyReader::SetSystemCount(uint32_t systems)
+{
+    m_systemCount = systems;
+}
+
+bool
+CybertwinTopologyReader::IsLocalNode(Ptr<Node> node)
+{
+    return node->GetSystemId() == Simulator::GetSystemId();
+}
+
+uint32_t
+CybertwinTopologyReader::GetNodeSystemId(const std::string& name)
+{
+    auto it = m_systemIds.find(name);
+    return it == m_systemIds.end() ? 0 : it->second;
+}
+
+// Partition the nodes between the systems (MPI ranks) of a distributed
+// run, before they are created since a node gets its system id at
+// construction. The partitioning section is optional, e.g.
+//  partitioning:
+//    systems: 4          # optional, checked against the number of ranks
+//    load_weight: 0.5    # share of the link load in the balance, the rest
+//                        # is the node count
+//
+// The partitions balance the node count and the data rate of the links of
+// their nodes, and cut few links. The smallest delay of the cut links
+// bounds how far the systems may run ahead of each other, so a link costs
+// more to cut the shorter its delay, and the links without delay and the
+// end clusters are never cut. Every rank computes the same partitions.
+void
+CybertwinTopologyReader::PartitionTopology(const YAML::Node& network,
+                                           const YAML::Node& partitioning)
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t systems = m_systemCount;
+    double loadWeight = 0.5;
+    if (partitioning)
+    {
+        if (partitioning["systems"] && systems > 0)
+        {
+            uint32_t configured = partitioning["systems"].as<uint32_t>();
+            NS_ABORT_MSG_IF(configured != systems,
+                            "The topology is partitioned for " << configured << " systems, not "
+                                                               << systems);
+        }
+        if (partitioning["load_weight"])
+        {
+            loadWeight = partitioning["load_weight"].as<double>();
+            NS_ABORT_MSG_IF(loadWeight < 0 || loadWeight > 1, "load_weight must be in [0, 1]");
+        }
+    }
+    m_systemIds.clear();
+    if (systems <= 1)
+    {
+        return;
+    }
+
+    // the vertices are the cloud nodes and the end clusters
+    std::vector<std::string> names;
+    std::vector<double> nodeCount;
+    std::unordered_map<std::string, uint32_t> index;
+    for (const char* layer : {"core_layer", "edge_layer", "access_layer"})
+    {
+        for (const auto& node : network[layer]["nodes"])
+        {
+            index[node["name"].as<std::string>()] = names.size();
+            names.push_back(node["name"].as<std::string>());
+            nodeCount.push_back(node["num_nodes"] ? node["num_nodes"].as<double>() : 1);
+        }
+    }
+
+    // the links, once each: rate in bit/s and delay
+    struct PartitionLink
+    {
+        uint32_t a;
+        uint32_t b;
+        double rate;
+        Time delay;
+    };
+    std::vector<PartitionLink> links;
+    std::set<std::pair<uint32_t, uint32_t>> linkSet;
+    auto addLink = [&](const std::string& a, const YAML::Node& link) {
+        auto target = index.find(link["target"].as<std::string>());
+        if (target == index.end())
+        {
+            return;
+        }
+        uint32_t i = index[a];
+        uint32_t j = target->second;
+        if (i == j || !linkSet.insert(std::minmax(i, j)).second)
+        {
+            return;
+        }
+        links.push_back({i,
+                         j,
+                         static_cast<double>(DataRate(link["data_rate"].as<std::string>())
+                                                 .GetBitRate()),
+                         Time(link["delay"].as<std::string>())});
+    };
+    for (const char* layer : {"core_layer", "edge_layer"})
+    {
+        for (const auto& node : network[layer]["nodes"])
+        {
+            for (const auto& link : node["connections"])
+            {
+                addLink(node["name"].as<std::string>(), link);
+            }
+        }
+    }
+    for (const auto& node : network["access_layer"]["nodes"])
+    {
+        // only the first gateway is connected
+        if (node["gateways"] && node["gateways"].size() > 0)
+        {
+            addLink(node["name"].as<std::string>(), node["gateways"][0]);
+        }
+    }
+
+    // merge the vertices joined by links without delay
+    uint32_t nVertices = names.size();
+    std::vector<uint32_t> parent(nVertices);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto findRoot = [&parent](uint32_t i) {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    Time minDelay = Time::Max();
+    for (const auto& link : links)
+    {
+        if (link.delay.IsStrictlyPositive())
+        {
+            minDelay = std::min(minDelay, link.delay);
+        }
+        else
+        {
+            parent[findRoot(link.b)] = findRoot(link.a);
+        }
+    }
+    std::vector<uint32_t> group(nVertices);
+    std::vector<uint32_t> roots;
+    for (uint32_t i = 0; i < nVertices; i++)
+    {
+        uint32_t root = findRoot(i);
+        if (root == i)
+        {
+            group[i] = roots.size();
+            roots.push_back(i);
+        }
+    }
+    for (uint32_t i = 0; i < nVertices; i++)
+    {
+        group[i] = group[findRoot(i)];
+    }
+    uint32_t nGroups = roots.size();
+
+    // the weight of a group is its share of the nodes and of the link load,
+    // the cost of a link is its share of the smallest delay
+    double totalNodes = std::accumulate(nodeCount.begin(), nodeCount.end(), 0.0);
+    double totalLoad = 0;
+    std::vector<double> load(nGroups, 0);
+    std::vector<std::map<uint32_t, double>> adjacency(nGroups);
+    for (const auto& link : links)
+    {
+        uint32_t a = group[link.a];
+        uint32_t b = group[link.b];
+        load[a] += link.rate;
+        load[b] += link.rate;
+        totalLoad += 2 * link.rate;
+        if (a != b)
+        {
+            double cost = minDelay.GetDouble() / link.delay.GetDouble();
+            adjacency[a][b] += cost;
+            adjacency[b][a] += cost;
+        }
+    }
+    if (totalLoad == 0)
+    {
+        loadWeight = 0;
+    }
+    std::vector<double> weight(nGroups, 0);
+    for (uint32_t i = 0; i < nVertices; i++)
+    {
+        weight[group[i]] += (1 - loadWeight) * nodeCount[i] / totalNodes;
+    }
+    for (uint32_t g = 0; g < nGroups; g++)
+    {
+        weight[g] += loadWeight > 0 ? loadWeight * load[g] / totalLoad : 0;
+    }
+    uint32_t k = std::min(systems, nGroups);
+
+    // seeds far apart: each new seed is the group farthest from the
+    // previous ones, in hops, the unreachable groups first
+    const uint32_t none = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> seeds;
+    seeds.push_back(std::max_element(weight.begin(), weight.end()) - weight.begin());
+    std::vector<uint32_t> distance(nGroups, none);
+    while (seeds.size() < k)
+    {
+        std::queue<uint32_t> queue;
+        distance[seeds.back()] = 0;
+        queue.push(seeds.back());
+        while (!queue.empty())
+        {
+            uint32_t g = queue.front();
+            queue.pop();
+            for (const auto& [neighbor, cost] : adjacency[g])
+            {
+                if (distance[neighbor] > distance[g] + 1)
+                {
+                    distance[neighbor] = distance[g] + 1;
+                    queue.push(neighbor);
+                }
+            }
+        }
+        seeds.push_back(std::max_element(distance.begin(), distance.end()) - distance.begin());
+    }
+
+    // grow the lightest partition by one group at a time, breadth first
+    std::vector<uint32_t> part(nGroups, none);
+    std::vector<double> partWeight(k, 0);
+    std::vector<std::queue<uint32_t>> frontier(k);
+    for (uint32_t p = 0; p < k; p++)
+    {
+        frontier[p].push(seeds[p]);
+    }
+    for (uint32_t assigned = 0; assigned < nGroups;)
+    {
+        uint32_t best = none;
+        for (uint32_t p = 0; p < k; p++)
+        {
+            while (!frontier[p].empty() && part[frontier[p].front()] != none)
+            {
+                frontier[p].pop();
+            }
+            if (!frontier[p].empty() && (best == none || partWeight[p] < partWeight[best]))
+            {
+                best = p;
+            }
+        }
+        if (best == none)
+        {
+            // a component no partition reaches goes to the lightest one
+            best = std::min_element(partWeight.begin(), partWeight.end()) - partWeight.begin();
+            frontier[best].push(std::find(part.begin(), part.end(), none) - part.begin());
+            continue;
+        }
+        uint32_t g = frontier[best].front();
+        frontier[best].pop();
+        part[g] = best;
+        partWeight[best] += weight[g];
+        assigned++;
+        for (const auto& [neighbor, cost] : adjacency[g])
+        {
+            if (part[neighbor] == none)
+            {
+                frontier[best].push(neighbor);
+            }
+        }
+    }
+
+    // move the boundary groups to the partition they have the costliest
+    // links with, within 5% of the average partition weight
+    double limit = 1.05 / k;
+    for (uint32_t pass = 0; pass < 4; pass++)
+    {
+        bool moved = false;
+        for (uint32_t g = 0; g < nGroups; g++)
+        {
+            uint32_t p = part[g];
+            std::map<uint32_t, double> costTo;
+            for (const auto& [neighbor, cost] : adjacency[g])
+            {
+                costTo[part[neighbor]] += cost;
+            }
+            double internal = costTo[p];
+            uint32_t best = p;
+            double bestGain = 1e-9;
+            for (const auto& [q, cost] : costTo)
+            {
+                if (q != p && partWeight[q] + weight[g] <= limit && cost - internal > bestGain)
+                {
+                    best = q;
+                    bestGain = cost - internal;
+                }
+            }
+            if (best != p && partWeight[p] > weight[g])
+            {
+                part[g] = best;
+                partWeight[p] -= weight[g];
+                partWeight[best] += weight[g];
+                moved = true;
+            }
+        }
+        if (!moved)
+        {
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < nVertices; i++)
+    {
+        m_systemIds[names[i]] = part[group[i]];
+    }
+    uint32_t cut = 0;
+    Time lookahead = Time::Max();
+    for (const auto& link : links)
+    {
+        if (part[group[link.a]] != part[group[link.b]])
+        {
+            cut++;
+            lookahead = std::min(lookahead, link.delay);
+        }
+    }
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] " << nVertices << " nodes and clusters in "
+                << k << " systems, " << cut << " of " << links.size() << " links cut, lookahead "
+                << lookahead.GetMicroSeconds() << "(us)");
+    for (uint32_t p = 0; p < k; p++)
+    {
+        NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "]   system " << p << ": weight "
+                    << partWeight[p]);
+    }
+}
+
 // Configure the Central Name Resolution Service (CNRS)
 // Currently we need to manually set the centralized 
 // node at the core cloud
@@ -697,6 +1055,9 @@ CybertwinTopologyReader::Read()
     NS_ASSERT(cybertwin_network["core_layer"] || cybertwin_network["edge_layer"] ||
               cybertwin_network["access_layer"]);
 
+    // the system ids must be known before the nodes are created
+    PartitionTopology(cybertwin_network, topology_yaml["partitioning"]);
+
     // parse core, edge and end layers
     ParseCoreCloud(cybertwin_network["core_layer"]);
     ParseEdgeCloud(cybertwin_network["edge_layer"]);
@@ -775,12 +1136,15 @@ CybertwinTopologyReader::InstallApplications()
             nodes.push_back(node.as<std::string>());
         }
 
-        // install the application on the nodes
+        // install the application on the nodes simulated by this system
         NodeContainer targetNodes;
         for (const auto& nodeName : nodes)
         {
             Ptr<Node> node = GetNodeByName(nodeName);
-            targetNodes.Add(node);
+            if (IsLocalNode(node))
+            {
+                targetNodes.Add(node);
+            }
         }
 
         YAML::Node newParams;
@@ -21,8 +21,14 @@
 // using yaml-cpp
 #include "yaml-cpp/yaml.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <set>
 #include <sstream>
 #include <vector>
 #include <unordered_map>
@@ -107,6 +113,13 @@ class CybertwinTopologyReader : public TopologyReader
     NodeContainer GetEndHostNodes();
     NodeContainer GetApNodes();
     NodeContainer GetStaNodes();
+    std::vector<NodeContainer> GetLayerPartitions();
+
+    // number of systems (MPI ranks) to partition the nodes between, the
+    // nodes all go to system 0 if there are less than two
+    void SetSystemCount(uint32_t systems);
+    // whether the node is simulated by this system
+    static bool IsLocalNode(Ptr<Node> node);
 
     //----------------------------------------------------------
     //          Application Installation
@@ -117,10 +130,11 @@ class CybertwinTopologyReader : public TopologyReader
     //----------------------------------------------------------
     //          Animation
     //----------------------------------------------------------
+    // the node named in the topology file, throws if there is none
+    Ptr<Node> GetNodeByName(const std::string &name);
 
   private:
     NodeType_e GetNodeType(const std::string &type);
-    Ptr<Node> GetNodeByName(const std::string &name);
     std::vector<Link_t> ParseLinks(const YAML::Node &connections);
     std::vector<Gateway_t> ParseGateways(const YAML::Node &gateways);
 
@@ -134,6 +148,9 @@ class CybertwinTopologyReader : public TopologyReader
     void ParseAccessNetwork(const YAML::Node &accessLayer);
     void ConfigCNRS(const YAML::Node &cnrsConfig);
 
+    void PartitionTopology(const YAML::Node &network, const YAML::Node &partitioning);
+    uint32_t GetNodeSystemId(const std::string &name);
+
     void ShowNetworkTopology();
 
     std::string MaskNumberToIpv4Address(std::string mask);
@@ -162,6 +179,10 @@ class CybertwinTopologyReader : public TopologyReader
 
     // Cybertwin Name Resolution Service
     std::string m_cnrsNodeName;
+
+    // partitioning between the MPI ranks
+    uint32_t m_systemCount;
+    std::unordered_map<std::string, uint32_t> m_systemIds;
 };
 
 }; // namespace ns3
@@ -0,0 +1,117 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the serialization of the Cybertwin headers:
+// adding a header, then parsing it with a PeekHeader followed by a
+// RemoveHeader, as some receive paths did, or with StripHeader.
+// Sample usage:  ./ns3 run 'bench-cybertwin-headers --n=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/cybertwin-header.h"
+#include "ns3/packet.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/**
+ * Get the wall clock time of a function.
+ *
+ * \param [in] f The function.
+ * \returns The time, in nanoseconds.
+ */
+template <typename F>
+double
+Measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+/**
+ * Benchmark a header with a fixed layout.
+ *
+ * \tparam T The header.
+ * \param [in] name The name of the header.
+ * \param [in] n The number of packets.
+ */
+template <typename T>
+void
+Bench(const std::string& name, uint32_t n)
+{
+    T header;
+    Ptr<Packet> packet = Create<Packet>(1000);
+
+    double serialize = Measure([&]() {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            packet->AddHeader(header);
+            packet->RemoveAtStart(T::Layout::SIZE);
+        }
+    });
+    double peekRemove = Measure([&]() {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            packet->AddHeader(header);
+            T peeked;
+            packet->PeekHeader(peeked);
+            packet->RemoveHeader(peeked);
+        }
+    });
+    double strip = Measure([&]() {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            packet->AddHeader(header);
+            StripHeader<T>(packet);
+        }
+    });
+
+    LOG(std::left << std::setw(24) << name << std::setw(8) << T::Layout::SIZE << std::fixed
+                  << std::setprecision(1) << std::setw(16) << serialize / n << std::setw(16)
+                  << peekRemove / n << strip / n);
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark for the serialization of the Cybertwin headers.\n"
+              "\n"
+              "For every header with a fixed layout, reports the time per packet,\n"
+              "in nanoseconds, to add the header, to add it then peek and remove it,\n"
+              "and to add it then strip it with StripHeader.");
+    cmd.AddValue("n", "number of packets per measure", n);
+    cmd.Parse(argc, argv);
+
+    LOG(std::left << std::setw(24) << "header" << std::setw(8) << "bytes" << std::setw(16)
+                  << "add (ns)" << std::setw(16) << "peek+remove" << "strip");
+    Bench<CybertwinHeader>("CybertwinHeader", n);
+    Bench<EndHostHeader>("EndHostHeader", n);
+    Bench<CybertwinDemuxHeader>("CybertwinDemuxHeader", n);
+    Bench<MultipathHeader>("MultipathHeader", n);
+    Bench<MultipathHeaderDSN>("MultipathHeaderDSN", n);
+    Bench<MdtpDatagramHeader>("MdtpDatagramHeader", n);
+
+    return 0;
+}
@@ -0,0 +1,411 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/** Number of calls to operator new, to count the allocations of lookups */
+static std::atomic<uint64_t> g_nAllocations{0};
+
+/**
+ * Counting replacement of the global operator new.
+ *
+ * \param [in] size The number of bytes.
+ * \returns The allocated memory.
+ */
+void*
+operator new(std::size_t size)
+{
+    g_nAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/**
+ * Replacement of the global operator delete, matching operator new.
+ *
+ * \param [in] p The memory.
+ */
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Replacement of the global sized operator delete, matching operator new.
+ *
+ * \param [in] p The memory.
+ */
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Parse a comma separated list of unsigned integers.
+ *
+ * \param [in] list The list, e.g. "4,8,16".
+ * \returns The values.
+ */
+std::vector<uint32_t>
+ParseList(const std::string& list)
+{
+    std::vector<uint32_t> values;
+    std::istringstream iss(list);
+    std::string item;
+    while (std::getline(iss, item, ','))
+    {
+        if (!item.empty())
+        {
+            values.push_back(std::stoul(item));
+        }
+    }
+    return values;
+}
+
+/**
+ * Build a side x side grid of routers connected by point-to-point links,
+ * each link on its own /30 subnet, optionally with a number of random
+ * extra links to break the regularity of the grid.
+ *
+ * \param [in] side The number of routers on a side of the grid.
+ * \param [in] extraLinks The number of additional random links.
+ * \returns The routers.
+ */
+NodeContainer
+BuildTopology(uint32_t side, uint32_t extraLinks)
+{
+    NodeContainer nodes;
+    nodes.Create(side * side);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("1ms"));
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+
+    auto connect = [&](uint32_t a, uint32_t b) {
+        NetDeviceContainer devices = p2p.Install(nodes.Get(a), nodes.Get(b));
+        address.Assign(devices);
+        address.NewNetwork();
+    };
+
+    for (uint32_t row = 0; row < side; row++)
+    {
+        for (uint32_t col = 0; col < side; col++)
+        {
+            uint32_t id = row * side + col;
+            if (col + 1 < side)
+            {
+                connect(id, id + 1);
+            }
+            if (row + 1 < side)
+            {
+                connect(id, id + side);
+            }
+        }
+    }
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    for (uint32_t i = 0; i < extraLinks && nodes.GetN() > 1; i++)
+    {
+        uint32_t a = rng->GetInteger(0, nodes.GetN() - 1);
+        uint32_t b = rng->GetInteger(0, nodes.GetN() - 1);
+        if (a != b)
+        {
+            connect(a, b);
+        }
+    }
+    return nodes;
+}
+
+/**
+ * Summarize the global routing tables of all the routers, so runs with
+ * different thread counts, or incremental and full updates, can be checked
+ * for identical results.
+ *
+ * \param [in] nodes The routers.
+ * \param [in] ordered Whether the order of the routes in a table matters.
+ * \param [out] nRoutes The total number of routes.
+ * \returns A hash of all the routes.
+ */
+uint64_t
+HashRoutes(const NodeContainer& nodes, bool ordered, uint64_t& nRoutes)
+{
+    uint64_t total = 0;
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t v) {
+        hash ^= v;
+        hash *= 1099511628211ULL;
+    };
+    nRoutes = 0;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+    {
+        Ptr<GlobalRouter> router = (*it)->GetObject<GlobalRouter>();
+        Ptr<Ipv4GlobalRouting> routing = router->GetRoutingProtocol();
+        mix((*it)->GetId());
+        for (uint32_t i = 0; i < routing->GetNRoutes(); i++)
+        {
+            Ipv4RoutingTableEntry* route = routing->GetRoute(i);
+            if (!ordered)
+            {
+                hash = 1469598103934665603ULL;
+                mix((*it)->GetId());
+            }
+            mix(route->GetDest().Get());
+            mix(route->GetDestNetworkMask().Get());
+            mix(route->GetGateway().Get());
+            mix(route->GetInterface());
+            total += hash;
+            nRoutes++;
+        }
+    }
+    return ordered ? hash : total;
+}
+
+/**
+ * Time a routing table update.
+ *
+ * \param [in] update The update function.
+ * \returns The wall clock time, in milliseconds.
+ */
+double
+TimeUpdate(void (*update)())
+{
+    auto start = std::chrono::steady_clock::now();
+    update();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/**
+ * Take an interface of the central router down and up again, and compare
+ * the incremental route updates with full recomputations.
+ *
+ * \param [in] nodes The routers.
+ */
+void
+BenchUpdates(const NodeContainer& nodes)
+{
+    Ptr<Ipv4> ipv4 = nodes.Get(nodes.GetN() / 2)->GetObject<Ipv4>();
+    if (ipv4->GetNInterfaces() < 2)
+    {
+        return;
+    }
+    for (bool up : {false, true})
+    {
+        if (up)
+        {
+            ipv4->SetUp(1);
+        }
+        else
+        {
+            ipv4->SetDown(1);
+        }
+        uint64_t nRoutes = 0;
+        double incremental = TimeUpdate(&Ipv4GlobalRoutingHelper::UpdateRoutingTables);
+        uint64_t incrementalHash = HashRoutes(nodes, false, nRoutes);
+        double full = TimeUpdate(&Ipv4GlobalRoutingHelper::RecomputeRoutingTables);
+        uint64_t fullHash = HashRoutes(nodes, false, nRoutes);
+        LOG("  interface " << (up ? "up:  " : "down:") << " incremental " << std::fixed
+                           << std::setprecision(2) << incremental << " ms, full " << full
+                           << " ms, " << nRoutes << " routes, "
+                           << (incrementalHash == fullHash ? "same" : "DIFFERENT") << " tables");
+        // the full recomputation dropped the kept trees
+        Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    }
+}
+
+/**
+ * Time forwarding table lookups on random routers towards random interface
+ * and subnet addresses, with the route list walk and with the prefix tries,
+ * creating a new Ipv4Route for every lookup or returning cached ones, and
+ * count the memory allocations.  The lookups run once untimed first, so the
+ * figures are those of the steady state, not of the cache fills.
+ *
+ * \param [in] nodes The routers.
+ * \param [in] nLookups The number of lookups.
+ */
+void
+BenchLookups(const NodeContainer& nodes, uint32_t nLookups)
+{
+    std::vector<Ipv4Address> dests;
+    std::vector<Ptr<Ipv4GlobalRouting>> routings;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+    {
+        Ptr<Ipv4> ipv4 = (*it)->GetObject<Ipv4>();
+        for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++)
+        {
+            Ipv4InterfaceAddress address = ipv4->GetAddress(i, 0);
+            dests.push_back(address.GetLocal());
+            dests.push_back(address.GetLocal().CombineMask(address.GetMask()));
+        }
+        routings.push_back((*it)->GetObject<GlobalRouter>()->GetRoutingProtocol());
+    }
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    queries.reserve(nLookups);
+    for (uint32_t i = 0; i < nLookups; i++)
+    {
+        queries.emplace_back(rng->GetInteger(0, routings.size() - 1),
+                             rng->GetInteger(0, dests.size() - 1));
+    }
+
+    const std::pair<bool, bool> configs[] = {{false, false}, {true, false}, {true, true}};
+    for (const auto& config : configs)
+    {
+        bool trie = config.first;
+        bool cache = config.second;
+        Ipv4Header header;
+        Socket::SocketErrno sockerr;
+        for (auto& routing : routings)
+        {
+            routing->SetAttribute("PrefixTrieLookup", BooleanValue(trie));
+            routing->SetAttribute("RouteCache", BooleanValue(cache));
+        }
+        // warm up with the same lookups, building the tries and filling the
+        // route caches, so the timed pass measures the steady state
+        for (const auto& query : queries)
+        {
+            header.SetDestination(dests[query.second]);
+            routings[query.first]->RouteOutput(nullptr, header, nullptr, sockerr);
+        }
+        uint64_t checksum = 0;
+        uint32_t nFound = 0;
+        uint64_t nAllocations = g_nAllocations.load();
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& query : queries)
+        {
+            header.SetDestination(dests[query.second]);
+            Ptr<Ipv4Route> route =
+                routings[query.first]->RouteOutput(nullptr, header, nullptr, sockerr);
+            if (route)
+            {
+                checksum += route->GetGateway().Get() + route->GetOutputDevice()->GetIfIndex();
+                nFound++;
+            }
+        }
+        auto stop = std::chrono::steady_clock::now();
+        nAllocations = g_nAllocations.load() - nAllocations;
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+        LOG("  lookups " << (trie ? "trie" : "list") << (cache ? "+cache:" : ":      ") << " "
+                         << std::fixed << std::setprecision(1) << ns / queries.size()
+                         << " ns/lookup, " << std::setprecision(3)
+                         << double(nAllocations) / queries.size() << " allocs/lookup, " << nFound
+                         << " found, checksum " << std::hex << checksum << std::dec);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string sizes = "4,8,16";
+    std::string threads = "1,0";
+    uint32_t extraLinks = 0;
+    uint32_t runs = 1;
+    bool update = false;
+    uint32_t lookups = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark for the global routing SPF calculation.\n"
+              "\n"
+              "Builds grid topologies of routers and times RecomputeRoutingTables\n"
+              "for every grid size and SPF thread count.  With --update, also\n"
+              "compares incremental route updates with full recomputations.  With\n"
+              "--lookups, also compares prefix trie lookups with route list walks,\n"
+              "and cached Ipv4Route objects with per lookup allocations.");
+    cmd.AddValue("sizes", "comma separated grid side lengths", sizes);
+    cmd.AddValue("threads", "comma separated SPF thread counts, 0 for one per core", threads);
+    cmd.AddValue("extra", "number of random links added to the grid", extraLinks);
+    cmd.AddValue("runs", "number of timed runs for each configuration", runs);
+    cmd.AddValue("update", "also time incremental updates after an interface change", update);
+    cmd.AddValue("lookups", "also time this many forwarding table lookups", lookups);
+    cmd.Parse(argc, argv);
+
+    LOG(std::left << std::setw(8) << "nodes" << std::setw(8) << "links" << std::setw(9)
+                  << "threads" << std::setw(12) << "time (ms)" << std::setw(10) << "routes"
+                  << "hash");
+
+    for (uint32_t side : ParseList(sizes))
+    {
+        NodeContainer nodes = BuildTopology(side, extraLinks);
+        uint32_t nLinks = 0;
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+        {
+            nLinks += (*it)->GetNDevices() - 1;
+        }
+        nLinks /= 2;
+
+        for (uint32_t nThreads : ParseList(threads))
+        {
+            Config::SetGlobal("GlobalRoutingSpfThreads", UintegerValue(nThreads));
+            double total = 0;
+            for (uint32_t run = 0; run < runs; run++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+                auto stop = std::chrono::steady_clock::now();
+                total += std::chrono::duration<double, std::milli>(stop - start).count();
+            }
+            uint64_t nRoutes = 0;
+            uint64_t hash = HashRoutes(nodes, true, nRoutes);
+            LOG(std::left << std::setw(8) << nodes.GetN() << std::setw(8) << nLinks
+                          << std::setw(9) << nThreads << std::setw(12) << std::fixed
+                          << std::setprecision(2) << total / runs << std::setw(10) << nRoutes
+                          << std::hex << hash << std::dec);
+        }
+
+        if (lookups > 0)
+        {
+            BenchLookups(nodes, lookups);
+        }
+
+        if (update)
+        {
+            Config::SetGlobal("GlobalRoutingIncrementalUpdates", BooleanValue(true));
+            Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+            BenchUpdates(nodes);
+            Config::SetGlobal("GlobalRoutingIncrementalUpdates", BooleanValue(false));
+        }
+
+        Simulator::Destroy();
+        Ipv4AddressGenerator::Reset();
+    }
+    return 0;
+}
@@ -350,6 +350,63 @@ benchByteTags(uint32_t n)
     }
 }
 
+/**
+ * Mirror the path of a packet of a Cybertwin flow: the host tags it with
+ * its cybertwin id, the edge server inspects the tags and forwards it to
+ * the peer with a credit tag and a multipath tag, the routers copy it at
+ * every hop and the destination edge server strips everything.  The tags
+ * have the sizes of CybertwinTag, CybertwinCreditTag and CybertwinMpTag.
+ *
+ * \param n The number of packets.
+ */
+static void
+benchCybertwin(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<20> tcp;
+    BenchTag<8> idTag;
+    BenchTag<18> creditTag;
+    BenchTag<9> mpTag;
+    BenchTag<61> certTag;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        // host
+        Ptr<Packet> p = Create<Packet>(1024);
+        p->AddPacketTag(idTag);
+        p->AddHeader(tcp);
+        p->AddHeader(ipv4);
+
+        // source edge server: inspect, then forward to the peer
+        p->PeekPacketTag(creditTag);
+        p->PeekPacketTag(certTag);
+        p->PeekPacketTag(idTag);
+        p->RemoveHeader(ipv4);
+        p->RemoveHeader(tcp);
+        p->RemovePacketTag(idTag);
+        p->AddPacketTag(creditTag);
+        p->AddPacketTag(mpTag);
+        p->AddHeader(tcp);
+        p->AddHeader(ipv4);
+
+        // core routers
+        for (uint32_t hop = 0; hop < 3; hop++)
+        {
+            Ptr<Packet> q = p->Copy();
+            q->RemoveHeader(ipv4);
+            q->AddHeader(ipv4);
+            p = q;
+        }
+
+        // destination edge server
+        p->PeekPacketTag(creditTag);
+        p->RemoveHeader(ipv4);
+        p->RemoveHeader(tcp);
+        p->RemovePacketTag(mpTag);
+        p->RemovePacketTag(creditTag);
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -408,5 +465,14 @@ main(int argc, char* argv[])
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
 
+    Packet::ResetPoolStatistics();
+    runBench(&benchCybertwin, n, minIterations, "Cybertwin forwarding path");
+    Packet::PoolStatistics pool = Packet::GetPoolStatistics();
+    double packetHitRate = 100.0 * pool.packetHits / std::max<uint64_t>(pool.packets, 1);
+    double tagHitRate = 100.0 * pool.tagHits / std::max<uint64_t>(pool.tags, 1);
+    std::cout << "Packet pool hit rate " << packetHitRate << "% (" << pool.packets
+              << " packets), packet tag pool hit rate " << tagHitRate << "% (" << pool.tags
+              << " tags)" << std::endl;
+
     return 0;
 }
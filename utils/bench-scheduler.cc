@@ -19,6 +19,7 @@
 
 #include "ns3/core-module.h"
 
+#include <chrono>
 #include <cmath> // sqrt
 #include <fstream>
 #include <iomanip>
@@ -26,6 +27,10 @@
 #include <string.h>
 #include <vector>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 using namespace ns3;
 
 /** Flag to write debugging output. */
@@ -193,13 +198,15 @@ class BenchSuite
      * \param [in] runs The number of replications.
      * \param [in] eventStream The random stream of event delays.
      * \param [in] calRev For the CalendarScheduler, whether the Reverse attribute was set.
+     * \param [in] eventPool Whether to recycle the memory of events through the event pool.
      */
     BenchSuite(ObjectFactory& factory,
                uint64_t pop,
                uint64_t total,
                uint64_t runs,
                Ptr<RandomVariableStream> eventStream,
-               bool calRev);
+               bool calRev,
+               bool eventPool);
 
     /** Write the results to \c LOG() */
     void Log() const;
@@ -269,8 +276,11 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
                        uint64_t total,
                        uint64_t runs,
                        Ptr<RandomVariableStream> eventStream,
-                       bool calRev)
+                       bool calRev,
+                       bool eventPool)
 {
+    // Each run destroys the simulator, so the next one is created with this value
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventPool", BooleanValue(eventPool));
     Simulator::SetScheduler(factory);
 
     m_scheduler = factory.GetTypeId().GetName();
@@ -282,6 +292,7 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     {
         m_scheduler += " (default)";
     }
+    m_scheduler += std::string(", event pool: ") + (eventPool ? "on" : "off");
 
     Bench bench(pop, total);
     bench.SetRandomStream(eventStream);
@@ -388,20 +399,44 @@ BenchSuite::Log() const
 /**
  *  Create a RandomVariableStream to generate next event delays.
  *
- *  If the \p filename parameter is empty a default exponential time
- *  distribution will be used, with mean delay of 100 ns.
+ *  If the \p filename parameter is empty the \p dist distribution will be
+ *  used: either a default exponential time distribution, with mean delay
+ *  of 100 ns, or a mixture modelled on the timers of the Cybertwin
+ *  models.
  *
  *  If the \p filename is `-` standard input will be used.
  *
  *  \param [in] filename The delay interval source file name.
+ *  \param [in] dist The name of the built in distribution.
  *  \returns The RandomVariableStream.
  */
 Ptr<RandomVariableStream>
-GetRandomStream(std::string filename)
+GetRandomStream(std::string filename, std::string dist)
 {
     Ptr<RandomVariableStream> stream = nullptr;
 
-    if (filename == "")
+    if (filename == "" && dist == "cybertwin")
+    {
+        LOG("  Event time distribution:      cybertwin timer mixture");
+        // Delays in ns, following the Schedule calls of src/cybertwin:
+        // ScheduleNow hand-offs, 10 us polling timers and link delays,
+        // 1 ms pacing, 10-100 ms statistics and report intervals, and
+        // sparse retransmission and one second timers.
+        auto erv = CreateObject<EmpiricalRandomVariable>();
+        erv->SetInterpolate(true);
+        erv->CDF(0, 0.25);
+        erv->CDF(1000, 0.30);
+        erv->CDF(9000, 0.32);
+        erv->CDF(11000, 0.62);
+        erv->CDF(50000, 0.75);
+        erv->CDF(990000, 0.78);
+        erv->CDF(1010000, 0.88);
+        erv->CDF(10000000, 0.93);
+        erv->CDF(100000000, 0.98);
+        erv->CDF(1000000000, 1.0);
+        stream = erv;
+    }
+    else if (filename == "")
     {
         LOG("  Event time distribution:      default exponential");
         auto erv = CreateObject<ExponentialRandomVariable>();
@@ -449,12 +484,154 @@ GetRandomStream(std::string filename)
     return stream;
 }
 
+/**
+ * Read an event trace recorded by DefaultSimulatorImpl.
+ *
+ * \param [in] filename The trace file name.
+ * \returns The records.
+ */
+std::vector<EventTraceReader::Record>
+LoadTrace(const std::string& filename)
+{
+    EventTraceReader reader;
+    if (!reader.Open(filename))
+    {
+        NS_FATAL_ERROR("cannot read the event trace " << filename);
+    }
+    std::vector<EventTraceReader::Record> records;
+    EventTraceReader::Record record;
+    uint64_t nRemoves = 0;
+    while (reader.Read(record))
+    {
+        records.push_back(record);
+        nRemoves += record.insert ? 0 : 1;
+    }
+    LOG("  Event trace:                  " << filename);
+    LOG("    Found " << records.size() - nRemoves << " inserts, " << nRemoves << " removes, "
+                     << reader.GetTypeNames().size() << " callback types");
+    return records;
+}
+
+/**
+ * \returns The number of bytes allocated on the heap, or 0 if unknown.
+ */
+uint64_t
+HeapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Replay an event trace against a scheduler: every event of the trace is
+ * inserted, and removed either by Remove(), or by RemoveNext() as the
+ * simulation executed it, in the recorded order.  An event inserted while
+ * another one was executing is inserted after removing the events up to
+ * that one.
+ *
+ * Output is a line with the run time, the rate of scheduler operations,
+ * the peak event population and the peak heap use above the start of the
+ * replay, sampled.
+ *
+ * \param [in] factory Factory pre-configured to create the desired Scheduler.
+ * \param [in] records The event trace.
+ * \param [in] label The label for the line.
+ */
+void
+Replay(ObjectFactory& factory, const std::vector<EventTraceReader::Record>& records, std::string label)
+{
+    std::vector<bool> pending; // indexed by uid
+    uint64_t nOps = 0;
+    uint64_t population = 0;
+    uint64_t maxPopulation = 0;
+    uint64_t heapStart = HeapInUse();
+    uint64_t heapPeak = heapStart;
+
+    auto start = std::chrono::steady_clock::now();
+    Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+    for (const auto& record : records)
+    {
+        uint32_t uid = record.event.key.m_uid;
+        if (record.insert)
+        {
+            if (record.parent < pending.size() && pending[record.parent])
+            {
+                uint32_t next;
+                do
+                {
+                    next = scheduler->RemoveNext().key.m_uid;
+                    pending[next] = false;
+                    population--;
+                    nOps++;
+                } while (next != record.parent);
+            }
+            scheduler->Insert(record.event);
+            if (uid >= pending.size())
+            {
+                pending.resize(uid + 1 + uid / 2, false);
+            }
+            pending[uid] = true;
+            maxPopulation = std::max(maxPopulation, ++population);
+        }
+        else if (uid < pending.size() && pending[uid])
+        {
+            scheduler->Remove(record.event);
+            pending[uid] = false;
+            population--;
+        }
+        if ((++nOps & 0xfff) == 0)
+        {
+            heapPeak = std::max(heapPeak, HeapInUse());
+        }
+    }
+    while (!scheduler->IsEmpty())
+    {
+        scheduler->RemoveNext();
+        nOps++;
+    }
+    scheduler = nullptr;
+    auto stop = std::chrono::steady_clock::now();
+    double time = std::chrono::duration<double>(stop - start).count();
+
+    LOG(std::left << std::setw(g_fwidth) << label << std::setw(g_fwidth) << time
+                  << std::setw(g_fwidth) << nOps / time << std::setw(g_fwidth) << maxPopulation
+                  << (heapPeak - heapStart) / 1024);
+}
+
+/**
+ * Replay an event trace against a scheduler a number of times.
+ *
+ * \param [in] factory Factory pre-configured to create the desired Scheduler.
+ * \param [in] records The event trace.
+ * \param [in] runs The number of replications.
+ */
+void
+ReplaySuite(ObjectFactory& factory,
+            const std::vector<EventTraceReader::Record>& records,
+            uint64_t runs)
+{
+    LOG("");
+    LOG(factory.GetTypeId().GetName() << ", trace replay");
+    LOG(std::left << std::setw(g_fwidth) << "Run #" << std::setw(g_fwidth) << "Time (s)"
+                  << std::setw(g_fwidth) << "Rate (op/s)" << std::setw(g_fwidth) << "Max pop"
+                  << "Heap (KiB)");
+    Replay(factory, records, "prime");
+    for (uint64_t i = 0; i < runs; i++)
+    {
+        Replay(factory, records, std::to_string(i));
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -463,23 +640,35 @@ main(int argc, char* argv[])
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
+    std::string dist = "exp";
+    std::string replay = "";
     bool calRev = false;
+    std::string pool = "on";
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark the simulator scheduler.\n"
               "\n"
               "Event intervals are taken from one of:\n"
               "  an exponential distribution, with mean 100 ns,\n"
+              "  a mixture of the Cybertwin timer intervals, by --dist=cybertwin,\n"
               "  an ascii file, given by the --file=\"<filename>\" argument,\n"
               "  or standard input, by the argument --file=\"-\"\n"
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
               "\n"
-              "If no scheduler is specified the MapScheduler will be run.");
+              "If no scheduler is specified the MapScheduler will be run.\n"
+              "\n"
+              "With --pool=both every scheduler is run without and then with\n"
+              "the event pool, to compare the event rates.\n"
+              "\n"
+              "With --replay=\"<filename>\" the schedulers replay the Insert,\n"
+              "RemoveNext and Remove calls of an event trace recorded with the\n"
+              "ns3::DefaultSimulatorImpl::EventTrace attribute instead.");
     cmd.AddValue("all", "use all schedulers", allSched);
     cmd.AddValue("cal", "use CalendarSheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListSheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
@@ -488,7 +677,10 @@ main(int argc, char* argv[])
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("dist", "built in event time distribution: exp or cybertwin", dist);
+    cmd.AddValue("replay", "event trace to replay against the schedulers", replay);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
+    cmd.AddValue("pool", "event memory pool: on, off or both", pool);
     cmd.Parse(argc, argv);
 
     g_me = cmd.GetName() + ": ";
@@ -499,36 +691,93 @@ main(int argc, char* argv[])
     LOG("  Event population size:        " << pop);
     LOG("  Total events per run:         " << total);
     LOG("  Number of runs per scheduler: " << runs);
+    LOG("  Event pool:                   " << pool);
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    std::vector<bool> pools;
+    if (pool == "off" || pool == "both")
+    {
+        pools.push_back(false);
+    }
+    if (pool == "on" || pool == "both")
+    {
+        pools.push_back(true);
+    }
+    if (pools.empty())
+    {
+        NS_FATAL_ERROR("invalid --pool value: " << pool);
+    }
+
+    if (!replay.empty())
+    {
+        auto records = LoadTrace(replay);
+        std::vector<std::pair<bool, std::string>> types = {
+            {schedCal, "ns3::CalendarScheduler"},
+            {schedHeap, "ns3::HeapScheduler"},
+            {schedLadder, "ns3::LadderScheduler"},
+            {schedList, "ns3::ListScheduler"},
+            {schedMap, "ns3::MapScheduler"},
+            {schedPQ, "ns3::PriorityQueueScheduler"}};
+        for (const auto& type : types)
+        {
+            if (type.first)
+            {
+                ObjectFactory factory(type.second);
+                ReplaySuite(factory, records, runs);
+            }
+        }
+        return 0;
+    }
+
+    if (dist != "exp" && dist != "cybertwin")
+    {
+        NS_FATAL_ERROR("invalid --dist value: " << dist);
+    }
+    auto eventStream = GetRandomStream(filename, dist);
 
     ObjectFactory factory("ns3::MapScheduler");
     if (schedCal)
     {
         factory.SetTypeId("ns3::CalendarScheduler");
         factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        for (bool eventPool : pools)
+        {
+            BenchSuite(factory, pop, total, runs, eventStream, calRev, eventPool).Log();
+        }
         if (allSched)
         {
             factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            for (bool eventPool : pools)
+            {
+                BenchSuite(factory, pop, total, runs, eventStream, !calRev, eventPool).Log();
+            }
         }
     }
     if (schedHeap)
     {
         factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        for (bool eventPool : pools)
+        {
+            BenchSuite(factory, pop, total, runs, eventStream, calRev, eventPool).Log();
+        }
+    }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        for (bool eventPool : pools)
+        {
+            BenchSuite(factory, pop, total, runs, eventStream, calRev, eventPool).Log();
+        }
     }
     if (schedList)
     {
@@ -539,17 +788,26 @@ main(int argc, char* argv[])
             LOG("Running List scheduler with 1/10 total events");
             listTotal /= 10;
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        for (bool eventPool : pools)
+        {
+            BenchSuite(factory, pop, listTotal, runs, eventStream, calRev, eventPool).Log();
+        }
     }
     if (schedMap)
     {
         factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        for (bool eventPool : pools)
+        {
+            BenchSuite(factory, pop, total, runs, eventStream, calRev, eventPool).Log();
+        }
     }
     if (schedPQ)
     {
         factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        for (bool eventPool : pools)
+        {
+            BenchSuite(factory, pop, total, runs, eventStream, calRev, eventPool).Log();
+        }
     }
 
     return 0;
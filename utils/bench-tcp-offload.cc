@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/**
+ * Parse a comma separated list of unsigned integers.
+ *
+ * \param [in] list The list, e.g. "0,65536".
+ * \returns The values.
+ */
+std::vector<uint32_t>
+ParseList(const std::string& list)
+{
+    std::vector<uint32_t> values;
+    std::istringstream iss(list);
+    std::string item;
+    while (std::getline(iss, item, ','))
+    {
+        if (!item.empty())
+        {
+            values.push_back(std::stoul(item));
+        }
+    }
+    return values;
+}
+
+/** Number of packets whose transmission started on the first link */
+static uint64_t g_nTxPackets = 0;
+
+/**
+ * Count the packets transmitted on the first link.
+ *
+ * \param [in] packet The packet.
+ */
+void
+CountTx(Ptr<const Packet> packet)
+{
+    g_nTxPackets++;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string sizes = "0,16384,64512";
+    std::string dataRate = "10Gbps";
+    std::string delay = "10us";
+    uint32_t flows = 1;
+    uint32_t hops = 2;
+    double duration = 0.1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark for TCP segmentation offload.\n"
+              "\n"
+              "Runs bulk TCP transfers along a chain of point-to-point links, for\n"
+              "every maximum super-segment size (0 disables the offload), and\n"
+              "reports the goodput, the events executed, the packets transmitted\n"
+              "on the first link and the wall clock time of the run.");
+    cmd.AddValue("sizes", "comma separated maximum super-segment sizes", sizes);
+    cmd.AddValue("rate", "data rate of the links", dataRate);
+    cmd.AddValue("delay", "delay of the links", delay);
+    cmd.AddValue("flows", "number of bulk transfers", flows);
+    cmd.AddValue("hops", "number of links between the sender and the receiver", hops);
+    cmd.AddValue("duration", "simulated time of the transfers, in seconds", duration);
+    cmd.Parse(argc, argv);
+
+    // full segments, with timestamps, must fit the 1500 byte MTU of the links
+    uint32_t segmentSize = 1500 - Ipv4Header().GetSerializedSize() - 32;
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(segmentSize));
+    Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(1 << 24));
+    Config::SetDefault("ns3::TcpSocket::RcvBufSize", UintegerValue(1 << 24));
+
+    LOG(std::left << std::setw(10) << "size" << std::setw(16) << "goodput (Mbps)" << std::setw(12)
+                  << "events" << std::setw(12) << "packets" << "time (ms)");
+
+    for (uint32_t size : ParseList(sizes))
+    {
+        Config::SetDefault("ns3::TcpSocketBase::MaxSuperSegmentSize", UintegerValue(size));
+
+        NodeContainer nodes;
+        nodes.Create(hops + 1);
+        InternetStackHelper stack;
+        stack.Install(nodes);
+        PointToPointHelper p2p;
+        p2p.SetDeviceAttribute("DataRate", StringValue(dataRate));
+        p2p.SetChannelAttribute("Delay", StringValue(delay));
+        Ipv4AddressHelper address("10.0.0.0", "255.255.255.0");
+        Ipv4InterfaceContainer last;
+        for (uint32_t i = 0; i < hops; i++)
+        {
+            NetDeviceContainer devices = p2p.Install(nodes.Get(i), nodes.Get(i + 1));
+            if (i == 0)
+            {
+                devices.Get(0)->TraceConnectWithoutContext("PhyTxBegin", MakeCallback(&CountTx));
+            }
+            last = address.Assign(devices);
+            address.NewNetwork();
+        }
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+        ApplicationContainer sinks;
+        for (uint32_t i = 0; i < flows; i++)
+        {
+            uint16_t port = 5000 + i;
+            BulkSendHelper source("ns3::TcpSocketFactory",
+                                  InetSocketAddress(last.GetAddress(1), port));
+            source.SetAttribute("SendSize", UintegerValue(1 << 16));
+            source.Install(nodes.Get(0)).Start(Seconds(0));
+            PacketSinkHelper sink("ns3::TcpSocketFactory",
+                                  InetSocketAddress(Ipv4Address::GetAny(), port));
+            // the sink binds to a device, the loopback one by default
+            sink.SetAttribute("DevIdx", UintegerValue(1));
+            sinks.Add(sink.Install(nodes.Get(hops)));
+        }
+
+        g_nTxPackets = 0;
+        Simulator::Stop(Seconds(duration));
+        auto start = std::chrono::steady_clock::now();
+        Simulator::Run();
+        auto stop = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+        uint64_t rxBytes = 0;
+        for (auto it = sinks.Begin(); it != sinks.End(); ++it)
+        {
+            rxBytes += DynamicCast<PacketSink>(*it)->GetTotalRx();
+        }
+        LOG(std::left << std::setw(10) << size << std::setw(16) << std::fixed
+                      << std::setprecision(1) << rxBytes * 8 / duration / 1e6 << std::setw(12)
+                      << Simulator::GetEventCount() << std::setw(12) << g_nTxPackets << ms);
+
+        Simulator::Destroy();
+        Ipv4AddressGenerator::Reset();
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program prints the records of a BinaryLogSink file as NS_LOG
+// would have printed them.
+// Sample usage:
+//   ./ns3 run 'log-render --input=cybertwin.nslog' > cybertwin.log
+
+#include "ns3/binary-log-sink.h"
+#include "ns3/command-line.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Print a binary log as text.\n"
+              "\n"
+              "The records are printed to the standard output, oldest first.");
+    cmd.AddValue("input", "binary log file", input);
+    cmd.Parse(argc, argv);
+
+    if (input.empty())
+    {
+        std::cerr << "No input log, use --input" << std::endl;
+        return 1;
+    }
+    if (!BinaryLogSink::Render(input, std::cout))
+    {
+        std::cerr << "Cannot render " << input << std::endl;
+        return 1;
+    }
+    return 0;
+}
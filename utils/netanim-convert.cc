@@ -0,0 +1,59 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts a binary trace of StreamingAnimationTrace, or a
+// window of it, to the XML that NetAnim reads.
+// Sample usage:
+//   ./ns3 run 'netanim-convert --input=cybertwin.ctsa --output=cybertwin.xml --start=1s --stop=2s'
+
+#include "ns3/command-line.h"
+#include "ns3/nstime.h"
+#include "ns3/streaming-animation-trace.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output = "animation.xml";
+    Time start = Seconds(0);
+    Time stop = Seconds(0);
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Convert a binary animation trace to NetAnim XML.\n"
+              "\n"
+              "Keeps the packets whose transmission starts in [start, stop), so\n"
+              "NetAnim can load a small window of a long run.");
+    cmd.AddValue("input", "binary animation trace", input);
+    cmd.AddValue("output", "NetAnim XML file", output);
+    cmd.AddValue("start", "start of the window", start);
+    cmd.AddValue("stop", "end of the window, 0 for the end of the trace", stop);
+    cmd.Parse(argc, argv);
+
+    if (input.empty())
+    {
+        std::cerr << "No input trace, use --input" << std::endl;
+        return 1;
+    }
+    if (!StreamingAnimationTrace::ConvertToXml(input, output, start, stop))
+    {
+        std::cerr << "Cannot convert " << input << " to " << output << std::endl;
+        return 1;
+    }
+    return 0;
+}
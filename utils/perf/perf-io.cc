@@ -13,13 +13,20 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include "ns3/async-pcap-file.h"
 #include "ns3/core-module.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/packet.h"
+#include "ns3/pcap-file.h"
+#include "ns3/trace-helper.h"
 
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -64,6 +71,115 @@ PerfStream(std::ostream& stream, uint32_t n, const char* buffer, uint32_t size)
     }
 }
 
+/**
+ * \ingroup system-tests-perf
+ *
+ * Check the performance of writing packets to a pcap file.
+ *
+ * \param file The pcap file to write to.
+ * \param n The number of packets to write.
+ * \param p The packet.
+ */
+void
+PerfPcap(PcapFile& file, uint32_t n, Ptr<const Packet> p)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        file.Write(i / 1000000, i % 1000000, p);
+    }
+}
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Check the performance of writing packets to an asynchronous pcap file.
+ *
+ * \param file The pcap file to write to.
+ * \param n The number of packets to write.
+ * \param p The packet.
+ */
+void
+PerfAsyncPcap(AsyncPcapFile& file, uint32_t n, Ptr<const Packet> p)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        file.Write(i / 1000000, i % 1000000, p);
+    }
+}
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Compare the pcap writers: PcapFile, and AsyncPcapFile writing pcap,
+ * pcapng and pcap stopping at the virtual payload.  Reports the minimum
+ * time spent by the simulation thread per packet, and for the
+ * asynchronous writers the time to close the file, which waits for the
+ * writer thread.
+ *
+ * \param n The number of packets to write.
+ * \param iter The number of runs.
+ * \param size The size of the packets.
+ */
+void
+PerfPcapWriters(uint32_t n, uint32_t iter, uint32_t size)
+{
+    // an Ethernet header in front of virtual payload, as the packets of
+    // the applications sending zero-filled data
+    Ptr<Packet> p = Create<Packet>(size > 14 ? size - 14 : 0);
+    EthernetHeader header;
+    p->AddHeader(header);
+
+    struct AsyncCase
+    {
+        std::string name;
+        AsyncPcapFile::Format format;
+        bool truncate;
+    };
+
+    const std::vector<AsyncCase> cases = {{"async pcap", AsyncPcapFile::PCAP, false},
+                                          {"async pcapng", AsyncPcapFile::PCAPNG, false},
+                                          {"async pcap, headers", AsyncPcapFile::PCAP, true}};
+
+    auto min = std::chrono::nanoseconds::max();
+    for (uint32_t i = 0; i < iter; ++i)
+    {
+        PcapFile file;
+        file.Open("pcaptest", std::ios::out);
+        file.Init(PcapHelper::DLT_EN10MB);
+        auto start = std::chrono::steady_clock::now();
+        PerfPcap(file, n, p);
+        file.Close();
+        auto end = std::chrono::steady_clock::now();
+        min = std::min(min, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+    }
+    std::cout << "pcap: " << min.count() / n << "ns per packet" << std::endl;
+
+    for (const auto& c : cases)
+    {
+        auto minWrite = std::chrono::nanoseconds::max();
+        auto minClose = std::chrono::nanoseconds::max();
+        for (uint32_t i = 0; i < iter; ++i)
+        {
+            AsyncPcapFile file;
+            file.Open("pcaptest");
+            file.Init(c.format, PcapHelper::DLT_EN10MB);
+            file.SetTruncateVirtualPayload(c.truncate);
+            auto start = std::chrono::steady_clock::now();
+            PerfAsyncPcap(file, n, p);
+            auto written = std::chrono::steady_clock::now();
+            file.Close();
+            auto end = std::chrono::steady_clock::now();
+            NS_ABORT_MSG_IF(file.Fail(), "PerfPcapWriters(): write error");
+            minWrite = std::min(minWrite,
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(written - start));
+            minClose = std::min(minClose,
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(end - written));
+        }
+        std::cout << c.name << ": " << minWrite.count() / n << "ns per packet, "
+                  << minClose.count() / 1000 << "us to close" << std::endl;
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -71,6 +187,8 @@ main(int argc, char* argv[])
     uint32_t iter = 50;
     bool doStream = false;
     bool binmode = true;
+    bool doPcap = false;
+    uint32_t packetSize = 1500;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("n", "How many times to write (defaults to 100000", n);
@@ -79,8 +197,16 @@ main(int argc, char* argv[])
     cmd.AddValue("binmode",
                  "Select binary mode for the C++ I/O benchmark (defaults to true)",
                  binmode);
+    cmd.AddValue("doPcap", "Run the pcap writers benchmark", doPcap);
+    cmd.AddValue("packetSize", "Size of the packets of the pcap benchmark", packetSize);
     cmd.Parse(argc, argv);
 
+    if (doPcap)
+    {
+        PerfPcapWriters(n, iter, packetSize);
+        return 0;
+    }
+
     auto minResultNs =
         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::nanoseconds::max());
 